@@ -11,13 +11,18 @@ common_SRC_FILES := \
     files/source/convert_from.cc \
     files/source/cpu_id.cc \
     files/source/format_conversion.cc \
+    files/source/frame.cc \
+    files/source/instrument.cc \
+    files/source/parallel.cc \
     files/source/planar_functions.cc \
     files/source/rotate.cc \
     files/source/rotate_argb.cc \
     files/source/row_common.cc \
+    files/source/row_dispatch.cc \
     files/source/row_posix.cc \
     files/source/scale.cc \
     files/source/scale_argb.cc \
+    files/source/scale_uv.cc \
     files/source/video_common.cc \
     files/source/mjpeg_decoder.cc \
 
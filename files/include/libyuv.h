@@ -17,7 +17,10 @@
 #include "libyuv/convert_argb.h"
 #include "libyuv/convert_from.h"
 #include "libyuv/cpu_id.h"
+#include "libyuv/explain.h"
 #include "libyuv/format_conversion.h"
+#include "libyuv/frame.h"
+#include "libyuv/instrument.h"
 #include "libyuv/planar_functions.h"
 #include "libyuv/rotate.h"
 #include "libyuv/rotate_argb.h"
@@ -65,6 +65,27 @@ double I420Ssim(const uint8* src_y_a, int stride_y_a,
                 const uint8* src_v_b, int stride_v_b,
                 int width, int height);
 
+// Count the values in a plane. The counts are added to histogram[256], so
+// clear it first for a single image. For a region of interest, pass a pointer
+// to its top left pixel and its size.
+LIBYUV_API
+int PlaneHistogram(const uint8* src_y, int src_stride_y,
+                   int width, int height, uint32* histogram);
+
+// Count the values of each channel of an ARGB image, added to histogram[1024]
+// as 256 counts each for B, G, R and A.
+LIBYUV_API
+int ARGBHistogram(const uint8* src_argb, int src_stride_argb,
+                  int width, int height, uint32* histogram);
+
+// Sum, sum of squares, minimum and maximum of a plane. The mean is
+// sum / (width * height) and the variance is
+// sum_squares / (width * height) - mean * mean.
+LIBYUV_API
+int PlaneStats(const uint8* src_y, int src_stride_y,
+               int width, int height,
+               uint64* sum, uint64* sum_squares, int* min, int* max);
+
 #ifdef __cplusplus
 }  // extern "C"
 }  // namespace libyuv
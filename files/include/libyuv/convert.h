@@ -107,6 +107,13 @@ int YUY2ToI420(const uint8* src_yuy2, int src_stride_yuy2,
                uint8* dst_v, int dst_stride_v,
                int width, int height);
 
+// Convert YUY2 to NV12.
+LIBYUV_API
+int YUY2ToNV12(const uint8* src_yuy2, int src_stride_yuy2,
+               uint8* dst_y, int dst_stride_y,
+               uint8* dst_uv, int dst_stride_uv,
+               int width, int height);
+
 // Convert UYVY to I420.
 LIBYUV_API
 int UYVYToI420(const uint8* src_uyvy, int src_stride_uyvy,
@@ -131,6 +138,13 @@ int ARGBToI420(const uint8* src_frame, int src_stride_frame,
                uint8* dst_v, int dst_stride_v,
                int width, int height);
 
+// ARGB little endian (bgra in memory) to NV12.
+LIBYUV_API
+int ARGBToNV12(const uint8* src_frame, int src_stride_frame,
+               uint8* dst_y, int dst_stride_y,
+               uint8* dst_uv, int dst_stride_uv,
+               int width, int height);
+
 // BGRA little endian (argb in memory) to I420.
 LIBYUV_API
 int BGRAToI420(const uint8* src_frame, int src_stride_frame,
@@ -195,6 +209,12 @@ int ARGB4444ToI420(const uint8* src_frame, int src_stride_frame,
                    uint8* dst_v, int dst_stride_v,
                    int width, int height);
 
+// Get the width and height of an MJPG frame from its headers without decoding
+// it. Returns 0 for successful; -1 if the headers could not be parsed.
+LIBYUV_API
+int MJPGSize(const uint8* sample, size_t sample_size,
+             int* width, int* height);
+
 #ifdef HAVE_JPEG
 // src_width/height provided by capture.
 // dst_width/height for clipping determine final size.
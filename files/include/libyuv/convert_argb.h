@@ -12,6 +12,7 @@
 #define INCLUDE_LIBYUV_CONVERT_ARGB_H_
 
 #include "libyuv/basic_types.h"
+#include "libyuv/frame.h"  // For YuvFrame
 // TODO(fbarchard): Remove the following headers includes
 #include "libyuv/convert_from.h"
 #include "libyuv/planar_functions.h"
@@ -45,6 +46,23 @@ int I420ToARGB(const uint8* src_y, int src_stride_y,
                uint8* dst_argb, int dst_stride_argb,
                int width, int height);
 
+// Convert I420 to ARGB and add the count of each Y value to histogram[256],
+// as PlaneHistogram would, in the same pass. histogram may be NULL.
+LIBYUV_API
+int I420ToARGBHistogram(const uint8* src_y, int src_stride_y,
+                        const uint8* src_u, int src_stride_u,
+                        const uint8* src_v, int src_stride_v,
+                        uint8* dst_argb, int dst_stride_argb,
+                        int width, int height, uint32* histogram);
+
+// Convert count I420 frames to ARGB frames of the same size, with the row
+// functions picked once for the batch. Frames are split into bands run on up
+// to num_threads threads. Frames with the layout AllocFrame gives them may
+// have the padding at the end of their rows written.
+LIBYUV_API
+int I420ToARGBBatch(const YuvFrame* src_frames, YuvFrame* dst_frames,
+                    int count, int num_threads);
+
 // Convert I422 to ARGB.
 LIBYUV_API
 int I422ToARGB(const uint8* src_y, int src_stride_y,
@@ -88,6 +106,14 @@ int NV12ToARGB(const uint8* src_y, int src_stride_y,
                uint8* dst_argb, int dst_stride_argb,
                int width, int height);
 
+// Convert NV12 to ARGB and add the count of each Y value to histogram[256].
+// histogram may be NULL.
+LIBYUV_API
+int NV12ToARGBHistogram(const uint8* src_y, int src_stride_y,
+                        const uint8* src_uv, int src_stride_uv,
+                        uint8* dst_argb, int dst_stride_argb,
+                        int width, int height, uint32* histogram);
+
 // Convert NV21 to ARGB.
 LIBYUV_API
 int NV21ToARGB(const uint8* src_y, int src_stride_y,
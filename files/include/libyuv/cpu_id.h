@@ -43,21 +43,48 @@ int InitCpuFlags(void);
 LIBYUV_API
 int ArmCpuCaps(const char* cpuinfo_name);
 
+// Mask for the calling thread, applied on top of MaskCpuFlags.
+LIBYUV_API
+int GetThreadCpuMask(void);
+
+// Reads the flags that another thread may be storing. An aligned int load
+// does not tear; the atomic builtin also tells thread sanitizer so.
+#if defined(__ATOMIC_ACQUIRE)
+#define LIBYUV_LOAD_CPU_INFO(p) __atomic_load_n(p, __ATOMIC_ACQUIRE)
+#else
+#define LIBYUV_LOAD_CPU_INFO(p) (*(volatile int*)(p))
+#endif
+
 // Detect CPU has SSE2 etc.
 // Test_flag parameter should be one of kCpuHas constants above.
 // returns non-zero if instruction set is detected
 static __inline int TestCpuFlag(int test_flag) {
   LIBYUV_API extern int cpu_info_;
-  return (cpu_info_ ? cpu_info_ : InitCpuFlags()) & test_flag;
+  LIBYUV_API extern int cpu_thread_masks_;
+  int cpu_info = LIBYUV_LOAD_CPU_INFO(&cpu_info_);
+  if (!cpu_info) {
+    cpu_info = InitCpuFlags();
+  }
+  if (LIBYUV_LOAD_CPU_INFO(&cpu_thread_masks_)) {
+    cpu_info &= GetThreadCpuMask();
+  }
+  return cpu_info & test_flag;
 }
 
 // For testing, allow CPU flags to be disabled.
 // ie MaskCpuFlags(~kCpuHasSSSE3) to disable SSSE3.
 // MaskCpuFlags(-1) to enable all cpu specific optimizations.
 // MaskCpuFlags(0) to disable all cpu specific optimizations.
+// This applies to all threads, so call it before starting others.
 LIBYUV_API
 void MaskCpuFlags(int enable_flags);
 
+// Like MaskCpuFlags but for the calling thread only, so threads can run
+// different row functions at the same time without locks. The thread mask is
+// applied on top of MaskCpuFlags. SetThreadCpuMask(-1) removes it.
+LIBYUV_API
+void SetThreadCpuMask(int enable_flags);
+
 // Low level cpuid for X86. Returns zeros on other CPUs.
 LIBYUV_API
 void CpuId(int cpu_info[4], int info_type);
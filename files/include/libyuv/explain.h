@@ -0,0 +1,88 @@
+/*
+ *  Copyright 2012 The LibYuv Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef INCLUDE_LIBYUV_EXPLAIN_H_  // NOLINT
+#define INCLUDE_LIBYUV_EXPLAIN_H_
+
+#include "libyuv/basic_types.h"
+#include "libyuv/scale.h"  // For FilterMode
+
+#ifdef __cplusplus
+namespace libyuv {
+extern "C" {
+#endif
+
+// The Explain functions take the same arguments as the function they are
+// named after and report, without touching any pixels, which path and row
+// kernel that call would use with the current cpu flags and why. Pointers
+// are only checked for alignment, so they may point at buffers that are not
+// allocated yet. They return 0, or -1 where the call itself would fail.
+
+// The choice for one plane or row function.
+// path is the function that handles the whole plane, kernel the row
+// function it runs and reason a short explanation of why the kernel was
+// picked, or why a faster one was not. simd is 1 if kernel uses SIMD, even
+// if only for part of the row.
+struct KernelChoice {
+  const char* path;
+  const char* kernel;
+  const char* reason;
+  int simd;
+};
+
+// Path and row kernel of ScalePlane.
+LIBYUV_API
+int ExplainScalePlane(const uint8* src, int src_stride,
+                      int src_width, int src_height,
+                      const uint8* dst, int dst_stride,
+                      int dst_width, int dst_height,
+                      FilterMode filtering, KernelChoice* choice);
+
+// Choices for the Y, U and V planes of I420Scale, in that order.
+LIBYUV_API
+int ExplainI420Scale(const uint8* src_y, int src_stride_y,
+                     const uint8* src_u, int src_stride_u,
+                     const uint8* src_v, int src_stride_v,
+                     int src_width, int src_height,
+                     const uint8* dst_y, int dst_stride_y,
+                     const uint8* dst_u, int dst_stride_u,
+                     const uint8* dst_v, int dst_stride_v,
+                     int dst_width, int dst_height,
+                     FilterMode filtering, KernelChoice choices[3]);
+
+// Row kernel of I420ToARGB and I420ToARGBHistogram.
+LIBYUV_API
+int ExplainI420ToARGB(const uint8* src_y, int src_stride_y,
+                      const uint8* src_u, int src_stride_u,
+                      const uint8* src_v, int src_stride_v,
+                      const uint8* dst_argb, int dst_stride_argb,
+                      int width, int height, KernelChoice* choice);
+
+// Row kernel of NV12ToARGB and NV12ToARGBHistogram.
+LIBYUV_API
+int ExplainNV12ToARGB(const uint8* src_y, int src_stride_y,
+                      const uint8* src_uv, int src_stride_uv,
+                      const uint8* dst_argb, int dst_stride_argb,
+                      int width, int height, KernelChoice* choice);
+
+// Choices for the Y row and the UV row of ARGBToI420, in that order.
+LIBYUV_API
+int ExplainARGBToI420(const uint8* src_argb, int src_stride_argb,
+                      const uint8* dst_y, int dst_stride_y,
+                      const uint8* dst_u, int dst_stride_u,
+                      const uint8* dst_v, int dst_stride_v,
+                      int width, int height, KernelChoice choices[2]);
+
+#ifdef __cplusplus
+}  // extern "C"
+}  // namespace libyuv
+#endif
+
+#endif  // INCLUDE_LIBYUV_EXPLAIN_H_  NOLINT
@@ -0,0 +1,97 @@
+/*
+ *  Copyright 2012 The LibYuv Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef INCLUDE_LIBYUV_FRAME_H_  // NOLINT
+#define INCLUDE_LIBYUV_FRAME_H_
+
+#include <stddef.h>  // For size_t
+
+#include "libyuv/basic_types.h"
+
+#ifdef __cplusplus
+namespace libyuv {
+extern "C" {
+#endif
+
+// A frame and the buffer that holds it.
+// Frames allocated here start each plane on a kFrameAlignment byte boundary
+// and round strides up to a multiple of it, so the aligned row functions
+// are used. There are at least kFramePadding bytes after the end of each
+// plane, so SIMD rows may read past the last pixel.
+
+static const int kFrameAlignment = 64;
+static const int kFramePadding = 64;
+
+// fourcc is FOURCC_I420, FOURCC_NV12 or FOURCC_ARGB.
+// The planes are Y, U and V for I420, Y and UV for NV12 and ARGB alone for
+// ARGB. Unused planes are NULL with a stride of 0.
+// buffer is the allocation that holds the planes, or NULL for a frame that
+// wraps memory libyuv does not own.
+struct YuvFrame {
+  uint32 fourcc;
+  int width;
+  int height;
+  uint8* plane[3];
+  int stride[3];
+  uint8* buffer;
+  size_t size;
+};
+
+// Returns the bytes AllocFrame needs for a frame, or 0 if the format or
+// size is not supported.
+LIBYUV_API
+size_t FrameBufferSize(uint32 fourcc, int width, int height);
+
+// Fills frame with planes laid out in buffer, which must be
+// kFrameAlignment byte aligned and FrameBufferSize bytes.
+LIBYUV_API
+int InitFrame(YuvFrame* frame, uint32 fourcc, int width, int height,
+              uint8* buffer);
+
+// Allocates an aligned frame. The pixels are not initialized.
+LIBYUV_API
+int AllocFrame(YuvFrame* frame, uint32 fourcc, int width, int height);
+
+// Frees a frame from AllocFrame or AcquireFrame and clears it.
+LIBYUV_API
+int FreeFrame(YuvFrame* frame);
+
+// A pool keeps released frames by format and size and hands them out
+// again, so a steady stream of frames does not allocate. A pool is not
+// thread safe; use one per thread.
+struct FramePool;
+
+// Creates a pool that keeps up to max_frames free frames of each format
+// and size, or all of them if max_frames is 0.
+LIBYUV_API
+FramePool* CreateFramePool(int max_frames);
+
+// Frees the frames in the pool and the pool. Frames still acquired can be
+// released to another pool or freed with FreeFrame.
+LIBYUV_API
+void DestroyFramePool(FramePool* pool);
+
+// Takes a free frame of the format and size from the pool, or allocates one
+// if there is none.
+LIBYUV_API
+int AcquireFrame(FramePool* pool, YuvFrame* frame,
+                 uint32 fourcc, int width, int height);
+
+// Returns a frame to the pool and clears it. The format, size and buffer
+// of frame must be as AcquireFrame or AllocFrame left them.
+LIBYUV_API
+int ReleaseFrame(FramePool* pool, YuvFrame* frame);
+
+#ifdef __cplusplus
+}  // extern "C"
+}  // namespace libyuv
+#endif
+
+#endif  // INCLUDE_LIBYUV_FRAME_H_  NOLINT
@@ -0,0 +1,59 @@
+/*
+ *  Copyright 2012 The LibYuv Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef INCLUDE_LIBYUV_INSTRUMENT_H_  // NOLINT
+#define INCLUDE_LIBYUV_INSTRUMENT_H_
+
+#include "libyuv/basic_types.h"
+
+#ifdef __cplusplus
+namespace libyuv {
+extern "C" {
+#endif
+
+// Call counts and timings of libyuv functions, kept when libyuv is built
+// with LIBYUV_INSTRUMENT defined. Without it the functions below return -1
+// and the library has no instrumentation cost.
+
+// Totals for one function and the kernel or path it chose.
+// pixels counts destination pixels. cycles is the time stamp counter
+// where there is one, otherwise nanoseconds.
+struct InstrumentStats {
+  const char* function;
+  const char* kernel;
+  uint64 calls;
+  uint64 pixels;
+  uint64 cycles;
+};
+
+// Copies up to max_stats totals to stats and returns how many there are,
+// which may be more than max_stats.
+LIBYUV_API
+int GetInstrumentStats(InstrumentStats* stats, int max_stats);
+
+// Clears the totals.
+LIBYUV_API
+int ResetInstrumentStats(void);
+
+// Called on the thread of each instrumented call as it returns.
+typedef void (*InstrumentCallback)(void* opaque,
+                                   const char* function, const char* kernel,
+                                   int width, int height, uint64 cycles);
+
+// Sets the callback, or removes it when callback is NULL.
+LIBYUV_API
+int SetInstrumentCallback(InstrumentCallback callback, void* opaque);
+
+#ifdef __cplusplus
+}  // extern "C"
+}  // namespace libyuv
+#endif
+
+#endif  // INCLUDE_LIBYUV_INSTRUMENT_H_  NOLINT
@@ -32,7 +32,31 @@ enum JpegSubsamplingType {
   kJpegUnknown
 };
 
+// Frame parameters found by ParseJpegHeader().
+struct JpegHeader {
+  int width;
+  int height;
+  int num_components;
+  // Sample factors of each component, as in the SOF marker.
+  int horiz_samp_factor[4];
+  int vert_samp_factor[4];
+  // Number of MCUs between restart markers, or 0 if there is no DRI marker.
+  int restart_interval;
+  // Number of components in the first scan.
+  int comps_in_scan;
+  bool progressive;
+  bool arithmetic;
+  JpegSubsamplingType subsampling;
+};
+
+// Parses the markers of a jpeg up to the first SOS without decoding it or
+// allocating memory. Fills in header and returns true if a frame header with
+// up to 4 components and a scan were found within src_len bytes.
+// Available without HAVE_JPEG for routing frames before decoding them.
+bool ParseJpegHeader(const uint8* src, size_t src_len, JpegHeader* header);
+
 struct SetJmpErrorMgr;
+struct RestartGroupDecoder;
 
 // MJPEG ("Motion JPEG") is a pseudo-standard video codec where the frames are
 // simply independent JPEG images with a fixed huffman table (which is omitted).
@@ -105,6 +129,18 @@ class MJpegDecoder {
   // Size of a component in bytes.
   int GetComponentSize(int component);
 
+  // Number of MCUs between restart markers, or 0 if the frame has none.
+  int GetRestartInterval();
+
+  // Number of row groups in the last loaded frame that can be decoded
+  // independently. Each group begins at a restart marker that falls on an
+  // iMCU row boundary. Returns 1 if the frame can not be split.
+  int GetNumRestartGroups();
+
+  // Maximum number of threads DecodeToBuffers() may use to decode restart
+  // groups in parallel. Default is 1, which decodes sequentially.
+  void SetNumThreads(int num_threads);
+
   // Call this after LoadFrame() if you decide you don't want to decode it
   // after all.
   bool UnloadFrame();
@@ -115,6 +151,8 @@ class MJpegDecoder {
   // GetNumComponents() and they must point to non-overlapping buffers of size
   // at least GetComponentSize(i). The pointers in planes are incremented
   // to point to after the end of the written data.
+  // If the frame has restart markers on iMCU row boundaries, is not cropped
+  // and SetNumThreads() allows it, row groups are decoded on multiple threads.
   // TODO(fbarchard): Add dst_x, dst_y to allow specific rect to be decoded.
   bool DecodeToBuffers(uint8** planes, int dst_width, int dst_height);
 
@@ -130,6 +168,8 @@ class MJpegDecoder {
      int* subsample_x, int* subsample_y, int number_of_components);
 
  private:
+  friend struct RestartGroupDecoder;
+
   struct Buffer {
     const uint8* data;
     int len;
@@ -161,6 +201,10 @@ class MJpegDecoder {
 
   int GetComponentScanlinePadding(int component);
 
+  // Restart marker scan of the entropy coded data following the SOS header.
+  void FindRestartMarkers();
+  bool DecodeRestartGroups(uint8** planes, int num_threads);
+
   // A buffer holding the input data for a frame.
   Buffer buf_;
   BufferVector buf_vec_;
@@ -181,6 +225,18 @@ class MJpegDecoder {
   // output buffers. Large enough for just one iMCU row.
   uint8** databuf_;
   int* databuf_strides_;
+
+  // Offset of the entropy coded data and of each RSTn marker in buf_.
+  int scan_offset_;
+  int* restart_offsets_;
+  int num_restart_offsets_;
+  int restart_offsets_size_;
+  // Segment index starting each independently decodable row group.
+  int* restart_groups_;
+  int num_restart_groups_;
+  int num_threads_;
+  RestartGroupDecoder* group_decoders_;
+  int num_group_decoders_;
 };
 
 }  // namespace libyuv
@@ -16,6 +16,7 @@
 // TODO(fbarchard): Remove the following headers includes.
 #include "libyuv/convert.h"
 #include "libyuv/convert_argb.h"
+#include "libyuv/scale.h"  // For FilterMode
 
 #ifdef __cplusplus
 namespace libyuv {
@@ -69,6 +70,14 @@ int I420Mirror(const uint8* src_y, int src_stride_y,
                uint8* dst_v, int dst_stride_v,
                int width, int height);
 
+// NV12 mirror. Also works for NV21.
+LIBYUV_API
+int NV12Mirror(const uint8* src_y, int src_stride_y,
+               const uint8* src_uv, int src_stride_uv,
+               uint8* dst_y, int dst_stride_y,
+               uint8* dst_uv, int dst_stride_uv,
+               int width, int height);
+
 // ARGB mirror.
 LIBYUV_API
 int ARGBMirror(const uint8* src_argb, int src_stride_argb,
@@ -244,6 +253,89 @@ int ARGBBlend(const uint8* src_argb0, int src_stride_argb0,
               uint8* dst_argb, int dst_stride_argb,
               int width, int height);
 
+// A layer for ARGBComposite. src_argb is attenuated ARGB of width x height
+// pixels, placed at (x, y) in the destination and clipped to it.
+// alpha fades the whole layer, from 0 (hidden) to 255 (as is).
+struct ARGBLayer {
+  const uint8* src_argb;
+  int src_stride_argb;
+  int x;
+  int y;
+  int width;
+  int height;
+  int alpha;
+};
+
+// Alpha Blend layers, bottom first, over an ARGB image in place.
+// Each destination row is read and written once for all layers, runs of
+// fully transparent layer pixels are skipped and opaque runs are copied.
+// Same result as calling ARGBBlend for each layer in turn on an opaque image.
+LIBYUV_API
+int ARGBComposite(const ARGBLayer* layers, int num_layers,
+                  uint8* dst_argb, int dst_stride_argb,
+                  int width, int height);
+
+// Blend 2 planes with an alpha plane and store to destination:
+// dst = (src_y0 * alpha + src_y1 * (255 - alpha) + 255) >> 8.
+// alpha is not premultiplied. dst_y may be src_y1 to blend in place.
+LIBYUV_API
+int BlendPlane(const uint8* src_y0, int src_stride_y0,
+               const uint8* src_y1, int src_stride_y1,
+               const uint8* alpha, int alpha_stride,
+               uint8* dst_y, int dst_stride_y,
+               int width, int height);
+
+// Blend an I420 overlay of src_width x src_height with a full resolution
+// alpha plane onto a dst_width x dst_height I420 frame in place, as
+// BlendPlane does. The overlay is placed at (x, y), which must be even so
+// chroma lines up, and clipped to the frame. Only the overlay rectangle of
+// the frame is touched. Chroma is blended with the 2x2 average of alpha.
+LIBYUV_API
+int I420Blend(const uint8* src_y, int src_stride_y,
+              const uint8* src_u, int src_stride_u,
+              const uint8* src_v, int src_stride_v,
+              const uint8* src_a, int src_stride_a,
+              int src_width, int src_height,
+              uint8* dst_y, int dst_stride_y,
+              uint8* dst_u, int dst_stride_u,
+              uint8* dst_v, int dst_stride_v,
+              int dst_width, int dst_height,
+              int x, int y);
+
+// Same as I420Blend onto an NV12 frame.
+LIBYUV_API
+int NV12Blend(const uint8* src_y, int src_stride_y,
+              const uint8* src_u, int src_stride_u,
+              const uint8* src_v, int src_stride_v,
+              const uint8* src_a, int src_stride_a,
+              int src_width, int src_height,
+              uint8* dst_y, int dst_stride_y,
+              uint8* dst_uv, int dst_stride_uv,
+              int dst_width, int dst_height,
+              int x, int y);
+
+// Blend an attenuated ARGB overlay, as taken by ARGBBlend, onto an I420
+// frame in place without converting the frame. Placement and clipping are
+// the same as I420Blend. The overlay is converted to YUV a row pair at a
+// time, so the cost is proportional to the overlay, not the frame.
+LIBYUV_API
+int I420BlendARGB(const uint8* src_argb, int src_stride_argb,
+                  int src_width, int src_height,
+                  uint8* dst_y, int dst_stride_y,
+                  uint8* dst_u, int dst_stride_u,
+                  uint8* dst_v, int dst_stride_v,
+                  int dst_width, int dst_height,
+                  int x, int y);
+
+// Same as I420BlendARGB onto an NV12 frame.
+LIBYUV_API
+int NV12BlendARGB(const uint8* src_argb, int src_stride_argb,
+                  int src_width, int src_height,
+                  uint8* dst_y, int dst_stride_y,
+                  uint8* dst_uv, int dst_stride_uv,
+                  int dst_width, int dst_height,
+                  int x, int y);
+
 // Convert I422 to YUY2.
 LIBYUV_API
 int I422ToYUY2(const uint8* src_y, int src_stride_y,
@@ -294,12 +386,119 @@ int ARGBBlur(const uint8* src_argb, int src_stride_argb,
              int32* dst_cumsum, int dst_stride32_cumsum,
              int width, int height, int radius);
 
+// Blur ARGB image with the same result as ARGBBlur's C code, without the
+// cumulative sum table. Each thread needs 24 bytes of scratch per pixel of
+// one row, plus radius * 2 + 1 rows when blurring in place, which all passes
+// after the first do. iterations passes approximate a Gaussian. radius is
+// 1 to 127, and width and height are at least 2. Unlike ARGBBlur, width may
+// be less than radius * 2 + 1.
+LIBYUV_API
+int ARGBBoxBlur(const uint8* src_argb, int src_stride_argb,
+                uint8* dst_argb, int dst_stride_argb,
+                int width, int height, int radius, int iterations,
+                int num_threads);
+
+// Blur a plane with a box filter of radius * 2 + 1 pixels square, applied
+// iterations times. 3 iterations approximate a Gaussian with sigma of about
+// radius. As with ARGBBlur, pixels outside the image are left out of the
+// average. radius is 0 to 127. src and dst may be the same plane.
+LIBYUV_API
+int PlaneBlur(const uint8* src_y, int src_stride_y,
+              uint8* dst_y, int dst_stride_y,
+              int width, int height, int radius, int iterations);
+
+// Blur an I420 image. The chroma planes use half the radius.
+LIBYUV_API
+int I420Blur(const uint8* src_y, int src_stride_y,
+             const uint8* src_u, int src_stride_u,
+             const uint8* src_v, int src_stride_v,
+             uint8* dst_y, int dst_stride_y,
+             uint8* dst_u, int dst_stride_u,
+             uint8* dst_v, int dst_stride_v,
+             int width, int height, int radius, int iterations);
+
+// Sharpen a plane with an unsharp mask: where a pixel differs from the
+// 3 iteration PlaneBlur by more than threshold, add amount / 256 of the
+// difference. amount is 0 to 32767, threshold 0 to 255.
+LIBYUV_API
+int PlaneUnsharpMask(const uint8* src_y, int src_stride_y,
+                     uint8* dst_y, int dst_stride_y,
+                     int width, int height,
+                     int radius, int amount, int threshold);
+
+// Sharpen the Y plane of an I420 image and copy U and V.
+LIBYUV_API
+int I420UnsharpMask(const uint8* src_y, int src_stride_y,
+                    const uint8* src_u, int src_stride_u,
+                    const uint8* src_v, int src_stride_v,
+                    uint8* dst_y, int dst_stride_y,
+                    uint8* dst_u, int dst_stride_u,
+                    uint8* dst_v, int dst_stride_v,
+                    int width, int height,
+                    int radius, int amount, int threshold);
+
 // Multiply ARGB image by ARGB value.
 LIBYUV_API
 int ARGBShade(const uint8* src_argb, int src_stride_argb,
               uint8* dst_argb, int dst_stride_argb,
               int width, int height, uint32 value);
 
+// Maximum number of effects in an ARGBEffectChain after folding.
+static const int kMaxARGBEffects = 16;
+
+// An effect of an ARGBEffectChain. Linear effects use matrix_argb as
+// ARGBColorMatrix does, per channel effects use table_argb as ARGBColorTable.
+struct ARGBEffect {
+  int type;
+  int8 matrix_argb[12];
+  uint8 table_argb[256 * 4];
+};
+
+// A chain of in place ARGB effects, run together on a few hundred pixels of
+// a row at a time so each pixel is loaded once for the whole chain.
+// Adjacent per channel effects (color table, quantize, shade) are folded into
+// one color table, with the same result as running them in turn.
+// Adjacent linear effects (gray, sepia, color matrix) are folded into one
+// color matrix when the first cannot clamp and the product fits in 8 bits.
+// That rounds once instead of per effect, so it may differ by a few levels.
+struct ARGBEffectChain {
+  int num_effects;
+  ARGBEffect effects[kMaxARGBEffects];
+};
+
+// Empty a chain. The Add functions append an effect with the same parameters
+// as the single effect function and return -1 if the chain is full.
+LIBYUV_API
+int ARGBEffectChainInit(ARGBEffectChain* chain);
+
+LIBYUV_API
+int ARGBEffectChainAddGray(ARGBEffectChain* chain);
+
+LIBYUV_API
+int ARGBEffectChainAddSepia(ARGBEffectChain* chain);
+
+LIBYUV_API
+int ARGBEffectChainAddColorMatrix(ARGBEffectChain* chain,
+                                  const int8* matrix_argb);
+
+LIBYUV_API
+int ARGBEffectChainAddColorTable(ARGBEffectChain* chain,
+                                 const uint8* table_argb);
+
+LIBYUV_API
+int ARGBEffectChainAddQuantize(ARGBEffectChain* chain,
+                               int scale, int interval_size,
+                               int interval_offset);
+
+LIBYUV_API
+int ARGBEffectChainAddShade(ARGBEffectChain* chain, uint32 value);
+
+// Apply the effects of a chain, first added first, to a rectangle of ARGB.
+LIBYUV_API
+int ARGBEffectChainApply(const ARGBEffectChain* chain,
+                         uint8* dst_argb, int dst_stride_argb,
+                         int x, int y, int width, int height);
+
 // Interpolate between two ARGB images using specified amount of interpolation
 // (0 to 255) and store to destination.
 // 'interpolation' is specified as 8 bit fraction where 0 means 100% src_argb0
@@ -312,6 +511,70 @@ int ARGBInterpolate(const uint8* src_argb0, int src_stride_argb0,
                     uint8* dst_argb, int dst_stride_argb,
                     int width, int height, int interpolation);
 
+// Border handling for ARGBAffine and I420Affine.
+enum AffineBorder {
+  kAffineBorderClamp = 0,  // Repeat the edge pixels.
+  kAffineBorderConstant = 1  // Fill with a constant value.
+};
+
+// Warp an ARGB image with a 2x3 matrix.
+// Each destination pixel (x, y) samples the source at
+//   u = matrix[0] * x + matrix[1] * y + matrix[2]
+//   v = matrix[3] * x + matrix[4] * y + matrix[5]
+// with pixel centers at integer positions. kFilterNone point samples, other
+// filter modes are bilinear. Samples outside the source use the border mode,
+// with value as the ARGB constant.
+// Rows are split into bands run on up to num_threads threads.
+LIBYUV_API
+int ARGBAffine(const uint8* src_argb, int src_stride_argb,
+               int src_width, int src_height,
+               uint8* dst_argb, int dst_stride_argb,
+               int dst_width, int dst_height,
+               const float* matrix, FilterMode filtering,
+               AffineBorder border, uint32 value, int num_threads);
+
+// Warp an I420 image with a 2x3 matrix, which is applied in luma pixels.
+// value_y, value_u and value_v are the constant border.
+LIBYUV_API
+int I420Affine(const uint8* src_y, int src_stride_y,
+               const uint8* src_u, int src_stride_u,
+               const uint8* src_v, int src_stride_v,
+               int src_width, int src_height,
+               uint8* dst_y, int dst_stride_y,
+               uint8* dst_u, int dst_stride_u,
+               uint8* dst_v, int dst_stride_v,
+               int dst_width, int dst_height,
+               const float* matrix, FilterMode filtering,
+               AffineBorder border, int value_y, int value_u, int value_v,
+               int num_threads);
+
+// Apply a 3D color lookup table to ARGB with tetrahedral interpolation.
+// lut_argb is lut_size^3 ARGB entries, 4 bytes each, with red changing
+// fastest, then green, then blue, as in .cube files. Each grid point is one
+// 32 bit load and its red neighbour is the next one. The alpha of the
+// entries is ignored and alpha is copied from the source.
+// lut_size is 2 to 65. src and dst may be the same image.
+// Rows are split into bands run on up to num_threads threads.
+LIBYUV_API
+int ARGBApply3DLut(const uint8* src_argb, int src_stride_argb,
+                   uint8* dst_argb, int dst_stride_argb,
+                   const uint8* lut_argb, int lut_size,
+                   int width, int height, int num_threads);
+
+// Apply a 3D color lookup table as ARGBApply3DLut does to an I420 image.
+// Each pair of rows is converted to ARGB in a row buffer, looked up and
+// converted back, so the grading is in RGB without an ARGB frame.
+// src and dst may be the same image.
+LIBYUV_API
+int I420Apply3DLut(const uint8* src_y, int src_stride_y,
+                   const uint8* src_u, int src_stride_u,
+                   const uint8* src_v, int src_stride_v,
+                   uint8* dst_y, int dst_stride_y,
+                   uint8* dst_u, int dst_stride_u,
+                   uint8* dst_v, int dst_stride_v,
+                   const uint8* lut_argb, int lut_size,
+                   int width, int height, int num_threads);
+
 #if defined(__CLR_VER) || defined(COVERAGE_ENABLED) || \
     defined(TARGET_IPHONE_SIMULATOR)
 #define YUV_DISABLE_ASM
@@ -46,6 +46,7 @@ extern "C" {
 #define HAS_ARGBTORGB24ROW_SSSE3
 #define HAS_ARGBTORGB565ROW_SSE2
 #define HAS_ARGBTORGBAROW_SSSE3
+#define HAS_ARGBTOUVINTERLEAVEROW_SSSE3
 #define HAS_ARGBTOUVROW_SSSE3
 #define HAS_ARGBTOYROW_SSSE3
 #define HAS_BGRATOARGBROW_SSSE3
@@ -58,7 +59,9 @@ extern "C" {
 #define HAS_I422TOABGRROW_SSSE3
 #define HAS_I422TOARGBROW_SSSE3
 #define HAS_I422TOBGRAROW_SSSE3
+#define HAS_I422TORGB565ROW_SSSE3
 #define HAS_I444TOARGBROW_SSSE3
+#define HAS_MERGEUV_SSE2
 #define HAS_MIRRORROW_SSSE3
 #define HAS_MIRRORROWUV_SSSE3
 #define HAS_NV12TOARGBROW_SSSE3
@@ -68,6 +71,7 @@ extern "C" {
 #define HAS_RGB565TOARGBROW_SSE2
 #define HAS_SETROW_X86
 #define HAS_SPLITUV_SSE2
+#define HAS_UVMIRRORROW_SSSE3
 #define HAS_UYVYTOUV422ROW_SSE2
 #define HAS_UYVYTOUVROW_SSE2
 #define HAS_UYVYTOYROW_SSE2
@@ -80,6 +84,7 @@ extern "C" {
 #define HAS_ARGBAFFINEROW_SSE2
 #define HAS_ARGBATTENUATEROW_SSSE3
 #define HAS_ARGBBLENDROW_SSSE3
+#define HAS_ARGBBLURCUMULATIVESUMROW_SSE2
 #define HAS_ARGBCOLORMATRIXROW_SSSE3
 #define HAS_ARGBGRAYROW_SSSE3
 #define HAS_ARGBINTERPOLATEROW_SSSE3
@@ -88,8 +93,33 @@ extern "C" {
 #define HAS_ARGBSEPIAROW_SSSE3
 #define HAS_ARGBSHADE_SSE2
 #define HAS_ARGBUNATTENUATEROW_SSE2
+#define HAS_BLENDPLANEROW_SSSE3
+#define HAS_BLURCOLUMNROW_SSE2
+#define HAS_BLURCUMULATIVESUMROW_SSE2
+#define HAS_BLURCUMULATIVESUMTOAVERAGEROW_SSE2
 #define HAS_COMPUTECUMULATIVESUMROW_SSE2
 #define HAS_CUMULATIVESUMTOAVERAGE_SSE2
+#define HAS_UNSHARPMASKROW_SSE2
+#endif
+
+// The following are available on 64 bit GCC x86 platforms:
+#if !defined(YUV_DISABLE_ASM) && defined(__x86_64__)
+#define HAS_ARGBAFFINEROWBILINEAR_SSE2
+#endif
+
+// The following need an assembler that knows AVX2 (GCC 4.7 or clang):
+#if !defined(YUV_DISABLE_ASM) && defined(__x86_64__) && \
+    (defined(__clang__) || (defined(__GNUC__) && \
+    (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7))))
+#define HAS_ARGBAPPLY3DLUTROW_AVX2
+#define HAS_ARGBBLENDROW_AVX2
+#endif
+
+// The following are in row_avx2.cc, which is written with intrinsics and
+// compiled with -mavx2. Builds that compile it so define LIBYUV_AVX2.
+#if !defined(YUV_DISABLE_ASM) && defined(LIBYUV_AVX2) && \
+    (defined(_M_X64) || defined(__x86_64__) || defined(__i386__))
+#define HAS_ARGBTOYROW_AVX2
 #endif
 
 // The following are Windows only:
@@ -113,17 +143,24 @@ extern "C" {
 
 // The following are available on Neon platforms
 #if !defined(YUV_DISABLE_ASM) && (defined(__ARM_NEON__) || defined(LIBYUV_NEON))
+#define HAS_ARGBBLURCUMULATIVESUMROW_NEON
+#define HAS_BLENDPLANEROW_NEON
+#define HAS_BLURCOLUMNROW_NEON
+#define HAS_BLURCUMULATIVESUMTOAVERAGEROW_NEON
 #define HAS_COPYROW_NEON
 #define HAS_I422TOABGRROW_NEON
 #define HAS_I422TOARGBROW_NEON
 #define HAS_I422TOBGRAROW_NEON
 #define HAS_I422TORAWROW_NEON
 #define HAS_I422TORGB24ROW_NEON
+#define HAS_I422TORGB565ROW_NEON
 #define HAS_I422TORGBAROW_NEON
+#define HAS_MERGEUV_NEON
 #define HAS_MIRRORROW_NEON
 #define HAS_MIRRORROWUV_NEON
 #define HAS_SETROW_NEON
 #define HAS_SPLITUV_NEON
+#define HAS_UVMIRRORROW_NEON
 #define HAS_UYVYTOUV422ROW_NEON
 #define HAS_UYVYTOUVROW_NEON
 #define HAS_UYVYTOYROW_NEON
@@ -214,8 +251,38 @@ void NV21ToARGBRow_NEON(const uint8* y_buf,
                         const uint8* uv_buf,
                         uint8* rgb_buf,
                         int width);
+void I422ToRGB565Row_NEON(const uint8* y_buf,
+                          const uint8* u_buf,
+                          const uint8* v_buf,
+                          uint8* rgb_buf,
+                          int width);
+void I422ToARGB1555Row_NEON(const uint8* y_buf,
+                            const uint8* u_buf,
+                            const uint8* v_buf,
+                            uint8* rgb_buf,
+                            int width);
+void I422ToARGB4444Row_NEON(const uint8* y_buf,
+                            const uint8* u_buf,
+                            const uint8* v_buf,
+                            uint8* rgb_buf,
+                            int width);
+void I422ToRGB565DitherRow_NEON(const uint8* y_buf,
+                                const uint8* u_buf,
+                                const uint8* v_buf,
+                                uint8* rgb_buf,
+                                uint32 dither4,
+                                int width);
+void NV12ToRGB565Row_NEON(const uint8* y_buf,
+                          const uint8* uv_buf,
+                          uint8* rgb_buf,
+                          int width);
+void NV21ToRGB565Row_NEON(const uint8* y_buf,
+                          const uint8* vu_buf,
+                          uint8* rgb_buf,
+                          int width);
 
 void ARGBToYRow_SSSE3(const uint8* src_argb, uint8* dst_y, int pix);
+void ARGBToYRow_AVX2(const uint8* src_argb, uint8* dst_y, int pix);
 void BGRAToYRow_SSSE3(const uint8* src_argb, uint8* dst_y, int pix);
 void ABGRToYRow_SSSE3(const uint8* src_argb, uint8* dst_y, int pix);
 void RGBAToYRow_SSSE3(const uint8* src_argb, uint8* dst_y, int pix);
@@ -241,6 +308,17 @@ void ABGRToUVRow_Unaligned_SSSE3(const uint8* src_argb0, int src_stride_argb,
 void RGBAToUVRow_Unaligned_SSSE3(const uint8* src_argb0, int src_stride_argb,
                                  uint8* dst_u, uint8* dst_v, int width);
 
+void ARGBToUVInterleaveRow_SSSE3(const uint8* src_argb0, int src_stride_argb,
+                                 uint8* dst_uv, int width);
+void ARGBToUVInterleaveRow_Unaligned_SSSE3(const uint8* src_argb0,
+                                           int src_stride_argb,
+                                           uint8* dst_uv, int width);
+void ARGBToUVInterleaveRow_Any_SSSE3(const uint8* src_argb0,
+                                     int src_stride_argb,
+                                     uint8* dst_uv, int width);
+void ARGBToUVInterleaveRow_C(const uint8* src_argb0, int src_stride_argb,
+                             uint8* dst_uv, int width);
+
 void MirrorRow_SSSE3(const uint8* src, uint8* dst, int width);
 void MirrorRow_SSE2(const uint8* src, uint8* dst, int width);
 void MirrorRow_NEON(const uint8* src, uint8* dst, int width);
@@ -253,10 +331,28 @@ void MirrorRowUV_C(const uint8* src, uint8* dst_u, uint8* dst_v, int width);
 void ARGBMirrorRow_SSSE3(const uint8* src, uint8* dst, int width);
 void ARGBMirrorRow_C(const uint8* src, uint8* dst, int width);
 
+// Mirrors interleaved UV, keeping U before V in each pair.
+void UVMirrorRow_SSSE3(const uint8* src_uv, uint8* dst_uv, int width);
+void UVMirrorRow_NEON(const uint8* src_uv, uint8* dst_uv, int width);
+void UVMirrorRow_C(const uint8* src_uv, uint8* dst_uv, int width);
+
 void SplitUV_SSE2(const uint8* src_uv, uint8* dst_u, uint8* dst_v, int pix);
 void SplitUV_NEON(const uint8* src_uv, uint8* dst_u, uint8* dst_v, int pix);
 void SplitUV_C(const uint8* src_uv, uint8* dst_u, uint8* dst_v, int pix);
 
+void MergeUV_SSE2(const uint8* src_u, const uint8* src_v, uint8* dst_uv,
+                  int width);
+void MergeUV_Unaligned_SSE2(const uint8* src_u, const uint8* src_v,
+                            uint8* dst_uv, int width);
+void MergeUV_NEON(const uint8* src_u, const uint8* src_v, uint8* dst_uv,
+                  int width);
+void MergeUV_C(const uint8* src_u, const uint8* src_v, uint8* dst_uv,
+               int width);
+void MergeUV_Any_SSE2(const uint8* src_u, const uint8* src_v, uint8* dst_uv,
+                      int width);
+void MergeUV_Any_NEON(const uint8* src_u, const uint8* src_v, uint8* dst_uv,
+                      int width);
+
 void CopyRow_SSE2(const uint8* src, uint8* dst, int count);
 void CopyRow_X86(const uint8* src, uint8* dst, int count);
 void CopyRow_NEON(const uint8* src, uint8* dst, int count);
@@ -385,6 +481,37 @@ void I422ToRAWRow_C(const uint8* y_buf,
                     const uint8* v_buf,
                     uint8* raw_buf,
                     int width);
+// Convert straight to 16 bit formats without an ARGB row in between.
+// dither4 holds 4 bytes added to B, G and R of pixels x & 3 before packing.
+void I422ToRGB565Row_C(const uint8* y_buf,
+                       const uint8* u_buf,
+                       const uint8* v_buf,
+                       uint8* rgb_buf,
+                       int width);
+void I422ToARGB1555Row_C(const uint8* y_buf,
+                         const uint8* u_buf,
+                         const uint8* v_buf,
+                         uint8* rgb_buf,
+                         int width);
+void I422ToARGB4444Row_C(const uint8* y_buf,
+                         const uint8* u_buf,
+                         const uint8* v_buf,
+                         uint8* rgb_buf,
+                         int width);
+void I422ToRGB565DitherRow_C(const uint8* y_buf,
+                             const uint8* u_buf,
+                             const uint8* v_buf,
+                             uint8* rgb_buf,
+                             uint32 dither4,
+                             int width);
+void NV12ToRGB565Row_C(const uint8* y_buf,
+                       const uint8* uv_buf,
+                       uint8* rgb_buf,
+                       int width);
+void NV21ToRGB565Row_C(const uint8* y_buf,
+                       const uint8* vu_buf,
+                       uint8* rgb_buf,
+                       int width);
 
 void YToARGBRow_C(const uint8* y_buf,
                   uint8* rgb_buf,
@@ -430,6 +557,36 @@ void I422ToABGRRow_SSSE3(const uint8* y_buf,
                          uint8* abgr_buf,
                          int width);
 
+void I422ToRGB565Row_SSSE3(const uint8* y_buf,
+                           const uint8* u_buf,
+                           const uint8* v_buf,
+                           uint8* rgb_buf,
+                           int width);
+void I422ToARGB1555Row_SSSE3(const uint8* y_buf,
+                             const uint8* u_buf,
+                             const uint8* v_buf,
+                             uint8* rgb_buf,
+                             int width);
+void I422ToARGB4444Row_SSSE3(const uint8* y_buf,
+                             const uint8* u_buf,
+                             const uint8* v_buf,
+                             uint8* rgb_buf,
+                             int width);
+void I422ToRGB565DitherRow_SSSE3(const uint8* y_buf,
+                                 const uint8* u_buf,
+                                 const uint8* v_buf,
+                                 uint8* rgb_buf,
+                                 uint32 dither4,
+                                 int width);
+void NV12ToRGB565Row_SSSE3(const uint8* y_buf,
+                           const uint8* uv_buf,
+                           uint8* rgb_buf,
+                           int width);
+void NV21ToRGB565Row_SSSE3(const uint8* y_buf,
+                           const uint8* vu_buf,
+                           uint8* rgb_buf,
+                           int width);
+
 void I422ToRGBARow_SSSE3(const uint8* y_buf,
                          const uint8* u_buf,
                          const uint8* v_buf,
@@ -522,6 +679,36 @@ void I422ToABGRRow_Any_SSSE3(const uint8* y_buf,
                              uint8* abgr_buf,
                              int width);
 
+void I422ToRGB565Row_Any_SSSE3(const uint8* y_buf,
+                               const uint8* u_buf,
+                               const uint8* v_buf,
+                               uint8* rgb_buf,
+                               int width);
+void I422ToARGB1555Row_Any_SSSE3(const uint8* y_buf,
+                                 const uint8* u_buf,
+                                 const uint8* v_buf,
+                                 uint8* rgb_buf,
+                                 int width);
+void I422ToARGB4444Row_Any_SSSE3(const uint8* y_buf,
+                                 const uint8* u_buf,
+                                 const uint8* v_buf,
+                                 uint8* rgb_buf,
+                                 int width);
+void I422ToRGB565DitherRow_Any_SSSE3(const uint8* y_buf,
+                                     const uint8* u_buf,
+                                     const uint8* v_buf,
+                                     uint8* rgb_buf,
+                                     uint32 dither4,
+                                     int width);
+void NV12ToRGB565Row_Any_SSSE3(const uint8* y_buf,
+                               const uint8* uv_buf,
+                               uint8* rgb_buf,
+                               int width);
+void NV21ToRGB565Row_Any_SSSE3(const uint8* y_buf,
+                               const uint8* vu_buf,
+                               uint8* rgb_buf,
+                               int width);
+
 void I422ToRGBARow_Any_SSSE3(const uint8* y_buf,
                              const uint8* u_buf,
                              const uint8* v_buf,
@@ -533,6 +720,8 @@ void YToARGBRow_SSE2(const uint8* y_buf,
                      int width);
 
 // ARGB preattenuated alpha blend.
+void ARGBBlendRow_AVX2(const uint8* src_argb0, const uint8* src_argb1,
+                       uint8* dst_argb, int width);
 void ARGBBlendRow_SSSE3(const uint8* src_argb0, const uint8* src_argb1,
                         uint8* dst_argb, int width);
 void ARGBBlendRow_SSE2(const uint8* src_argb0, const uint8* src_argb1,
@@ -540,6 +729,18 @@ void ARGBBlendRow_SSE2(const uint8* src_argb0, const uint8* src_argb1,
 void ARGBBlendRow_C(const uint8* src_argb0, const uint8* src_argb1,
                     uint8* dst_argb, int width);
 
+// Planar alpha blend of a single channel: dst = lerp(src1, src0, alpha).
+void BlendPlaneRow_SSSE3(const uint8* src0, const uint8* src1,
+                         const uint8* alpha, uint8* dst, int width);
+void BlendPlaneRow_NEON(const uint8* src0, const uint8* src1,
+                        const uint8* alpha, uint8* dst, int width);
+void BlendPlaneRow_C(const uint8* src0, const uint8* src1,
+                     const uint8* alpha, uint8* dst, int width);
+void BlendPlaneRow_Any_SSSE3(const uint8* src0, const uint8* src1,
+                             const uint8* alpha, uint8* dst, int width);
+void BlendPlaneRow_Any_NEON(const uint8* src0, const uint8* src1,
+                            const uint8* alpha, uint8* dst, int width);
+
 void ARGBToRGB24Row_Any_SSSE3(const uint8* src_argb, uint8* dst_rgb, int pix);
 void ARGBToRAWRow_Any_SSSE3(const uint8* src_argb, uint8* dst_rgb, int pix);
 void ARGBToRGB565Row_Any_SSE2(const uint8* src_argb, uint8* dst_rgb, int pix);
@@ -550,6 +751,7 @@ void ARGBToRGB24Row_Any_NEON(const uint8* src_argb, uint8* dst_rgb, int pix);
 void ARGBToRAWRow_Any_NEON(const uint8* src_argb, uint8* dst_rgb, int pix);
 
 void ARGBToYRow_Any_SSSE3(const uint8* src_argb, uint8* dst_y, int pix);
+void ARGBToYRow_Any_AVX2(const uint8* src_argb, uint8* dst_y, int pix);
 void BGRAToYRow_Any_SSSE3(const uint8* src_argb, uint8* dst_y, int pix);
 void ABGRToYRow_Any_SSSE3(const uint8* src_argb, uint8* dst_y, int pix);
 void RGBAToYRow_Any_SSSE3(const uint8* src_argb, uint8* dst_y, int pix);
@@ -599,6 +801,35 @@ void NV21ToARGBRow_Any_NEON(const uint8* y_buf,
                             const uint8* uv_buf,
                             uint8* argb_buf,
                             int width);
+void I422ToRGB565Row_Any_NEON(const uint8* y_buf,
+                              const uint8* u_buf,
+                              const uint8* v_buf,
+                              uint8* rgb_buf,
+                              int width);
+void I422ToARGB1555Row_Any_NEON(const uint8* y_buf,
+                                const uint8* u_buf,
+                                const uint8* v_buf,
+                                uint8* rgb_buf,
+                                int width);
+void I422ToARGB4444Row_Any_NEON(const uint8* y_buf,
+                                const uint8* u_buf,
+                                const uint8* v_buf,
+                                uint8* rgb_buf,
+                                int width);
+void I422ToRGB565DitherRow_Any_NEON(const uint8* y_buf,
+                                    const uint8* u_buf,
+                                    const uint8* v_buf,
+                                    uint8* rgb_buf,
+                                    uint32 dither4,
+                                    int width);
+void NV12ToRGB565Row_Any_NEON(const uint8* y_buf,
+                              const uint8* uv_buf,
+                              uint8* rgb_buf,
+                              int width);
+void NV21ToRGB565Row_Any_NEON(const uint8* y_buf,
+                              const uint8* vu_buf,
+                              uint8* rgb_buf,
+                              int width);
 
 void YUY2ToYRow_SSE2(const uint8* src_yuy2, uint8* dst_y, int pix);
 void YUY2ToUVRow_SSE2(const uint8* src_yuy2, int stride_yuy2,
@@ -687,6 +918,19 @@ void ARGBColorMatrixRow_SSSE3(uint8* dst_argb, const int8* matrix_argb,
 void ARGBColorTableRow_C(uint8* dst_argb, const uint8* table_argb, int width);
 void ARGBColorTableRow_X86(uint8* dst_argb, const uint8* table_argb, int width);
 
+// 3D LUT with tetrahedral interpolation. lut_index holds 256 entries for each
+// of B, G and R: the LUT offset of the lower grid point << 9 | the fraction
+// of the way to the next one, 0 to 256.
+void ARGBApply3DLutRow_C(const uint8* src_argb, uint8* dst_argb,
+                         const uint8* lut_argb, const int32* lut_index,
+                         int lut_size, int width);
+void ARGBApply3DLutRow_AVX2(const uint8* src_argb, uint8* dst_argb,
+                            const uint8* lut_argb, const int32* lut_index,
+                            int lut_size, int width);
+void ARGBApply3DLutRow_Any_AVX2(const uint8* src_argb, uint8* dst_argb,
+                                const uint8* lut_argb, const int32* lut_index,
+                                int lut_size, int width);
+
 void ARGBQuantizeRow_C(uint8* dst_argb, int scale, int interval_size,
                        int interval_offset, int width);
 void ARGBQuantizeRow_SSE2(uint8* dst_argb, int scale, int interval_size,
@@ -703,6 +947,57 @@ void CumulativeSumToAverage_C(const int32* topleft, const int32* botleft,
 void ComputeCumulativeSumRow_C(const uint8* row, int32* cumsum,
                                const int32* previous_cumsum, int width);
 
+// Used for PlaneBlur and ARGBBoxBlur. Column sums are kept in 16 bits, which
+// holds up to 257 rows. cumsum has width + 1 entries (pixels for ARGB);
+// cumsum[0] is the starting value.
+void BlurColumnAddRow_C(const uint8* src, uint16* sum, int width);
+void BlurColumnAddRow_SSE2(const uint8* src, uint16* sum, int width);
+void BlurColumnAddRow_NEON(const uint8* src, uint16* sum, int width);
+void BlurColumnAddRow_Any_SSE2(const uint8* src, uint16* sum, int width);
+void BlurColumnAddRow_Any_NEON(const uint8* src, uint16* sum, int width);
+void BlurColumnSubRow_C(const uint8* src, uint16* sum, int width);
+void BlurColumnSubRow_SSE2(const uint8* src, uint16* sum, int width);
+void BlurColumnSubRow_NEON(const uint8* src, uint16* sum, int width);
+void BlurColumnSubRow_Any_SSE2(const uint8* src, uint16* sum, int width);
+void BlurColumnSubRow_Any_NEON(const uint8* src, uint16* sum, int width);
+void BlurCumulativeSumRow_C(const uint16* sum, int32* cumsum, int width);
+void BlurCumulativeSumRow_SSE2(const uint16* sum, int32* cumsum, int width);
+void BlurCumulativeSumRow_Any_SSE2(const uint16* sum, int32* cumsum,
+                                   int width);
+void ARGBBlurCumulativeSumRow_C(const uint16* sum, int32* cumsum, int width);
+void ARGBBlurCumulativeSumRow_SSE2(const uint16* sum, int32* cumsum,
+                                   int width);
+void ARGBBlurCumulativeSumRow_NEON(const uint16* sum, int32* cumsum,
+                                   int width);
+// Averages are (cumsum[i + diameter] - cumsum[i]) * ooa + rounding,
+// truncated.
+void BlurCumulativeSumToAverageRow_C(const int32* cumsum, int diameter,
+                                     float ooa, float rounding,
+                                     uint8* dst, int count);
+void BlurCumulativeSumToAverageRow_SSE2(const int32* cumsum, int diameter,
+                                        float ooa, float rounding,
+                                        uint8* dst, int count);
+void BlurCumulativeSumToAverageRow_NEON(const int32* cumsum, int diameter,
+                                        float ooa, float rounding,
+                                        uint8* dst, int count);
+void BlurCumulativeSumToAverageRow_Any_SSE2(const int32* cumsum, int diameter,
+                                            float ooa, float rounding,
+                                            uint8* dst, int count);
+void BlurCumulativeSumToAverageRow_Any_NEON(const int32* cumsum, int diameter,
+                                            float ooa, float rounding,
+                                            uint8* dst, int count);
+
+void UnsharpMaskRow_C(const uint8* src, const uint8* src_blur, uint8* dst,
+                      int amount, int threshold, int width);
+void UnsharpMaskRow_SSE2(const uint8* src, const uint8* src_blur, uint8* dst,
+                         int amount, int threshold, int width);
+void UnsharpMaskRow_Any_SSE2(const uint8* src, const uint8* src_blur,
+                             uint8* dst, int amount, int threshold, int width);
+
+// Counts into 4 tables of 256 that the caller sums, so runs of equal values
+// do not wait on the previous increment of the same counter.
+void HistogramRow_C(const uint8* src, uint32* histogram, int width);
+
 void ARGBShadeRow_C(const uint8* src_argb, uint8* dst_argb, int width,
                     uint32 value);
 void ARGBShadeRow_SSE2(const uint8* src_argb, uint8* dst_argb, int width,
@@ -715,6 +1010,19 @@ LIBYUV_API
 void ARGBAffineRow_SSE2(const uint8* src_argb, int src_argb_stride,
                         uint8* dst_argb, const float* uv_dudv, int width);
 
+// Bilinear filtered version of ARGBAffineRow. Positions are truncated to
+// 1/256 of a pixel, and all 4 taps must be inside the source.
+void ARGBAffineRowBilinear_C(const uint8* src_argb, int src_argb_stride,
+                             uint8* dst_argb, const float* uv_dudv, int width);
+void ARGBAffineRowBilinear_SSE2(const uint8* src_argb, int src_argb_stride,
+                                uint8* dst_argb, const float* uv_dudv,
+                                int width);
+// Planar versions, used for I420Affine.
+void AffineRow_C(const uint8* src, int src_stride,
+                 uint8* dst, const float* uv_dudv, int width);
+void AffineRowBilinear_C(const uint8* src, int src_stride,
+                         uint8* dst, const float* uv_dudv, int width);
+
 void ARGBInterpolateRow_C(uint8* dst_ptr, const uint8* src_ptr,
                           ptrdiff_t src_stride,
                           int dst_width, int source_y_fraction);
@@ -722,6 +1030,166 @@ void ARGBInterpolateRow_SSSE3(uint8* dst_ptr, const uint8* src_ptr,
                               ptrdiff_t src_stride, int dst_width,
                               int source_y_fraction);
 
+// Kernels written with intrinsics in scale_sse2.cc, compare_sse2.cc and
+// rotate_ssse3.cc, for GCC x86 and x64 builds that compile them and define
+// LIBYUV_SSE2 or LIBYUV_SSSE3. scale.cc, compare.cc and rotate.cc call them
+// in place of their inline assembly versions.
+#if !defined(YUV_DISABLE_ASM) && defined(LIBYUV_SSE2) && \
+    (defined(__x86_64__) || defined(__i386__))
+void ScaleRowDown2_SSE2(const uint8* src_ptr, ptrdiff_t src_stride,
+                        uint8* dst_ptr, int dst_width);
+void ScaleRowDown2Int_SSE2(const uint8* src_ptr, ptrdiff_t src_stride,
+                           uint8* dst_ptr, int dst_width);
+void ScaleRowDown2_Unaligned_SSE2(const uint8* src_ptr, ptrdiff_t src_stride,
+                                  uint8* dst_ptr, int dst_width);
+void ScaleRowDown2Int_Unaligned_SSE2(const uint8* src_ptr,
+                                     ptrdiff_t src_stride,
+                                     uint8* dst_ptr, int dst_width);
+void ScaleRowDown4_SSE2(const uint8* src_ptr, ptrdiff_t src_stride,
+                        uint8* dst_ptr, int dst_width);
+void ScaleRowDown4Int_SSE2(const uint8* src_ptr, ptrdiff_t src_stride,
+                           uint8* dst_ptr, int dst_width);
+uint32 SumSquareError_SSE2(const uint8* src_a, const uint8* src_b, int count);
+#endif
+#if !defined(YUV_DISABLE_ASM) && defined(LIBYUV_SSSE3) && \
+    (defined(__x86_64__) || defined(__i386__))
+void TransposeWx8_SSSE3(const uint8* src, int src_stride,
+                        uint8* dst, int dst_stride, int width);
+#if defined(__x86_64__)
+void TransposeWx8_FAST_SSSE3(const uint8* src, int src_stride,
+                             uint8* dst, int dst_stride, int width);
+#endif
+#endif
+
+// Calls band_function(param, y, height) for bands of rows that together
+// cover 0 to height, on up to num_threads threads. Returns when all bands
+// are done.
+typedef void (*BandFunction)(void* param, int y, int height);
+void RunBands(BandFunction band_function, void* param,
+              int height, int num_threads);
+// Number of bands RunBands uses. Band i of n starts at row i * height / n.
+int BandCount(int height, int num_threads);
+// Same as RunBands for a batch of count frames. band_function gets the first
+// frame and the number of frames of its band. Bands are at least one frame
+// where RunBands bands are at least 16 rows.
+void RunFrameBands(BandFunction band_function, void* param,
+                   int count, int num_threads);
+// Number of bands RunFrameBands uses.
+int FrameBandCount(int count, int num_threads);
+
+// The variants of a row function in a RowDispatch. c is the portable
+// function. The first tier of SIMD variants runs widths over width_mask[0]:
+// any takes any such width, unaligned a multiple of width_mask[0] + 1 and
+// aligned also needs 16 byte aligned pointers and strides. The narrow tier
+// is the same for widths from width_mask[1] + 1 to width_mask[0], such as
+// SSSE3 kernels for widths under the AVX2 step. A width_mask of 0 means the
+// tier has no SIMD kernel, and a tier without an aligned kernel repeats the
+// unaligned one.
+enum RowVariant {
+  kRowC = 0,
+  kRowAny,
+  kRowUnaligned,
+  kRowAligned,
+  kRowNarrowAny,
+  kRowNarrowUnaligned,
+  kRowNarrowAligned,
+  kRowVariants
+};
+
+// functions and names are indexed by RowVariant.
+#define ROW_VARIANTS(FUNCTION_TYPE)                                            \
+    struct {                                                                   \
+      FUNCTION_TYPE functions[kRowVariants];                                   \
+      const char* names[kRowVariants];                                         \
+      int width_mask[2];                                                       \
+      bool has_aligned[2];                                                     \
+    }
+
+typedef void (*I422ToARGBRowFunction)(const uint8* y_buf,
+                                      const uint8* u_buf,
+                                      const uint8* v_buf,
+                                      uint8* argb_buf,
+                                      int width);
+typedef void (*NV12ToARGBRowFunction)(const uint8* y_buf,
+                                      const uint8* uv_buf,
+                                      uint8* argb_buf,
+                                      int width);
+typedef void (*ARGBToYRowFunction)(const uint8* src_argb, uint8* dst_y,
+                                   int pix);
+typedef void (*ARGBToUVRowFunction)(const uint8* src_argb0,
+                                    int src_stride_argb,
+                                    uint8* dst_u, uint8* dst_v, int width);
+
+// The row functions of the conversions that have Explain functions, so
+// explain, instrument and the kernel that runs agree. New code that calls
+// one of these takes it from the table with SELECT_ROW. The older
+// conversions still pick them with TestCpuFlag, as do the callers of row
+// functions that are not in the table.
+struct RowDispatch {
+  int cpu_flags;
+  ROW_VARIANTS(I422ToARGBRowFunction) I422ToARGBRow;
+  ROW_VARIANTS(NV12ToARGBRowFunction) NV12ToARGBRow;
+  ROW_VARIANTS(NV12ToARGBRowFunction) NV21ToARGBRow;
+  ROW_VARIANTS(ARGBToYRowFunction) ARGBToYRow;
+  ROW_VARIANTS(ARGBToUVRowFunction) ARGBToUVRow;
+};
+
+// Table for the current cpu flags, built by the first caller after
+// MaskCpuFlags changes them. Tables are never freed, so a pointer stays
+// valid on any thread.
+LIBYUV_API
+const RowDispatch* GetRowDispatch();
+
+// Returns the RowVariant for width. is_aligned is whether the pointers and
+// strides that the aligned variants need are 16 byte aligned.
+int SelectRowVariant(const int width_mask[2], int width, bool is_aligned);
+
+// The function that SelectRowVariant picks, and its name.
+#define SELECT_ROW(variants, width, is_aligned)                                \
+    ((variants).functions[SelectRowVariant((variants).width_mask, width,       \
+                                           is_aligned)])
+#define SELECT_ROW_NAME(variants, width, is_aligned)                           \
+    ((variants).names[SelectRowVariant((variants).width_mask, width,           \
+                                       is_aligned)])
+
+// Helpers for the Explain functions in explain.h.
+struct KernelChoice;
+
+// Sets choice to a portable kernel, with the reason that there is no SIMD
+// kernel for the cpu flags.
+void ExplainKernelC(KernelChoice* choice, const char* path,
+                    const char* kernel);
+
+// Called for each SIMD kernel the cpu flags allow, in the order the caller
+// tries them. The kernel is chosen if width_ok and aligned_ok, otherwise
+// the reason says which of them failed.
+void ExplainKernel(KernelChoice* choice, const char* kernel,
+                   bool width_ok, bool aligned_ok);
+
+// Sets choice to the variant SELECT_ROW picks and why.
+void ExplainRowVariants(KernelChoice* choice, const char* path,
+                        const char* const names[kRowVariants],
+                        const int width_mask[2], const bool has_aligned[2],
+                        int width, bool is_aligned);
+#define EXPLAIN_ROW(choice, path, variants, width, is_aligned)                 \
+    ExplainRowVariants(choice, path, (variants).names, (variants).width_mask,  \
+                       (variants).has_aligned, width, is_aligned)
+
+// Instrumented functions call INSTRUMENT_START once their arguments are
+// checked and INSTRUMENT_STOP with the kernel or path name they used. The
+// arguments are not evaluated unless LIBYUV_INSTRUMENT is defined.
+#ifdef LIBYUV_INSTRUMENT
+uint64 InstrumentTimer(void);
+void InstrumentRecord(const char* function, const char* kernel,
+                      int width, int height, uint64 start);
+#define INSTRUMENT_START() const uint64 instrument_start = InstrumentTimer()
+#define INSTRUMENT_STOP(function, kernel, width, height)                       \
+    InstrumentRecord(function, kernel, width, height, instrument_start)
+#else
+#define INSTRUMENT_START()
+#define INSTRUMENT_STOP(function, kernel, width, height)
+#endif
+
 #ifdef __cplusplus
 }  // extern "C"
 }  // namespace libyuv
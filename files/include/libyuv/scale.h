@@ -12,6 +12,7 @@
 #define INCLUDE_LIBYUV_SCALE_H_
 
 #include "libyuv/basic_types.h"
+#include "libyuv/rotate.h"  // For RotationMode
 
 #ifdef __cplusplus
 namespace libyuv {
@@ -54,6 +55,51 @@ int I420Scale(const uint8* src_y, int src_stride_y,
               int dst_width, int dst_height,
               FilterMode filtering);
 
+// Scales an NV12 image from the src width and height to the dst width and
+// height. The interleaved UV plane is scaled directly, as pairs, so it is
+// not split into U and V. Also works for NV21.
+// Returns 0 if successful.
+LIBYUV_API
+int NV12Scale(const uint8* src_y, int src_stride_y,
+              const uint8* src_uv, int src_stride_uv,
+              int src_width, int src_height,
+              uint8* dst_y, int dst_stride_y,
+              uint8* dst_uv, int dst_stride_uv,
+              int dst_width, int dst_height,
+              FilterMode filtering);
+
+// Rotates and scales a YUV 4:2:0 image in one pass, without writing a
+// rotated intermediate frame.
+// dst_width and dst_height are the size after rotation.
+// kFilterNone and kFilterBilinear match I420Rotate followed by I420Scale,
+// bilinear within 1. kFilterBox on a scale down of 2x or more in height
+// averages boxes that tile the rotated image from its top left. It matches
+// I420Scale within 1 for 2x and 2 for 4x, where I420Scale box filters too.
+// For other sizes I420Scale filters bilinear, so the results differ.
+// Returns 0 if successful.
+LIBYUV_API
+int I420RotateScale(const uint8* src_y, int src_stride_y,
+                    const uint8* src_u, int src_stride_u,
+                    const uint8* src_v, int src_stride_v,
+                    int src_width, int src_height,
+                    uint8* dst_y, int dst_stride_y,
+                    uint8* dst_u, int dst_stride_u,
+                    uint8* dst_v, int dst_stride_v,
+                    int dst_width, int dst_height,
+                    RotationMode mode, FilterMode filtering);
+
+// Rotates and scales NV12 input and stores in I420.
+// Same as I420RotateScale with NV12ToI420Rotate in place of I420Rotate.
+LIBYUV_API
+int NV12ToI420RotateScale(const uint8* src_y, int src_stride_y,
+                          const uint8* src_uv, int src_stride_uv,
+                          int src_width, int src_height,
+                          uint8* dst_y, int dst_stride_y,
+                          uint8* dst_u, int dst_stride_u,
+                          uint8* dst_v, int dst_stride_v,
+                          int dst_width, int dst_height,
+                          RotationMode mode, FilterMode filtering);
+
 // Legacy API.  Deprecated.
 LIBYUV_API
 int Scale(const uint8* src_y, const uint8* src_u, const uint8* src_v,
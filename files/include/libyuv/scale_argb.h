@@ -12,6 +12,7 @@
 #define INCLUDE_LIBYUV_SCALE_ARGB_H_
 
 #include "libyuv/basic_types.h"
+#include "libyuv/frame.h"  // For YuvFrame
 #include "libyuv/scale.h"  // For FilterMode
 
 #ifdef __cplusplus
@@ -26,6 +27,12 @@ int ARGBScale(const uint8* src_argb, int src_stride_argb,
               int dst_width, int dst_height,
               FilterMode filtering);
 
+// Scale count ARGB frames, each to the size of its destination frame.
+// Frames are split into bands run on up to num_threads threads.
+LIBYUV_API
+int ARGBScaleBatch(const YuvFrame* src_frames, YuvFrame* dst_frames,
+                   int count, FilterMode filtering, int num_threads);
+
 #ifdef __cplusplus
 }  // extern "C"
 }  // namespace libyuv
@@ -9,6 +9,8 @@
 {
   'variables': {
      'use_system_libjpeg%': 0,
+     # Set to 1 to count calls and time of functions. See instrument.h.
+     'libyuv_instrument%': 0,
   },
   'targets': [
     {
@@ -27,6 +29,19 @@
             ],
           },
         }],
+        ['libyuv_instrument==1', {
+          'defines': [
+            'LIBYUV_INSTRUMENT',
+          ],
+        }],
+        ['OS=="linux" or OS=="mac"', {
+          # Restart marker groups of large jpegs are decoded on threads.
+          'link_settings': {
+            'libraries': [
+              '-lpthread',
+            ],
+          },
+        }],
       ],
       'defines': [
         'HAVE_JPEG',
@@ -51,7 +66,10 @@
         'include/libyuv/convert_argb.h',
         'include/libyuv/convert_from.h',
         'include/libyuv/cpu_id.h',
+        'include/libyuv/explain.h',
         'include/libyuv/format_conversion.h',
+        'include/libyuv/frame.h',
+        'include/libyuv/instrument.h',
         'include/libyuv/mjpeg_decoder.h',
         'include/libyuv/planar_functions.h',
         'include/libyuv/rotate.h',
@@ -65,23 +83,33 @@
         # sources.
         'source/compare.cc',
         'source/compare_neon.cc',
+        'source/compare_sse2.cc',
         'source/convert.cc',
         'source/convert_argb.cc',
         'source/convert_from.cc',
         'source/cpu_id.cc',
         'source/format_conversion.cc',
+        'source/frame.cc',
+        'source/instrument.cc',
         'source/mjpeg_decoder.cc',
+        'source/parallel.cc',
         'source/planar_functions.cc',
         'source/rotate.cc',
         'source/rotate_argb.cc',
         'source/rotate_neon.cc',
+        'source/rotate_ssse3.cc',
+        'source/row_avx2.cc',
         'source/row_common.cc',
+        'source/row_dispatch.cc',
         'source/row_neon.cc',
         'source/row_posix.cc',
+        'source/row_ssse3.cc',
         'source/row_win.cc',
         'source/scale.cc',
         'source/scale_neon.cc',
+        'source/scale_sse2.cc',
         'source/scale_argb.cc',
+        'source/scale_uv.cc',
         'source/video_common.cc',
       ],
     },
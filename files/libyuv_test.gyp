@@ -7,6 +7,9 @@
 # be found in the AUTHORS file in the root of the source tree.
 
 {
+  'variables': {
+     'use_system_libjpeg%': 0,
+  },
   'targets': [
     {
       'target_name': 'libyuv_unittest',
@@ -18,6 +21,7 @@
         'testing/gtest.gyp:gtest_main',
       ],
       'defines': [
+        'HAVE_JPEG',
         'LIBYUV_SVNREVISION="<!(svnversion -n)"',
         # 'LIBYUV_USING_SHARED_LIBRARY',
       ],
@@ -28,6 +32,10 @@
         # sources
         'unit_test/compare_test.cc',
         'unit_test/cpu_test.cc',
+        'unit_test/explain_test.cc',
+        'unit_test/frame_test.cc',
+        'unit_test/instrument_test.cc',
+        'unit_test/mjpeg_test.cc',
         'unit_test/planar_test.cc',
         'unit_test/rotate_argb_test.cc',
         'unit_test/rotate_test.cc',
@@ -42,6 +50,12 @@
             '-fexceptions',
           ],
         }],
+        # mjpeg_test encodes its test images with libjpeg.
+        ['use_system_libjpeg==0', {
+          'dependencies': [
+             '<(DEPTH)/third_party/libjpeg_turbo/libjpeg.gyp:libjpeg',
+          ],
+        }],
       ], # conditions
     },
 
@@ -64,6 +78,20 @@
       ], # conditions
     },
 
+    {
+      # Throughput of the conversion, scale, rotate and compare functions
+      # by resolution, alignment and cpu flags, as CSV or JSON.
+      'target_name': 'libyuv_bench',
+      'type': 'executable',
+      'dependencies': [
+        'libyuv.gyp:libyuv',
+      ],
+      'sources': [
+        # sources
+        'util/libyuv_bench.cc',
+      ],
+    },
+
   ], # targets
 }
 
@@ -12,6 +12,7 @@
 
 #include <float.h>
 #include <math.h>
+#include <string.h>  // For memset()
 #ifdef _OPENMP
 #include <omp.h>
 #endif
@@ -292,6 +293,7 @@ static uint32 SumSquareError_SSE2(const uint8* src_a, const uint8* src_b,
 
 #elif !defined(YUV_DISABLE_ASM) && (defined(__x86_64__) || defined(__i386__))
 #define HAS_SUMSQUAREERROR_SSE2
+#if !defined(LIBYUV_SSE2)  // Else in compare_sse2.cc, declared in row.h
 static uint32 SumSquareError_SSE2(const uint8* src_a, const uint8* src_b,
                                   int count) {
   uint32 sse;
@@ -336,6 +338,7 @@ static uint32 SumSquareError_SSE2(const uint8* src_a, const uint8* src_b,
   );
   return sse;
 }
+#endif  // !defined(LIBYUV_SSE2)
 #endif
 
 static uint32 SumSquareError_C(const uint8* src_a, const uint8* src_b,
@@ -417,6 +420,309 @@ uint64 ComputeSumSquareErrorPlane(const uint8* src_a, int stride_a,
   return sse;
 }
 
+#if !defined(YUV_DISABLE_ASM) && (defined(__ARM_NEON__) || defined(LIBYUV_NEON))
+#define HAS_PLANESTATSROW_NEON
+
+void PlaneStatsRow_NEON(const uint8* src, int count, uint32* stats);
+
+#elif !defined(YUV_DISABLE_ASM) && defined(_M_IX86)
+#define HAS_PLANESTATSROW_SSE2
+// Sum, sum of squares, min and max of a multiple of 16 values, up to 32K.
+__declspec(naked) __declspec(align(16))
+static void PlaneStatsRow_SSE2(const uint8* src, int count, uint32* stats) {
+  __asm {
+    mov        eax, [esp + 4]    // src
+    mov        ecx, [esp + 8]    // count
+    mov        edx, [esp + 12]   // stats
+    pxor       xmm0, xmm0        // sum
+    pxor       xmm1, xmm1        // sum of squares
+    pcmpeqb    xmm2, xmm2        // min
+    pxor       xmm3, xmm3        // max
+    pxor       xmm5, xmm5
+
+    align      16
+  wloop:
+    movdqu     xmm4, [eax]
+    lea        eax,  [eax + 16]
+    pminub     xmm2, xmm4
+    pmaxub     xmm3, xmm4
+    movdqa     xmm6, xmm4
+    psadbw     xmm6, xmm5
+    paddd      xmm0, xmm6
+    movdqa     xmm6, xmm4
+    punpcklbw  xmm4, xmm5
+    punpckhbw  xmm6, xmm5
+    pmaddwd    xmm4, xmm4
+    pmaddwd    xmm6, xmm6
+    paddd      xmm1, xmm4
+    paddd      xmm1, xmm6
+    sub        ecx, 16
+    jg         wloop
+
+    pshufd     xmm4, xmm0, 0EEh
+    paddd      xmm0, xmm4
+    pshufd     xmm4, xmm1, 0EEh
+    paddd      xmm1, xmm4
+    pshufd     xmm4, xmm1, 01h
+    paddd      xmm1, xmm4
+    movdqa     xmm4, xmm2
+    psrldq     xmm4, 8
+    pminub     xmm2, xmm4
+    movdqa     xmm4, xmm3
+    psrldq     xmm4, 8
+    pmaxub     xmm3, xmm4
+    movdqa     xmm4, xmm2
+    psrldq     xmm4, 4
+    pminub     xmm2, xmm4
+    movdqa     xmm4, xmm3
+    psrldq     xmm4, 4
+    pmaxub     xmm3, xmm4
+    movdqa     xmm4, xmm2
+    psrldq     xmm4, 2
+    pminub     xmm2, xmm4
+    movdqa     xmm4, xmm3
+    psrldq     xmm4, 2
+    pmaxub     xmm3, xmm4
+    movdqa     xmm4, xmm2
+    psrldq     xmm4, 1
+    pminub     xmm2, xmm4
+    movdqa     xmm4, xmm3
+    psrldq     xmm4, 1
+    pmaxub     xmm3, xmm4
+    movd       [edx], xmm0
+    movd       [edx + 4], xmm1
+    movd       [edx + 8], xmm2
+    movd       [edx + 12], xmm3
+    ret
+  }
+}
+
+#elif !defined(YUV_DISABLE_ASM) && (defined(__x86_64__) || defined(__i386__))
+#define HAS_PLANESTATSROW_SSE2
+// Sum, sum of squares, min and max of a multiple of 16 values, up to 32K.
+static void PlaneStatsRow_SSE2(const uint8* src, int count, uint32* stats) {
+  asm volatile (
+    "pxor      %%xmm0,%%xmm0                   \n"
+    "pxor      %%xmm1,%%xmm1                   \n"
+    "pcmpeqb   %%xmm2,%%xmm2                   \n"
+    "pxor      %%xmm3,%%xmm3                   \n"
+    "pxor      %%xmm5,%%xmm5                   \n"
+    ".p2align  4                               \n"
+    "1:                                        \n"
+    "movdqu    (%0),%%xmm4                     \n"
+    "lea       0x10(%0),%0                     \n"
+    "pminub    %%xmm4,%%xmm2                   \n"
+    "pmaxub    %%xmm4,%%xmm3                   \n"
+    "movdqa    %%xmm4,%%xmm6                   \n"
+    "psadbw    %%xmm5,%%xmm6                   \n"
+    "paddd     %%xmm6,%%xmm0                   \n"
+    "movdqa    %%xmm4,%%xmm6                   \n"
+    "punpcklbw %%xmm5,%%xmm4                   \n"
+    "punpckhbw %%xmm5,%%xmm6                   \n"
+    "pmaddwd   %%xmm4,%%xmm4                   \n"
+    "pmaddwd   %%xmm6,%%xmm6                   \n"
+    "paddd     %%xmm4,%%xmm1                   \n"
+    "paddd     %%xmm6,%%xmm1                   \n"
+    "sub       $0x10,%1                        \n"
+    "jg        1b                              \n"
+
+    "pshufd    $0xee,%%xmm0,%%xmm4             \n"
+    "paddd     %%xmm4,%%xmm0                   \n"
+    "pshufd    $0xee,%%xmm1,%%xmm4             \n"
+    "paddd     %%xmm4,%%xmm1                   \n"
+    "pshufd    $0x1,%%xmm1,%%xmm4              \n"
+    "paddd     %%xmm4,%%xmm1                   \n"
+    "movdqa    %%xmm2,%%xmm4                   \n"
+    "psrldq    $0x8,%%xmm4                     \n"
+    "pminub    %%xmm4,%%xmm2                   \n"
+    "movdqa    %%xmm3,%%xmm4                   \n"
+    "psrldq    $0x8,%%xmm4                     \n"
+    "pmaxub    %%xmm4,%%xmm3                   \n"
+    "movdqa    %%xmm2,%%xmm4                   \n"
+    "psrldq    $0x4,%%xmm4                     \n"
+    "pminub    %%xmm4,%%xmm2                   \n"
+    "movdqa    %%xmm3,%%xmm4                   \n"
+    "psrldq    $0x4,%%xmm4                     \n"
+    "pmaxub    %%xmm4,%%xmm3                   \n"
+    "movdqa    %%xmm2,%%xmm4                   \n"
+    "psrldq    $0x2,%%xmm4                     \n"
+    "pminub    %%xmm4,%%xmm2                   \n"
+    "movdqa    %%xmm3,%%xmm4                   \n"
+    "psrldq    $0x2,%%xmm4                     \n"
+    "pmaxub    %%xmm4,%%xmm3                   \n"
+    "movdqa    %%xmm2,%%xmm4                   \n"
+    "psrldq    $0x1,%%xmm4                     \n"
+    "pminub    %%xmm4,%%xmm2                   \n"
+    "movdqa    %%xmm3,%%xmm4                   \n"
+    "psrldq    $0x1,%%xmm4                     \n"
+    "pmaxub    %%xmm4,%%xmm3                   \n"
+    "movd      %%xmm0,(%2)                     \n"
+    "movd      %%xmm1,0x4(%2)                  \n"
+    "movd      %%xmm2,0x8(%2)                  \n"
+    "movd      %%xmm3,0xc(%2)                  \n"
+  : "+r"(src),        // %0
+    "+r"(count)       // %1
+  : "r"(stats)        // %2
+  : "memory", "cc"
+#if defined(__SSE2__)
+    , "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5", "xmm6"
+#endif
+  );
+}
+#endif
+
+// stats gets the sum, sum of squares, min and max. min and max are in the
+// low byte.
+static void PlaneStatsRow_C(const uint8* src, int count, uint32* stats) {
+  uint32 sum = 0u;
+  uint32 sum_squares = 0u;
+  int min = 255;
+  int max = 0;
+  for (int i = 0; i < count; ++i) {
+    const int v = src[i];
+    sum += v;
+    sum_squares += v * v;
+    min = v < min ? v : min;
+    max = v > max ? v : max;
+  }
+  stats[0] = sum;
+  stats[1] = sum_squares;
+  stats[2] = min;
+  stats[3] = max;
+}
+
+// Counts go to 2 tables per channel that are summed at the end.
+static void ARGBHistogramRow_C(const uint8* src_argb, uint32* histogram,
+                               int width) {
+  int x;
+  for (x = 0; x < width - 1; x += 2) {
+    ++histogram[src_argb[0]];
+    ++histogram[256 + src_argb[1]];
+    ++histogram[512 + src_argb[2]];
+    ++histogram[768 + src_argb[3]];
+    ++histogram[1024 + src_argb[4]];
+    ++histogram[1280 + src_argb[5]];
+    ++histogram[1536 + src_argb[6]];
+    ++histogram[1792 + src_argb[7]];
+    src_argb += 8;
+  }
+  if (width & 1) {
+    ++histogram[src_argb[0]];
+    ++histogram[256 + src_argb[1]];
+    ++histogram[512 + src_argb[2]];
+    ++histogram[768 + src_argb[3]];
+  }
+}
+
+LIBYUV_API
+int PlaneHistogram(const uint8* src_y, int src_stride_y,
+                   int width, int height, uint32* histogram) {
+  if (!src_y || !histogram || width <= 0 || height == 0) {
+    return -1;
+  }
+  // Negative height means invert the image.
+  if (height < 0) {
+    height = -height;
+    src_y = src_y + (height - 1) * src_stride_y;
+    src_stride_y = -src_stride_y;
+  }
+  uint32 tables[256 * 4];
+  memset(tables, 0, sizeof(tables));
+  for (int y = 0; y < height; ++y) {
+    HistogramRow_C(src_y, tables, width);
+    src_y += src_stride_y;
+  }
+  for (int i = 0; i < 256; ++i) {
+    histogram[i] += tables[i] + tables[256 + i] + tables[512 + i] +
+        tables[768 + i];
+  }
+  return 0;
+}
+
+LIBYUV_API
+int ARGBHistogram(const uint8* src_argb, int src_stride_argb,
+                  int width, int height, uint32* histogram) {
+  if (!src_argb || !histogram || width <= 0 || height == 0) {
+    return -1;
+  }
+  // Negative height means invert the image.
+  if (height < 0) {
+    height = -height;
+    src_argb = src_argb + (height - 1) * src_stride_argb;
+    src_stride_argb = -src_stride_argb;
+  }
+  uint32 tables[256 * 8];
+  memset(tables, 0, sizeof(tables));
+  for (int y = 0; y < height; ++y) {
+    ARGBHistogramRow_C(src_argb, tables, width);
+    src_argb += src_stride_argb;
+  }
+  for (int i = 0; i < 256 * 4; ++i) {
+    histogram[i] += tables[i] + tables[1024 + i];
+  }
+  return 0;
+}
+
+LIBYUV_API
+int PlaneStats(const uint8* src_y, int src_stride_y,
+               int width, int height,
+               uint64* sum, uint64* sum_squares, int* min, int* max) {
+  if (!src_y || !sum || !sum_squares || !min || !max ||
+      width <= 0 || height == 0) {
+    return -1;
+  }
+  // Negative height means invert the image.
+  if (height < 0) {
+    height = -height;
+    src_y = src_y + (height - 1) * src_stride_y;
+    src_stride_y = -src_stride_y;
+  }
+  void (*PlaneStatsRow)(const uint8* src, int count, uint32* stats) =
+      PlaneStatsRow_C;
+#if defined(HAS_PLANESTATSROW_NEON)
+  if (TestCpuFlag(kCpuHasNEON)) {
+    PlaneStatsRow = PlaneStatsRow_NEON;
+  }
+#elif defined(HAS_PLANESTATSROW_SSE2)
+  if (TestCpuFlag(kCpuHasSSE2)) {
+    PlaneStatsRow = PlaneStatsRow_SSE2;
+  }
+#endif
+  // 32K squares fit the 32 bit sums of PlaneStatsRow.
+  const int kBlockSize = 1 << 15;
+  uint64 total = 0;
+  uint64 total_squares = 0;
+  uint32 minimum = 255u;
+  uint32 maximum = 0u;
+  uint32 stats[4];
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; x += kBlockSize) {
+      int count = width - x < kBlockSize ? width - x : kBlockSize;
+      int n = count & ~15;
+      if (n > 0) {
+        PlaneStatsRow(src_y + x, n, stats);
+        total += stats[0];
+        total_squares += stats[1];
+        minimum = (stats[2] & 0xff) < minimum ? (stats[2] & 0xff) : minimum;
+        maximum = (stats[3] & 0xff) > maximum ? (stats[3] & 0xff) : maximum;
+      }
+      if (count & 15) {
+        PlaneStatsRow_C(src_y + x + n, count & 15, stats);
+        total += stats[0];
+        total_squares += stats[1];
+        minimum = stats[2] < minimum ? stats[2] : minimum;
+        maximum = stats[3] > maximum ? stats[3] : maximum;
+      }
+    }
+    src_y += src_stride_y;
+  }
+  *sum = total;
+  *sum_squares = total_squares;
+  *min = static_cast<int>(minimum);
+  *max = static_cast<int>(maximum);
+  return 0;
+}
+
 LIBYUV_API
 double SumSquareErrorToPsnr(uint64 sse, uint64 count) {
   double psnr;
@@ -53,6 +53,52 @@ uint32 SumSquareError_NEON(const uint8* src_a, const uint8* src_b, int count) {
   return sse;
 }
 
+// Sum, sum of squares, min and max of a multiple of 16 values, up to 32K.
+// min and max are in the low byte of stats[2] and stats[3].
+void PlaneStatsRow_NEON(const uint8* src, int count, uint32* stats) {
+  asm volatile (
+    "vmov.u8    q8, #0                         \n"
+    "vmov.u8    q9, #0                         \n"
+    "vmov.u8    q10, #255                      \n"
+    "vmov.u8    q11, #0                        \n"
+
+    ".p2align  2                               \n"
+  "1:                                          \n"
+    "vld1.u8    {q0}, [%0]!                    \n"
+    "subs       %1, %1, #16                    \n"
+    "vpaddl.u8  q1, q0                         \n"
+    "vmull.u8   q2, d0, d0                     \n"
+    "vmull.u8   q3, d1, d1                     \n"
+    "vmin.u8    q10, q10, q0                   \n"
+    "vmax.u8    q11, q11, q0                   \n"
+    "vpadal.u16 q8, q1                         \n"
+    "vpadal.u16 q9, q2                         \n"
+    "vpadal.u16 q9, q3                         \n"
+    "bgt        1b                             \n"
+
+    "vadd.u32   d16, d16, d17                  \n"
+    "vadd.u32   d18, d18, d19                  \n"
+    "vpadd.u32  d16, d16, d16                  \n"
+    "vpadd.u32  d18, d18, d18                  \n"
+    "vpmin.u8   d20, d20, d21                  \n"
+    "vpmax.u8   d22, d22, d23                  \n"
+    "vpmin.u8   d20, d20, d20                  \n"
+    "vpmax.u8   d22, d22, d22                  \n"
+    "vpmin.u8   d20, d20, d20                  \n"
+    "vpmax.u8   d22, d22, d22                  \n"
+    "vpmin.u8   d20, d20, d20                  \n"
+    "vpmax.u8   d22, d22, d22                  \n"
+    "vst1.32    {d16[0]}, [%2]!                \n"
+    "vst1.32    {d18[0]}, [%2]!                \n"
+    "vst1.32    {d20[0]}, [%2]!                \n"
+    "vst1.32    {d22[0]}, [%2]                 \n"
+    : "+r"(src),
+      "+r"(count),
+      "+r"(stats)
+    :
+    : "memory", "cc", "q0", "q1", "q2", "q3", "q8", "q9", "q10", "q11");
+}
+
 #endif  // __ARM_NEON__
 
 #ifdef __cplusplus
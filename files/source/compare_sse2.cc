@@ -0,0 +1,60 @@
+/*
+ *  Copyright 2012 The LibYuv Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "libyuv/basic_types.h"
+#include "libyuv/row.h"
+
+#if !defined(YUV_DISABLE_ASM) && defined(LIBYUV_SSE2) && \
+    (defined(__x86_64__) || defined(__i386__))
+#include <emmintrin.h>
+#endif
+
+#ifdef __cplusplus
+namespace libyuv {
+extern "C" {
+#endif
+
+// This module is for GCC x86 and x64 builds that compile the intrinsics
+// kernels and define LIBYUV_SSE2. The functions here replace the inline
+// assembly versions in compare.cc.
+#if !defined(YUV_DISABLE_ASM) && defined(LIBYUV_SSE2) && \
+    (defined(__x86_64__) || defined(__i386__))
+
+// 16 pixels per loop. count is a multiple of 16 and both sources are 16 byte
+// aligned.
+uint32 SumSquareError_SSE2(const uint8* src_a, const uint8* src_b, int count) {
+  const __m128i kZero = _mm_setzero_si128();
+  // Two sums, so that the adds of one loop do not wait for each other.
+  __m128i sse = _mm_setzero_si128();
+  __m128i sse_hi = _mm_setzero_si128();
+  for (; count > 0; count -= 16) {
+    __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(src_a));
+    __m128i b = _mm_load_si128(reinterpret_cast<const __m128i*>(src_b));
+    // |a - b|, as one of the two saturating differences is 0.
+    __m128i diff = _mm_or_si128(_mm_subs_epu8(a, b), _mm_subs_epu8(b, a));
+    __m128i lo = _mm_unpacklo_epi8(diff, kZero);
+    __m128i hi = _mm_unpackhi_epi8(diff, kZero);
+    sse = _mm_add_epi32(sse, _mm_madd_epi16(lo, lo));
+    sse_hi = _mm_add_epi32(sse_hi, _mm_madd_epi16(hi, hi));
+    src_a += 16;
+    src_b += 16;
+  }
+  sse = _mm_add_epi32(sse, sse_hi);
+  sse = _mm_add_epi32(sse, _mm_shuffle_epi32(sse, 0xee));
+  sse = _mm_add_epi32(sse, _mm_shuffle_epi32(sse, 0x01));
+  return static_cast<uint32>(_mm_cvtsi128_si32(sse));
+}
+
+#endif  // !defined(YUV_DISABLE_ASM) && defined(LIBYUV_SSE2) ...
+
+#ifdef __cplusplus
+}  // extern "C"
+}  // namespace libyuv
+#endif
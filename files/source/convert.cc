@@ -12,10 +12,9 @@
 
 #include "libyuv/basic_types.h"
 #include "libyuv/cpu_id.h"
+#include "libyuv/explain.h"
 #include "libyuv/format_conversion.h"
-#ifdef HAVE_JPEG
 #include "libyuv/mjpeg_decoder.h"
-#endif
 #include "libyuv/planar_functions.h"
 #include "libyuv/rotate.h"
 #include "libyuv/video_common.h"
@@ -761,6 +760,101 @@ int YUY2ToI420(const uint8* src_yuy2, int src_stride_yuy2,
   return 0;
 }
 
+// Convert YUY2 to NV12.
+LIBYUV_API
+int YUY2ToNV12(const uint8* src_yuy2, int src_stride_yuy2,
+               uint8* dst_y, int dst_stride_y,
+               uint8* dst_uv, int dst_stride_uv,
+               int width, int height) {
+  if (!src_yuy2 || !dst_y || !dst_uv ||
+      width <= 0 || width > kMaxStride || height == 0) {
+    return -1;
+  }
+  // Negative height means invert the image.
+  if (height < 0) {
+    height = -height;
+    src_yuy2 = src_yuy2 + (height - 1) * src_stride_yuy2;
+    src_stride_yuy2 = -src_stride_yuy2;
+  }
+  void (*YUY2ToUVRow)(const uint8* src_yuy2, int src_stride_yuy2,
+                      uint8* dst_u, uint8* dst_v, int pix);
+  void (*YUY2ToYRow)(const uint8* src_yuy2,
+                     uint8* dst_y, int pix);
+  YUY2ToYRow = YUY2ToYRow_C;
+  YUY2ToUVRow = YUY2ToUVRow_C;
+#if defined(HAS_YUY2TOYROW_SSE2)
+  if (TestCpuFlag(kCpuHasSSE2)) {
+    if (width > 16) {
+      YUY2ToUVRow = YUY2ToUVRow_Any_SSE2;
+      YUY2ToYRow = YUY2ToYRow_Any_SSE2;
+    }
+    if (IS_ALIGNED(width, 16)) {
+      YUY2ToUVRow = YUY2ToUVRow_Unaligned_SSE2;
+      YUY2ToYRow = YUY2ToYRow_Unaligned_SSE2;
+      if (IS_ALIGNED(src_yuy2, 16) && IS_ALIGNED(src_stride_yuy2, 16)) {
+        YUY2ToUVRow = YUY2ToUVRow_SSE2;
+        if (IS_ALIGNED(dst_y, 16) && IS_ALIGNED(dst_stride_y, 16)) {
+          YUY2ToYRow = YUY2ToYRow_SSE2;
+        }
+      }
+    }
+  }
+#elif defined(HAS_YUY2TOYROW_NEON)
+  if (TestCpuFlag(kCpuHasNEON)) {
+    if (width > 8) {
+      YUY2ToYRow = YUY2ToYRow_Any_NEON;
+      if (width > 16) {
+        YUY2ToUVRow = YUY2ToUVRow_Any_NEON;
+      }
+    }
+    if (IS_ALIGNED(width, 16)) {
+      YUY2ToYRow = YUY2ToYRow_NEON;
+      YUY2ToUVRow = YUY2ToUVRow_NEON;
+    }
+  }
+#endif
+  int halfwidth = (width + 1) >> 1;
+  void (*MergeUV)(const uint8* src_u, const uint8* src_v, uint8* dst_uv,
+                  int width) = MergeUV_C;
+#if defined(HAS_MERGEUV_SSE2)
+  if (TestCpuFlag(kCpuHasSSE2) && halfwidth >= 16) {
+    MergeUV = MergeUV_Any_SSE2;
+    if (IS_ALIGNED(halfwidth, 16)) {
+      MergeUV = MergeUV_Unaligned_SSE2;
+      if (IS_ALIGNED(dst_uv, 16) && IS_ALIGNED(dst_stride_uv, 16)) {
+        MergeUV = MergeUV_SSE2;
+      }
+    }
+  }
+#elif defined(HAS_MERGEUV_NEON)
+  if (TestCpuFlag(kCpuHasNEON) && halfwidth >= 16) {
+    MergeUV = MergeUV_Any_NEON;
+    if (IS_ALIGNED(halfwidth, 16)) {
+      MergeUV = MergeUV_NEON;
+    }
+  }
+#endif
+  // One row of U and V, interleaved into dst_uv as soon as it is converted.
+  SIMD_ALIGNED(uint8 row_u[kMaxStride / 2]);
+  SIMD_ALIGNED(uint8 row_v[kMaxStride / 2]);
+
+  for (int y = 0; y < height - 1; y += 2) {
+    YUY2ToUVRow(src_yuy2, src_stride_yuy2, row_u, row_v, width);
+    MergeUV(row_u, row_v, dst_uv, halfwidth);
+    YUY2ToYRow(src_yuy2, dst_y, width);
+    YUY2ToYRow(src_yuy2 + src_stride_yuy2, dst_y + dst_stride_y, width);
+    src_yuy2 += src_stride_yuy2 * 2;
+    dst_y += dst_stride_y * 2;
+    dst_uv += dst_stride_uv;
+  }
+  if (height & 1) {
+    YUY2ToUVRow(src_yuy2, 0, row_u, row_v, width);
+    MergeUV(row_u, row_v, dst_uv, halfwidth);
+    YUY2ToYRow(src_yuy2, dst_y, width);
+  }
+  return 0;
+}
+
 // Convert UYVY to I420.
 LIBYUV_API
 int UYVYToI420(const uint8* src_uyvy, int src_stride_uyvy,
@@ -995,23 +1089,99 @@ int ARGBToI420(const uint8* src_argb, int src_stride_argb,
     src_argb = src_argb + (height - 1) * src_stride_argb;
     src_stride_argb = -src_stride_argb;
   }
+  INSTRUMENT_START();
+  const RowDispatch* dispatch = GetRowDispatch();
+  const bool src_aligned =
+      IS_ALIGNED(src_argb, 16) && IS_ALIGNED(src_stride_argb, 16);
+  ARGBToUVRowFunction ARGBToUVRow =
+      SELECT_ROW(dispatch->ARGBToUVRow, width, src_aligned);
+  const bool y_aligned = src_aligned &&
+      IS_ALIGNED(dst_y, 16) && IS_ALIGNED(dst_stride_y, 16);
+  ARGBToYRowFunction ARGBToYRow =
+      SELECT_ROW(dispatch->ARGBToYRow, width, y_aligned);
+
+  for (int y = 0; y < height - 1; y += 2) {
+    ARGBToUVRow(src_argb, src_stride_argb, dst_u, dst_v, width);
+    ARGBToYRow(src_argb, dst_y, width);
+    ARGBToYRow(src_argb + src_stride_argb, dst_y + dst_stride_y, width);
+    src_argb += src_stride_argb * 2;
+    dst_y += dst_stride_y * 2;
+    dst_u += dst_stride_u;
+    dst_v += dst_stride_v;
+  }
+  if (height & 1) {
+    ARGBToUVRow(src_argb, 0, dst_u, dst_v, width);
+    ARGBToYRow(src_argb, dst_y, width);
+  }
+  INSTRUMENT_STOP("ARGBToI420",
+                  SELECT_ROW_NAME(dispatch->ARGBToYRow, width, y_aligned),
+                  width, height);
+  return 0;
+}
+
+LIBYUV_API
+int ExplainARGBToI420(const uint8* src_argb, int src_stride_argb,
+                      const uint8* dst_y, int dst_stride_y,
+                      const uint8* dst_u, int,
+                      const uint8* dst_v, int,
+                      int width, int height, KernelChoice choices[2]) {
+  if (!src_argb ||
+      !dst_y || !dst_u || !dst_v ||
+      width <= 0 || height == 0 || !choices) {
+    return -1;
+  }
+  if (height < 0) {
+    height = -height;
+    src_argb = src_argb + (height - 1) * src_stride_argb;
+    src_stride_argb = -src_stride_argb;
+  }
+  const RowDispatch* dispatch = GetRowDispatch();
+  const bool src_aligned =
+      IS_ALIGNED(src_argb, 16) && IS_ALIGNED(src_stride_argb, 16);
+  const bool y_aligned = src_aligned &&
+      IS_ALIGNED(dst_y, 16) && IS_ALIGNED(dst_stride_y, 16);
+  EXPLAIN_ROW(&choices[0], "ARGBToI420", dispatch->ARGBToYRow, width,
+              y_aligned);
+  EXPLAIN_ROW(&choices[1], "ARGBToI420", dispatch->ARGBToUVRow, width,
+              src_aligned);
+  return 0;
+}
+
+// Same as ARGBToI420 but the UV row kernel interleaves U and V as it stores
+// them, so no planar U and V are written.
+LIBYUV_API
+int ARGBToNV12(const uint8* src_argb, int src_stride_argb,
+               uint8* dst_y, int dst_stride_y,
+               uint8* dst_uv, int dst_stride_uv,
+               int width, int height) {
+  if (!src_argb ||
+      !dst_y || !dst_uv ||
+      width <= 0 || height == 0) {
+    return -1;
+  }
+  // Negative height means invert the image.
+  if (height < 0) {
+    height = -height;
+    src_argb = src_argb + (height - 1) * src_stride_argb;
+    src_stride_argb = -src_stride_argb;
+  }
   void (*ARGBToYRow)(const uint8* src_argb, uint8* dst_y, int pix);
-  void (*ARGBToUVRow)(const uint8* src_argb0, int src_stride_argb,
-                      uint8* dst_u, uint8* dst_v, int width);
+  void (*ARGBToUVInterleaveRow)(const uint8* src_argb0, int src_stride_argb,
+                                uint8* dst_uv, int width);
 
   ARGBToYRow = ARGBToYRow_C;
-  ARGBToUVRow = ARGBToUVRow_C;
-#if defined(HAS_ARGBTOYROW_SSSE3)
+  ARGBToUVInterleaveRow = ARGBToUVInterleaveRow_C;
+#if defined(HAS_ARGBTOUVINTERLEAVEROW_SSSE3)
   if (TestCpuFlag(kCpuHasSSSE3)) {
     if (width > 16) {
-      ARGBToUVRow = ARGBToUVRow_Any_SSSE3;
+      ARGBToUVInterleaveRow = ARGBToUVInterleaveRow_Any_SSSE3;
       ARGBToYRow = ARGBToYRow_Any_SSSE3;
     }
     if (IS_ALIGNED(width, 16)) {
-      ARGBToUVRow = ARGBToUVRow_Unaligned_SSSE3;
+      ARGBToUVInterleaveRow = ARGBToUVInterleaveRow_Unaligned_SSSE3;
       ARGBToYRow = ARGBToYRow_Unaligned_SSSE3;
       if (IS_ALIGNED(src_argb, 16) && IS_ALIGNED(src_stride_argb, 16)) {
-        ARGBToUVRow = ARGBToUVRow_SSSE3;
+        ARGBToUVInterleaveRow = ARGBToUVInterleaveRow_SSSE3;
         if (IS_ALIGNED(dst_y, 16) && IS_ALIGNED(dst_stride_y, 16)) {
           ARGBToYRow = ARGBToYRow_SSSE3;
         }
@@ -1021,16 +1191,15 @@ int ARGBToI420(const uint8* src_argb, int src_stride_argb,
 #endif
 
   for (int y = 0; y < height - 1; y += 2) {
-    ARGBToUVRow(src_argb, src_stride_argb, dst_u, dst_v, width);
+    ARGBToUVInterleaveRow(src_argb, src_stride_argb, dst_uv, width);
     ARGBToYRow(src_argb, dst_y, width);
     ARGBToYRow(src_argb + src_stride_argb, dst_y + dst_stride_y, width);
     src_argb += src_stride_argb * 2;
     dst_y += dst_stride_y * 2;
-    dst_u += dst_stride_u;
-    dst_v += dst_stride_v;
+    dst_uv += dst_stride_uv;
   }
   if (height & 1) {
-    ARGBToUVRow(src_argb, 0, dst_u, dst_v, width);
+    ARGBToUVInterleaveRow(src_argb, 0, dst_uv, width);
     ARGBToYRow(src_argb, dst_y, width);
   }
   return 0;
@@ -1567,6 +1736,19 @@ int ARGB4444ToI420(const uint8* src_argb4444, int src_stride_argb4444,
   return 0;
 }
 
+// Parses the frame header only, so it is available without HAVE_JPEG.
+LIBYUV_API
+int MJPGSize(const uint8* sample, size_t sample_size,
+             int* width, int* height) {
+  JpegHeader header;
+  if (!width || !height || !ParseJpegHeader(sample, sample_size, &header)) {
+    return -1;
+  }
+  *width = header.width;
+  *height = header.height;
+  return 0;
+}
+
 #ifdef HAVE_JPEG
 struct I420Buffers {
   uint8* y;
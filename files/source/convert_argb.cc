@@ -13,6 +13,7 @@
 #include <string.h>  // for memset()
 
 #include "libyuv/cpu_id.h"
+#include "libyuv/explain.h"
 #include "libyuv/format_conversion.h"
 #ifdef HAVE_JPEG
 #include "libyuv/mjpeg_decoder.h"
@@ -531,6 +532,18 @@ int NV12ToARGB(const uint8* src_y, int src_stride_y,
                const uint8* src_uv, int src_stride_uv,
                uint8* dst_argb, int dst_stride_argb,
                int width, int height) {
+  return NV12ToARGBHistogram(src_y, src_stride_y,
+                             src_uv, src_stride_uv,
+                             dst_argb, dst_stride_argb,
+                             width, height, NULL);
+}
+
+// Convert NV12 to ARGB and count the Y values while each row is in cache.
+LIBYUV_API
+int NV12ToARGBHistogram(const uint8* src_y, int src_stride_y,
+                        const uint8* src_uv, int src_stride_uv,
+                        uint8* dst_argb, int dst_stride_argb,
+                        int width, int height, uint32* histogram) {
   if (!src_y || !src_uv || !dst_argb ||
       width <= 0 || height == 0) {
     return -1;
@@ -541,38 +554,59 @@ int NV12ToARGB(const uint8* src_y, int src_stride_y,
     dst_argb = dst_argb + (height - 1) * dst_stride_argb;
     dst_stride_argb = -dst_stride_argb;
   }
-  void (*NV12ToARGBRow)(const uint8* y_buf,
-                        const uint8* uv_buf,
-                        uint8* rgb_buf,
-                        int width) = NV12ToARGBRow_C;
-#if defined(HAS_NV12TOARGBROW_SSSE3)
-  if (TestCpuFlag(kCpuHasSSSE3) && width >= 8) {
-    NV12ToARGBRow = NV12ToARGBRow_Any_SSSE3;
-    if (IS_ALIGNED(width, 8)) {
-      NV12ToARGBRow = NV12ToARGBRow_Unaligned_SSSE3;
-      if (IS_ALIGNED(dst_argb, 16) && IS_ALIGNED(dst_stride_argb, 16)) {
-        NV12ToARGBRow = NV12ToARGBRow_SSSE3;
-      }
-    }
-  }
-#endif
-#if defined(HAS_NV12TOARGBROW_NEON)
-  if (TestCpuFlag(kCpuHasNEON) && width >= 8) {
-    NV12ToARGBRow = NV12ToARGBRow_Any_NEON;
-    if (IS_ALIGNED(width, 8)) {
-      NV12ToARGBRow = NV12ToARGBRow_NEON;
-    }
-  }
-#endif
+  INSTRUMENT_START();
+  const RowDispatch* dispatch = GetRowDispatch();
+  const bool dst_aligned =
+      IS_ALIGNED(dst_argb, 16) && IS_ALIGNED(dst_stride_argb, 16);
+  NV12ToARGBRowFunction NV12ToARGBRow =
+      SELECT_ROW(dispatch->NV12ToARGBRow, width, dst_aligned);
 
+  uint32 tables[256 * 4];
+  if (histogram) {
+    memset(tables, 0, sizeof(tables));
+  }
   for (int y = 0; y < height; ++y) {
     NV12ToARGBRow(src_y, src_uv, dst_argb, width);
+    if (histogram) {
+      HistogramRow_C(src_y, tables, width);
+    }
     dst_argb += dst_stride_argb;
     src_y += src_stride_y;
     if (y & 1) {
       src_uv += src_stride_uv;
     }
   }
+  if (histogram) {
+    for (int i = 0; i < 256; ++i) {
+      histogram[i] += tables[i] + tables[256 + i] + tables[512 + i] +
+          tables[768 + i];
+    }
+  }
+  INSTRUMENT_STOP(histogram ? "NV12ToARGBHistogram" : "NV12ToARGB",
+                  SELECT_ROW_NAME(dispatch->NV12ToARGBRow, width, dst_aligned),
+                  width, height);
+  return 0;
+}
+
+LIBYUV_API
+int ExplainNV12ToARGB(const uint8* src_y, int,
+                      const uint8* src_uv, int,
+                      const uint8* dst_argb, int dst_stride_argb,
+                      int width, int height, KernelChoice* choice) {
+  if (!src_y || !src_uv || !dst_argb ||
+      width <= 0 || height == 0 || !choice) {
+    return -1;
+  }
+  if (height < 0) {
+    height = -height;
+    dst_argb = dst_argb + (height - 1) * dst_stride_argb;
+    dst_stride_argb = -dst_stride_argb;
+  }
+  const RowDispatch* dispatch = GetRowDispatch();
+  const bool dst_aligned =
+      IS_ALIGNED(dst_argb, 16) && IS_ALIGNED(dst_stride_argb, 16);
+  EXPLAIN_ROW(choice, "NV12ToARGB", dispatch->NV12ToARGBRow, width,
+              dst_aligned);
   return 0;
 }
 
@@ -592,29 +626,12 @@ int NV21ToARGB(const uint8* src_y, int src_stride_y,
     dst_argb = dst_argb + (height - 1) * dst_stride_argb;
     dst_stride_argb = -dst_stride_argb;
   }
-  void (*NV21ToARGBRow)(const uint8* y_buf,
-                        const uint8* uv_buf,
-                        uint8* rgb_buf,
-                        int width) = NV21ToARGBRow_C;
-#if defined(HAS_NV21TOARGBROW_SSSE3)
-  if (TestCpuFlag(kCpuHasSSSE3) && width >= 8) {
-    NV21ToARGBRow = NV21ToARGBRow_Any_SSSE3;
-    if (IS_ALIGNED(width, 8)) {
-      NV21ToARGBRow = NV21ToARGBRow_Unaligned_SSSE3;
-      if (IS_ALIGNED(dst_argb, 16) && IS_ALIGNED(dst_stride_argb, 16)) {
-        NV21ToARGBRow = NV21ToARGBRow_SSSE3;
-      }
-    }
-  }
-#endif
-#if defined(HAS_NV21TOARGBROW_NEON)
-  if (TestCpuFlag(kCpuHasNEON) && width >= 8) {
-    NV21ToARGBRow = NV21ToARGBRow_Any_NEON;
-    if (IS_ALIGNED(width, 8)) {
-      NV21ToARGBRow = NV21ToARGBRow_NEON;
-    }
-  }
-#endif
+  INSTRUMENT_START();
+  const RowDispatch* dispatch = GetRowDispatch();
+  const bool dst_aligned =
+      IS_ALIGNED(dst_argb, 16) && IS_ALIGNED(dst_stride_argb, 16);
+  NV12ToARGBRowFunction NV21ToARGBRow =
+      SELECT_ROW(dispatch->NV21ToARGBRow, width, dst_aligned);
 
   for (int y = 0; y < height; ++y) {
     NV21ToARGBRow(src_y, src_uv, dst_argb, width);
@@ -624,6 +641,9 @@ int NV21ToARGB(const uint8* src_y, int src_stride_y,
       src_uv += src_stride_uv;
     }
   }
+  INSTRUMENT_STOP("NV21ToARGB",
+                  SELECT_ROW_NAME(dispatch->NV21ToARGBRow, width, dst_aligned),
+                  width, height);
   return 0;
 }
 
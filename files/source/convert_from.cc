@@ -10,10 +10,15 @@
 
 #include "libyuv/convert_from.h"
 
+#include <string.h>  // For memset()
+
 #include "libyuv/basic_types.h"
 #include "libyuv/convert.h"  // For I420Copy
+#include "libyuv/convert_argb.h"  // For I420ToARGBHistogram
 #include "libyuv/cpu_id.h"
+#include "libyuv/explain.h"
 #include "libyuv/format_conversion.h"
+#include "libyuv/frame.h"
 #include "libyuv/planar_functions.h"
 #include "libyuv/rotate.h"
 #include "libyuv/video_common.h"
@@ -222,6 +227,78 @@ int I400Copy(const uint8* src_y, int src_stride_y,
   return 0;
 }
 
+LIBYUV_API
+int I420ToNV12(const uint8* src_y, int src_stride_y,
+               const uint8* src_u, int src_stride_u,
+               const uint8* src_v, int src_stride_v,
+               uint8* dst_y, int dst_stride_y,
+               uint8* dst_uv, int dst_stride_uv,
+               int width, int height) {
+  if (!src_y || !src_u || !src_v || !dst_y || !dst_uv ||
+      width <= 0 || height == 0) {
+    return -1;
+  }
+  // Negative height means invert the image.
+  if (height < 0) {
+    height = -height;
+    int halfheight = (height + 1) >> 1;
+    dst_y = dst_y + (height - 1) * dst_stride_y;
+    dst_uv = dst_uv + (halfheight - 1) * dst_stride_uv;
+    dst_stride_y = -dst_stride_y;
+    dst_stride_uv = -dst_stride_uv;
+  }
+  int halfwidth = (width + 1) >> 1;
+  void (*MergeUV)(const uint8* src_u, const uint8* src_v, uint8* dst_uv,
+                  int width) = MergeUV_C;
+#if defined(HAS_MERGEUV_SSE2)
+  if (TestCpuFlag(kCpuHasSSE2) && halfwidth >= 16) {
+    MergeUV = MergeUV_Any_SSE2;
+    if (IS_ALIGNED(halfwidth, 16)) {
+      MergeUV = MergeUV_Unaligned_SSE2;
+      if (IS_ALIGNED(src_u, 16) && IS_ALIGNED(src_stride_u, 16) &&
+          IS_ALIGNED(src_v, 16) && IS_ALIGNED(src_stride_v, 16) &&
+          IS_ALIGNED(dst_uv, 16) && IS_ALIGNED(dst_stride_uv, 16)) {
+        MergeUV = MergeUV_SSE2;
+      }
+    }
+  }
+#elif defined(HAS_MERGEUV_NEON)
+  if (TestCpuFlag(kCpuHasNEON) && halfwidth >= 16) {
+    MergeUV = MergeUV_Any_NEON;
+    if (IS_ALIGNED(halfwidth, 16)) {
+      MergeUV = MergeUV_NEON;
+    }
+  }
+#endif
+
+  CopyPlane(src_y, src_stride_y, dst_y, dst_stride_y, width, height);
+
+  int halfheight = (height + 1) >> 1;
+  for (int y = 0; y < halfheight; ++y) {
+    // Merge a row of U and V into a row of UV.
+    MergeUV(src_u, src_v, dst_uv, halfwidth);
+    src_u += src_stride_u;
+    src_v += src_stride_v;
+    dst_uv += dst_stride_uv;
+  }
+  return 0;
+}
+
+LIBYUV_API
+int I420ToNV21(const uint8* src_y, int src_stride_y,
+               const uint8* src_u, int src_stride_u,
+               const uint8* src_v, int src_stride_v,
+               uint8* dst_y, int dst_stride_y,
+               uint8* dst_vu, int dst_stride_vu,
+               int width, int height) {
+  return I420ToNV12(src_y, src_stride_y,
+                    src_v, src_stride_v,
+                    src_u, src_stride_u,
+                    dst_y, dst_stride_y,
+                    dst_vu, dst_stride_vu,
+                    width, height);
+}
+
 // YUY2 - Macro-pixel = 2 image pixels
 // Y0U0Y1V0....Y2U2Y3V2...Y4U4Y5V4....
 
@@ -686,6 +763,20 @@ int I420ToARGB(const uint8* src_y, int src_stride_y,
                const uint8* src_v, int src_stride_v,
                uint8* dst_argb, int dst_stride_argb,
                int width, int height) {
+  return I420ToARGBHistogram(src_y, src_stride_y,
+                             src_u, src_stride_u,
+                             src_v, src_stride_v,
+                             dst_argb, dst_stride_argb,
+                             width, height, NULL);
+}
+
+// Convert I420 to ARGB and count the Y values while each row is in cache.
+LIBYUV_API
+int I420ToARGBHistogram(const uint8* src_y, int src_stride_y,
+                        const uint8* src_u, int src_stride_u,
+                        const uint8* src_v, int src_stride_v,
+                        uint8* dst_argb, int dst_stride_argb,
+                        int width, int height, uint32* histogram) {
   if (!src_y || !src_u || !src_v || !dst_argb ||
       width <= 0 || height == 0) {
     return -1;
@@ -696,32 +787,22 @@ int I420ToARGB(const uint8* src_y, int src_stride_y,
     dst_argb = dst_argb + (height - 1) * dst_stride_argb;
     dst_stride_argb = -dst_stride_argb;
   }
-  void (*I422ToARGBRow)(const uint8* y_buf,
-                        const uint8* u_buf,
-                        const uint8* v_buf,
-                        uint8* rgb_buf,
-                        int width) = I422ToARGBRow_C;
-#if defined(HAS_I422TOARGBROW_NEON)
-  if (TestCpuFlag(kCpuHasNEON)) {
-    I422ToARGBRow = I422ToARGBRow_Any_NEON;
-    if (IS_ALIGNED(width, 16)) {
-      I422ToARGBRow = I422ToARGBRow_NEON;
-    }
-  }
-#elif defined(HAS_I422TOARGBROW_SSSE3)
-  if (TestCpuFlag(kCpuHasSSSE3) && width >= 8) {
-    I422ToARGBRow = I422ToARGBRow_Any_SSSE3;
-    if (IS_ALIGNED(width, 8)) {
-      I422ToARGBRow = I422ToARGBRow_Unaligned_SSSE3;
-      if (IS_ALIGNED(dst_argb, 16) && IS_ALIGNED(dst_stride_argb, 16)) {
-        I422ToARGBRow = I422ToARGBRow_SSSE3;
-      }
-    }
-  }
-#endif
+  INSTRUMENT_START();
+  const RowDispatch* dispatch = GetRowDispatch();
+  const bool dst_aligned =
+      IS_ALIGNED(dst_argb, 16) && IS_ALIGNED(dst_stride_argb, 16);
+  I422ToARGBRowFunction I422ToARGBRow =
+      SELECT_ROW(dispatch->I422ToARGBRow, width, dst_aligned);
 
+  uint32 tables[256 * 4];
+  if (histogram) {
+    memset(tables, 0, sizeof(tables));
+  }
   for (int y = 0; y < height; ++y) {
     I422ToARGBRow(src_y, src_u, src_v, dst_argb, width);
+    if (histogram) {
+      HistogramRow_C(src_y, tables, width);
+    }
     dst_argb += dst_stride_argb;
     src_y += src_stride_y;
     if (y & 1) {
@@ -729,6 +810,132 @@ int I420ToARGB(const uint8* src_y, int src_stride_y,
       src_v += src_stride_v;
     }
   }
+  if (histogram) {
+    for (int i = 0; i < 256; ++i) {
+      histogram[i] += tables[i] + tables[256 + i] + tables[512 + i] +
+          tables[768 + i];
+    }
+  }
+  INSTRUMENT_STOP(histogram ? "I420ToARGBHistogram" : "I420ToARGB",
+                  SELECT_ROW_NAME(dispatch->I422ToARGBRow, width, dst_aligned),
+                  width, height);
+  return 0;
+}
+
+LIBYUV_API
+int ExplainI420ToARGB(const uint8* src_y, int,
+                      const uint8* src_u, int,
+                      const uint8* src_v, int,
+                      const uint8* dst_argb, int dst_stride_argb,
+                      int width, int height, KernelChoice* choice) {
+  if (!src_y || !src_u || !src_v || !dst_argb ||
+      width <= 0 || height == 0 || !choice) {
+    return -1;
+  }
+  if (height < 0) {
+    height = -height;
+    dst_argb = dst_argb + (height - 1) * dst_stride_argb;
+    dst_stride_argb = -dst_stride_argb;
+  }
+  const RowDispatch* dispatch = GetRowDispatch();
+  const bool dst_aligned =
+      IS_ALIGNED(dst_argb, 16) && IS_ALIGNED(dst_stride_argb, 16);
+  EXPLAIN_ROW(choice, "I420ToARGB", dispatch->I422ToARGBRow, width,
+              dst_aligned);
+  return 0;
+}
+
+// Whether frame still has the planes and strides AllocFrame gave it, so
+// each row has padding up to the next kFrameAlignment bytes.
+static bool HasFrameLayout(const YuvFrame& frame) {
+  YuvFrame layout;
+  if (!frame.buffer || InitFrame(&layout, frame.fourcc, frame.width,
+                                 frame.height, frame.buffer) != 0) {
+    return false;
+  }
+  for (int i = 0; i < 3; ++i) {
+    if (frame.plane[i] != layout.plane[i] ||
+        frame.stride[i] != layout.stride[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+struct I420ToARGBBatchParam {
+  const RowDispatch* dispatch;
+  const YuvFrame* src_frames;
+  YuvFrame* dst_frames;
+};
+
+// Converts frames first to first + count - 1, as a band of RunFrameBands.
+static void I420ToARGBFrames(void* param, int first, int count) {
+  const I420ToARGBBatchParam* p =
+      static_cast<const I420ToARGBBatchParam*>(param);
+  const int* width_masks = p->dispatch->I422ToARGBRow.width_mask;
+  for (int i = first; i < first + count; ++i) {
+    const YuvFrame& src = p->src_frames[i];
+    const YuvFrame& dst = p->dst_frames[i];
+    INSTRUMENT_START();
+    int width = src.width;
+    // The step of the tier of SIMD variants that takes width.
+    const int width_mask =
+        width > width_masks[0] ? width_masks[0] : width_masks[1];
+    // Frames laid out by AllocFrame have room in their strides for whole
+    // SIMD steps, so a row that would need the Any version runs the full
+    // version over the padding instead.
+    if (width > width_mask && (width & width_mask) &&
+        HasFrameLayout(src) && HasFrameLayout(dst)) {
+      width = (width + width_mask) & ~width_mask;
+    }
+    const bool dst_aligned =
+        IS_ALIGNED(dst.plane[0], 16) && IS_ALIGNED(dst.stride[0], 16);
+    I422ToARGBRowFunction I422ToARGBRow =
+        SELECT_ROW(p->dispatch->I422ToARGBRow, width, dst_aligned);
+    const uint8* src_y = src.plane[0];
+    const uint8* src_u = src.plane[1];
+    const uint8* src_v = src.plane[2];
+    uint8* dst_argb = dst.plane[0];
+    for (int y = 0; y < src.height; ++y) {
+      I422ToARGBRow(src_y, src_u, src_v, dst_argb, width);
+      dst_argb += dst.stride[0];
+      src_y += src.stride[0];
+      if (y & 1) {
+        src_u += src.stride[1];
+        src_v += src.stride[2];
+      }
+    }
+    // Each frame is its own call, so the kernel recorded is the one its
+    // width and alignment chose.
+    INSTRUMENT_STOP("I420ToARGBBatch",
+                    SELECT_ROW_NAME(p->dispatch->I422ToARGBRow, width,
+                                    dst_aligned),
+                    src.width, src.height);
+  }
+}
+
+// Convert I420 frames to ARGB frames of the same size.
+LIBYUV_API
+int I420ToARGBBatch(const YuvFrame* src_frames, YuvFrame* dst_frames,
+                    int count, int num_threads) {
+  if (!src_frames || !dst_frames || count <= 0) {
+    return -1;
+  }
+  for (int i = 0; i < count; ++i) {
+    const YuvFrame& src = src_frames[i];
+    const YuvFrame& dst = dst_frames[i];
+    if (src.fourcc != FOURCC_I420 || dst.fourcc != FOURCC_ARGB ||
+        !src.plane[0] || !src.plane[1] || !src.plane[2] || !dst.plane[0] ||
+        src.width <= 0 || src.height <= 0 ||
+        dst.width != src.width || dst.height != src.height) {
+      return -1;
+    }
+  }
+  I420ToARGBBatchParam p;
+  p.dispatch = GetRowDispatch();
+  p.src_frames = src_frames;
+  p.dst_frames = dst_frames;
+  RunFrameBands(I420ToARGBFrames, &p, count, num_threads);
   return 0;
 }
 
@@ -1020,39 +1227,96 @@ int I420ToRGB565(const uint8* src_y, int src_stride_y,
     dst_rgb = dst_rgb + (height - 1) * dst_stride_rgb;
     dst_stride_rgb = -dst_stride_rgb;
   }
-  void (*I422ToARGBRow)(const uint8* y_buf,
-                        const uint8* u_buf,
-                        const uint8* v_buf,
-                        uint8* rgb_buf,
-                        int width) = I422ToARGBRow_C;
-#if defined(HAS_I422TOARGBROW_NEON)
-  if (TestCpuFlag(kCpuHasNEON)) {
-    I422ToARGBRow = I422ToARGBRow_NEON;
-  }
-#elif defined(HAS_I422TOARGBROW_SSSE3)
+  void (*I422ToRGB565Row)(const uint8* y_buf,
+                          const uint8* u_buf,
+                          const uint8* v_buf,
+                          uint8* rgb_buf,
+                          int width) = I422ToRGB565Row_C;
+#if defined(HAS_I422TORGB565ROW_SSSE3)
   if (TestCpuFlag(kCpuHasSSSE3)) {
-    I422ToARGBRow = I422ToARGBRow_SSSE3;
+    I422ToRGB565Row = I422ToRGB565Row_Any_SSSE3;
+    if (IS_ALIGNED(width, 8)) {
+      I422ToRGB565Row = I422ToRGB565Row_SSSE3;
+    }
+  }
+#elif defined(HAS_I422TORGB565ROW_NEON)
+  if (TestCpuFlag(kCpuHasNEON)) {
+    I422ToRGB565Row = I422ToRGB565Row_Any_NEON;
+    if (IS_ALIGNED(width, 8)) {
+      I422ToRGB565Row = I422ToRGB565Row_NEON;
+    }
   }
 #endif
 
-  SIMD_ALIGNED(uint8 row[kMaxStride]);
-  void (*ARGBToRGB565Row)(const uint8* src_rgb, uint8* dst_rgb, int pix) =
-      ARGBToRGB565Row_C;
-#if defined(HAS_ARGBTORGB565ROW_SSE2)
-  if (TestCpuFlag(kCpuHasSSE2)) {
-    if (width * 2 <= kMaxStride) {
-      ARGBToRGB565Row = ARGBToRGB565Row_Any_SSE2;
+  for (int y = 0; y < height; ++y) {
+    I422ToRGB565Row(src_y, src_u, src_v, dst_rgb, width);
+    dst_rgb += dst_stride_rgb;
+    src_y += src_stride_y;
+    if (y & 1) {
+      src_u += src_stride_u;
+      src_v += src_stride_v;
     }
-    if (IS_ALIGNED(width, 4)) {
-      ARGBToRGB565Row = ARGBToRGB565Row_SSE2;
+  }
+  return 0;
+}
+
+// Ordered dither for RGB565, added to B, G and R before truncating.
+static const uint8 kDither565_4x4[16] = {
+  0, 4, 1, 5,
+  6, 2, 7, 3,
+  1, 5, 0, 4,
+  7, 3, 6, 2,
+};
+
+// Convert I420 to RGB565 with a 4x4 dither matrix.
+LIBYUV_API
+int I420ToRGB565Dither(const uint8* src_y, int src_stride_y,
+                       const uint8* src_u, int src_stride_u,
+                       const uint8* src_v, int src_stride_v,
+                       uint8* dst_rgb565, int dst_stride_rgb565,
+                       const uint8* dither4x4, int width, int height) {
+  if (!src_y || !src_u || !src_v ||
+      !dst_rgb565 ||
+      width <= 0 || height == 0) {
+    return -1;
+  }
+  // Negative height means invert the image.
+  if (height < 0) {
+    height = -height;
+    dst_rgb565 = dst_rgb565 + (height - 1) * dst_stride_rgb565;
+    dst_stride_rgb565 = -dst_stride_rgb565;
+  }
+  if (!dither4x4) {
+    dither4x4 = kDither565_4x4;
+  }
+  void (*I422ToRGB565DitherRow)(const uint8* y_buf,
+                                const uint8* u_buf,
+                                const uint8* v_buf,
+                                uint8* rgb_buf,
+                                uint32 dither4,
+                                int width) = I422ToRGB565DitherRow_C;
+#if defined(HAS_I422TORGB565ROW_SSSE3)
+  if (TestCpuFlag(kCpuHasSSSE3)) {
+    I422ToRGB565DitherRow = I422ToRGB565DitherRow_Any_SSSE3;
+    if (IS_ALIGNED(width, 8)) {
+      I422ToRGB565DitherRow = I422ToRGB565DitherRow_SSSE3;
+    }
+  }
+#elif defined(HAS_I422TORGB565ROW_NEON)
+  if (TestCpuFlag(kCpuHasNEON)) {
+    I422ToRGB565DitherRow = I422ToRGB565DitherRow_Any_NEON;
+    if (IS_ALIGNED(width, 8)) {
+      I422ToRGB565DitherRow = I422ToRGB565DitherRow_NEON;
     }
   }
 #endif
 
   for (int y = 0; y < height; ++y) {
-    I422ToARGBRow(src_y, src_u, src_v, row, width);
-    ARGBToRGB565Row(row, dst_rgb, width);
-    dst_rgb += dst_stride_rgb;
+    const uint8* d = dither4x4 + ((y & 3) << 2);
+    uint32 dither4 = d[0] | (d[1] << 8) | (d[2] << 16) |
+                     (static_cast<uint32>(d[3]) << 24);
+    I422ToRGB565DitherRow(src_y, src_u, src_v, dst_rgb565, dither4, width);
+    dst_rgb565 += dst_stride_rgb565;
     src_y += src_stride_y;
     if (y & 1) {
       src_u += src_stride_u;
@@ -1080,38 +1344,29 @@ int I420ToARGB1555(const uint8* src_y, int src_stride_y,
     dst_argb = dst_argb + (height - 1) * dst_stride_argb;
     dst_stride_argb = -dst_stride_argb;
   }
-  void (*I422ToARGBRow)(const uint8* y_buf,
-                        const uint8* u_buf,
-                        const uint8* v_buf,
-                        uint8* rgb_buf,
-                        int width) = I422ToARGBRow_C;
-#if defined(HAS_I422TOARGBROW_NEON)
-  if (TestCpuFlag(kCpuHasNEON)) {
-    I422ToARGBRow = I422ToARGBRow_NEON;
-  }
-#elif defined(HAS_I422TOARGBROW_SSSE3)
+  void (*I422ToARGB1555Row)(const uint8* y_buf,
+                            const uint8* u_buf,
+                            const uint8* v_buf,
+                            uint8* rgb_buf,
+                            int width) = I422ToARGB1555Row_C;
+#if defined(HAS_I422TORGB565ROW_SSSE3)
   if (TestCpuFlag(kCpuHasSSSE3)) {
-    I422ToARGBRow = I422ToARGBRow_SSSE3;
-  }
-#endif
-
-  SIMD_ALIGNED(uint8 row[kMaxStride]);
-  void (*ARGBToARGB1555Row)(const uint8* src_argb, uint8* dst_rgb, int pix) =
-      ARGBToARGB1555Row_C;
-#if defined(HAS_ARGBTOARGB1555ROW_SSE2)
-  if (TestCpuFlag(kCpuHasSSE2)) {
-    if (width * 2 <= kMaxStride) {
-      ARGBToARGB1555Row = ARGBToARGB1555Row_Any_SSE2;
+    I422ToARGB1555Row = I422ToARGB1555Row_Any_SSSE3;
+    if (IS_ALIGNED(width, 8)) {
+      I422ToARGB1555Row = I422ToARGB1555Row_SSSE3;
     }
-    if (IS_ALIGNED(width, 4)) {
-      ARGBToARGB1555Row = ARGBToARGB1555Row_SSE2;
+  }
+#elif defined(HAS_I422TORGB565ROW_NEON)
+  if (TestCpuFlag(kCpuHasNEON)) {
+    I422ToARGB1555Row = I422ToARGB1555Row_Any_NEON;
+    if (IS_ALIGNED(width, 8)) {
+      I422ToARGB1555Row = I422ToARGB1555Row_NEON;
     }
   }
 #endif
 
   for (int y = 0; y < height; ++y) {
-    I422ToARGBRow(src_y, src_u, src_v, row, width);
-    ARGBToARGB1555Row(row, dst_argb, width);
+    I422ToARGB1555Row(src_y, src_u, src_v, dst_argb, width);
     dst_argb += dst_stride_argb;
     src_y += src_stride_y;
     if (y & 1) {
@@ -1140,38 +1395,29 @@ int I420ToARGB4444(const uint8* src_y, int src_stride_y,
     dst_argb = dst_argb + (height - 1) * dst_stride_argb;
     dst_stride_argb = -dst_stride_argb;
   }
-  void (*I422ToARGBRow)(const uint8* y_buf,
-                        const uint8* u_buf,
-                        const uint8* v_buf,
-                        uint8* rgb_buf,
-                        int width) = I422ToARGBRow_C;
-#if defined(HAS_I422TOARGBROW_NEON)
-  if (TestCpuFlag(kCpuHasNEON)) {
-    I422ToARGBRow = I422ToARGBRow_NEON;
-  }
-#elif defined(HAS_I422TOARGBROW_SSSE3)
+  void (*I422ToARGB4444Row)(const uint8* y_buf,
+                            const uint8* u_buf,
+                            const uint8* v_buf,
+                            uint8* rgb_buf,
+                            int width) = I422ToARGB4444Row_C;
+#if defined(HAS_I422TORGB565ROW_SSSE3)
   if (TestCpuFlag(kCpuHasSSSE3)) {
-    I422ToARGBRow = I422ToARGBRow_SSSE3;
-  }
-#endif
-
-  SIMD_ALIGNED(uint8 row[kMaxStride]);
-  void (*ARGBToARGB4444Row)(const uint8* src_argb, uint8* dst_rgb, int pix) =
-     ARGBToARGB4444Row_C;
-#if defined(HAS_ARGBTOARGB4444ROW_SSE2)
-  if (TestCpuFlag(kCpuHasSSE2)) {
-    if (width * 2 <= kMaxStride) {
-      ARGBToARGB4444Row = ARGBToARGB4444Row_Any_SSE2;
+    I422ToARGB4444Row = I422ToARGB4444Row_Any_SSSE3;
+    if (IS_ALIGNED(width, 8)) {
+      I422ToARGB4444Row = I422ToARGB4444Row_SSSE3;
     }
-    if (IS_ALIGNED(width, 4)) {
-      ARGBToARGB4444Row = ARGBToARGB4444Row_SSE2;
+  }
+#elif defined(HAS_I422TORGB565ROW_NEON)
+  if (TestCpuFlag(kCpuHasNEON)) {
+    I422ToARGB4444Row = I422ToARGB4444Row_Any_NEON;
+    if (IS_ALIGNED(width, 8)) {
+      I422ToARGB4444Row = I422ToARGB4444Row_NEON;
     }
   }
 #endif
 
   for (int y = 0; y < height; ++y) {
-    I422ToARGBRow(src_y, src_u, src_v, row, width);
-    ARGBToARGB4444Row(row, dst_argb, width);
+    I422ToARGB4444Row(src_y, src_u, src_v, dst_argb, width);
     dst_argb += dst_stride_argb;
     src_y += src_stride_y;
     if (y & 1) {
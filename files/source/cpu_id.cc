@@ -13,6 +13,9 @@
 #ifdef _MSC_VER
 #include <intrin.h>  // For __cpuid()
 #endif
+#if defined(_WIN32)
+#include <windows.h>  // For InterlockedCompareExchange()
+#endif
 #if !defined(__CLR_VER) && defined(_M_X64) && \
     defined(_MSC_VER) && (_MSC_FULL_VER >= 160040219)
 #include <immintrin.h>  // For _xgetbv()
@@ -34,14 +37,14 @@ static __inline void __cpuid(int cpu_info[4], int info_type) {
     "cpuid                                     \n"
     "xchg %%edi, %%ebx                         \n"
     : "=a"(cpu_info[0]), "=D"(cpu_info[1]), "=c"(cpu_info[2]), "=d"(cpu_info[3])
-    : "a"(info_type));
+    : "a"(info_type), "c"(0));  // Sub leaf 0 for leaf 7.
 }
 #elif defined(__i386__) || defined(__x86_64__)
 static __inline void __cpuid(int cpu_info[4], int info_type) {
   asm volatile (  // NOLINT
     "cpuid                                     \n"
     : "=a"(cpu_info[0]), "=b"(cpu_info[1]), "=c"(cpu_info[2]), "=d"(cpu_info[3])
-    : "a"(info_type));
+    : "a"(info_type), "c"(0));  // Sub leaf 0 for leaf 7.
 }
 #endif
 
@@ -136,76 +139,138 @@ static bool TestEnv(const char* name) {
   return false;
 }
 
-LIBYUV_API
-int InitCpuFlags(void) {
+// Reads the cpu flags without storing them.
+static int DetectCpuFlags(void) {
+  int cpu_flags = 0;
 #if !defined(__CLR_VER) && defined(CPU_X86)
   int cpu_info[4];
   __cpuid(cpu_info, 1);
-  cpu_info_ = ((cpu_info[3] & 0x04000000) ? kCpuHasSSE2 : 0) |
+  cpu_flags = ((cpu_info[3] & 0x04000000) ? kCpuHasSSE2 : 0) |
               ((cpu_info[2] & 0x00000200) ? kCpuHasSSSE3 : 0) |
               ((cpu_info[2] & 0x00080000) ? kCpuHasSSE41 : 0) |
               ((cpu_info[2] & 0x00100000) ? kCpuHasSSE42 : 0) |
               (((cpu_info[2] & 0x18000000) == 0x18000000) ? kCpuHasAVX : 0) |
               kCpuInitialized | kCpuHasX86;
 #ifdef HAS_XGETBV
-  if (cpu_info_ & kCpuHasAVX) {
+  if (cpu_flags & kCpuHasAVX) {
     __cpuid(cpu_info, 7);
     if ((cpu_info[1] & 0x00000020) &&
         ((XGetBV(kXCR_XFEATURE_ENABLED_MASK) & 0x06) == 0x06)) {
-      cpu_info_ |= kCpuHasAVX2;
+      cpu_flags |= kCpuHasAVX2;
     }
   }
 #endif
   // environment variable overrides for testing.
   if (TestEnv("LIBYUV_DISABLE_X86")) {
-    cpu_info_ &= ~kCpuHasX86;
+    cpu_flags &= ~kCpuHasX86;
   }
   if (TestEnv("LIBYUV_DISABLE_SSE2")) {
-    cpu_info_ &= ~kCpuHasSSE2;
+    cpu_flags &= ~kCpuHasSSE2;
   }
   if (TestEnv("LIBYUV_DISABLE_SSSE3")) {
-    cpu_info_ &= ~kCpuHasSSSE3;
+    cpu_flags &= ~kCpuHasSSSE3;
   }
   if (TestEnv("LIBYUV_DISABLE_SSE41")) {
-    cpu_info_ &= ~kCpuHasSSE41;
+    cpu_flags &= ~kCpuHasSSE41;
   }
   if (TestEnv("LIBYUV_DISABLE_SSE42")) {
-    cpu_info_ &= ~kCpuHasSSE42;
+    cpu_flags &= ~kCpuHasSSE42;
   }
   if (TestEnv("LIBYUV_DISABLE_AVX")) {
-    cpu_info_ &= ~kCpuHasAVX;
+    cpu_flags &= ~kCpuHasAVX;
   }
   if (TestEnv("LIBYUV_DISABLE_AVX2")) {
-    cpu_info_ &= ~kCpuHasAVX2;
+    cpu_flags &= ~kCpuHasAVX2;
   }
   if (TestEnv("LIBYUV_DISABLE_ASM")) {
-    cpu_info_ = kCpuInitialized;
+    cpu_flags = kCpuInitialized;
   }
 #elif defined(__arm__)
 #if defined(__linux__) && (defined(__ARM_NEON__) || defined(LIBYUV_NEON))
   // linux arm parse text file for neon detect.
-  cpu_info_ = ArmCpuCaps("/proc/cpuinfo");
+  cpu_flags = ArmCpuCaps("/proc/cpuinfo");
 #elif defined(__ARM_NEON__)
   // gcc -mfpu=neon defines __ARM_NEON__
   // Enable Neon if you want support for Neon and Arm, and use MaskCpuFlags
   // to disable Neon on devices that do not have it.
-  cpu_info_ = kCpuHasNEON;
+  cpu_flags = kCpuHasNEON;
 #endif
-  cpu_info_ |= kCpuInitialized | kCpuHasARM;
+  cpu_flags |= kCpuInitialized | kCpuHasARM;
   if (TestEnv("LIBYUV_DISABLE_NEON")) {
-    cpu_info_ &= ~kCpuHasNEON;
+    cpu_flags &= ~kCpuHasNEON;
   }
   if (TestEnv("LIBYUV_DISABLE_ASM")) {
-    cpu_info_ = kCpuInitialized;
+    cpu_flags = kCpuInitialized;
   }
 #endif  // __arm__
-  return cpu_info_;
+  return cpu_flags;
+}
+
+// Threads that race here detect the same flags and the first to store them
+// wins, so a MaskCpuFlags that happens meanwhile is kept.
+LIBYUV_API
+int InitCpuFlags(void) {
+  const int cpu_flags = DetectCpuFlags();
+#if defined(_WIN32)
+  const int previous = static_cast<int>(InterlockedCompareExchange(
+      reinterpret_cast<volatile LONG*>(&cpu_info_), cpu_flags, 0));
+#elif defined(__GNUC__)
+  const int previous = __sync_val_compare_and_swap(&cpu_info_, 0, cpu_flags);
+#else
+  const int previous = cpu_info_;
+  if (!previous) {
+    cpu_info_ = cpu_flags;
+  }
+#endif
+  return previous ? previous : cpu_flags;
 }
 
 LIBYUV_API
 void MaskCpuFlags(int enable_flags) {
-  InitCpuFlags();
-  cpu_info_ = (cpu_info_ & enable_flags) | kCpuInitialized;
+  const int cpu_flags = (DetectCpuFlags() & enable_flags) | kCpuInitialized;
+#if defined(_WIN32)
+  InterlockedExchange(reinterpret_cast<volatile LONG*>(&cpu_info_), cpu_flags);
+#elif defined(__GNUC__)
+  __sync_lock_test_and_set(&cpu_info_, cpu_flags);
+  __sync_synchronize();
+#else
+  cpu_info_ = cpu_flags;
+#endif
+}
+
+// Set once any thread has a mask, so TestCpuFlag only looks up the mask of
+// its thread when masks are in use.
+LIBYUV_API
+int cpu_thread_masks_ = 0;
+
+#if defined(_MSC_VER)
+static __declspec(thread) int thread_cpu_mask_ = -1;
+#elif defined(__GNUC__)
+static __thread int thread_cpu_mask_ = -1;
+#else
+// Without thread local storage the mask applies to all threads.
+static int thread_cpu_mask_ = -1;
+#endif
+
+LIBYUV_API
+void SetThreadCpuMask(int enable_flags) {
+  thread_cpu_mask_ = enable_flags | kCpuInitialized;
+  if (enable_flags != -1 && !LIBYUV_LOAD_CPU_INFO(&cpu_thread_masks_)) {
+#if defined(_WIN32)
+    InterlockedExchange(reinterpret_cast<volatile LONG*>(&cpu_thread_masks_),
+                        1);
+#elif defined(__GNUC__)
+    __sync_lock_test_and_set(&cpu_thread_masks_, 1);
+    __sync_synchronize();
+#else
+    cpu_thread_masks_ = 1;
+#endif
+  }
+}
+
+LIBYUV_API
+int GetThreadCpuMask(void) {
+  return thread_cpu_mask_;
 }
 
 #ifdef __cplusplus
@@ -0,0 +1,255 @@
+/*
+ *  Copyright 2012 The LibYuv Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "libyuv/frame.h"
+
+#include <string.h>  // For memset()
+
+#include "libyuv/row.h"  // For IS_ALIGNED
+#include "libyuv/video_common.h"
+
+#ifdef __cplusplus
+namespace libyuv {
+extern "C" {
+#endif
+
+static size_t AlignUp(size_t n) {
+  return (n + kFrameAlignment - 1) & ~static_cast<size_t>(kFrameAlignment - 1);
+}
+
+// Fills the strides and plane sizes of a format. Returns the number of
+// planes, or 0 if the format or size is not supported.
+static int FrameLayout(uint32 fourcc, int width, int height,
+                       int stride[3], size_t plane_size[3]) {
+  // Keeps the offset of the last row of a plane inside an int, as row
+  // pointers are computed with int strides.
+  if (width <= 0 || height <= 0 || width > 16384 || height > 16384) {
+    return 0;
+  }
+  const int halfwidth = (width + 1) >> 1;
+  const int halfheight = (height + 1) >> 1;
+  int num_planes = 0;
+  switch (fourcc) {
+    case FOURCC_I420:
+      stride[0] = static_cast<int>(AlignUp(width));
+      stride[1] = static_cast<int>(AlignUp(halfwidth));
+      stride[2] = stride[1];
+      plane_size[0] = static_cast<size_t>(stride[0]) * height;
+      plane_size[1] = static_cast<size_t>(stride[1]) * halfheight;
+      plane_size[2] = plane_size[1];
+      num_planes = 3;
+      break;
+    case FOURCC_NV12:
+      stride[0] = static_cast<int>(AlignUp(width));
+      stride[1] = static_cast<int>(AlignUp(halfwidth * 2));
+      plane_size[0] = static_cast<size_t>(stride[0]) * height;
+      plane_size[1] = static_cast<size_t>(stride[1]) * halfheight;
+      num_planes = 2;
+      break;
+    case FOURCC_ARGB:
+      stride[0] = static_cast<int>(AlignUp(width * 4));
+      plane_size[0] = static_cast<size_t>(stride[0]) * height;
+      num_planes = 1;
+      break;
+    default:
+      return 0;
+  }
+  for (int i = num_planes; i < 3; ++i) {
+    stride[i] = 0;
+    plane_size[i] = 0;
+  }
+  return num_planes;
+}
+
+LIBYUV_API
+size_t FrameBufferSize(uint32 fourcc, int width, int height) {
+  int stride[3];
+  size_t plane_size[3];
+  const int num_planes = FrameLayout(fourcc, width, height, stride,
+                                     plane_size);
+  size_t size = 0;
+  for (int i = 0; i < num_planes; ++i) {
+    size += AlignUp(plane_size[i] + kFramePadding);
+  }
+  return size;
+}
+
+LIBYUV_API
+int InitFrame(YuvFrame* frame, uint32 fourcc, int width, int height,
+              uint8* buffer) {
+  int stride[3];
+  size_t plane_size[3];
+  const int num_planes = FrameLayout(fourcc, width, height, stride,
+                                     plane_size);
+  if (!frame || !buffer || !num_planes ||
+      !IS_ALIGNED(buffer, kFrameAlignment)) {
+    return -1;
+  }
+  memset(frame, 0, sizeof(*frame));
+  frame->fourcc = fourcc;
+  frame->width = width;
+  frame->height = height;
+  uint8* plane = buffer;
+  for (int i = 0; i < num_planes; ++i) {
+    frame->plane[i] = plane;
+    frame->stride[i] = stride[i];
+    plane += AlignUp(plane_size[i] + kFramePadding);
+  }
+  frame->size = plane - buffer;
+  return 0;
+}
+
+// The pointer new[] returned is kept in front of the aligned buffer.
+static uint8* AllocAligned(size_t size) {
+  uint8* memory = new uint8[size + sizeof(uint8*) + kFrameAlignment - 1];
+  uint8* buffer = ALIGNP(memory + sizeof(uint8*), kFrameAlignment);
+  reinterpret_cast<uint8**>(buffer)[-1] = memory;
+  return buffer;
+}
+
+static void FreeAligned(uint8* buffer) {
+  delete[] reinterpret_cast<uint8**>(buffer)[-1];
+}
+
+LIBYUV_API
+int AllocFrame(YuvFrame* frame, uint32 fourcc, int width, int height) {
+  const size_t size = FrameBufferSize(fourcc, width, height);
+  if (!frame || !size) {
+    return -1;
+  }
+  uint8* buffer = AllocAligned(size);
+  InitFrame(frame, fourcc, width, height, buffer);
+  frame->buffer = buffer;
+  return 0;
+}
+
+LIBYUV_API
+int FreeFrame(YuvFrame* frame) {
+  if (!frame) {
+    return -1;
+  }
+  if (frame->buffer) {
+    FreeAligned(frame->buffer);
+  }
+  memset(frame, 0, sizeof(*frame));
+  return 0;
+}
+
+// Free frames of one format and size. Each free buffer holds the pointer to
+// the next one in its first bytes, so the list needs no memory of its own.
+struct FrameList {
+  uint32 fourcc;
+  int width;
+  int height;
+  int num_frames;
+  uint8* first;
+  FrameList* next;
+};
+
+struct FramePool {
+  int max_frames;
+  FrameList* lists;
+};
+
+static FrameList* FindFrameList(FramePool* pool, uint32 fourcc,
+                                int width, int height) {
+  for (FrameList* list = pool->lists; list; list = list->next) {
+    if (list->fourcc == fourcc && list->width == width &&
+        list->height == height) {
+      return list;
+    }
+  }
+  return NULL;
+}
+
+LIBYUV_API
+FramePool* CreateFramePool(int max_frames) {
+  if (max_frames < 0) {
+    return NULL;
+  }
+  FramePool* pool = new FramePool;
+  pool->max_frames = max_frames;
+  pool->lists = NULL;
+  return pool;
+}
+
+LIBYUV_API
+void DestroyFramePool(FramePool* pool) {
+  if (!pool) {
+    return;
+  }
+  FrameList* list = pool->lists;
+  while (list) {
+    uint8* buffer = list->first;
+    while (buffer) {
+      uint8* next = *reinterpret_cast<uint8**>(buffer);
+      FreeAligned(buffer);
+      buffer = next;
+    }
+    FrameList* next = list->next;
+    delete list;
+    list = next;
+  }
+  delete pool;
+}
+
+LIBYUV_API
+int AcquireFrame(FramePool* pool, YuvFrame* frame,
+                 uint32 fourcc, int width, int height) {
+  if (!pool) {
+    return -1;
+  }
+  FrameList* list = FindFrameList(pool, fourcc, width, height);
+  if (!list || !list->first) {
+    return AllocFrame(frame, fourcc, width, height);
+  }
+  if (!frame) {
+    return -1;
+  }
+  uint8* buffer = list->first;
+  list->first = *reinterpret_cast<uint8**>(buffer);
+  --list->num_frames;
+  InitFrame(frame, fourcc, width, height, buffer);
+  frame->buffer = buffer;
+  return 0;
+}
+
+LIBYUV_API
+int ReleaseFrame(FramePool* pool, YuvFrame* frame) {
+  if (!pool || !frame || !frame->buffer ||
+      !FrameBufferSize(frame->fourcc, frame->width, frame->height)) {
+    return -1;
+  }
+  FrameList* list = FindFrameList(pool, frame->fourcc, frame->width,
+                                  frame->height);
+  if (!list) {
+    list = new FrameList;
+    list->fourcc = frame->fourcc;
+    list->width = frame->width;
+    list->height = frame->height;
+    list->num_frames = 0;
+    list->first = NULL;
+    list->next = pool->lists;
+    pool->lists = list;
+  }
+  if (pool->max_frames && list->num_frames >= pool->max_frames) {
+    return FreeFrame(frame);
+  }
+  *reinterpret_cast<uint8**>(frame->buffer) = list->first;
+  list->first = frame->buffer;
+  ++list->num_frames;
+  memset(frame, 0, sizeof(*frame));
+  return 0;
+}
+
+#ifdef __cplusplus
+}  // extern "C"
+}  // namespace libyuv
+#endif
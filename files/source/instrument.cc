@@ -0,0 +1,275 @@
+/*
+ *  Copyright 2012 The LibYuv Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "libyuv/instrument.h"
+
+#ifdef LIBYUV_INSTRUMENT
+#include <string.h>  // For strcmp()
+#if defined(_WIN32)
+#include <windows.h>  // For InterlockedExchangeAdd64()
+#else
+#include <time.h>  // For clock_gettime()
+#endif
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#include <intrin.h>  // For __rdtsc()
+#endif
+#endif
+
+#include "libyuv/row.h"
+
+#ifdef __cplusplus
+namespace libyuv {
+extern "C" {
+#endif
+
+#ifdef LIBYUV_INSTRUMENT
+
+// Entries are added under a spin lock and never removed, so the hot path
+// finds its entry without locking and only adds to its counters.
+// Calls from different source files may have their own copy of a name, so
+// names are matched by pointer and entries are merged by name when read.
+static const int kMaxInstrumentEntries = 256;
+
+struct InstrumentEntry {
+  const char* function;
+  const char* kernel;
+  volatile uint64 calls;
+  volatile uint64 pixels;
+  volatile uint64 cycles;
+};
+
+struct InstrumentHook {
+  InstrumentCallback callback;
+  void* opaque;
+};
+
+static InstrumentEntry entries_[kMaxInstrumentEntries];
+static volatile int num_entries_ = 0;
+static volatile int lock_ = 0;
+static InstrumentHook* volatile hook_ = NULL;
+
+#if defined(_WIN32)
+static void AtomicAdd64(volatile uint64* p, uint64 v) {
+  InterlockedExchangeAdd64(reinterpret_cast<volatile LONGLONG*>(p),
+                           static_cast<LONGLONG>(v));
+}
+static uint64 AtomicLoad64(volatile uint64* p) {
+  return static_cast<uint64>(InterlockedCompareExchange64(
+      reinterpret_cast<volatile LONGLONG*>(p), 0, 0));
+}
+static void AtomicStore64(volatile uint64* p, uint64 v) {
+  InterlockedExchange64(reinterpret_cast<volatile LONGLONG*>(p),
+                        static_cast<LONGLONG>(v));
+}
+static int AtomicLoad(volatile int* p) {
+  return InterlockedCompareExchange(reinterpret_cast<volatile LONG*>(p), 0, 0);
+}
+static void AtomicStore(volatile int* p, int v) {
+  InterlockedExchange(reinterpret_cast<volatile LONG*>(p), v);
+}
+static void Lock() {
+  while (InterlockedCompareExchange(reinterpret_cast<volatile LONG*>(&lock_),
+                                    1, 0)) {
+  }
+}
+static InstrumentHook* LoadHook() {
+  return static_cast<InstrumentHook*>(InterlockedCompareExchangePointer(
+      reinterpret_cast<PVOID volatile*>(&hook_), NULL, NULL));
+}
+static void StoreHook(InstrumentHook* hook) {
+  InterlockedExchangePointer(reinterpret_cast<PVOID volatile*>(&hook_), hook);
+}
+#else
+static void AtomicAdd64(volatile uint64* p, uint64 v) {
+  __sync_fetch_and_add(p, v);
+}
+static uint64 AtomicLoad64(volatile uint64* p) {
+  return __sync_fetch_and_add(p, 0);
+}
+static void AtomicStore64(volatile uint64* p, uint64 v) {
+  __sync_lock_test_and_set(p, v);
+}
+static int AtomicLoad(volatile int* p) {
+  return __sync_fetch_and_add(p, 0);
+}
+static void AtomicStore(volatile int* p, int v) {
+  __sync_lock_test_and_set(p, v);
+  __sync_synchronize();
+}
+static void Lock() {
+  while (__sync_lock_test_and_set(&lock_, 1)) {
+  }
+}
+static InstrumentHook* LoadHook() {
+  return __sync_fetch_and_add(&hook_, 0);
+}
+static void StoreHook(InstrumentHook* hook) {
+  static_cast<void>(__sync_lock_test_and_set(&hook_, hook));
+  __sync_synchronize();
+}
+#endif
+
+static void Unlock() {
+  AtomicStore(&lock_, 0);
+}
+
+uint64 InstrumentTimer(void) {
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+  return __rdtsc();
+#elif defined(__i386__) || defined(__x86_64__)
+  uint32 lo;
+  uint32 hi;
+  asm volatile ("rdtsc" : "=a"(lo), "=d"(hi));
+  return (static_cast<uint64>(hi) << 32) | lo;
+#elif defined(_WIN32)
+  LARGE_INTEGER count;
+  LARGE_INTEGER frequency;
+  QueryPerformanceCounter(&count);
+  QueryPerformanceFrequency(&frequency);
+  return static_cast<uint64>(count.QuadPart * 1000000000. /
+                             frequency.QuadPart);
+#else
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return static_cast<uint64>(t.tv_sec) * 1000000000u + t.tv_nsec;
+#endif
+}
+
+static InstrumentEntry* FindEntry(const char* function, const char* kernel) {
+  int n = AtomicLoad(&num_entries_);
+  for (int i = 0; i < n; ++i) {
+    if (entries_[i].function == function && entries_[i].kernel == kernel) {
+      return &entries_[i];
+    }
+  }
+  Lock();
+  // Another thread may have added it meanwhile.
+  n = num_entries_;
+  for (int i = 0; i < n; ++i) {
+    if (entries_[i].function == function && entries_[i].kernel == kernel) {
+      Unlock();
+      return &entries_[i];
+    }
+  }
+  InstrumentEntry* entry = NULL;
+  if (n < kMaxInstrumentEntries) {
+    entry = &entries_[n];
+    entry->function = function;
+    entry->kernel = kernel;
+    AtomicStore(&num_entries_, n + 1);
+  }
+  Unlock();
+  return entry;
+}
+
+void InstrumentRecord(const char* function, const char* kernel,
+                      int width, int height, uint64 start) {
+  const uint64 cycles = InstrumentTimer() - start;
+  if (height < 0) {
+    height = -height;
+  }
+  InstrumentEntry* entry = FindEntry(function, kernel);
+  if (entry) {
+    AtomicAdd64(&entry->calls, 1u);
+    AtomicAdd64(&entry->pixels, static_cast<uint64>(width) * height);
+    AtomicAdd64(&entry->cycles, cycles);
+  }
+  InstrumentHook* hook = LoadHook();
+  if (hook) {
+    hook->callback(hook->opaque, function, kernel, width, height, cycles);
+  }
+}
+
+LIBYUV_API
+int GetInstrumentStats(InstrumentStats* stats, int max_stats) {
+  if (!stats && max_stats > 0) {
+    return -1;
+  }
+  const int n = AtomicLoad(&num_entries_);
+  int count = 0;
+  for (int i = 0; i < n; ++i) {
+    const InstrumentEntry& entry = entries_[i];
+    const uint64 calls = AtomicLoad64(&entries_[i].calls);
+    if (!calls) {
+      continue;
+    }
+    int j = 0;
+    while (j < count && j < max_stats &&
+           (strcmp(stats[j].function, entry.function) ||
+            strcmp(stats[j].kernel, entry.kernel))) {
+      ++j;
+    }
+    if (j >= max_stats) {
+      // Not copied, so it can not be merged either; count it once.
+      ++count;
+      continue;
+    }
+    if (j == count) {
+      stats[j].function = entry.function;
+      stats[j].kernel = entry.kernel;
+      stats[j].calls = 0;
+      stats[j].pixels = 0;
+      stats[j].cycles = 0;
+      ++count;
+    }
+    stats[j].calls += calls;
+    stats[j].pixels += AtomicLoad64(&entries_[i].pixels);
+    stats[j].cycles += AtomicLoad64(&entries_[i].cycles);
+  }
+  return count;
+}
+
+LIBYUV_API
+int ResetInstrumentStats(void) {
+  const int n = AtomicLoad(&num_entries_);
+  for (int i = 0; i < n; ++i) {
+    AtomicStore64(&entries_[i].calls, 0u);
+    AtomicStore64(&entries_[i].pixels, 0u);
+    AtomicStore64(&entries_[i].cycles, 0u);
+  }
+  return 0;
+}
+
+// A replaced hook is not freed, as another thread may be calling it.
+LIBYUV_API
+int SetInstrumentCallback(InstrumentCallback callback, void* opaque) {
+  InstrumentHook* hook = NULL;
+  if (callback) {
+    hook = new InstrumentHook;
+    hook->callback = callback;
+    hook->opaque = opaque;
+  }
+  StoreHook(hook);
+  return 0;
+}
+
+#else  // LIBYUV_INSTRUMENT
+
+LIBYUV_API
+int GetInstrumentStats(InstrumentStats*, int) {
+  return -1;
+}
+
+LIBYUV_API
+int ResetInstrumentStats(void) {
+  return -1;
+}
+
+LIBYUV_API
+int SetInstrumentCallback(InstrumentCallback, void*) {
+  return -1;
+}
+
+#endif  // LIBYUV_INSTRUMENT
+
+#ifdef __cplusplus
+}  // extern "C"
+}  // namespace libyuv
+#endif
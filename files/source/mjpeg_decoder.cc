@@ -10,6 +10,8 @@
 
 #include "libyuv/mjpeg_decoder.h"
 
+#include <string.h>  // For memset()
+
 #ifdef HAVE_JPEG
 // Must be included before jpeglib
 #include <assert.h>
@@ -19,6 +21,13 @@
 #endif
 #include <stdio.h>
 #include <stdlib.h>
+#if defined(_WIN32)
+#include <windows.h>  // For CreateThread()
+#define HAVE_RESTART_THREADS
+#elif defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#define HAVE_RESTART_THREADS
+#endif
 
 extern "C" {
 #include <jpeglib.h>
@@ -36,6 +45,99 @@ struct SetJmpErrorMgr {
 };
 #endif
 
+// Restart groups are decoded with per thread buffers sized for this many
+// components. Frames with more components are decoded sequentially.
+static const int kMaxGroupComponents = 4;
+
+// Restart markers RST0 to RST7 followed by EOI. Streams synthesized for a
+// restart group renumber its markers from RST0 and end with EOI.
+static const uint8 kRestartMarkers[18] = {
+  0xff, 0xd0, 0xff, 0xd1, 0xff, 0xd2, 0xff, 0xd3,
+  0xff, 0xd4, 0xff, 0xd5, 0xff, 0xd6, 0xff, 0xd7,
+  0xff, 0xd9
+};
+
+// Decodes a range of iMCU rows that begins at a restart marker. Each group
+// decoder owns a jpeglib decompressor fed with the frame headers followed by
+// the entropy coded segments of its rows, so it can run on its own thread.
+struct RestartGroupDecoder {
+  jpeg_decompress_struct decompress;
+  jpeg_source_mgr source_mgr;
+#ifdef HAVE_SETJMP
+  SetJmpErrorMgr error_mgr;
+#endif
+  MJpegDecoder::Buffer* buffers;
+  int buffers_size;
+  MJpegDecoder::BufferVector buf_vec;
+
+  uint8* databuf[kMaxGroupComponents];
+  int databuf_size[kMaxGroupComponents];
+  uint8** scanlines[kMaxGroupComponents];
+  int scanlines_size[kMaxGroupComponents];
+
+  // Job description filled in by DecodeRestartGroups().
+  int num_components;
+  int num_rows;  // iMCU rows to decode.
+  int image_scanlines;  // Image scanlines per iMCU row.
+  int component_scanlines[kMaxGroupComponents];
+  int component_stride[kMaxGroupComponents];
+  int component_width[kMaxGroupComponents];
+  int component_lines_left[kMaxGroupComponents];
+  uint8* dst[kMaxGroupComponents];
+  bool result;
+
+  void Init();
+  void Destroy();
+  void ReserveBuffers(int size);
+  bool Decode();
+};
+
+void RestartGroupDecoder::Init() {
+#ifdef HAVE_SETJMP
+  decompress.err = jpeg_std_error(&error_mgr.base);
+  error_mgr.base.error_exit = &MJpegDecoder::ErrorHandler;
+#endif
+  source_mgr.init_source = &MJpegDecoder::init_source;
+  source_mgr.fill_input_buffer = &MJpegDecoder::fill_input_buffer;
+  source_mgr.skip_input_data = &MJpegDecoder::skip_input_data;
+  source_mgr.resync_to_restart = &jpeg_resync_to_restart;
+  source_mgr.term_source = &MJpegDecoder::term_source;
+  jpeg_create_decompress(&decompress);
+  decompress.src = &source_mgr;
+  decompress.client_data = &buf_vec;
+  buffers = NULL;
+  buffers_size = 0;
+  buf_vec.buffers = NULL;
+  buf_vec.len = 0;
+  buf_vec.pos = 0;
+  for (int i = 0; i < kMaxGroupComponents; ++i) {
+    databuf[i] = NULL;
+    databuf_size[i] = 0;
+    scanlines[i] = NULL;
+    scanlines_size[i] = 0;
+  }
+}
+
+void RestartGroupDecoder::Destroy() {
+  jpeg_destroy_decompress(&decompress);
+  delete [] buffers;
+  for (int i = 0; i < kMaxGroupComponents; ++i) {
+    delete [] databuf[i];
+    delete [] scanlines[i];
+  }
+}
+
+void RestartGroupDecoder::ReserveBuffers(int size) {
+  if (size > buffers_size) {
+    delete [] buffers;
+    buffers = new MJpegDecoder::Buffer[size];
+    buffers_size = size;
+  }
+  buf_vec.buffers = buffers;
+  buf_vec.len = 0;
+  buf_vec.pos = 0;
+}
+
 const int MJpegDecoder::kColorSpaceUnknown = JCS_UNKNOWN;
 const int MJpegDecoder::kColorSpaceGrayscale = JCS_GRAYSCALE;
 const int MJpegDecoder::kColorSpaceRgb = JCS_RGB;
@@ -49,7 +151,16 @@ MJpegDecoder::MJpegDecoder()
       scanlines_(NULL),
       scanlines_sizes_(NULL),
       databuf_(NULL),
-      databuf_strides_(NULL) {
+      databuf_strides_(NULL),
+      scan_offset_(0),
+      restart_offsets_(NULL),
+      num_restart_offsets_(0),
+      restart_offsets_size_(0),
+      restart_groups_(NULL),
+      num_restart_groups_(0),
+      num_threads_(1),
+      group_decoders_(NULL),
+      num_group_decoders_(0) {
   decompress_struct_ = new jpeg_decompress_struct;
   source_mgr_ = new jpeg_source_mgr;
 #ifdef HAVE_SETJMP
@@ -78,6 +189,12 @@ MJpegDecoder::~MJpegDecoder() {
   delete error_mgr_;
 #endif
   DestroyOutputBuffers();
+  for (int i = 0; i < num_group_decoders_; ++i) {
+    group_decoders_[i].Destroy();
+  }
+  delete [] group_decoders_;
+  delete [] restart_offsets_;
+  delete [] restart_groups_;
 }
 
 // Helper function to validate the jpeg looks ok.
@@ -134,6 +251,9 @@ bool MJpegDecoder::LoadFrame(const uint8* src, size_t src_len) {
     // ERROR: Bad MJPEG header
     return false;
   }
+  // jpeg_read_header stops at the first byte of entropy coded data.
+  scan_offset_ = static_cast<int>(source_mgr_->next_input_byte - buf_.data);
+  FindRestartMarkers();
   AllocOutputBuffers(GetNumComponents());
   for (int i = 0; i < num_outbufs_; ++i) {
     int scanlines_size = GetComponentScanlinesPerImcuRow(i);
@@ -176,6 +296,79 @@ static int DivideAndRoundDown(int numerator, int denominator) {
   return numerator / denominator;
 }
 
+// Records the offset of each RSTn marker in the scan and the offset of the
+// marker that ends it. Segments that begin on an iMCU row boundary start a
+// restart group. Only baseline single scan frames are split; anything else,
+// including out of sequence or missing markers, leaves a single group.
+void MJpegDecoder::FindRestartMarkers() {
+  num_restart_offsets_ = 0;
+  num_restart_groups_ = 1;
+  int restart_interval = GetRestartInterval();
+  if (restart_interval <= 0 ||
+      decompress_struct_->progressive_mode ||
+      decompress_struct_->comps_in_scan != GetNumComponents() ||
+      GetNumComponents() > kMaxGroupComponents ||
+      (GetNumComponents() == 1 && (GetHorizSampFactor(0) != 1 ||
+                                   GetVertSampFactor(0) != 1))) {
+    return;
+  }
+  int mcus_per_row = DivideAndRoundUp(GetWidth(),
+      decompress_struct_->max_h_samp_factor * DCTSIZE);
+  int mcu_rows = DivideAndRoundUp(GetHeight(), GetImageScanlinesPerImcuRow());
+  int num_segments = DivideAndRoundUp(mcus_per_row * mcu_rows,
+                                      restart_interval);
+  if (num_segments > restart_offsets_size_) {
+    delete [] restart_offsets_;
+    delete [] restart_groups_;
+    restart_offsets_ = new int[num_segments];
+    restart_groups_ = new int[num_segments];
+    restart_offsets_size_ = num_segments;
+  }
+
+  // Markers are the only place 0xff is not followed by a stuffed 0x00.
+  const uint8* data = buf_.data;
+  int len = buf_.len;
+  int pos = scan_offset_;
+  int num_offsets = 0;
+  while (pos < len - 1) {
+    const uint8* ff = static_cast<const uint8*>(
+        memchr(data + pos, 0xff, len - 1 - pos));
+    if (!ff) {
+      break;
+    }
+    pos = static_cast<int>(ff - data);
+    while (pos < len - 1 && data[pos + 1] == 0xff) {  // Fill bytes.
+      ++pos;
+    }
+    int marker = data[pos + 1];
+    if (marker == 0x00) {
+      pos += 2;
+      continue;
+    }
+    if (num_offsets >= num_segments) {
+      return;
+    }
+    restart_offsets_[num_offsets++] = pos;
+    if (marker < 0xd0 || marker > 0xd7) {
+      break;  // EOI or another scan ends the entropy coded data.
+    }
+    if (marker != 0xd0 + ((num_offsets - 1) & 7)) {
+      return;
+    }
+    pos += 2;
+  }
+  if (num_offsets != num_segments) {
+    return;
+  }
+  num_restart_offsets_ = num_offsets;
+  num_restart_groups_ = 0;
+  for (int i = 0; i < num_segments; ++i) {
+    if ((i * restart_interval) % mcus_per_row == 0) {
+      restart_groups_[num_restart_groups_++] = i;
+    }
+  }
+}
+
 // Returns width of the last loaded frame.
 int MJpegDecoder::GetWidth() {
   return decompress_struct_->image_width;
@@ -244,6 +437,18 @@ int MJpegDecoder::GetComponentSize(int component) {
   return GetComponentWidth(component) * GetComponentHeight(component);
 }
 
+int MJpegDecoder::GetRestartInterval() {
+  return decompress_struct_->restart_interval;
+}
+
+int MJpegDecoder::GetNumRestartGroups() {
+  return num_restart_groups_;
+}
+
+void MJpegDecoder::SetNumThreads(int num_threads) {
+  num_threads_ = num_threads > 1 ? num_threads : 1;
+}
+
 bool MJpegDecoder::UnloadFrame() {
 #ifdef HAVE_SETJMP
   if (setjmp(error_mgr_->setjmp_buffer)) {
@@ -273,6 +478,12 @@ bool MJpegDecoder::DecodeToBuffers(
     // ERROR: Bad dimensions
     return false;
   }
+#ifdef HAVE_RESTART_THREADS
+  if (num_threads_ > 1 && num_restart_groups_ > 1 &&
+      dst_height == GetHeight()) {
+    return DecodeRestartGroups(planes, num_threads_);
+  }
+#endif
 #ifdef HAVE_SETJMP
   if (setjmp(error_mgr_->setjmp_buffer)) {
     // We called into jpeglib, it experienced an error sometime during this
@@ -355,6 +566,193 @@ bool MJpegDecoder::DecodeToBuffers(
   return FinishDecode();
 }
 
+// Decodes the rows of one restart group on the calling thread.
+bool RestartGroupDecoder::Decode() {
+#ifdef HAVE_SETJMP
+  if (setjmp(error_mgr.setjmp_buffer)) {
+    jpeg_abort_decompress(&decompress);
+    return false;
+  }
+#endif
+  if (jpeg_read_header(&decompress, TRUE) != JPEG_HEADER_OK) {
+    return false;
+  }
+  for (int i = 0; i < num_components; ++i) {
+    int size = component_scanlines[i] * component_stride[i];
+    if (databuf_size[i] != size) {
+      delete [] databuf[i];
+      databuf[i] = new uint8[size];
+      databuf_size[i] = size;
+    }
+    if (scanlines_size[i] != component_scanlines[i]) {
+      delete [] scanlines[i];
+      scanlines[i] = new uint8* [component_scanlines[i]];
+      scanlines_size[i] = component_scanlines[i];
+    }
+    for (int j = 0; j < component_scanlines[i]; ++j) {
+      scanlines[i][j] = databuf[i] + j * component_stride[i];
+    }
+  }
+  // Same settings as MJpegDecoder::StartDecode().
+  decompress.raw_data_out = TRUE;
+  decompress.dct_method = JDCT_IFAST;
+  decompress.dither_mode = JDITHER_NONE;
+  decompress.do_fancy_upsampling = false;
+  decompress.enable_2pass_quant = false;
+  decompress.do_block_smoothing = false;
+  if (!jpeg_start_decompress(&decompress)) {
+    return false;
+  }
+  for (int row = 0; row < num_rows; ++row) {
+    if (static_cast<unsigned int>(image_scanlines) !=
+        jpeg_read_raw_data(&decompress, scanlines, image_scanlines)) {
+      jpeg_abort_decompress(&decompress);
+      return false;
+    }
+    for (int i = 0; i < num_components; ++i) {
+      int rows = component_scanlines[i];
+      if (rows > component_lines_left[i]) {
+        rows = component_lines_left[i];
+      }
+      CopyRows(databuf[i], component_stride[i],
+               dst[i], component_width[i], rows);
+      dst[i] += rows * component_width[i];
+      component_lines_left[i] -= rows;
+    }
+  }
+  // The stream ends after this group so finishing would report an error.
+  jpeg_abort_decompress(&decompress);
+  return true;
+}
+
+#ifdef HAVE_RESTART_THREADS
+#if defined(_WIN32)
+static DWORD WINAPI RestartGroupThread(LPVOID opaque) {
+#else
+static void* RestartGroupThread(void* opaque) {
+#endif
+  RestartGroupDecoder* group = static_cast<RestartGroupDecoder*>(opaque);
+  group->result = group->Decode();
+  return 0;
+}
+
+// Splits the restart groups into one contiguous range of iMCU rows per thread.
+// The last range is decoded on the calling thread.
+bool MJpegDecoder::DecodeRestartGroups(uint8** planes, int num_threads) {
+  if (num_threads > num_restart_groups_) {
+    num_threads = num_restart_groups_;
+  }
+  if (num_threads > num_group_decoders_) {
+    for (int i = 0; i < num_group_decoders_; ++i) {
+      group_decoders_[i].Destroy();
+    }
+    delete [] group_decoders_;
+    group_decoders_ = new RestartGroupDecoder[num_threads];
+    for (int i = 0; i < num_threads; ++i) {
+      group_decoders_[i].Init();
+    }
+    num_group_decoders_ = num_threads;
+  }
+  int mcus_per_row = DivideAndRoundUp(GetWidth(),
+      decompress_struct_->max_h_samp_factor * DCTSIZE);
+  int mcu_rows = DivideAndRoundUp(GetHeight(), GetImageScanlinesPerImcuRow());
+  int restart_interval = GetRestartInterval();
+  int num_segments = num_restart_offsets_;
+  for (int t = 0; t < num_threads; ++t) {
+    RestartGroupDecoder* group = &group_decoders_[t];
+    int first_group = t * num_restart_groups_ / num_threads;
+    int end_group = (t + 1) * num_restart_groups_ / num_threads;
+    int first_segment = restart_groups_[first_group];
+    int end_segment = end_group < num_restart_groups_ ?
+        restart_groups_[end_group] : num_segments;
+    int first_row = first_segment * restart_interval / mcus_per_row;
+    int end_row = end_group < num_restart_groups_ ?
+        end_segment * restart_interval / mcus_per_row : mcu_rows;
+
+    // Headers, then each segment followed by a renumbered RSTn, then EOI.
+    group->ReserveBuffers((end_segment - first_segment) * 2 + 1);
+    MJpegDecoder::Buffer* buffer = group->buffers;
+    buffer->data = buf_.data;
+    buffer->len = scan_offset_;
+    ++buffer;
+    for (int i = first_segment; i < end_segment; ++i) {
+      int start = i ? restart_offsets_[i - 1] + 2 : scan_offset_;
+      buffer->data = buf_.data + start;
+      buffer->len = restart_offsets_[i] - start;
+      ++buffer;
+      buffer->data = i + 1 < end_segment ?
+          kRestartMarkers + ((i - first_segment) & 7) * 2 :
+          kRestartMarkers + 16;
+      buffer->len = 2;
+      ++buffer;
+    }
+    group->buf_vec.len = static_cast<int>(buffer - group->buffers);
+
+    group->num_components = num_outbufs_;
+    group->num_rows = end_row - first_row;
+    group->image_scanlines = GetImageScanlinesPerImcuRow();
+    for (int i = 0; i < num_outbufs_; ++i) {
+      int component_scanlines = GetComponentScanlinesPerImcuRow(i);
+      group->component_scanlines[i] = component_scanlines;
+      group->component_stride[i] = GetComponentStride(i);
+      group->component_width[i] = GetComponentWidth(i);
+      group->component_lines_left[i] =
+          GetComponentHeight(i) - first_row * component_scanlines;
+      group->dst[i] = planes[i] +
+          first_row * component_scanlines * GetComponentWidth(i);
+    }
+    group->result = false;
+  }
+
+#if defined(_WIN32)
+  HANDLE* threads = new HANDLE[num_threads];
+  for (int t = 0; t < num_threads - 1; ++t) {
+    threads[t] = CreateThread(NULL, 0, &RestartGroupThread,
+                              &group_decoders_[t], 0, NULL);
+    if (!threads[t]) {
+      RestartGroupThread(&group_decoders_[t]);
+    }
+  }
+  RestartGroupThread(&group_decoders_[num_threads - 1]);
+  for (int t = 0; t < num_threads - 1; ++t) {
+    if (threads[t]) {
+      WaitForSingleObject(threads[t], INFINITE);
+      CloseHandle(threads[t]);
+    }
+  }
+#else
+  pthread_t* threads = new pthread_t[num_threads];
+  bool* started = new bool[num_threads];
+  for (int t = 0; t < num_threads - 1; ++t) {
+    started[t] = pthread_create(&threads[t], NULL, &RestartGroupThread,
+                                &group_decoders_[t]) == 0;
+    if (!started[t]) {
+      RestartGroupThread(&group_decoders_[t]);
+    }
+  }
+  RestartGroupThread(&group_decoders_[num_threads - 1]);
+  for (int t = 0; t < num_threads - 1; ++t) {
+    if (started[t]) {
+      pthread_join(threads[t], NULL);
+    }
+  }
+  delete [] started;
+#endif
+  delete [] threads;
+
+  bool result = true;
+  for (int t = 0; t < num_threads; ++t) {
+    result = result && group_decoders_[t].result;
+  }
+  for (int i = 0; i < num_outbufs_; ++i) {
+    planes[i] += GetComponentSize(i);
+  }
+  // Match the state left by FinishDecode().
+  jpeg_abort_decompress(decompress_struct_);
+  return result;
+}
+#endif  // HAVE_RESTART_THREADS
+
 bool MJpegDecoder::DecodeToCallback(CallbackFunction fn, void* opaque,
     int dst_width, int dst_height) {
   if (dst_width != GetWidth() ||
@@ -555,6 +953,11 @@ inline bool MJpegDecoder::DecodeImcuRow() {
                          GetImageScanlinesPerImcuRow());
 }
 
+}  // namespace libyuv
+#endif  // HAVE_JPEG
+
+namespace libyuv {
+
 // The helper function which recognizes the jpeg sub-sampling type.
 JpegSubsamplingType MJpegDecoder::JpegSubsamplingTypeHelper(
     int* subsample_x, int* subsample_y, int number_of_components) {
@@ -580,6 +983,99 @@ JpegSubsamplingType MJpegDecoder::JpegSubsamplingTypeHelper(
   return kJpegUnknown;
 }
 
+static int ReadBigEndian16(const uint8* p) {
+  return (p[0] << 8) | p[1];
+}
+
+// Walks the marker segments following SOI. Every segment up to SOS, other
+// than the standalone markers, starts with a 2 byte length that includes
+// itself.
+bool ParseJpegHeader(const uint8* src, size_t src_len, JpegHeader* header) {
+  if (!src || !header || src_len < 4 || src[0] != 0xff || src[1] != 0xd8) {
+    return false;
+  }
+  memset(header, 0, sizeof(*header));
+  header->subsampling = kJpegUnknown;
+  bool have_frame = false;
+  size_t pos = 2;
+  while (pos + 1 < src_len) {
+    if (src[pos] != 0xff) {
+      return false;
+    }
+    int marker = src[pos + 1];
+    if (marker == 0xff) {  // Fill byte.
+      ++pos;
+      continue;
+    }
+    pos += 2;
+    if (marker == 0x01 || (marker >= 0xd0 && marker <= 0xd8)) {
+      continue;  // TEM, RSTn and SOI have no length.
+    }
+    if (marker == 0xd9 || pos + 2 > src_len) {
+      return false;  // EOI before a scan.
+    }
+    size_t length = ReadBigEndian16(src + pos);
+    if (length < 2 || pos + length > src_len) {
+      return false;
+    }
+    const uint8* segment = src + pos + 2;
+    size_t segment_len = length - 2;
+    pos += length;
+
+    if (marker >= 0xc0 && marker <= 0xcf &&
+        marker != 0xc4 && marker != 0xc8 && marker != 0xcc) {
+      // SOFn: precision, height, width, components.
+      if (have_frame || segment_len < 6) {
+        return false;
+      }
+      int num_components = segment[5];
+      if (num_components < 1 || num_components > 4 ||
+          segment_len < 6 + static_cast<size_t>(num_components) * 3) {
+        return false;
+      }
+      header->height = ReadBigEndian16(segment + 1);
+      header->width = ReadBigEndian16(segment + 3);
+      header->num_components = num_components;
+      int max_h = 1;
+      int max_v = 1;
+      for (int i = 0; i < num_components; ++i) {
+        int h = segment[6 + i * 3 + 1] >> 4;
+        int v = segment[6 + i * 3 + 1] & 15;
+        if (h < 1 || h > 4 || v < 1 || v > 4) {
+          return false;
+        }
+        header->horiz_samp_factor[i] = h;
+        header->vert_samp_factor[i] = v;
+        max_h = h > max_h ? h : max_h;
+        max_v = v > max_v ? v : max_v;
+      }
+      int subsample_x[4];
+      int subsample_y[4];
+      for (int i = 0; i < num_components; ++i) {
+        subsample_x[i] = max_h / header->horiz_samp_factor[i];
+        subsample_y[i] = max_v / header->vert_samp_factor[i];
+      }
+      header->subsampling = MJpegDecoder::JpegSubsamplingTypeHelper(
+          subsample_x, subsample_y, num_components);
+      header->progressive = (marker & 3) == 2;
+      header->arithmetic = marker >= 0xc9;
+      have_frame = true;
+    } else if (marker == 0xdd) {  // DRI
+      if (segment_len < 2) {
+        return false;
+      }
+      header->restart_interval = ReadBigEndian16(segment);
+    } else if (marker == 0xda) {  // SOS
+      if (segment_len < 1) {
+        return false;
+      }
+      header->comps_in_scan = segment[0];
+      // A height of 0 is defined later by a DNL marker, which is not parsed.
+      return have_frame && header->width > 0 && header->height > 0;
+    }
+  }
+  return false;
+}
+
 }  // namespace libyuv
-#endif  // HAVE_JPEG
 
@@ -0,0 +1,144 @@
+/*
+ *  Copyright 2012 The LibYuv Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "libyuv/row.h"
+
+#include "libyuv/cpu_id.h"
+
+#if defined(_WIN32)
+#include <windows.h>  // For CreateThread()
+#define HAVE_BAND_THREADS
+#elif defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#define HAVE_BAND_THREADS
+#endif
+
+#ifdef __cplusplus
+namespace libyuv {
+extern "C" {
+#endif
+
+// Bands are at least this many rows, so small images stay on one thread.
+static const int kMinBandHeight = 16;
+static const int kMaxBandThreads = 16;
+
+#ifdef HAVE_BAND_THREADS
+struct Band {
+  BandFunction band_function;
+  void* param;
+  int y;
+  int height;
+  int cpu_mask;
+};
+
+#if defined(_WIN32)
+static DWORD WINAPI BandThread(LPVOID opaque) {
+#else
+static void* BandThread(void* opaque) {
+#endif
+  Band* band = static_cast<Band*>(opaque);
+  // Bands use the row functions of the thread that started them.
+  if (band->cpu_mask != GetThreadCpuMask()) {
+    SetThreadCpuMask(band->cpu_mask);
+  }
+  band->band_function(band->param, band->y, band->height);
+  return 0;
+}
+#endif
+
+// Number of bands of at least min_band items that count items split into.
+static int BandCountMin(int count, int min_band, int num_threads) {
+  if (num_threads > count / min_band) {
+    num_threads = count / min_band;
+  }
+  if (num_threads > kMaxBandThreads) {
+    num_threads = kMaxBandThreads;
+  }
+#ifdef HAVE_BAND_THREADS
+  return num_threads > 1 ? num_threads : 1;
+#else
+  return 1;
+#endif
+}
+
+int BandCount(int height, int num_threads) {
+  return BandCountMin(height, kMinBandHeight, num_threads);
+}
+
+int FrameBandCount(int count, int num_threads) {
+  return BandCountMin(count, 1, num_threads);
+}
+
+// Splits the items into one band per thread. The first band runs on the
+// calling thread. Bands that fail to start a thread also run on the calling
+// thread, so all items are always done on return.
+static void RunBandsMin(BandFunction band_function, void* param,
+                        int count, int min_band, int num_threads) {
+  num_threads = BandCountMin(count, min_band, num_threads);
+#ifdef HAVE_BAND_THREADS
+  if (num_threads > 1) {
+    Band bands[kMaxBandThreads];
+#if defined(_WIN32)
+    HANDLE threads[kMaxBandThreads];
+#else
+    pthread_t threads[kMaxBandThreads];
+#endif
+    bool started[kMaxBandThreads];
+    const int cpu_mask = GetThreadCpuMask();
+    for (int t = 0; t < num_threads; ++t) {
+      bands[t].band_function = band_function;
+      bands[t].cpu_mask = cpu_mask;
+      bands[t].param = param;
+      bands[t].y = t * count / num_threads;
+      bands[t].height = (t + 1) * count / num_threads - bands[t].y;
+    }
+    for (int t = 1; t < num_threads; ++t) {
+#if defined(_WIN32)
+      threads[t] = CreateThread(NULL, 0, BandThread, &bands[t], 0, NULL);
+      started[t] = threads[t] != NULL;
+#else
+      started[t] = pthread_create(&threads[t], NULL, BandThread,
+                                  &bands[t]) == 0;
+#endif
+    }
+    BandThread(&bands[0]);
+    for (int t = 1; t < num_threads; ++t) {
+      if (!started[t]) {
+        BandThread(&bands[t]);
+        continue;
+      }
+#if defined(_WIN32)
+      WaitForSingleObject(threads[t], INFINITE);
+      CloseHandle(threads[t]);
+#else
+      pthread_join(threads[t], NULL);
+#endif
+    }
+    return;
+  }
+#endif
+  band_function(param, 0, count);
+}
+
+void RunBands(BandFunction band_function, void* param,
+              int height, int num_threads) {
+  RunBandsMin(band_function, param, height, kMinBandHeight, num_threads);
+}
+
+// A frame is enough work for a thread of its own.
+void RunFrameBands(BandFunction band_function, void* param,
+                   int count, int num_threads) {
+  RunBandsMin(band_function, param, count, 1, num_threads);
+}
+
+#ifdef __cplusplus
+}  // extern "C"
+}  // namespace libyuv
+#endif
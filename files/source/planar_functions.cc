@@ -10,6 +10,8 @@
 
 #include "libyuv/planar_functions.h"
 
+#include <math.h>  // for floor()
+#include <stdlib.h>  // for abs()
 #include <string.h>  // for memset()
 
 #include "libyuv/cpu_id.h"
@@ -28,6 +30,12 @@ LIBYUV_API
 void CopyPlane(const uint8* src_y, int src_stride_y,
                uint8* dst_y, int dst_stride_y,
                int width, int height) {
+  // Negative height means invert the image.
+  if (height < 0) {
+    height = -height;
+    src_y = src_y + (height - 1) * src_stride_y;
+    src_stride_y = -src_stride_y;
+  }
   void (*CopyRow)(const uint8* src, uint8* dst, int width) = CopyRow_C;
 #if defined(HAS_COPYROW_NEON)
   if (TestCpuFlag(kCpuHasNEON) && IS_ALIGNED(width, 64)) {
@@ -264,6 +272,54 @@ int I420Mirror(const uint8* src_y, int src_stride_y,
   return 0;
 }
 
+// NV12 mirror. The UV plane is mirrored a pair at a time, without
+// splitting it into U and V.
+LIBYUV_API
+int NV12Mirror(const uint8* src_y, int src_stride_y,
+               const uint8* src_uv, int src_stride_uv,
+               uint8* dst_y, int dst_stride_y,
+               uint8* dst_uv, int dst_stride_uv,
+               int width, int height) {
+  if (!src_y || !src_uv || !dst_uv || width <= 0 || height == 0) {
+    return -1;
+  }
+  // Negative height means invert the image.
+  if (height < 0) {
+    height = -height;
+    int halfheight = (height + 1) >> 1;
+    src_y = src_y + (height - 1) * src_stride_y;
+    src_uv = src_uv + (halfheight - 1) * src_stride_uv;
+    src_stride_y = -src_stride_y;
+    src_stride_uv = -src_stride_uv;
+  }
+
+  int halfwidth = (width + 1) >> 1;
+  int halfheight = (height + 1) >> 1;
+  void (*UVMirrorRow)(const uint8* src_uv, uint8* dst_uv, int width) =
+      UVMirrorRow_C;
+#if defined(HAS_UVMIRRORROW_NEON)
+  if (TestCpuFlag(kCpuHasNEON) && IS_ALIGNED(halfwidth, 8)) {
+    UVMirrorRow = UVMirrorRow_NEON;
+  }
+#elif defined(HAS_UVMIRRORROW_SSSE3)
+  if (TestCpuFlag(kCpuHasSSSE3) && IS_ALIGNED(halfwidth, 8) &&
+      IS_ALIGNED(src_uv, 16) && IS_ALIGNED(src_stride_uv, 16) &&
+      IS_ALIGNED(dst_uv, 16) && IS_ALIGNED(dst_stride_uv, 16)) {
+    UVMirrorRow = UVMirrorRow_SSSE3;
+  }
+#endif
+
+  if (dst_y) {
+    MirrorPlane(src_y, src_stride_y, dst_y, dst_stride_y, width, height);
+  }
+  for (int y = 0; y < halfheight; ++y) {
+    UVMirrorRow(src_uv, dst_uv, halfwidth);
+    src_uv += src_stride_uv;
+    dst_uv += dst_stride_uv;
+  }
+  return 0;
+}
+
 // ARGB mirror.
 LIBYUV_API
 int ARGBMirror(const uint8* src_argb, int src_stride_argb,
@@ -305,6 +361,12 @@ LIBYUV_API
 ARGBBlendRow GetARGBBlend() {
   void (*ARGBBlendRow)(const uint8* src_argb, const uint8* src_argb1,
                        uint8* dst_argb, int width) = ARGBBlendRow_C;
+#if defined(HAS_ARGBBLENDROW_AVX2)
+  if (TestCpuFlag(kCpuHasAVX2)) {
+    ARGBBlendRow = ARGBBlendRow_AVX2;
+    return ARGBBlendRow;
+  }
+#endif
 #if defined(HAS_ARGBBLENDROW_SSSE3)
   if (TestCpuFlag(kCpuHasSSSE3)) {
     ARGBBlendRow = ARGBBlendRow_SSSE3;
@@ -346,6 +408,471 @@ int ARGBBlend(const uint8* src_argb0, int src_stride_argb0,
   return 0;
 }
 
+// Spans of a layer row are classified this many pixels at a time.
+static const int kCompositeSpan = 32;
+
+enum CompositeSpanType {
+  kSpanTransparent = 0,  // All pixels are 0 and leave the destination as is.
+  kSpanOpaque = 1,       // All alphas are 255 and replace the destination.
+  kSpanBlend = 2,
+};
+
+static CompositeSpanType ARGBSpanType(const uint8* src_argb, int width) {
+  const uint32* src = reinterpret_cast<const uint32*>(src_argb);
+  uint32 any = 0u;
+  uint32 all = 0xffffffffu;
+  for (int x = 0; x < width; ++x) {
+    any |= src[x];
+    all &= src[x];
+  }
+  if (any == 0u) {
+    return kSpanTransparent;
+  }
+  return (all >> 24) == 255u ? kSpanOpaque : kSpanBlend;
+}
+
+// Blend one row of a layer over the destination row, skipping transparent
+// runs and copying opaque ones when the layer is not faded.
+static void CompositeLayerRow(const uint8* src_argb, uint8* dst_argb,
+                              int width, int alpha,
+                              ARGBBlendRow ARGBBlendRow, uint8* row) {
+  const uint32 shade = static_cast<uint32>(alpha) * 0x01010101u;
+  int x = 0;
+  while (x < width) {
+    int n = width - x < kCompositeSpan ? width - x : kCompositeSpan;
+    CompositeSpanType type = ARGBSpanType(src_argb + x * 4, n);
+    // Extend the run while the following spans are the same type.
+    int run = n;
+    while (x + run < width) {
+      n = width - x - run < kCompositeSpan ? width - x - run : kCompositeSpan;
+      if (ARGBSpanType(src_argb + (x + run) * 4, n) != type) {
+        break;
+      }
+      run += n;
+    }
+    if (type == kSpanOpaque && alpha == 255) {
+      memcpy(dst_argb + x * 4, src_argb + x * 4, run * 4);
+    } else if (type != kSpanTransparent) {
+      if (alpha == 255) {
+        ARGBBlendRow(src_argb + x * 4, dst_argb + x * 4, dst_argb + x * 4,
+                     run);
+      } else {
+        // Fade the layer into the row buffer a piece at a time.
+        for (int i = 0; i < run; i += kMaxStride / 4) {
+          int m = run - i < kMaxStride / 4 ? run - i : kMaxStride / 4;
+          const uint8* src = src_argb + (x + i) * 4;
+          void (*ARGBShadeRow)(const uint8* src_argb, uint8* dst_argb,
+                               int width, uint32 value) = ARGBShadeRow_C;
+#if defined(HAS_ARGBSHADE_SSE2)
+          if (TestCpuFlag(kCpuHasSSE2) && IS_ALIGNED(m, 4) &&
+              IS_ALIGNED(src, 16)) {
+            ARGBShadeRow = ARGBShadeRow_SSE2;
+          }
+#endif
+          ARGBShadeRow(src, row, m, shade);
+          ARGBBlendRow(row, dst_argb + (x + i) * 4, dst_argb + (x + i) * 4, m);
+        }
+      }
+    }
+    x += run;
+  }
+}
+
+// Composite layers over an ARGB image, one destination row at a time.
+LIBYUV_API
+int ARGBComposite(const ARGBLayer* layers, int num_layers,
+                  uint8* dst_argb, int dst_stride_argb,
+                  int width, int height) {
+  if (!layers || num_layers < 0 || !dst_argb || width <= 0 || height == 0) {
+    return -1;
+  }
+  for (int i = 0; i < num_layers; ++i) {
+    if (!layers[i].src_argb || layers[i].width <= 0 ||
+        layers[i].height <= 0 || layers[i].alpha < 0 ||
+        layers[i].alpha > 255) {
+      return -1;
+    }
+  }
+  // Negative height means invert the image.
+  if (height < 0) {
+    height = -height;
+    dst_argb = dst_argb + (height - 1) * dst_stride_argb;
+    dst_stride_argb = -dst_stride_argb;
+  }
+  ARGBBlendRow ARGBBlendRow = GetARGBBlend();
+  SIMD_ALIGNED(uint8 row[kMaxStride]);
+
+  for (int y = 0; y < height; ++y) {
+    for (int i = 0; i < num_layers; ++i) {
+      const ARGBLayer& layer = layers[i];
+      int layer_y = y - layer.y;
+      if (layer.alpha == 0 || layer_y < 0 || layer_y >= layer.height) {
+        continue;
+      }
+      int x0 = layer.x < 0 ? 0 : layer.x;
+      int x1 = layer.x + layer.width < width ? layer.x + layer.width : width;
+      if (x0 >= x1) {
+        continue;
+      }
+      CompositeLayerRow(layer.src_argb + layer_y * layer.src_stride_argb +
+                        (x0 - layer.x) * 4,
+                        dst_argb + x0 * 4, x1 - x0, layer.alpha,
+                        ARGBBlendRow, row);
+    }
+    dst_argb += dst_stride_argb;
+  }
+  return 0;
+}
+
+typedef void (*BlendPlaneRowFunc)(const uint8* src0, const uint8* src1,
+                                  const uint8* alpha, uint8* dst, int width);
+
+static BlendPlaneRowFunc GetBlendPlaneRow(int width) {
+  BlendPlaneRowFunc BlendPlaneRow = BlendPlaneRow_C;
+#if defined(HAS_BLENDPLANEROW_SSSE3)
+  if (TestCpuFlag(kCpuHasSSSE3) && width >= 8) {
+    BlendPlaneRow = IS_ALIGNED(width, 8) ? BlendPlaneRow_SSSE3 :
+                                           BlendPlaneRow_Any_SSSE3;
+  }
+#elif defined(HAS_BLENDPLANEROW_NEON)
+  if (TestCpuFlag(kCpuHasNEON) && width >= 8) {
+    BlendPlaneRow = IS_ALIGNED(width, 8) ? BlendPlaneRow_NEON :
+                                           BlendPlaneRow_Any_NEON;
+  }
+#endif
+  return BlendPlaneRow;
+}
+
+// Blend 2 planes with an alpha plane and store to destination.
+LIBYUV_API
+int BlendPlane(const uint8* src_y0, int src_stride_y0,
+               const uint8* src_y1, int src_stride_y1,
+               const uint8* alpha, int alpha_stride,
+               uint8* dst_y, int dst_stride_y,
+               int width, int height) {
+  if (!src_y0 || !src_y1 || !alpha || !dst_y || width <= 0 || height == 0) {
+    return -1;
+  }
+  // Negative height means invert the image.
+  if (height < 0) {
+    height = -height;
+    dst_y = dst_y + (height - 1) * dst_stride_y;
+    dst_stride_y = -dst_stride_y;
+  }
+  BlendPlaneRowFunc BlendPlaneRow = GetBlendPlaneRow(width);
+  for (int y = 0; y < height; ++y) {
+    BlendPlaneRow(src_y0, src_y1, alpha, dst_y, width);
+    src_y0 += src_stride_y0;
+    src_y1 += src_stride_y1;
+    alpha += alpha_stride;
+    dst_y += dst_stride_y;
+  }
+  return 0;
+}
+
+// Average 2x2 blocks of alpha for chroma. With step 2 each average is
+// stored twice to weight both bytes of an interleaved UV pair.
+static void HalfAlphaRow(const uint8* src_a0, const uint8* src_a1,
+                         uint8* dst_a, int width, int step) {
+  for (int x = 0; x < width - 1; x += 2) {
+    uint8 a = static_cast<uint8>((src_a0[x] + src_a0[x + 1] +
+                                  src_a1[x] + src_a1[x + 1] + 2) >> 2);
+    dst_a[0] = a;
+    dst_a[step - 1] = a;
+    dst_a += step;
+  }
+  if (width & 1) {
+    uint8 a = static_cast<uint8>((src_a0[width - 1] + src_a1[width - 1] + 1) >>
+                                 1);
+    dst_a[0] = a;
+    dst_a[step - 1] = a;
+  }
+}
+
+// Clip an overlay of src_width x src_height placed at (*x, *y) to a frame of
+// dst_width x dst_height. On return (*x, *y) is the frame position and
+// (*src_x, *src_y) the overlay position of the visible part. Positions are
+// kept even so chroma stays aligned. Returns false if nothing is visible.
+static bool ClipOverlay(int src_width, int src_height,
+                        int dst_width, int dst_height,
+                        int* x, int* y, int* src_x, int* src_y,
+                        int* width, int* height) {
+  *src_x = *x < 0 ? -*x : 0;
+  *src_y = *y < 0 ? -*y : 0;
+  *x += *src_x;
+  *y += *src_y;
+  *width = src_width - *src_x;
+  *height = src_height - *src_y;
+  if (*x + *width > dst_width) {
+    *width = dst_width - *x;
+  }
+  if (*y + *height > dst_height) {
+    *height = dst_height - *y;
+  }
+  return *width > 0 && *height > 0;
+}
+
+// Blend the rectangle of an I420 overlay with alpha onto the same rectangle
+// of a frame. Pointers are at the top left of the rectangle. A NULL dst_v
+// means dst_u is interleaved UV. Rectangles wider than the row buffers are
+// blended in strips of kMaxStride, which is even so chroma stays aligned.
+static void BlendI420Rect(const uint8* src_y, int src_stride_y,
+                          const uint8* src_u, int src_stride_u,
+                          const uint8* src_v, int src_stride_v,
+                          const uint8* src_a, int src_stride_a,
+                          uint8* dst_y, int dst_stride_y,
+                          uint8* dst_u, int dst_stride_u,
+                          uint8* dst_v, int dst_stride_v,
+                          int width, int height) {
+  if (width > kMaxStride) {
+    for (int j = 0; j < width; j += kMaxStride) {
+      const int w = width - j < kMaxStride ? width - j : kMaxStride;
+      BlendI420Rect(src_y + j, src_stride_y,
+                    src_u + j / 2, src_stride_u,
+                    src_v + j / 2, src_stride_v,
+                    src_a + j, src_stride_a,
+                    dst_y + j, dst_stride_y,
+                    dst_u + (dst_v ? j / 2 : j), dst_stride_u,
+                    dst_v ? dst_v + j / 2 : NULL, dst_stride_v,
+                    w, height);
+    }
+    return;
+  }
+  const int halfwidth = (width + 1) >> 1;
+  const int uv_step = dst_v ? 1 : 2;
+  BlendPlaneRowFunc BlendPlaneRow = GetBlendPlaneRow(width);
+  BlendPlaneRowFunc BlendPlaneRowUV = GetBlendPlaneRow(halfwidth * uv_step);
+  void (*MergeUV)(const uint8* src_u, const uint8* src_v, uint8* dst_uv,
+                  int width) = MergeUV_C;
+#if defined(HAS_MERGEUV_SSE2)
+  if (TestCpuFlag(kCpuHasSSE2) && halfwidth >= 16) {
+    MergeUV = MergeUV_Any_SSE2;
+    if (IS_ALIGNED(halfwidth, 16)) {
+      MergeUV = MergeUV_Unaligned_SSE2;
+      if (IS_ALIGNED(src_u, 16) && IS_ALIGNED(src_stride_u, 16) &&
+          IS_ALIGNED(src_v, 16) && IS_ALIGNED(src_stride_v, 16)) {
+        MergeUV = MergeUV_SSE2;
+      }
+    }
+  }
+#elif defined(HAS_MERGEUV_NEON)
+  if (TestCpuFlag(kCpuHasNEON) && halfwidth >= 16) {
+    MergeUV = IS_ALIGNED(halfwidth, 16) ? MergeUV_NEON : MergeUV_Any_NEON;
+  }
+#endif
+  SIMD_ALIGNED(uint8 row_a[kMaxStride]);
+  SIMD_ALIGNED(uint8 row_uv[kMaxStride]);
+
+  for (int y = 0; y < height; y += 2) {
+    const int next_a = y + 1 < height ? src_stride_a : 0;
+    BlendPlaneRow(src_y, dst_y, src_a, dst_y, width);
+    if (y + 1 < height) {
+      BlendPlaneRow(src_y + src_stride_y, dst_y + dst_stride_y,
+                    src_a + src_stride_a, dst_y + dst_stride_y, width);
+    }
+    HalfAlphaRow(src_a, src_a + next_a, row_a, width, uv_step);
+    if (dst_v) {
+      BlendPlaneRowUV(src_u, dst_u, row_a, dst_u, halfwidth);
+      BlendPlaneRowUV(src_v, dst_v, row_a, dst_v, halfwidth);
+      dst_v += dst_stride_v;
+    } else {
+      MergeUV(src_u, src_v, row_uv, halfwidth);
+      BlendPlaneRowUV(row_uv, dst_u, row_a, dst_u, halfwidth * 2);
+    }
+    src_y += src_stride_y * 2;
+    src_u += src_stride_u;
+    src_v += src_stride_v;
+    src_a += src_stride_a * 2;
+    dst_y += dst_stride_y * 2;
+    dst_u += dst_stride_u;
+  }
+}
+
+// Blend an I420 overlay with an alpha plane onto an I420 frame in place.
+LIBYUV_API
+int I420Blend(const uint8* src_y, int src_stride_y,
+              const uint8* src_u, int src_stride_u,
+              const uint8* src_v, int src_stride_v,
+              const uint8* src_a, int src_stride_a,
+              int src_width, int src_height,
+              uint8* dst_y, int dst_stride_y,
+              uint8* dst_u, int dst_stride_u,
+              uint8* dst_v, int dst_stride_v,
+              int dst_width, int dst_height,
+              int x, int y) {
+  if (!src_y || !src_u || !src_v || !src_a ||
+      !dst_y || !dst_u || !dst_v ||
+      src_width <= 0 || src_height <= 0 || dst_width <= 0 || dst_height <= 0 ||
+      (x & 1) || (y & 1)) {
+    return -1;
+  }
+  int src_x, src_y0, width, height;
+  if (!ClipOverlay(src_width, src_height, dst_width, dst_height,
+                   &x, &y, &src_x, &src_y0, &width, &height)) {
+    return 0;
+  }
+  BlendI420Rect(src_y + src_y0 * src_stride_y + src_x, src_stride_y,
+                src_u + (src_y0 / 2) * src_stride_u + src_x / 2, src_stride_u,
+                src_v + (src_y0 / 2) * src_stride_v + src_x / 2, src_stride_v,
+                src_a + src_y0 * src_stride_a + src_x, src_stride_a,
+                dst_y + y * dst_stride_y + x, dst_stride_y,
+                dst_u + (y / 2) * dst_stride_u + x / 2, dst_stride_u,
+                dst_v + (y / 2) * dst_stride_v + x / 2, dst_stride_v,
+                width, height);
+  return 0;
+}
+
+// Blend an I420 overlay with an alpha plane onto an NV12 frame in place.
+LIBYUV_API
+int NV12Blend(const uint8* src_y, int src_stride_y,
+              const uint8* src_u, int src_stride_u,
+              const uint8* src_v, int src_stride_v,
+              const uint8* src_a, int src_stride_a,
+              int src_width, int src_height,
+              uint8* dst_y, int dst_stride_y,
+              uint8* dst_uv, int dst_stride_uv,
+              int dst_width, int dst_height,
+              int x, int y) {
+  if (!src_y || !src_u || !src_v || !src_a || !dst_y || !dst_uv ||
+      src_width <= 0 || src_height <= 0 || dst_width <= 0 || dst_height <= 0 ||
+      (x & 1) || (y & 1)) {
+    return -1;
+  }
+  int src_x, src_y0, width, height;
+  if (!ClipOverlay(src_width, src_height, dst_width, dst_height,
+                   &x, &y, &src_x, &src_y0, &width, &height)) {
+    return 0;
+  }
+  BlendI420Rect(src_y + src_y0 * src_stride_y + src_x, src_stride_y,
+                src_u + (src_y0 / 2) * src_stride_u + src_x / 2, src_stride_u,
+                src_v + (src_y0 / 2) * src_stride_v + src_x / 2, src_stride_v,
+                src_a + src_y0 * src_stride_a + src_x, src_stride_a,
+                dst_y + y * dst_stride_y + x, dst_stride_y,
+                dst_uv + (y / 2) * dst_stride_uv + x, dst_stride_uv,
+                NULL, 0,
+                width, height);
+  return 0;
+}
+
+static void ARGBExtractAlphaRow(const uint8* src_argb, uint8* dst_a,
+                                int width) {
+  for (int x = 0; x < width; ++x) {
+    dst_a[x] = src_argb[x * 4 + 3];
+  }
+}
+
+// Blend an attenuated ARGB overlay onto an I420 or NV12 frame. The overlay
+// is unattenuated and converted to I420 with alpha 2 rows at a time, in
+// strips that fit the row buffers, then blended like I420Blend.
+static int BlendARGBOverlay(const uint8* src_argb, int src_stride_argb,
+                            int src_width, int src_height,
+                            uint8* dst_y, int dst_stride_y,
+                            uint8* dst_u, int dst_stride_u,
+                            uint8* dst_v, int dst_stride_v,
+                            int dst_width, int dst_height,
+                            int x, int y) {
+  int src_x, src_y0, width, height;
+  if (!ClipOverlay(src_width, src_height, dst_width, dst_height,
+                   &x, &y, &src_x, &src_y0, &width, &height)) {
+    return 0;
+  }
+  src_argb += src_y0 * src_stride_argb + src_x * 4;
+  dst_y += y * dst_stride_y + x;
+  dst_u += (y / 2) * dst_stride_u + (dst_v ? x / 2 : x);
+  if (dst_v) {
+    dst_v += (y / 2) * dst_stride_v + x / 2;
+  }
+  // Split wide overlays into equal strips, a multiple of 16 pixels wide, so
+  // every strip but a narrow single one can use the SIMD rows.
+  const int kStrip = kMaxStride / 4;
+  const int num_strips = (width + kStrip - 1) / kStrip;
+  const int strip = num_strips == 1 ? width :
+      ((width + num_strips - 1) / num_strips + 15) & ~15;
+
+  void (*ARGBUnattenuateRow)(const uint8* src_argb, uint8* dst_argb,
+                             int width) = ARGBUnattenuateRow_C;
+#if defined(HAS_ARGBUNATTENUATEROW_SSE2)
+  if (TestCpuFlag(kCpuHasSSE2) && IS_ALIGNED(width, 4) &&
+      IS_ALIGNED(src_argb, 16) && IS_ALIGNED(src_stride_argb, 16)) {
+    ARGBUnattenuateRow = ARGBUnattenuateRow_SSE2;
+  }
+#endif
+  // The row buffers are aligned, so the strip width picks the variant.
+  const RowDispatch* dispatch = GetRowDispatch();
+  SIMD_ALIGNED(uint8 row_argb[kMaxStride * 2]);
+  SIMD_ALIGNED(uint8 row_y[kStrip * 2]);
+  SIMD_ALIGNED(uint8 row_a[kStrip * 2]);
+  SIMD_ALIGNED(uint8 row_u[kStrip / 2]);
+  SIMD_ALIGNED(uint8 row_v[kStrip / 2]);
+
+  for (int i = 0; i < height; i += 2) {
+    const int rows = i + 1 < height ? 2 : 1;
+    for (int j = 0; j < width; j += strip) {
+      const int w = width - j < strip ? width - j : strip;
+      ARGBToYRowFunction ARGBToYRow =
+          SELECT_ROW(dispatch->ARGBToYRow, w, true);
+      ARGBToUVRowFunction ARGBToUVRow =
+          SELECT_ROW(dispatch->ARGBToUVRow, w, true);
+      for (int r = 0; r < rows; ++r) {
+        ARGBUnattenuateRow(src_argb + r * src_stride_argb + j * 4,
+                           row_argb + r * kMaxStride, w);
+        ARGBToYRow(row_argb + r * kMaxStride, row_y + r * kStrip, w);
+        ARGBExtractAlphaRow(row_argb + r * kMaxStride, row_a + r * kStrip, w);
+      }
+      ARGBToUVRow(row_argb, rows == 2 ? kMaxStride : 0, row_u, row_v, w);
+      BlendI420Rect(row_y, kStrip, row_u, 0, row_v, 0, row_a, kStrip,
+                    dst_y + j, dst_stride_y,
+                    dst_u + (dst_v ? j / 2 : j), dst_stride_u,
+                    dst_v ? dst_v + j / 2 : NULL, dst_stride_v,
+                    w, rows);
+    }
+    src_argb += src_stride_argb * 2;
+    dst_y += dst_stride_y * 2;
+    dst_u += dst_stride_u;
+    if (dst_v) {
+      dst_v += dst_stride_v;
+    }
+  }
+  return 0;
+}
+
+// Blend an attenuated ARGB overlay onto an I420 frame in place.
+LIBYUV_API
+int I420BlendARGB(const uint8* src_argb, int src_stride_argb,
+                  int src_width, int src_height,
+                  uint8* dst_y, int dst_stride_y,
+                  uint8* dst_u, int dst_stride_u,
+                  uint8* dst_v, int dst_stride_v,
+                  int dst_width, int dst_height,
+                  int x, int y) {
+  if (!src_argb || !dst_y || !dst_u || !dst_v ||
+      src_width <= 0 || src_height <= 0 || dst_width <= 0 || dst_height <= 0 ||
+      (x & 1) || (y & 1)) {
+    return -1;
+  }
+  return BlendARGBOverlay(src_argb, src_stride_argb, src_width, src_height,
+                          dst_y, dst_stride_y, dst_u, dst_stride_u,
+                          dst_v, dst_stride_v, dst_width, dst_height, x, y);
+}
+
+// Blend an attenuated ARGB overlay onto an NV12 frame in place.
+LIBYUV_API
+int NV12BlendARGB(const uint8* src_argb, int src_stride_argb,
+                  int src_width, int src_height,
+                  uint8* dst_y, int dst_stride_y,
+                  uint8* dst_uv, int dst_stride_uv,
+                  int dst_width, int dst_height,
+                  int x, int y) {
+  if (!src_argb || !dst_y || !dst_uv ||
+      src_width <= 0 || src_height <= 0 || dst_width <= 0 || dst_height <= 0 ||
+      (x & 1) || (y & 1)) {
+    return -1;
+  }
+  return BlendARGBOverlay(src_argb, src_stride_argb, src_width, src_height,
+                          dst_y, dst_stride_y, dst_uv, dst_stride_uv,
+                          NULL, 0, dst_width, dst_height, x, y);
+}
+
 // Convert ARGB to I400.
 LIBYUV_API
 int ARGBToI400(const uint8* src_argb, int src_stride_argb,
@@ -821,7 +1348,6 @@ int ARGBToARGB4444(const uint8* src_argb, int src_stride_argb,
 }
 
 // Convert NV12 to RGB565.
-// TODO(fbarchard): (Re) Optimize for Neon.
 LIBYUV_API
 int NV12ToRGB565(const uint8* src_y, int src_stride_y,
                  const uint8* src_uv, int src_stride_uv,
@@ -836,33 +1362,28 @@ int NV12ToRGB565(const uint8* src_y, int src_stride_y,
     dst_rgb565 = dst_rgb565 + (height - 1) * dst_stride_rgb565;
     dst_stride_rgb565 = -dst_stride_rgb565;
   }
-  void (*NV12ToARGBRow)(const uint8* y_buf,
-                        const uint8* uv_buf,
-                        uint8* rgb_buf,
-                        int width) = NV12ToARGBRow_C;
-#if defined(HAS_NV12TOARGBROW_SSSE3)
-  if (TestCpuFlag(kCpuHasSSSE3) && width * 4 <= kMaxStride) {
-    NV12ToARGBRow = NV12ToARGBRow_SSSE3;
-  }
-#endif
-#if defined(HAS_NV12TOARGBROW_NEON)
-  if (TestCpuFlag(kCpuHasNEON) && width * 4 <= kMaxStride) {
-    NV12ToARGBRow = NV12ToARGBRow_NEON;
+  void (*NV12ToRGB565Row)(const uint8* y_buf,
+                          const uint8* uv_buf,
+                          uint8* rgb_buf,
+                          int width) = NV12ToRGB565Row_C;
+#if defined(HAS_I422TORGB565ROW_SSSE3)
+  if (TestCpuFlag(kCpuHasSSSE3)) {
+    NV12ToRGB565Row = NV12ToRGB565Row_Any_SSSE3;
+    if (IS_ALIGNED(width, 8)) {
+      NV12ToRGB565Row = NV12ToRGB565Row_SSSE3;
+    }
   }
-#endif
-
-  SIMD_ALIGNED(uint8 row[kMaxStride]);
-  void (*ARGBToRGB565Row)(const uint8* src_argb, uint8* dst_rgb, int pix) =
-      ARGBToRGB565Row_C;
-#if defined(HAS_ARGBTORGB565ROW_SSE2)
-  if (TestCpuFlag(kCpuHasSSE2) && IS_ALIGNED(width, 4)) {
-    ARGBToRGB565Row = ARGBToRGB565Row_SSE2;
+#elif defined(HAS_I422TORGB565ROW_NEON)
+  if (TestCpuFlag(kCpuHasNEON)) {
+    NV12ToRGB565Row = NV12ToRGB565Row_Any_NEON;
+    if (IS_ALIGNED(width, 8)) {
+      NV12ToRGB565Row = NV12ToRGB565Row_NEON;
+    }
   }
 #endif
 
   for (int y = 0; y < height; ++y) {
-    NV12ToARGBRow(src_y, src_uv, row, width);
-    ARGBToRGB565Row(row, dst_rgb565, width);
+    NV12ToRGB565Row(src_y, src_uv, dst_rgb565, width);
     dst_rgb565 += dst_stride_rgb565;
     src_y += src_stride_y;
     if (y & 1) {
@@ -887,28 +1408,28 @@ int NV21ToRGB565(const uint8* src_y, int src_stride_y,
     dst_rgb565 = dst_rgb565 + (height - 1) * dst_stride_rgb565;
     dst_stride_rgb565 = -dst_stride_rgb565;
   }
-  void (*NV21ToARGBRow)(const uint8* y_buf,
-                        const uint8* uv_buf,
-                        uint8* rgb_buf,
-                        int width) = NV21ToARGBRow_C;
-#if defined(HAS_NV21TOARGBROW_SSSE3)
-  if (TestCpuFlag(kCpuHasSSSE3) && width * 4 <= kMaxStride) {
-    NV21ToARGBRow = NV21ToARGBRow_SSSE3;
+  void (*NV21ToRGB565Row)(const uint8* y_buf,
+                          const uint8* uv_buf,
+                          uint8* rgb_buf,
+                          int width) = NV21ToRGB565Row_C;
+#if defined(HAS_I422TORGB565ROW_SSSE3)
+  if (TestCpuFlag(kCpuHasSSSE3)) {
+    NV21ToRGB565Row = NV21ToRGB565Row_Any_SSSE3;
+    if (IS_ALIGNED(width, 8)) {
+      NV21ToRGB565Row = NV21ToRGB565Row_SSSE3;
+    }
   }
-#endif
-
-  SIMD_ALIGNED(uint8 row[kMaxStride]);
-  void (*ARGBToRGB565Row)(const uint8* src_argb, uint8* dst_rgb, int pix) =
-      ARGBToRGB565Row_C;
-#if defined(HAS_ARGBTORGB565ROW_SSE2)
-  if (TestCpuFlag(kCpuHasSSE2) && IS_ALIGNED(width, 4)) {
-    ARGBToRGB565Row = ARGBToRGB565Row_SSE2;
+#elif defined(HAS_I422TORGB565ROW_NEON)
+  if (TestCpuFlag(kCpuHasNEON)) {
+    NV21ToRGB565Row = NV21ToRGB565Row_Any_NEON;
+    if (IS_ALIGNED(width, 8)) {
+      NV21ToRGB565Row = NV21ToRGB565Row_NEON;
+    }
   }
 #endif
 
   for (int y = 0; y < height; ++y) {
-    NV21ToARGBRow(src_y, src_vu, row, width);
-    ARGBToRGB565Row(row, dst_rgb565, width);
+    NV21ToRGB565Row(src_y, src_vu, dst_rgb565, width);
     dst_rgb565 += dst_stride_rgb565;
     src_y += src_stride_y;
     if (y & 1) {
@@ -1355,6 +1876,388 @@ int ARGBBlur(const uint8* src_argb, int src_stride_argb,
   return 0;
 }
 
+static const int kMaxPlaneBlurRadius = 127;
+
+// A box blur pass over a band of rows, shared by PlaneBlur and ARGBBoxBlur.
+// Column sums are updated by adding the row entering the box and
+// subtracting the row leaving it, so the cost does not depend on radius.
+// Each output row is then averaged from the running sum of the column sums.
+// The box for pixel i covers [max(i - radius, first), min(i + radius, n - 1)]
+// on each axis.
+struct BoxBlur {
+  const uint8* src;
+  int src_stride;
+  uint8* dst;
+  int dst_stride;
+  int width;
+  int height;
+  int bpp;
+  int radius;
+  int first;
+  float rounding;
+  bool in_place;
+  // Per band: column sums, their running sum along the row and, when
+  // blurring in place, a ring of radius + 1 rows followed by the radius rows
+  // below the band, saved before any band starts.
+  uint8* scratch;
+  int band_scratch_size;
+  int num_bands;
+  void (*BlurColumnAddRow)(const uint8* src, uint16* sum, int width);
+  void (*BlurColumnSubRow)(const uint8* src, uint16* sum, int width);
+  void (*BlurCumulativeSumRow)(const uint16* sum, int32* cumsum, int width);
+  void (*BlurCumulativeSumToAverageRow)(const int32* cumsum, int diameter,
+      float ooa, float rounding, uint8* dst, int count);
+};
+
+static void InitBoxBlur(BoxBlur* p, int width, int height, int bpp,
+                        int radius, int first, float rounding,
+                        bool in_place, int num_bands) {
+  const int row_size = width * bpp;
+  const int stride = (row_size + 15) & ~15;
+  p->width = width;
+  p->height = height;
+  p->bpp = bpp;
+  p->radius = radius;
+  p->first = first;
+  p->rounding = rounding;
+  p->in_place = in_place;
+  p->num_bands = num_bands;
+  p->band_scratch_size = stride * 2 + (stride + 16) * 4 +
+      (in_place ? stride * (radius * 2 + 1) : 0);
+  p->BlurColumnAddRow = BlurColumnAddRow_C;
+  p->BlurColumnSubRow = BlurColumnSubRow_C;
+  p->BlurCumulativeSumRow = bpp == 4 ? ARGBBlurCumulativeSumRow_C :
+      BlurCumulativeSumRow_C;
+  p->BlurCumulativeSumToAverageRow = BlurCumulativeSumToAverageRow_C;
+#if defined(HAS_BLURCOLUMNROW_SSE2)
+  if (TestCpuFlag(kCpuHasSSE2) && row_size >= 16) {
+    p->BlurColumnAddRow = BlurColumnAddRow_Any_SSE2;
+    p->BlurColumnSubRow = BlurColumnSubRow_Any_SSE2;
+    if (IS_ALIGNED(row_size, 16)) {
+      p->BlurColumnAddRow = BlurColumnAddRow_SSE2;
+      p->BlurColumnSubRow = BlurColumnSubRow_SSE2;
+    }
+  }
+#elif defined(HAS_BLURCOLUMNROW_NEON)
+  if (TestCpuFlag(kCpuHasNEON) && row_size >= 16) {
+    p->BlurColumnAddRow = BlurColumnAddRow_Any_NEON;
+    p->BlurColumnSubRow = BlurColumnSubRow_Any_NEON;
+    if (IS_ALIGNED(row_size, 16)) {
+      p->BlurColumnAddRow = BlurColumnAddRow_NEON;
+      p->BlurColumnSubRow = BlurColumnSubRow_NEON;
+    }
+  }
+#endif
+#if defined(HAS_BLURCUMULATIVESUMROW_SSE2)
+  if (TestCpuFlag(kCpuHasSSE2) && bpp == 1 && width >= 8) {
+    p->BlurCumulativeSumRow = BlurCumulativeSumRow_Any_SSE2;
+    if (IS_ALIGNED(width, 8)) {
+      p->BlurCumulativeSumRow = BlurCumulativeSumRow_SSE2;
+    }
+  }
+#endif
+#if defined(HAS_ARGBBLURCUMULATIVESUMROW_SSE2)
+  if (TestCpuFlag(kCpuHasSSE2) && bpp == 4) {
+    p->BlurCumulativeSumRow = ARGBBlurCumulativeSumRow_SSE2;
+  }
+#elif defined(HAS_ARGBBLURCUMULATIVESUMROW_NEON)
+  if (TestCpuFlag(kCpuHasNEON) && bpp == 4) {
+    p->BlurCumulativeSumRow = ARGBBlurCumulativeSumRow_NEON;
+  }
+#endif
+#if defined(HAS_BLURCUMULATIVESUMTOAVERAGEROW_SSE2)
+  if (TestCpuFlag(kCpuHasSSE2)) {
+    p->BlurCumulativeSumToAverageRow = BlurCumulativeSumToAverageRow_Any_SSE2;
+  }
+#elif defined(HAS_BLURCUMULATIVESUMTOAVERAGEROW_NEON)
+  if (TestCpuFlag(kCpuHasNEON)) {
+    p->BlurCumulativeSumToAverageRow = BlurCumulativeSumToAverageRow_Any_NEON;
+  }
+#endif
+}
+
+// Saves the rows around each band that neighbouring bands overwrite, so a
+// pass can run in place with all bands at once.
+static void SaveBoxBlurBandEdges(BoxBlur* p) {
+  const int row_size = p->width * p->bpp;
+  const int stride = (row_size + 15) & ~15;
+  const int radius = p->radius;
+  for (int band = 0; band < p->num_bands; ++band) {
+    const int y0 = band * p->height / p->num_bands;
+    const int y1 = (band + 1) * p->height / p->num_bands;
+    uint8* ring = p->scratch + band * p->band_scratch_size +
+        stride * 2 + (stride + 16) * 4;
+    uint8* below = ring + stride * (radius + 1);
+    for (int y = y0 - radius > 0 ? y0 - radius : 0; y < y0; ++y) {
+      memcpy(ring + (y % (radius + 1)) * stride, p->src + y * p->src_stride,
+             row_size);
+    }
+    for (int y = y1; y < y1 + radius && y < p->height; ++y) {
+      memcpy(below + (y - y1) * stride, p->src + y * p->src_stride,
+             row_size);
+    }
+  }
+}
+
+// Averages one pixel whose box is clipped by the left or right edge.
+static void BoxBlurEdgePixel(const BoxBlur* p, const int32* cumsum, int rows,
+                             int x, uint8* dst) {
+  const int x0 = x - p->radius > p->first ? x - p->radius : p->first;
+  const int x1 = x + p->radius + 1 < p->width ? x + p->radius + 1 : p->width;
+  BlurCumulativeSumToAverageRow_C(cumsum + x0 * p->bpp, (x1 - x0) * p->bpp,
+                                  1.0f / ((x1 - x0) * rows), p->rounding,
+                                  dst + x * p->bpp, p->bpp);
+}
+
+static void BoxBlurRows(void* param, int y, int height) {
+  const BoxBlur* p = static_cast<const BoxBlur*>(param);
+  int band = 0;
+  while (band * p->height / p->num_bands < y) {
+    ++band;
+  }
+  const int width = p->width;
+  const int bpp = p->bpp;
+  const int radius = p->radius;
+  const int first = p->first;
+  const int stride = (width * bpp + 15) & ~15;
+  uint8* scratch = p->scratch + band * p->band_scratch_size;
+  uint16* sum = reinterpret_cast<uint16*>(scratch);
+  int32* cumsum = reinterpret_cast<int32*>(scratch + stride * 2);
+  uint8* ring = scratch + stride * 2 + (stride + 16) * 4;
+  uint8* below = ring + stride * (radius + 1);
+  const int y0 = y;
+  const int y1 = y + height;
+  const int diameter = radius * 2 + 1;
+  // Pixels from left to right have a box that is not clipped by the edges.
+  const int left = radius + first < width ? radius + first : width;
+  const int right = width - radius > left ? width - radius : left;
+
+  memset(sum, 0, width * bpp * sizeof(sum[0]));
+  memset(cumsum, 0, bpp * sizeof(cumsum[0]));
+  int bot_y = y0 - radius > first ? y0 - radius : first;
+  int top_y = bot_y;
+  for (y = y0; y < y1; ++y) {
+    const int end_y = y + radius + 1 < p->height ? y + radius + 1 : p->height;
+    for (; bot_y < end_y; ++bot_y) {
+      const uint8* src = p->src + bot_y * p->src_stride;
+      if (p->in_place && bot_y >= y1) {
+        src = below + (bot_y - y1) * stride;
+      } else if (p->in_place && bot_y < y) {
+        src = ring + (bot_y % (radius + 1)) * stride;
+      }
+      p->BlurColumnAddRow(src, sum, width * bpp);
+    }
+    for (; top_y < y - radius; ++top_y) {
+      const uint8* src = p->src + top_y * p->src_stride;
+      if (p->in_place) {
+        src = ring + (top_y % (radius + 1)) * stride;
+      }
+      p->BlurColumnSubRow(src, sum, width * bpp);
+    }
+    const int rows = bot_y - top_y;
+    p->BlurCumulativeSumRow(sum, cumsum, width);
+    if (p->in_place) {
+      memcpy(ring + (y % (radius + 1)) * stride, p->src + y * p->src_stride,
+             width * bpp);
+    }
+
+    uint8* dst = p->dst + y * p->dst_stride;
+    if (right > left) {
+      p->BlurCumulativeSumToAverageRow(cumsum + (left - radius) * bpp,
+                                       diameter * bpp,
+                                       1.0f / (diameter * rows), p->rounding,
+                                       dst + left * bpp, (right - left) * bpp);
+    }
+    for (int x = 0; x < left; ++x) {
+      BoxBlurEdgePixel(p, cumsum, rows, x, dst);
+    }
+    for (int x = right; x < width; ++x) {
+      BoxBlurEdgePixel(p, cumsum, rows, x, dst);
+    }
+  }
+}
+
+// Negative height means invert the image. Inverting in place moves rows
+// over ones still to be read, so the source is copied first. Returns the
+// copy to delete, or NULL.
+static uint8* InvertBlurSource(const uint8** src, int* src_stride,
+                               const uint8* dst, int row_bytes, int* height) {
+  uint8* copy_mem = NULL;
+  if (*height < 0) {
+    *height = -*height;
+    if (*src == dst) {
+      const int copy_stride = (row_bytes + 15) & ~15;
+      copy_mem = new uint8[copy_stride * *height + 15];
+      uint8* copy = ALIGNP(copy_mem, 16);
+      CopyPlane(*src, *src_stride, copy, copy_stride, row_bytes, *height);
+      *src = copy;
+      *src_stride = copy_stride;
+    }
+    *src = *src + (*height - 1) * *src_stride;
+    *src_stride = -*src_stride;
+  }
+  return copy_mem;
+}
+
+// Runs iterations box blur passes over all bands. The first pass reads src
+// and the rest blur dst in place.
+static void RunBoxBlur(const uint8* src, int src_stride,
+                       uint8* dst, int dst_stride,
+                       int width, int height, int bpp, int radius, int first,
+                       float rounding, int iterations, int num_threads) {
+  const int num_bands = BandCount(height, num_threads);
+  BoxBlur p;
+  InitBoxBlur(&p, width, height, bpp, radius, first, rounding,
+              src == dst || iterations > 1, num_bands);
+  uint8* scratch_mem = new uint8[p.band_scratch_size * num_bands + 15];
+  p.scratch = ALIGNP(scratch_mem, 16);
+  p.dst = dst;
+  p.dst_stride = dst_stride;
+  for (int i = 0; i < iterations; ++i) {
+    p.src = i == 0 ? src : dst;
+    p.src_stride = i == 0 ? src_stride : dst_stride;
+    p.in_place = p.src == dst;
+    if (p.in_place) {
+      SaveBoxBlurBandEdges(&p);
+    }
+    RunBands(BoxBlurRows, &p, height, num_bands);
+  }
+  delete [] scratch_mem;
+}
+
+// Blur a plane with iterations passes of a box filter.
+LIBYUV_API
+int PlaneBlur(const uint8* src_y, int src_stride_y,
+              uint8* dst_y, int dst_stride_y,
+              int width, int height, int radius, int iterations) {
+  if (!src_y || !dst_y || width <= 0 || height == 0 ||
+      radius < 0 || radius > kMaxPlaneBlurRadius || iterations < 1) {
+    return -1;
+  }
+  uint8* copy_mem = InvertBlurSource(&src_y, &src_stride_y, dst_y, width,
+                                     &height);
+  RunBoxBlur(src_y, src_stride_y, dst_y, dst_stride_y, width, height, 1,
+             radius, 0, 0.5f, iterations, 1);
+  delete [] copy_mem;
+  return 0;
+}
+
+// Blur ARGB with a box filter, as ARGBBlur does, without a cumulative sum
+// table.
+LIBYUV_API
+int ARGBBoxBlur(const uint8* src_argb, int src_stride_argb,
+                uint8* dst_argb, int dst_stride_argb,
+                int width, int height, int radius, int iterations,
+                int num_threads) {
+  if (!src_argb || !dst_argb || width < 2 || (height > -2 && height < 2) ||
+      radius < 1 || radius > kMaxPlaneBlurRadius || iterations < 1) {
+    return -1;
+  }
+  uint8* copy_mem = InvertBlurSource(&src_argb, &src_stride_argb, dst_argb,
+                                     width * 4, &height);
+  // ARGBBlur leaves out the first row and column and truncates.
+  RunBoxBlur(src_argb, src_stride_argb, dst_argb, dst_stride_argb,
+             width, height, 4, radius, 1, 0.0f, iterations, num_threads);
+  delete [] copy_mem;
+  return 0;
+}
+
+// Blur I420 with half the radius for chroma.
+LIBYUV_API
+int I420Blur(const uint8* src_y, int src_stride_y,
+             const uint8* src_u, int src_stride_u,
+             const uint8* src_v, int src_stride_v,
+             uint8* dst_y, int dst_stride_y,
+             uint8* dst_u, int dst_stride_u,
+             uint8* dst_v, int dst_stride_v,
+             int width, int height, int radius, int iterations) {
+  if (!src_u || !src_v || !dst_u || !dst_v ||
+      PlaneBlur(src_y, src_stride_y, dst_y, dst_stride_y,
+                width, height, radius, iterations) != 0) {
+    return -1;
+  }
+  const int halfwidth = (width + 1) >> 1;
+  const int halfheight = height < 0 ? -((1 - height) >> 1) : (height + 1) >> 1;
+  const int halfradius = (radius + 1) >> 1;
+  PlaneBlur(src_u, src_stride_u, dst_u, dst_stride_u,
+            halfwidth, halfheight, halfradius, iterations);
+  PlaneBlur(src_v, src_stride_v, dst_v, dst_stride_v,
+            halfwidth, halfheight, halfradius, iterations);
+  return 0;
+}
+
+// Sharpen a plane with an unsharp mask.
+LIBYUV_API
+int PlaneUnsharpMask(const uint8* src_y, int src_stride_y,
+                     uint8* dst_y, int dst_stride_y,
+                     int width, int height,
+                     int radius, int amount, int threshold) {
+  if (!src_y || !dst_y || width <= 0 || height == 0 ||
+      radius < 0 || radius > kMaxPlaneBlurRadius ||
+      amount < 0 || amount > 32767 || threshold < 0 || threshold > 255) {
+    return -1;
+  }
+  uint8* copy_mem = InvertBlurSource(&src_y, &src_stride_y, dst_y, width,
+                                     &height);
+  void (*UnsharpMaskRow)(const uint8* src, const uint8* src_blur, uint8* dst,
+                         int amount, int threshold, int width) =
+      UnsharpMaskRow_C;
+#if defined(HAS_UNSHARPMASKROW_SSE2)
+  if (TestCpuFlag(kCpuHasSSE2) && width >= 8) {
+    UnsharpMaskRow = UnsharpMaskRow_Any_SSE2;
+    if (IS_ALIGNED(width, 8)) {
+      UnsharpMaskRow = UnsharpMaskRow_SSE2;
+    }
+  }
+#endif
+  // The blur goes to dst, which the mask then updates a row at a time, unless
+  // the source is being sharpened in place.
+  uint8* blur_mem = NULL;
+  uint8* blur = dst_y;
+  int blur_stride = dst_stride_y;
+  if (src_y == dst_y) {
+    blur_stride = (width + 15) & ~15;
+    blur_mem = new uint8[blur_stride * height + 15];
+    blur = ALIGNP(blur_mem, 16);
+  }
+  PlaneBlur(src_y, src_stride_y, blur, blur_stride, width, height, radius, 3);
+  for (int y = 0; y < height; ++y) {
+    UnsharpMaskRow(src_y, blur, dst_y, amount, threshold, width);
+    src_y += src_stride_y;
+    blur += blur_stride;
+    dst_y += dst_stride_y;
+  }
+  delete [] blur_mem;
+  delete [] copy_mem;
+  return 0;
+}
+
+// Sharpen the luma of I420.
+LIBYUV_API
+int I420UnsharpMask(const uint8* src_y, int src_stride_y,
+                    const uint8* src_u, int src_stride_u,
+                    const uint8* src_v, int src_stride_v,
+                    uint8* dst_y, int dst_stride_y,
+                    uint8* dst_u, int dst_stride_u,
+                    uint8* dst_v, int dst_stride_v,
+                    int width, int height,
+                    int radius, int amount, int threshold) {
+  if (!src_u || !src_v || !dst_u || !dst_v ||
+      PlaneUnsharpMask(src_y, src_stride_y, dst_y, dst_stride_y,
+                       width, height, radius, amount, threshold) != 0) {
+    return -1;
+  }
+  const int halfwidth = (width + 1) >> 1;
+  const int halfheight = height < 0 ? -((1 - height) >> 1) : (height + 1) >> 1;
+  if (src_u != dst_u) {
+    CopyPlane(src_u, src_stride_u, dst_u, dst_stride_u, halfwidth, halfheight);
+  }
+  if (src_v != dst_v) {
+    CopyPlane(src_v, src_stride_v, dst_v, dst_stride_v, halfwidth, halfheight);
+  }
+  return 0;
+}
+
 // Multiply ARGB image by a specified ARGB value.
 LIBYUV_API
 int ARGBShade(const uint8* src_argb, int src_stride_argb,
@@ -1386,6 +2289,245 @@ int ARGBShade(const uint8* src_argb, int src_stride_argb,
   return 0;
 }
 
+enum ARGBEffectType {
+  kEffectGray = 0,
+  kEffectSepia = 1,
+  kEffectMatrix = 2,
+  kEffectTable = 3,
+};
+
+// Color matrices with the same results as ARGBGrayRow_C and ARGBSepiaRow_C.
+static const int8 kGrayMatrix[12] = {
+  14, 76, 38, 0, 14, 76, 38, 0, 14, 76, 38, 0,
+};
+static const int8 kSepiaMatrix[12] = {
+  17, 68, 35, 0, 22, 88, 45, 0, 24, 98, 50, 0,
+};
+
+LIBYUV_API
+int ARGBEffectChainInit(ARGBEffectChain* chain) {
+  if (!chain) {
+    return -1;
+  }
+  chain->num_effects = 0;
+  return 0;
+}
+
+// Fold matrix 'first' followed by matrix 'second' into 'dst'.
+// Only done when 'first' has no negative coefficients and no row sums over
+// 1.0, so it never clamps, and each pair of the folded coefficients sums to
+// at most 1.0, so pmaddubsw in ARGBColorMatrixRow_SSSE3 does not saturate.
+static bool FoldColorMatrix(const int8* first, const int8* second, int8* dst) {
+  for (int i = 0; i < 3; ++i) {
+    int sum = 0;
+    for (int j = 0; j < 4; ++j) {
+      if (first[i * 4 + j] < 0) {
+        return false;
+      }
+      sum += first[i * 4 + j];
+    }
+    if (sum > 128) {
+      return false;
+    }
+  }
+  int8 folded[12];
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 4; ++j) {
+      int sum = 0;
+      for (int k = 0; k < 3; ++k) {
+        sum += second[i * 4 + k] * first[k * 4 + j];
+      }
+      if (j == 3) {
+        sum += second[i * 4 + 3] * 128;  // Alpha passes through 'first'.
+      }
+      sum = (sum + 64) >> 7;
+      if (sum < -128 || sum > 127) {
+        return false;
+      }
+      folded[i * 4 + j] = static_cast<int8>(sum);
+    }
+    if (abs(folded[i * 4 + 0]) + abs(folded[i * 4 + 1]) > 128 ||
+        abs(folded[i * 4 + 2]) + abs(folded[i * 4 + 3]) > 128) {
+      return false;
+    }
+  }
+  memcpy(dst, folded, sizeof(folded));
+  return true;
+}
+
+static int AddLinearEffect(ARGBEffectChain* chain, int type,
+                           const int8* matrix_argb) {
+  if (!chain || !matrix_argb) {
+    return -1;
+  }
+  if (chain->num_effects > 0) {
+    ARGBEffect* last = &chain->effects[chain->num_effects - 1];
+    if (last->type != kEffectTable &&
+        FoldColorMatrix(last->matrix_argb, matrix_argb, last->matrix_argb)) {
+      last->type = kEffectMatrix;
+      return 0;
+    }
+  }
+  if (chain->num_effects >= kMaxARGBEffects) {
+    return -1;
+  }
+  ARGBEffect* effect = &chain->effects[chain->num_effects++];
+  effect->type = type;
+  memcpy(effect->matrix_argb, matrix_argb, sizeof(effect->matrix_argb));
+  return 0;
+}
+
+// Add a table, composing it with a table just before it.
+static int AddTableEffect(ARGBEffectChain* chain, const uint8* table_argb) {
+  if (chain->num_effects > 0) {
+    ARGBEffect* last = &chain->effects[chain->num_effects - 1];
+    if (last->type == kEffectTable) {
+      for (int i = 0; i < 256 * 4; ++i) {
+        last->table_argb[i] = table_argb[last->table_argb[i] * 4 + (i & 3)];
+      }
+      return 0;
+    }
+  }
+  if (chain->num_effects >= kMaxARGBEffects) {
+    return -1;
+  }
+  ARGBEffect* effect = &chain->effects[chain->num_effects++];
+  effect->type = kEffectTable;
+  memcpy(effect->table_argb, table_argb, sizeof(effect->table_argb));
+  return 0;
+}
+
+LIBYUV_API
+int ARGBEffectChainAddGray(ARGBEffectChain* chain) {
+  return AddLinearEffect(chain, kEffectGray, kGrayMatrix);
+}
+
+LIBYUV_API
+int ARGBEffectChainAddSepia(ARGBEffectChain* chain) {
+  return AddLinearEffect(chain, kEffectSepia, kSepiaMatrix);
+}
+
+LIBYUV_API
+int ARGBEffectChainAddColorMatrix(ARGBEffectChain* chain,
+                                  const int8* matrix_argb) {
+  return AddLinearEffect(chain, kEffectMatrix, matrix_argb);
+}
+
+LIBYUV_API
+int ARGBEffectChainAddColorTable(ARGBEffectChain* chain,
+                                 const uint8* table_argb) {
+  if (!chain || !table_argb) {
+    return -1;
+  }
+  return AddTableEffect(chain, table_argb);
+}
+
+// Quantize as a table. Values saturate like ARGBQuantizeRow_SSE2.
+LIBYUV_API
+int ARGBEffectChainAddQuantize(ARGBEffectChain* chain,
+                               int scale, int interval_size,
+                               int interval_offset) {
+  if (!chain || interval_size < 1 || interval_size > 255) {
+    return -1;
+  }
+  uint8 table_argb[256 * 4];
+  for (int i = 0; i < 256; ++i) {
+    int v = (i * scale >> 16) * interval_size + interval_offset;
+    v = v < 0 ? 0 : v > 255 ? 255 : v;
+    table_argb[i * 4 + 0] = table_argb[i * 4 + 1] = table_argb[i * 4 + 2] =
+        static_cast<uint8>(v);
+    table_argb[i * 4 + 3] = static_cast<uint8>(i);
+  }
+  return AddTableEffect(chain, table_argb);
+}
+
+// Shade as a table, with the same math as ARGBShadeRow_C.
+LIBYUV_API
+int ARGBEffectChainAddShade(ARGBEffectChain* chain, uint32 value) {
+  if (!chain || value == 0u) {
+    return -1;
+  }
+  uint8 table_argb[256 * 4];
+  for (int i = 0; i < 256; ++i) {
+    for (int j = 0; j < 4; ++j) {
+      const uint32 scale = (value >> (j * 8)) & 0xff;
+      table_argb[i * 4 + j] =
+          static_cast<uint8>((i * 0x101u) * (scale * 0x101u) >> 24);
+    }
+  }
+  return AddTableEffect(chain, table_argb);
+}
+
+// Pixels of a row run through the chain at a time. 2 KB stays in L1 cache.
+static const int kEffectSpan = 512;
+
+LIBYUV_API
+int ARGBEffectChainApply(const ARGBEffectChain* chain,
+                         uint8* dst_argb, int dst_stride_argb,
+                         int dst_x, int dst_y, int width, int height) {
+  if (!chain || !dst_argb || width <= 0 || height <= 0 ||
+      dst_x < 0 || dst_y < 0) {
+    return -1;
+  }
+  void (*ARGBGrayRow)(const uint8* src_argb, uint8* dst_argb,
+                      int width) = ARGBGrayRow_C;
+  void (*ARGBSepiaRow)(uint8* dst_argb, int width) = ARGBSepiaRow_C;
+  void (*ARGBColorMatrixRow)(uint8* dst_argb, const int8* matrix_argb,
+                             int width) = ARGBColorMatrixRow_C;
+  void (*ARGBColorTableRow)(uint8* dst_argb, const uint8* table_argb,
+                            int width) = ARGBColorTableRow_C;
+  uint8* dst = dst_argb + dst_y * dst_stride_argb + dst_x * 4;
+#if defined(HAS_ARGBGRAYROW_SSSE3)
+  if (TestCpuFlag(kCpuHasSSSE3) && IS_ALIGNED(width, 8) &&
+      IS_ALIGNED(dst, 16) && IS_ALIGNED(dst_stride_argb, 16)) {
+    ARGBGrayRow = ARGBGrayRow_SSSE3;
+  }
+#endif
+#if defined(HAS_ARGBSEPIAROW_SSSE3)
+  if (TestCpuFlag(kCpuHasSSSE3) && IS_ALIGNED(width, 8) &&
+      IS_ALIGNED(dst, 16) && IS_ALIGNED(dst_stride_argb, 16)) {
+    ARGBSepiaRow = ARGBSepiaRow_SSSE3;
+  }
+#endif
+#if defined(HAS_ARGBCOLORMATRIXROW_SSSE3)
+  if (TestCpuFlag(kCpuHasSSSE3) && IS_ALIGNED(width, 8) &&
+      IS_ALIGNED(dst, 16) && IS_ALIGNED(dst_stride_argb, 16)) {
+    ARGBColorMatrixRow = ARGBColorMatrixRow_SSSE3;
+  }
+#endif
+#if defined(HAS_ARGBCOLORTABLEROW_X86)
+  if (TestCpuFlag(kCpuHasX86)) {
+    ARGBColorTableRow = ARGBColorTableRow_X86;
+  }
+#endif
+
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; x += kEffectSpan) {
+      uint8* span = dst + x * 4;
+      const int n = width - x < kEffectSpan ? width - x : kEffectSpan;
+      for (int i = 0; i < chain->num_effects; ++i) {
+        const ARGBEffect& effect = chain->effects[i];
+        switch (effect.type) {
+          case kEffectGray:
+            ARGBGrayRow(span, span, n);
+            break;
+          case kEffectSepia:
+            ARGBSepiaRow(span, n);
+            break;
+          case kEffectMatrix:
+            ARGBColorMatrixRow(span, effect.matrix_argb, n);
+            break;
+          default:
+            ARGBColorTableRow(span, effect.table_argb, n);
+            break;
+        }
+      }
+    }
+    dst += dst_stride_argb;
+  }
+  return 0;
+}
+
 // Interpolate 2 ARGB images by specified amount (0 to 255).
 LIBYUV_API
 int ARGBInterpolate(const uint8* src_argb0, int src_stride_argb0,
@@ -1422,6 +2564,467 @@ int ARGBInterpolate(const uint8* src_argb0, int src_stride_argb0,
   return 0;
 }
 
+// Affine warp of a plane of 1 (planar) or 4 (ARGB) bytes per pixel.
+// Each row is split into an interior span, where the whole filter footprint
+// is inside the source and the row functions run without checks, and border
+// pixels on either side, which are sampled one at a time with the border
+// mode applied.
+struct AffinePlane {
+  const uint8* src;
+  int src_stride;
+  int src_width;
+  int src_height;
+  uint8* dst;
+  int dst_stride;
+  int dst_width;
+  int bpp;
+  float matrix[6];
+  bool bilinear;
+  AffineBorder border;
+  uint8 value[4];
+  void (*AffineRow)(const uint8* src, int src_stride,
+                    uint8* dst, const float* uv_dudv, int width);
+};
+
+// Interior spans are split into runs of this many pixels, each starting
+// from an exact position, which bounds the drift of the row functions
+// stepping uv with float adds.
+static const int kAffineRun = 256;
+
+// Returns the source pixel for x, y, or NULL if outside for constant border.
+static const uint8* AffineBorderPixel(const AffinePlane* p, int x, int y) {
+  if (x < 0 || x >= p->src_width || y < 0 || y >= p->src_height) {
+    if (p->border == kAffineBorderConstant) {
+      return NULL;
+    }
+    x = x < 0 ? 0 : (x >= p->src_width ? p->src_width - 1 : x);
+    y = y < 0 ? 0 : (y >= p->src_height ? p->src_height - 1 : y);
+  }
+  return p->src + y * p->src_stride + x * p->bpp;
+}
+
+static void AffineBorderPixels(const AffinePlane* p, float u, float v,
+                               int x, int count, uint8* dst) {
+  const float du = p->matrix[0];
+  const float dv = p->matrix[3];
+  // Far away positions all sample the border, so clamp them before the
+  // conversion to int.
+  const float maxu = static_cast<float>(p->src_width + 1);
+  const float maxv = static_cast<float>(p->src_height + 1);
+  for (int i = 0; i < count; ++i) {
+    float pu = u + du * static_cast<float>(x + i);
+    float pv = v + dv * static_cast<float>(x + i);
+    pu = pu < -2.f ? -2.f : (pu > maxu ? maxu : pu);
+    pv = pv < -2.f ? -2.f : (pv > maxv ? maxv : pv);
+    if (!p->bilinear) {
+      const uint8* src = AffineBorderPixel(p,
+          static_cast<int>(floor(pu)), static_cast<int>(floor(pv)));
+      memcpy(dst, src ? src : p->value, p->bpp);
+    } else {
+      int xi = static_cast<int>(floor(pu * 256.f));
+      int yi = static_cast<int>(floor(pv * 256.f));
+      int x1_fraction = xi & 255;
+      int x0_fraction = 256 - x1_fraction;
+      int y1_fraction = yi & 255;
+      int y0_fraction = 256 - y1_fraction;
+      const uint8* s00 = AffineBorderPixel(p, xi >> 8, yi >> 8);
+      const uint8* s01 = AffineBorderPixel(p, (xi >> 8) + 1, yi >> 8);
+      const uint8* s10 = AffineBorderPixel(p, xi >> 8, (yi >> 8) + 1);
+      const uint8* s11 = AffineBorderPixel(p, (xi >> 8) + 1, (yi >> 8) + 1);
+      for (int j = 0; j < p->bpp; ++j) {
+        int top = ((s00 ? s00[j] : p->value[j]) * x0_fraction +
+                   (s01 ? s01[j] : p->value[j]) * x1_fraction) >> 8;
+        int bot = ((s10 ? s10[j] : p->value[j]) * x0_fraction +
+                   (s11 ? s11[j] : p->value[j]) * x1_fraction) >> 8;
+        dst[j] = (top * y0_fraction + bot * y1_fraction) >> 8;
+      }
+    }
+    dst += p->bpp;
+  }
+}
+
+// Narrows [*x0, *x1) to the x where lo <= start + x * step <= hi.
+static void AffineSpan(double start, double step, double lo, double hi,
+                       int* x0, int* x1) {
+  if (step == 0.) {
+    if (start < lo || start > hi) {
+      *x1 = *x0;
+    }
+    return;
+  }
+  double a = (lo - start) / step;
+  double b = (hi - start) / step;
+  if (a > b) {
+    double t = a;
+    a = b;
+    b = t;
+  }
+  if (a >= *x1 || b < *x0) {
+    *x1 = *x0;
+    return;
+  }
+  if (a > *x0) {
+    *x0 = static_cast<int>(ceil(a));
+  }
+  if (b < *x1 - 1) {
+    *x1 = static_cast<int>(floor(b)) + 1;
+  }
+  if (*x1 < *x0) {
+    *x1 = *x0;
+  }
+}
+
+static void AffinePlaneRows(void* param, int y, int height) {
+  const AffinePlane* p = static_cast<const AffinePlane*>(param);
+  const float* m = p->matrix;
+  // Keep 1 pixel from the edges, which covers the float rounding of the
+  // row functions. Bilinear also reads the pixel right of and below.
+  const double maxu = p->src_width - (p->bilinear ? 2 : 1);
+  const double maxv = p->src_height - (p->bilinear ? 2 : 1);
+  uint8* dst = p->dst + y * p->dst_stride;
+  for (int j = y; j < y + height; ++j) {
+    float u = m[1] * static_cast<float>(j) + m[2];
+    float v = m[4] * static_cast<float>(j) + m[5];
+    int x0 = 0;
+    int x1 = p->dst_width;
+    AffineSpan(static_cast<double>(m[1]) * j + m[2], m[0], 1., maxu, &x0, &x1);
+    AffineSpan(static_cast<double>(m[4]) * j + m[5], m[3], 1., maxv, &x0, &x1);
+    AffineBorderPixels(p, u, v, 0, x0, dst);
+    for (int x = x0; x < x1; x += kAffineRun) {
+      float uv_dudv[4];
+      uv_dudv[0] = u + m[0] * static_cast<float>(x);
+      uv_dudv[1] = v + m[3] * static_cast<float>(x);
+      uv_dudv[2] = m[0];
+      uv_dudv[3] = m[3];
+      int n = x1 - x < kAffineRun ? x1 - x : kAffineRun;
+      p->AffineRow(p->src, p->src_stride, dst + x * p->bpp, uv_dudv, n);
+    }
+    AffineBorderPixels(p, u, v, x1, p->dst_width - x1, dst + x1 * p->bpp);
+    dst += p->dst_stride;
+  }
+}
+
+static void AffinePlaneBands(AffinePlane* p, int dst_height, int num_threads) {
+  RunBands(AffinePlaneRows, p, dst_height, num_threads);
+}
+
+static void InitAffinePlane(AffinePlane* p,
+                            const uint8* src, int src_stride,
+                            int src_width, int src_height,
+                            uint8* dst, int dst_stride, int dst_width,
+                            int bpp, const float* matrix,
+                            FilterMode filtering, AffineBorder border) {
+  p->src = src;
+  p->src_stride = src_stride;
+  p->src_width = src_width;
+  p->src_height = src_height;
+  p->dst = dst;
+  p->dst_stride = dst_stride;
+  p->dst_width = dst_width;
+  p->bpp = bpp;
+  for (int i = 0; i < 6; ++i) {
+    p->matrix[i] = matrix[i];
+  }
+  p->bilinear = filtering != kFilterNone;
+  p->border = border;
+  memset(p->value, 0, sizeof(p->value));
+  if (bpp == 1) {
+    p->AffineRow = p->bilinear ? AffineRowBilinear_C : AffineRow_C;
+    return;
+  }
+  p->AffineRow = p->bilinear ? ARGBAffineRowBilinear_C : ARGBAffineRow_C;
+  // The SSE2 versions form offsets with 16 bit multiplies.
+#if defined(HAS_ARGBAFFINEROW_SSE2)
+  if (!p->bilinear && TestCpuFlag(kCpuHasSSE2) && src_stride < 32768) {
+    p->AffineRow = ARGBAffineRow_SSE2;
+  }
+#endif
+#if defined(HAS_ARGBAFFINEROWBILINEAR_SSE2)
+  if (p->bilinear && TestCpuFlag(kCpuHasSSE2) && src_stride < 32768) {
+    p->AffineRow = ARGBAffineRowBilinear_SSE2;
+  }
+#endif
+}
+
+// Negative src_height flips the source by adjusting the matrix, so the
+// row functions always see a positive stride.
+static void FlipAffineMatrix(const float* matrix, int src_height,
+                             float* flipped) {
+  flipped[0] = matrix[0];
+  flipped[1] = matrix[1];
+  flipped[2] = matrix[2];
+  flipped[3] = -matrix[3];
+  flipped[4] = -matrix[4];
+  flipped[5] = static_cast<float>(src_height - 1) - matrix[5];
+}
+
+// Warp an ARGB image with a 2x3 matrix.
+LIBYUV_API
+int ARGBAffine(const uint8* src_argb, int src_stride_argb,
+               int src_width, int src_height,
+               uint8* dst_argb, int dst_stride_argb,
+               int dst_width, int dst_height,
+               const float* matrix, FilterMode filtering,
+               AffineBorder border, uint32 value, int num_threads) {
+  if (!src_argb || !dst_argb || !matrix || src_width <= 0 ||
+      src_height == 0 || dst_width <= 0 || dst_height <= 0 ||
+      src_stride_argb <= 0) {
+    return -1;
+  }
+  float m[6];
+  if (src_height < 0) {
+    src_height = -src_height;
+    FlipAffineMatrix(matrix, src_height, m);
+    matrix = m;
+  }
+  AffinePlane plane;
+  InitAffinePlane(&plane, src_argb, src_stride_argb, src_width, src_height,
+                  dst_argb, dst_stride_argb, dst_width, 4, matrix,
+                  filtering, border);
+  memcpy(plane.value, &value, 4);
+  AffinePlaneBands(&plane, dst_height, num_threads);
+  return 0;
+}
+
+// Warp an I420 image with a 2x3 matrix.
+LIBYUV_API
+int I420Affine(const uint8* src_y, int src_stride_y,
+               const uint8* src_u, int src_stride_u,
+               const uint8* src_v, int src_stride_v,
+               int src_width, int src_height,
+               uint8* dst_y, int dst_stride_y,
+               uint8* dst_u, int dst_stride_u,
+               uint8* dst_v, int dst_stride_v,
+               int dst_width, int dst_height,
+               const float* matrix, FilterMode filtering,
+               AffineBorder border, int value_y, int value_u, int value_v,
+               int num_threads) {
+  if (!src_y || !src_u || !src_v || !dst_y || !dst_u || !dst_v || !matrix ||
+      src_width <= 0 || src_height == 0 || dst_width <= 0 ||
+      dst_height <= 0 || src_stride_y <= 0 || src_stride_u <= 0 ||
+      src_stride_v <= 0) {
+    return -1;
+  }
+  float m[6];
+  if (src_height < 0) {
+    src_height = -src_height;
+    FlipAffineMatrix(matrix, src_height, m);
+    matrix = m;
+  }
+  // Chroma sample centers are at luma position 2 * x + 0.5.
+  // Map them through the matrix and back to chroma positions.
+  float uv_matrix[6];
+  uv_matrix[0] = matrix[0];
+  uv_matrix[1] = matrix[1];
+  uv_matrix[2] = (matrix[2] + 0.5f * (matrix[0] + matrix[1]) - 0.5f) * 0.5f;
+  uv_matrix[3] = matrix[3];
+  uv_matrix[4] = matrix[4];
+  uv_matrix[5] = (matrix[5] + 0.5f * (matrix[3] + matrix[4]) - 0.5f) * 0.5f;
+  int src_halfwidth = (src_width + 1) >> 1;
+  int src_halfheight = (src_height + 1) >> 1;
+  int dst_halfwidth = (dst_width + 1) >> 1;
+  int dst_halfheight = (dst_height + 1) >> 1;
+
+  AffinePlane plane;
+  InitAffinePlane(&plane, src_y, src_stride_y, src_width, src_height,
+                  dst_y, dst_stride_y, dst_width, 1, matrix,
+                  filtering, border);
+  plane.value[0] = static_cast<uint8>(value_y);
+  AffinePlaneBands(&plane, dst_height, num_threads);
+  InitAffinePlane(&plane, src_u, src_stride_u, src_halfwidth, src_halfheight,
+                  dst_u, dst_stride_u, dst_halfwidth, 1, uv_matrix,
+                  filtering, border);
+  plane.value[0] = static_cast<uint8>(value_u);
+  AffinePlaneBands(&plane, dst_halfheight, num_threads);
+  InitAffinePlane(&plane, src_v, src_stride_v, src_halfwidth, src_halfheight,
+                  dst_v, dst_stride_v, dst_halfwidth, 1, uv_matrix,
+                  filtering, border);
+  plane.value[0] = static_cast<uint8>(value_v);
+  AffinePlaneBands(&plane, dst_halfheight, num_threads);
+  return 0;
+}
+
+// Largest 3D LUT. The grid offset of a channel << 9 fits in 31 bits.
+static const int kMax3DLutSize = 65;
+
+typedef void (*ARGBApply3DLutRowFunc)(const uint8* src_argb, uint8* dst_argb,
+                                      const uint8* lut_argb,
+                                      const int32* lut_index,
+                                      int lut_size, int width);
+
+struct Apply3DLut {
+  const uint8* lut_argb;
+  int lut_size;
+  int32 lut_index[256 * 3];
+  ARGBApply3DLutRowFunc ARGBApply3DLutRow;
+  const uint8* src[3];
+  int src_stride[3];
+  uint8* dst[3];
+  int dst_stride[3];
+  int width;
+  int height;
+};
+
+// Map each 8 bit B, G and R value to its grid cell and the fraction of the
+// way across it. 255 lands at the far side of the last cell, not the start
+// of one past it.
+static void Init3DLut(Apply3DLut* p, const uint8* lut_argb, int lut_size,
+                      int width) {
+  p->lut_argb = lut_argb;
+  p->lut_size = lut_size;
+  const int32 step[3] = { lut_size * lut_size, lut_size, 1 };
+  for (int v = 0; v < 256; ++v) {
+    int position = v * (lut_size - 1);
+    int index = position / 255;
+    int fraction = ((position % 255) * 256 + 127) / 255;
+    if (index == lut_size - 1) {
+      index = lut_size - 2;
+      fraction = 256;
+    }
+    for (int c = 0; c < 3; ++c) {
+      p->lut_index[c * 256 + v] = (index * step[c]) << 9 | fraction;
+    }
+  }
+  p->ARGBApply3DLutRow = ARGBApply3DLutRow_C;
+#if defined(HAS_ARGBAPPLY3DLUTROW_AVX2)
+  if (TestCpuFlag(kCpuHasAVX2) && width >= 8) {
+    p->ARGBApply3DLutRow = IS_ALIGNED(width, 8) ? ARGBApply3DLutRow_AVX2 :
+                                                  ARGBApply3DLutRow_Any_AVX2;
+  }
+#endif
+}
+
+static void ARGBApply3DLutRows(void* param, int y, int height) {
+  const Apply3DLut* p = static_cast<const Apply3DLut*>(param);
+  const uint8* src = p->src[0] + y * p->src_stride[0];
+  uint8* dst = p->dst[0] + y * p->dst_stride[0];
+  for (int j = 0; j < height; ++j) {
+    p->ARGBApply3DLutRow(src, dst, p->lut_argb, p->lut_index, p->lut_size,
+                         p->width);
+    src += p->src_stride[0];
+    dst += p->dst_stride[0];
+  }
+}
+
+LIBYUV_API
+int ARGBApply3DLut(const uint8* src_argb, int src_stride_argb,
+                   uint8* dst_argb, int dst_stride_argb,
+                   const uint8* lut_argb, int lut_size,
+                   int width, int height, int num_threads) {
+  if (!src_argb || !dst_argb || !lut_argb || width <= 0 || height == 0 ||
+      lut_size < 2 || lut_size > kMax3DLutSize) {
+    return -1;
+  }
+  // Negative height means invert the image.
+  if (height < 0) {
+    height = -height;
+    src_argb = src_argb + (height - 1) * src_stride_argb;
+    src_stride_argb = -src_stride_argb;
+  }
+  Apply3DLut p;
+  Init3DLut(&p, lut_argb, lut_size, width);
+  p.src[0] = src_argb;
+  p.src_stride[0] = src_stride_argb;
+  p.dst[0] = dst_argb;
+  p.dst_stride[0] = dst_stride_argb;
+  p.width = width;
+  p.height = height;
+  RunBands(ARGBApply3DLutRows, &p, height, num_threads);
+  return 0;
+}
+
+// Bands are in pairs of rows, so each band starts on a chroma row.
+static void I420Apply3DLutRows(void* param, int y, int height) {
+  const Apply3DLut* p = static_cast<const Apply3DLut*>(param);
+  const int width = p->width;
+  // Two ARGB rows, in one buffer per band so bands can run in parallel.
+  const int row_stride = (width * 4 + 15) & ~15;
+  uint8* row_mem = new uint8[row_stride * 2 + 15];
+  uint8* rows = ALIGNP(row_mem, 16);
+  const RowDispatch* dispatch = GetRowDispatch();
+  I422ToARGBRowFunction I422ToARGBRow =
+      SELECT_ROW(dispatch->I422ToARGBRow, width, true);
+  ARGBToUVRowFunction ARGBToUVRow =
+      SELECT_ROW(dispatch->ARGBToUVRow, width, true);
+  ARGBToYRowFunction ARGBToYRow =
+      SELECT_ROW(dispatch->ARGBToYRow, width,
+                 IS_ALIGNED(p->dst[0], 16) && IS_ALIGNED(p->dst_stride[0], 16));
+
+  const int y0 = y * 2;
+  const int y1 = (y + height) * 2 < p->height ? (y + height) * 2 : p->height;
+  const uint8* src_y = p->src[0] + y0 * p->src_stride[0];
+  const uint8* src_u = p->src[1] + y * p->src_stride[1];
+  const uint8* src_v = p->src[2] + y * p->src_stride[2];
+  uint8* dst_y = p->dst[0] + y0 * p->dst_stride[0];
+  uint8* dst_u = p->dst[1] + y * p->dst_stride[1];
+  uint8* dst_v = p->dst[2] + y * p->dst_stride[2];
+  for (int j = y0; j < y1; j += 2) {
+    const int num_rows = j + 1 < y1 ? 2 : 1;
+    for (int r = 0; r < num_rows; ++r) {
+      uint8* row = rows + r * row_stride;
+      I422ToARGBRow(src_y + r * p->src_stride[0], src_u, src_v, row, width);
+      p->ARGBApply3DLutRow(row, row, p->lut_argb, p->lut_index, p->lut_size,
+                           width);
+    }
+    ARGBToUVRow(rows, num_rows == 2 ? row_stride : 0, dst_u, dst_v, width);
+    for (int r = 0; r < num_rows; ++r) {
+      ARGBToYRow(rows + r * row_stride, dst_y + r * p->dst_stride[0], width);
+    }
+    src_y += p->src_stride[0] * 2;
+    src_u += p->src_stride[1];
+    src_v += p->src_stride[2];
+    dst_y += p->dst_stride[0] * 2;
+    dst_u += p->dst_stride[1];
+    dst_v += p->dst_stride[2];
+  }
+  delete [] row_mem;
+}
+
+LIBYUV_API
+int I420Apply3DLut(const uint8* src_y, int src_stride_y,
+                   const uint8* src_u, int src_stride_u,
+                   const uint8* src_v, int src_stride_v,
+                   uint8* dst_y, int dst_stride_y,
+                   uint8* dst_u, int dst_stride_u,
+                   uint8* dst_v, int dst_stride_v,
+                   const uint8* lut_argb, int lut_size,
+                   int width, int height, int num_threads) {
+  if (!src_y || !src_u || !src_v || !dst_y || !dst_u || !dst_v ||
+      !lut_argb || width <= 0 || height == 0 ||
+      lut_size < 2 || lut_size > kMax3DLutSize) {
+    return -1;
+  }
+  // Negative height means invert the image.
+  if (height < 0) {
+    height = -height;
+    int halfheight = (height + 1) >> 1;
+    src_y = src_y + (height - 1) * src_stride_y;
+    src_u = src_u + (halfheight - 1) * src_stride_u;
+    src_v = src_v + (halfheight - 1) * src_stride_v;
+    src_stride_y = -src_stride_y;
+    src_stride_u = -src_stride_u;
+    src_stride_v = -src_stride_v;
+  }
+  Apply3DLut p;
+  Init3DLut(&p, lut_argb, lut_size, width);
+  p.src[0] = src_y;
+  p.src[1] = src_u;
+  p.src[2] = src_v;
+  p.src_stride[0] = src_stride_y;
+  p.src_stride[1] = src_stride_u;
+  p.src_stride[2] = src_stride_v;
+  p.dst[0] = dst_y;
+  p.dst[1] = dst_u;
+  p.dst[2] = dst_v;
+  p.dst_stride[0] = dst_stride_y;
+  p.dst_stride[1] = dst_stride_u;
+  p.dst_stride[2] = dst_stride_v;
+  p.width = width;
+  p.height = height;
+  RunBands(I420Apply3DLutRows, &p, (height + 1) >> 1, num_threads);
+  return 0;
+}
+
 #ifdef __cplusplus
 }  // extern "C"
 }  // namespace libyuv
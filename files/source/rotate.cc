@@ -282,6 +282,7 @@ static void TransposeUVWx8_SSE2(const uint8* src, int src_stride,
 }
 #elif !defined(YUV_DISABLE_ASM) && (defined(__i386__) || defined(__x86_64__))
 #define HAS_TRANSPOSE_WX8_SSSE3
+#if !defined(LIBYUV_SSSE3)  // Else in rotate_ssse3.cc, declared in row.h
 static void TransposeWx8_SSSE3(const uint8* src, int src_stride,
                                uint8* dst, int dst_stride, int width) {
   asm volatile (
@@ -368,6 +369,7 @@ static void TransposeWx8_SSSE3(const uint8* src, int src_stride,
   #endif
   );
 }
+#endif  // !defined(LIBYUV_SSSE3)
 
 #if !defined(YUV_DISABLE_ASM) && defined (__i386__)
 #define HAS_TRANSPOSE_UVWX8_SSE2
@@ -494,6 +496,7 @@ extern "C" void TransposeUVWx8_SSE2(const uint8* src, int src_stride,
 #elif !defined(YUV_DISABLE_ASM) && defined(__x86_64__)
 // 64 bit version has enough registers to do 16x8 to 8x16 at a time.
 #define HAS_TRANSPOSE_WX8_FAST_SSSE3
+#if !defined(LIBYUV_SSSE3)  // Else in rotate_ssse3.cc, declared in row.h
 static void TransposeWx8_FAST_SSSE3(const uint8* src, int src_stride,
                                     uint8* dst, int dst_stride, int width) {
   asm volatile (
@@ -631,6 +634,7 @@ static void TransposeWx8_FAST_SSSE3(const uint8* src, int src_stride,
     "xmm8", "xmm9", "xmm10", "xmm11", "xmm12", "xmm13",  "xmm14",  "xmm15"
 );
 }
+#endif  // !defined(LIBYUV_SSSE3)
 
 #define HAS_TRANSPOSE_UVWX8_SSE2
 static void TransposeUVWx8_SSE2(const uint8* src, int src_stride,
@@ -742,9 +746,282 @@ static void TransposeUVWx8_SSE2(const uint8* src, int src_stride,
     "xmm8", "xmm9"
 );
 }
+
+// AVX2 transposes 32 columns of 8 rows at a time. The unpacks work within
+// 128 bit lanes, so the low lane produces columns 0 to 15 and the high lane
+// columns 16 to 31, two columns per register.
+#if defined(__clang__) || (defined(__GNUC__) && \
+    (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7)))
+#define HAS_TRANSPOSE_WX8_AVX2
+static void TransposeWx8_AVX2(const uint8* src, int src_stride,
+                              uint8* dst, int dst_stride, int width) {
+  asm volatile (
+  ".p2align  4                                 \n"
+"1:                                            \n"
+  "vmovdqu    (%0),%%ymm0                      \n"
+  "vmovdqu    (%0,%3),%%ymm1                   \n"
+  "lea        (%0,%3,2),%0                     \n"
+  "vmovdqu    (%0),%%ymm2                      \n"
+  "vmovdqu    (%0,%3),%%ymm3                   \n"
+  "lea        (%0,%3,2),%0                     \n"
+  "vmovdqu    (%0),%%ymm4                      \n"
+  "vmovdqu    (%0,%3),%%ymm5                   \n"
+  "lea        (%0,%3,2),%0                     \n"
+  "vmovdqu    (%0),%%ymm6                      \n"
+  "vmovdqu    (%0,%3),%%ymm7                   \n"
+  "lea        (%0,%3,2),%0                     \n"
+  "neg        %3                               \n"
+  "lea        0x20(%0,%3,8),%0                 \n"
+  "neg        %3                               \n"
+  // First round of bit swap.
+  "vpunpckhbw %%ymm1,%%ymm0,%%ymm8             \n"
+  "vpunpcklbw %%ymm1,%%ymm0,%%ymm0             \n"
+  "vpunpckhbw %%ymm3,%%ymm2,%%ymm9             \n"
+  "vpunpcklbw %%ymm3,%%ymm2,%%ymm2             \n"
+  "vpunpckhbw %%ymm5,%%ymm4,%%ymm10            \n"
+  "vpunpcklbw %%ymm5,%%ymm4,%%ymm4             \n"
+  "vpunpckhbw %%ymm7,%%ymm6,%%ymm11            \n"
+  "vpunpcklbw %%ymm7,%%ymm6,%%ymm6             \n"
+  // Second round of bit swap.
+  "vpunpckhwd %%ymm2,%%ymm0,%%ymm1             \n"
+  "vpunpcklwd %%ymm2,%%ymm0,%%ymm0             \n"
+  "vpunpckhwd %%ymm9,%%ymm8,%%ymm3             \n"
+  "vpunpcklwd %%ymm9,%%ymm8,%%ymm2             \n"
+  "vpunpckhwd %%ymm6,%%ymm4,%%ymm5             \n"
+  "vpunpcklwd %%ymm6,%%ymm4,%%ymm4             \n"
+  "vpunpckhwd %%ymm11,%%ymm10,%%ymm7           \n"
+  "vpunpcklwd %%ymm11,%%ymm10,%%ymm6           \n"
+  // Third round of bit swap.
+  "vpunpckldq %%ymm4,%%ymm0,%%ymm8             \n"
+  "vpunpckhdq %%ymm4,%%ymm0,%%ymm9             \n"
+  "vpunpckldq %%ymm5,%%ymm1,%%ymm10            \n"
+  "vpunpckhdq %%ymm5,%%ymm1,%%ymm11            \n"
+  "vpunpckldq %%ymm6,%%ymm2,%%ymm12            \n"
+  "vpunpckhdq %%ymm6,%%ymm2,%%ymm13            \n"
+  "vpunpckldq %%ymm7,%%ymm3,%%ymm14            \n"
+  "vpunpckhdq %%ymm7,%%ymm3,%%ymm15            \n"
+  // Write columns 0 to 15 from the low lanes.
+  "vmovq      %%xmm8,(%1)                      \n"
+  "vmovhps    %%xmm8,(%1,%4)                   \n"
+  "lea        (%1,%4,2),%1                     \n"
+  "vmovq      %%xmm9,(%1)                      \n"
+  "vmovhps    %%xmm9,(%1,%4)                   \n"
+  "lea        (%1,%4,2),%1                     \n"
+  "vmovq      %%xmm10,(%1)                     \n"
+  "vmovhps    %%xmm10,(%1,%4)                  \n"
+  "lea        (%1,%4,2),%1                     \n"
+  "vmovq      %%xmm11,(%1)                     \n"
+  "vmovhps    %%xmm11,(%1,%4)                  \n"
+  "lea        (%1,%4,2),%1                     \n"
+  "vmovq      %%xmm12,(%1)                     \n"
+  "vmovhps    %%xmm12,(%1,%4)                  \n"
+  "lea        (%1,%4,2),%1                     \n"
+  "vmovq      %%xmm13,(%1)                     \n"
+  "vmovhps    %%xmm13,(%1,%4)                  \n"
+  "lea        (%1,%4,2),%1                     \n"
+  "vmovq      %%xmm14,(%1)                     \n"
+  "vmovhps    %%xmm14,(%1,%4)                  \n"
+  "lea        (%1,%4,2),%1                     \n"
+  "vmovq      %%xmm15,(%1)                     \n"
+  "vmovhps    %%xmm15,(%1,%4)                  \n"
+  "lea        (%1,%4,2),%1                     \n"
+  // Write columns 16 to 31 from the high lanes.
+  "vextracti128 $0x1,%%ymm8,%%xmm0             \n"
+  "vextracti128 $0x1,%%ymm9,%%xmm1             \n"
+  "vextracti128 $0x1,%%ymm10,%%xmm2            \n"
+  "vextracti128 $0x1,%%ymm11,%%xmm3            \n"
+  "vextracti128 $0x1,%%ymm12,%%xmm4            \n"
+  "vextracti128 $0x1,%%ymm13,%%xmm5            \n"
+  "vextracti128 $0x1,%%ymm14,%%xmm6            \n"
+  "vextracti128 $0x1,%%ymm15,%%xmm7            \n"
+  "vmovq      %%xmm0,(%1)                      \n"
+  "vmovhps    %%xmm0,(%1,%4)                   \n"
+  "lea        (%1,%4,2),%1                     \n"
+  "vmovq      %%xmm1,(%1)                      \n"
+  "vmovhps    %%xmm1,(%1,%4)                   \n"
+  "lea        (%1,%4,2),%1                     \n"
+  "vmovq      %%xmm2,(%1)                      \n"
+  "vmovhps    %%xmm2,(%1,%4)                   \n"
+  "lea        (%1,%4,2),%1                     \n"
+  "vmovq      %%xmm3,(%1)                      \n"
+  "vmovhps    %%xmm3,(%1,%4)                   \n"
+  "lea        (%1,%4,2),%1                     \n"
+  "vmovq      %%xmm4,(%1)                      \n"
+  "vmovhps    %%xmm4,(%1,%4)                   \n"
+  "lea        (%1,%4,2),%1                     \n"
+  "vmovq      %%xmm5,(%1)                      \n"
+  "vmovhps    %%xmm5,(%1,%4)                   \n"
+  "lea        (%1,%4,2),%1                     \n"
+  "vmovq      %%xmm6,(%1)                      \n"
+  "vmovhps    %%xmm6,(%1,%4)                   \n"
+  "lea        (%1,%4,2),%1                     \n"
+  "vmovq      %%xmm7,(%1)                      \n"
+  "vmovhps    %%xmm7,(%1,%4)                   \n"
+  "lea        (%1,%4,2),%1                     \n"
+  "sub        $0x20,%2                         \n"
+  "jg         1b                               \n"
+  "vzeroupper                                  \n"
+  : "+r"(src),    // %0
+    "+r"(dst),    // %1
+    "+r"(width)   // %2
+  : "r"(static_cast<intptr_t>(src_stride)),  // %3
+    "r"(static_cast<intptr_t>(dst_stride))   // %4
+  : "memory", "cc",
+    "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5", "xmm6", "xmm7",
+    "xmm8", "xmm9", "xmm10", "xmm11", "xmm12", "xmm13",  "xmm14",  "xmm15"
+);
+}
+
+// Same transpose as TransposeWx8_AVX2 on 16 UV pairs. Even columns are U and
+// odd columns are V, so each register holds a row of dst_a and of dst_b.
+#define HAS_TRANSPOSE_UVWX8_AVX2
+static void TransposeUVWx8_AVX2(const uint8* src, int src_stride,
+                                uint8* dst_a, int dst_stride_a,
+                                uint8* dst_b, int dst_stride_b,
+                                int w) {
+  asm volatile (
+  ".p2align  4                                 \n"
+"1:                                            \n"
+  "vmovdqu    (%0),%%ymm0                      \n"
+  "vmovdqu    (%0,%4),%%ymm1                   \n"
+  "lea        (%0,%4,2),%0                     \n"
+  "vmovdqu    (%0),%%ymm2                      \n"
+  "vmovdqu    (%0,%4),%%ymm3                   \n"
+  "lea        (%0,%4,2),%0                     \n"
+  "vmovdqu    (%0),%%ymm4                      \n"
+  "vmovdqu    (%0,%4),%%ymm5                   \n"
+  "lea        (%0,%4,2),%0                     \n"
+  "vmovdqu    (%0),%%ymm6                      \n"
+  "vmovdqu    (%0,%4),%%ymm7                   \n"
+  "lea        (%0,%4,2),%0                     \n"
+  "neg        %4                               \n"
+  "lea        0x20(%0,%4,8),%0                 \n"
+  "neg        %4                               \n"
+  // First round of bit swap.
+  "vpunpckhbw %%ymm1,%%ymm0,%%ymm8             \n"
+  "vpunpcklbw %%ymm1,%%ymm0,%%ymm0             \n"
+  "vpunpckhbw %%ymm3,%%ymm2,%%ymm9             \n"
+  "vpunpcklbw %%ymm3,%%ymm2,%%ymm2             \n"
+  "vpunpckhbw %%ymm5,%%ymm4,%%ymm10            \n"
+  "vpunpcklbw %%ymm5,%%ymm4,%%ymm4             \n"
+  "vpunpckhbw %%ymm7,%%ymm6,%%ymm11            \n"
+  "vpunpcklbw %%ymm7,%%ymm6,%%ymm6             \n"
+  // Second round of bit swap.
+  "vpunpckhwd %%ymm2,%%ymm0,%%ymm1             \n"
+  "vpunpcklwd %%ymm2,%%ymm0,%%ymm0             \n"
+  "vpunpckhwd %%ymm9,%%ymm8,%%ymm3             \n"
+  "vpunpcklwd %%ymm9,%%ymm8,%%ymm2             \n"
+  "vpunpckhwd %%ymm6,%%ymm4,%%ymm5             \n"
+  "vpunpcklwd %%ymm6,%%ymm4,%%ymm4             \n"
+  "vpunpckhwd %%ymm11,%%ymm10,%%ymm7           \n"
+  "vpunpcklwd %%ymm11,%%ymm10,%%ymm6           \n"
+  // Third round of bit swap.
+  "vpunpckldq %%ymm4,%%ymm0,%%ymm8             \n"
+  "vpunpckhdq %%ymm4,%%ymm0,%%ymm9             \n"
+  "vpunpckldq %%ymm5,%%ymm1,%%ymm10            \n"
+  "vpunpckhdq %%ymm5,%%ymm1,%%ymm11            \n"
+  "vpunpckldq %%ymm6,%%ymm2,%%ymm12            \n"
+  "vpunpckhdq %%ymm6,%%ymm2,%%ymm13            \n"
+  "vpunpckldq %%ymm7,%%ymm3,%%ymm14            \n"
+  "vpunpckhdq %%ymm7,%%ymm3,%%ymm15            \n"
+  // Write pairs 0 to 7 from the low lanes.
+  "vmovq      %%xmm8,(%1)                      \n"
+  "vmovhps    %%xmm8,(%2)                      \n"
+  "lea        (%1,%5),%1                       \n"
+  "lea        (%2,%6),%2                       \n"
+  "vmovq      %%xmm9,(%1)                      \n"
+  "vmovhps    %%xmm9,(%2)                      \n"
+  "lea        (%1,%5),%1                       \n"
+  "lea        (%2,%6),%2                       \n"
+  "vmovq      %%xmm10,(%1)                     \n"
+  "vmovhps    %%xmm10,(%2)                     \n"
+  "lea        (%1,%5),%1                       \n"
+  "lea        (%2,%6),%2                       \n"
+  "vmovq      %%xmm11,(%1)                     \n"
+  "vmovhps    %%xmm11,(%2)                     \n"
+  "lea        (%1,%5),%1                       \n"
+  "lea        (%2,%6),%2                       \n"
+  "vmovq      %%xmm12,(%1)                     \n"
+  "vmovhps    %%xmm12,(%2)                     \n"
+  "lea        (%1,%5),%1                       \n"
+  "lea        (%2,%6),%2                       \n"
+  "vmovq      %%xmm13,(%1)                     \n"
+  "vmovhps    %%xmm13,(%2)                     \n"
+  "lea        (%1,%5),%1                       \n"
+  "lea        (%2,%6),%2                       \n"
+  "vmovq      %%xmm14,(%1)                     \n"
+  "vmovhps    %%xmm14,(%2)                     \n"
+  "lea        (%1,%5),%1                       \n"
+  "lea        (%2,%6),%2                       \n"
+  "vmovq      %%xmm15,(%1)                     \n"
+  "vmovhps    %%xmm15,(%2)                     \n"
+  "lea        (%1,%5),%1                       \n"
+  "lea        (%2,%6),%2                       \n"
+  // Write pairs 8 to 15 from the high lanes.
+  "vextracti128 $0x1,%%ymm8,%%xmm0             \n"
+  "vextracti128 $0x1,%%ymm9,%%xmm1             \n"
+  "vextracti128 $0x1,%%ymm10,%%xmm2            \n"
+  "vextracti128 $0x1,%%ymm11,%%xmm3            \n"
+  "vextracti128 $0x1,%%ymm12,%%xmm4            \n"
+  "vextracti128 $0x1,%%ymm13,%%xmm5            \n"
+  "vextracti128 $0x1,%%ymm14,%%xmm6            \n"
+  "vextracti128 $0x1,%%ymm15,%%xmm7            \n"
+  "vmovq      %%xmm0,(%1)                      \n"
+  "vmovhps    %%xmm0,(%2)                      \n"
+  "lea        (%1,%5),%1                       \n"
+  "lea        (%2,%6),%2                       \n"
+  "vmovq      %%xmm1,(%1)                      \n"
+  "vmovhps    %%xmm1,(%2)                      \n"
+  "lea        (%1,%5),%1                       \n"
+  "lea        (%2,%6),%2                       \n"
+  "vmovq      %%xmm2,(%1)                      \n"
+  "vmovhps    %%xmm2,(%2)                      \n"
+  "lea        (%1,%5),%1                       \n"
+  "lea        (%2,%6),%2                       \n"
+  "vmovq      %%xmm3,(%1)                      \n"
+  "vmovhps    %%xmm3,(%2)                      \n"
+  "lea        (%1,%5),%1                       \n"
+  "lea        (%2,%6),%2                       \n"
+  "vmovq      %%xmm4,(%1)                      \n"
+  "vmovhps    %%xmm4,(%2)                      \n"
+  "lea        (%1,%5),%1                       \n"
+  "lea        (%2,%6),%2                       \n"
+  "vmovq      %%xmm5,(%1)                      \n"
+  "vmovhps    %%xmm5,(%2)                      \n"
+  "lea        (%1,%5),%1                       \n"
+  "lea        (%2,%6),%2                       \n"
+  "vmovq      %%xmm6,(%1)                      \n"
+  "vmovhps    %%xmm6,(%2)                      \n"
+  "lea        (%1,%5),%1                       \n"
+  "lea        (%2,%6),%2                       \n"
+  "vmovq      %%xmm7,(%1)                      \n"
+  "vmovhps    %%xmm7,(%2)                      \n"
+  "lea        (%1,%5),%1                       \n"
+  "lea        (%2,%6),%2                       \n"
+  "sub        $0x10,%3                         \n"
+  "jg         1b                               \n"
+  "vzeroupper                                  \n"
+  : "+r"(src),    // %0
+    "+r"(dst_a),  // %1
+    "+r"(dst_b),  // %2
+    "+r"(w)   // %3
+  : "r"(static_cast<intptr_t>(src_stride)),    // %4
+    "r"(static_cast<intptr_t>(dst_stride_a)),  // %5
+    "r"(static_cast<intptr_t>(dst_stride_b))   // %6
+  : "memory", "cc",
+    "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5", "xmm6", "xmm7",
+    "xmm8", "xmm9", "xmm10", "xmm11", "xmm12", "xmm13",  "xmm14",  "xmm15"
+);
+}
+#endif  // HAS_TRANSPOSE_WX8_AVX2
 #endif
 #endif
 
+// Columns of the source transposed per tile. Each tile writes to this many
+// destination rows, which stay in cache and TLB until every 8 row strip of
+// the tile has filled them. Must be a multiple of 32 for the SIMD kernels.
+static const int kTransposeTileWidth = 32;
+
 static void TransposeWx8_C(const uint8* src, int src_stride,
                            uint8* dst, int dst_stride,
                            int width) {
@@ -796,17 +1073,31 @@ void TransposePlane(const uint8* src, int src_stride,
     TransposeWx8 = TransposeWx8_FAST_SSSE3;
   }
 #endif
-
-  // Work across the source in 8x8 tiles
-  int i = height;
-  while (i >= 8) {
-    TransposeWx8(src, src_stride, dst, dst_stride, width);
-    src += 8 * src_stride;    // Go down 8 rows.
-    dst += 8;                 // Move over 8 columns.
-    i -= 8;
+#if defined(HAS_TRANSPOSE_WX8_AVX2)
+  if (TestCpuFlag(kCpuHasAVX2) && IS_ALIGNED(width, 32)) {
+    TransposeWx8 = TransposeWx8_AVX2;
   }
+#endif
 
-  TransposeWxH_C(src, src_stride, dst, dst_stride, width, i);
+  // Work across the source in tiles of kTransposeTileWidth columns, and
+  // down each tile in 8 row strips.
+  for (int x = 0; x < width; x += kTransposeTileWidth) {
+    int tile_width = width - x;
+    if (tile_width > kTransposeTileWidth) {
+      tile_width = kTransposeTileWidth;
+    }
+    const uint8* src_tile = src + x;
+    uint8* dst_tile = dst + x * dst_stride;
+    int i = height;
+    while (i >= 8) {
+      TransposeWx8(src_tile, src_stride, dst_tile, dst_stride, tile_width);
+      src_tile += 8 * src_stride;    // Go down 8 rows.
+      dst_tile += 8;                 // Move over 8 columns.
+      i -= 8;
+    }
+
+    TransposeWxH_C(src_tile, src_stride, dst_tile, dst_stride, tile_width, i);
+  }
 }
 
 LIBYUV_API
@@ -955,24 +1246,39 @@ void TransposeUV(const uint8* src, int src_stride,
     TransposeUVWx8 = TransposeUVWx8_SSE2;
   }
 #endif
-
-  // Work through the source in 8x8 tiles.
-  int i = height;
-  while (i >= 8) {
-    TransposeUVWx8(src, src_stride,
-                   dst_a, dst_stride_a,
-                   dst_b, dst_stride_b,
-                   width);
-    src += 8 * src_stride;    // Go down 8 rows.
-    dst_a += 8;               // Move over 8 columns.
-    dst_b += 8;               // Move over 8 columns.
-    i -= 8;
+#if defined(HAS_TRANSPOSE_UVWX8_AVX2)
+  if (TestCpuFlag(kCpuHasAVX2) && IS_ALIGNED(width, 16)) {
+    TransposeUVWx8 = TransposeUVWx8_AVX2;
   }
+#endif
 
-  TransposeUVWxH_C(src, src_stride,
-                   dst_a, dst_stride_a,
-                   dst_b, dst_stride_b,
-                   width, i);
+  // Work across the source in tiles of kTransposeTileWidth bytes, which is
+  // half as many UV pairs, and down each tile in 8 row strips.
+  for (int x = 0; x < width; x += kTransposeTileWidth / 2) {
+    int tile_width = width - x;
+    if (tile_width > kTransposeTileWidth / 2) {
+      tile_width = kTransposeTileWidth / 2;
+    }
+    const uint8* src_tile = src + x * 2;
+    uint8* dst_tile_a = dst_a + x * dst_stride_a;
+    uint8* dst_tile_b = dst_b + x * dst_stride_b;
+    int i = height;
+    while (i >= 8) {
+      TransposeUVWx8(src_tile, src_stride,
+                     dst_tile_a, dst_stride_a,
+                     dst_tile_b, dst_stride_b,
+                     tile_width);
+      src_tile += 8 * src_stride;    // Go down 8 rows.
+      dst_tile_a += 8;               // Move over 8 columns.
+      dst_tile_b += 8;               // Move over 8 columns.
+      i -= 8;
+    }
+
+    TransposeUVWxH_C(src_tile, src_stride,
+                     dst_tile_a, dst_stride_a,
+                     dst_tile_b, dst_stride_b,
+                     tile_width, i);
+  }
 }
 
 LIBYUV_API
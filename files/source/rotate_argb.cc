@@ -25,18 +25,18 @@ extern "C" {
 #if !defined(YUV_DISABLE_ASM) && (defined(_M_IX86) || \
   defined(__x86_64__) || defined(__i386__))
 #define HAS_SCALEARGBROWDOWNEVEN_SSE2
-void ScaleARGBRowDownEven_SSE2(const uint8* src_ptr, int src_stride,
+void ScaleARGBRowDownEven_SSE2(const uint8* src_ptr, ptrdiff_t src_stride,
                                int src_stepx,
                                uint8* dst_ptr, int dst_width);
 #endif
-void ScaleARGBRowDownEven_C(const uint8* src_ptr, int,
+void ScaleARGBRowDownEven_C(const uint8* src_ptr, ptrdiff_t,
                             int src_stepx,
                             uint8* dst_ptr, int dst_width);
 
 static void ARGBTranspose(const uint8* src, int src_stride,
                           uint8* dst, int dst_stride,
                           int width, int height) {
-  void (*ScaleARGBRowDownEven)(const uint8* src_ptr, int src_stride,
+  void (*ScaleARGBRowDownEven)(const uint8* src_ptr, ptrdiff_t src_stride,
       int src_step, uint8* dst_ptr, int dst_width) = ScaleARGBRowDownEven_C;
 #if defined(HAS_SCALEARGBROWDOWNEVEN_SSE2)
   if (TestCpuFlag(kCpuHasSSE2) &&
@@ -0,0 +1,117 @@
+/*
+ *  Copyright 2012 The LibYuv Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "libyuv/basic_types.h"
+#include "libyuv/row.h"
+
+#if !defined(YUV_DISABLE_ASM) && defined(LIBYUV_SSSE3) && \
+    (defined(__x86_64__) || defined(__i386__))
+#include <emmintrin.h>
+#endif
+
+#ifdef __cplusplus
+namespace libyuv {
+extern "C" {
+#endif
+
+// This module is for GCC x86 and x64 builds that compile the intrinsics
+// kernels and define LIBYUV_SSSE3. The functions here replace the inline
+// assembly versions in rotate.cc.
+#if !defined(YUV_DISABLE_ASM) && defined(LIBYUV_SSSE3) && \
+    (defined(__x86_64__) || defined(__i386__))
+
+static __inline __m128i LoadRow8(const uint8* src, int src_stride, int row) {
+  return _mm_loadl_epi64(
+      reinterpret_cast<const __m128i*>(src + src_stride * row));
+}
+
+static __inline void StoreRow8(uint8* dst, int dst_stride, int row,
+                               __m128i v) {
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + dst_stride * row), v);
+}
+
+// Transposes the low 8 bytes of rows r0 to r7 and writes the 8 columns as 8
+// rows of dst.
+static __inline void Transpose8x8(__m128i r0, __m128i r1, __m128i r2,
+                                  __m128i r3, __m128i r4, __m128i r5,
+                                  __m128i r6, __m128i r7,
+                                  uint8* dst, int dst_stride) {
+  __m128i a0 = _mm_unpacklo_epi8(r0, r1);
+  __m128i a1 = _mm_unpacklo_epi8(r2, r3);
+  __m128i a2 = _mm_unpacklo_epi8(r4, r5);
+  __m128i a3 = _mm_unpacklo_epi8(r6, r7);
+  __m128i b0 = _mm_unpacklo_epi16(a0, a1);
+  __m128i b1 = _mm_unpackhi_epi16(a0, a1);
+  __m128i b2 = _mm_unpacklo_epi16(a2, a3);
+  __m128i b3 = _mm_unpackhi_epi16(a2, a3);
+  __m128i c0 = _mm_unpacklo_epi32(b0, b2);
+  __m128i c1 = _mm_unpackhi_epi32(b0, b2);
+  __m128i c2 = _mm_unpacklo_epi32(b1, b3);
+  __m128i c3 = _mm_unpackhi_epi32(b1, b3);
+  StoreRow8(dst, dst_stride, 0, c0);
+  StoreRow8(dst, dst_stride, 1, _mm_unpackhi_epi64(c0, c0));
+  StoreRow8(dst, dst_stride, 2, c1);
+  StoreRow8(dst, dst_stride, 3, _mm_unpackhi_epi64(c1, c1));
+  StoreRow8(dst, dst_stride, 4, c2);
+  StoreRow8(dst, dst_stride, 5, _mm_unpackhi_epi64(c2, c2));
+  StoreRow8(dst, dst_stride, 6, c3);
+  StoreRow8(dst, dst_stride, 7, _mm_unpackhi_epi64(c3, c3));
+}
+
+void TransposeWx8_SSSE3(const uint8* src, int src_stride,
+                        uint8* dst, int dst_stride, int width) {
+  for (; width > 0; width -= 8) {
+    Transpose8x8(LoadRow8(src, src_stride, 0), LoadRow8(src, src_stride, 1),
+                 LoadRow8(src, src_stride, 2), LoadRow8(src, src_stride, 3),
+                 LoadRow8(src, src_stride, 4), LoadRow8(src, src_stride, 5),
+                 LoadRow8(src, src_stride, 6), LoadRow8(src, src_stride, 7),
+                 dst, dst_stride);
+    src += 8;
+    dst += dst_stride * 8;
+  }
+}
+
+#if defined(__x86_64__)
+static __inline __m128i LoadRow16(const uint8* src, int src_stride, int row) {
+  return _mm_load_si128(
+      reinterpret_cast<const __m128i*>(src + src_stride * row));
+}
+
+// 64 bit has enough registers to do 16x8 to 8x16 at a time.
+// Alignment requirement: src and src_stride 16 byte aligned.
+void TransposeWx8_FAST_SSSE3(const uint8* src, int src_stride,
+                             uint8* dst, int dst_stride, int width) {
+  for (; width > 0; width -= 16) {
+    __m128i r0 = LoadRow16(src, src_stride, 0);
+    __m128i r1 = LoadRow16(src, src_stride, 1);
+    __m128i r2 = LoadRow16(src, src_stride, 2);
+    __m128i r3 = LoadRow16(src, src_stride, 3);
+    __m128i r4 = LoadRow16(src, src_stride, 4);
+    __m128i r5 = LoadRow16(src, src_stride, 5);
+    __m128i r6 = LoadRow16(src, src_stride, 6);
+    __m128i r7 = LoadRow16(src, src_stride, 7);
+    Transpose8x8(r0, r1, r2, r3, r4, r5, r6, r7, dst, dst_stride);
+    Transpose8x8(_mm_unpackhi_epi64(r0, r0), _mm_unpackhi_epi64(r1, r1),
+                 _mm_unpackhi_epi64(r2, r2), _mm_unpackhi_epi64(r3, r3),
+                 _mm_unpackhi_epi64(r4, r4), _mm_unpackhi_epi64(r5, r5),
+                 _mm_unpackhi_epi64(r6, r6), _mm_unpackhi_epi64(r7, r7),
+                 dst + dst_stride * 8, dst_stride);
+    src += 16;
+    dst += dst_stride * 16;
+  }
+}
+#endif
+
+#endif  // !defined(YUV_DISABLE_ASM) && defined(LIBYUV_SSSE3) ...
+
+#ifdef __cplusplus
+}  // extern "C"
+}  // namespace libyuv
+#endif
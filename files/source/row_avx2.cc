@@ -0,0 +1,58 @@
+/*
+ *  Copyright 2012 The LibYuv Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "libyuv/row.h"
+
+#ifdef HAS_ARGBTOYROW_AVX2
+#include <immintrin.h>
+#endif
+
+#ifdef __cplusplus
+namespace libyuv {
+extern "C" {
+#endif
+
+// This module is compiled with -mavx2 and is only called when the cpu has
+// AVX2, so nothing here may be called unconditionally.
+
+#ifdef HAS_ARGBTOYROW_AVX2
+
+// 32 pixels per loop. Same math as ARGBToYRow_SSSE3, so the results are
+// identical. Like the SSSE3 version a width that is not a multiple of 32 is
+// rounded up.
+void ARGBToYRow_AVX2(const uint8* src_argb, uint8* dst_y, int pix) {
+  const __m256i kARGBToY = _mm256_set1_epi32(0x0021410d);  // 13, 65, 33, 0
+  const __m256i kAddY16 = _mm256_set1_epi8(16);
+  // vphaddw and vpackuswb work within 128 bit lanes; this puts the groups
+  // of 4 pixels back in order.
+  const __m256i kPermdARGBToY = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+  for (; pix > 0; pix -= 32) {
+    const __m256i* src = reinterpret_cast<const __m256i*>(src_argb);
+    __m256i y0 = _mm256_maddubs_epi16(_mm256_loadu_si256(src + 0), kARGBToY);
+    __m256i y1 = _mm256_maddubs_epi16(_mm256_loadu_si256(src + 1), kARGBToY);
+    __m256i y2 = _mm256_maddubs_epi16(_mm256_loadu_si256(src + 2), kARGBToY);
+    __m256i y3 = _mm256_maddubs_epi16(_mm256_loadu_si256(src + 3), kARGBToY);
+    y0 = _mm256_srli_epi16(_mm256_hadd_epi16(y0, y1), 7);
+    y2 = _mm256_srli_epi16(_mm256_hadd_epi16(y2, y3), 7);
+    y0 = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(y0, y2),
+                                     kPermdARGBToY);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst_y),
+                        _mm256_add_epi8(y0, kAddY16));
+    src_argb += 128;
+    dst_y += 32;
+  }
+}
+
+#endif  // HAS_ARGBTOYROW_AVX2
+
+#ifdef __cplusplus
+}  // extern "C"
+}  // namespace libyuv
+#endif
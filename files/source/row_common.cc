@@ -304,6 +304,33 @@ MAKEROWY(BGRA, 1, 2, 3)
 MAKEROWY(ABGR, 0, 1, 2)
 MAKEROWY(RGBA, 3, 2, 1)
 
+// ARGBToUVRow_C with the U and V of each pair of pixels stored together, as
+// used by NV12.
+void ARGBToUVInterleaveRow_C(const uint8* src_argb0, int src_stride_argb,
+                             uint8* dst_uv, int width) {
+  const uint8* src_argb1 = src_argb0 + src_stride_argb;
+  for (int x = 0; x < width - 1; x += 2) {
+    uint8 ab = (src_argb0[0] + src_argb0[4] +
+               src_argb1[0] + src_argb1[4]) >> 2;
+    uint8 ag = (src_argb0[1] + src_argb0[5] +
+               src_argb1[1] + src_argb1[5]) >> 2;
+    uint8 ar = (src_argb0[2] + src_argb0[6] +
+               src_argb1[2] + src_argb1[6]) >> 2;
+    dst_uv[0] = RGBToU(ar, ag, ab);
+    dst_uv[1] = RGBToV(ar, ag, ab);
+    src_argb0 += 8;
+    src_argb1 += 8;
+    dst_uv += 2;
+  }
+  if (width & 1) {
+    uint8 ab = (src_argb0[0] + src_argb1[0]) >> 1;
+    uint8 ag = (src_argb0[1] + src_argb1[1]) >> 1;
+    uint8 ar = (src_argb0[2] + src_argb1[2]) >> 1;
+    dst_uv[0] = RGBToU(ar, ag, ab);
+    dst_uv[1] = RGBToV(ar, ag, ab);
+  }
+}
+
 // http://en.wikipedia.org/wiki/Grayscale.
 // 0.11 * B + 0.59 * G + 0.30 * R
 // Coefficients rounded to multiple of 2 for consistency with SSSE3 version.
@@ -397,6 +424,49 @@ void ARGBColorTableRow_C(uint8* dst_argb, const uint8* table_argb, int width) {
   }
 }
 
+// Interpolate a 3D LUT in the tetrahedron of the grid cell that holds the
+// pixel. Vertex A is one step along the axis with the largest fraction and
+// vertex B one more step along the next largest. Ties pick any of the tied
+// axes as their vertex weight is 0. Same choices as the AVX2 version.
+void ARGBApply3DLutRow_C(const uint8* src_argb, uint8* dst_argb,
+                         const uint8* lut_argb, const int32* lut_index,
+                         int lut_size, int width) {
+  const int step_g = lut_size;
+  const int step_b = lut_size * lut_size;
+  const int step_all = 1 + step_g + step_b;
+  for (int x = 0; x < width; ++x) {
+    const int32 index_b = lut_index[src_argb[0]];
+    const int32 index_g = lut_index[256 + src_argb[1]];
+    const int32 index_r = lut_index[512 + src_argb[2]];
+    const int fb = index_b & 0x1ff;
+    const int fg = index_g & 0x1ff;
+    const int fr = index_r & 0x1ff;
+    int fmax = fr > fg ? fr : fg;
+    fmax = fb > fmax ? fb : fmax;
+    int fmin = fr < fg ? fr : fg;
+    fmin = fb < fmin ? fb : fmin;
+    const int fmid = fr + fg + fb - fmax - fmin;
+    const int step_max = fr == fmax ? 1 : fb == fmax ? step_b : step_g;
+    const int step_min = fb == fmin ? step_b : fr == fmin ? 1 : step_g;
+    const uint8* c0 = lut_argb +
+        ((index_b >> 9) + (index_g >> 9) + (index_r >> 9)) * 4;
+    const uint8* ca = c0 + step_max * 4;
+    const uint8* cb = c0 + (step_all - step_min) * 4;
+    const uint8* c1 = c0 + step_all * 4;
+    const int w0 = 256 - fmax;
+    const int wa = fmax - fmid;
+    const int wb = fmid - fmin;
+    const int w1 = fmin;
+    for (int i = 0; i < 3; ++i) {
+      dst_argb[i] = static_cast<uint8>((c0[i] * w0 + ca[i] * wa +
+                                        cb[i] * wb + c1[i] * w1 + 128) >> 8);
+    }
+    dst_argb[3] = src_argb[3];
+    src_argb += 4;
+    dst_argb += 4;
+  }
+}
+
 void ARGBQuantizeRow_C(uint8* dst_argb, int scale, int interval_size,
                        int interval_offset, int width) {
   for (int x = 0; x < width; ++x) {
@@ -600,6 +670,116 @@ void NV21ToARGBRow_C(const uint8* y_buf,
   }
 }
 
+// Pack 1 pixel of B, G and R into 16 bits.
+static __inline uint16 PackRGB565(uint8 b, uint8 g, uint8 r) {
+  return static_cast<uint16>((b >> 3) | ((g >> 2) << 5) | ((r >> 3) << 11));
+}
+
+static __inline uint16 PackARGB1555(uint8 b, uint8 g, uint8 r) {
+  return static_cast<uint16>((b >> 3) | ((g >> 3) << 5) | ((r >> 3) << 10) |
+                             0x8000);
+}
+
+static __inline uint16 PackARGB4444(uint8 b, uint8 g, uint8 r) {
+  return static_cast<uint16>((b >> 4) | (g & 0xf0) | ((r >> 4) << 8) |
+                             0xf000);
+}
+
+static __inline uint8 DitherAdd(uint8 v, int d) {
+  int s = v + d;
+  return static_cast<uint8>(s > 255 ? 255 : s);
+}
+
+#define I422TO16BITROW(NAME, PACK)                                             \
+    void NAME(const uint8* y_buf,                                              \
+              const uint8* u_buf,                                              \
+              const uint8* v_buf,                                              \
+              uint8* rgb_buf,                                                  \
+              int width) {                                                     \
+      uint16* dst = reinterpret_cast<uint16*>(rgb_buf);                        \
+      uint8 b, g, r;                                                           \
+      for (int x = 0; x < width - 1; x += 2) {                                 \
+        YuvPixel2(y_buf[0], u_buf[0], v_buf[0], &b, &g, &r);                   \
+        dst[0] = PACK(b, g, r);                                                \
+        YuvPixel2(y_buf[1], u_buf[0], v_buf[0], &b, &g, &r);                   \
+        dst[1] = PACK(b, g, r);                                                \
+        y_buf += 2;                                                            \
+        u_buf += 1;                                                            \
+        v_buf += 1;                                                            \
+        dst += 2;  /* Advance 2 pixels. */                                     \
+      }                                                                        \
+      if (width & 1) {                                                         \
+        YuvPixel2(y_buf[0], u_buf[0], v_buf[0], &b, &g, &r);                   \
+        dst[0] = PACK(b, g, r);                                                \
+      }                                                                        \
+    }
+
+I422TO16BITROW(I422ToRGB565Row_C, PackRGB565)
+I422TO16BITROW(I422ToARGB1555Row_C, PackARGB1555)
+I422TO16BITROW(I422ToARGB4444Row_C, PackARGB4444)
+#undef I422TO16BITROW
+
+void I422ToRGB565DitherRow_C(const uint8* y_buf,
+                             const uint8* u_buf,
+                             const uint8* v_buf,
+                             uint8* rgb_buf,
+                             uint32 dither4,
+                             int width) {
+  uint16* dst = reinterpret_cast<uint16*>(rgb_buf);
+  uint8 b, g, r;
+  for (int x = 0; x < width; ++x) {
+    int d = (dither4 >> ((x & 3) * 8)) & 0xff;
+    YuvPixel2(y_buf[0], u_buf[0], v_buf[0], &b, &g, &r);
+    dst[0] = PackRGB565(DitherAdd(b, d), DitherAdd(g, d), DitherAdd(r, d));
+    y_buf += 1;
+    u_buf += x & 1;
+    v_buf += x & 1;
+    dst += 1;
+  }
+}
+
+void NV12ToRGB565Row_C(const uint8* y_buf,
+                       const uint8* uv_buf,
+                       uint8* rgb_buf,
+                       int width) {
+  uint16* dst = reinterpret_cast<uint16*>(rgb_buf);
+  uint8 b, g, r;
+  for (int x = 0; x < width - 1; x += 2) {
+    YuvPixel2(y_buf[0], uv_buf[0], uv_buf[1], &b, &g, &r);
+    dst[0] = PackRGB565(b, g, r);
+    YuvPixel2(y_buf[1], uv_buf[0], uv_buf[1], &b, &g, &r);
+    dst[1] = PackRGB565(b, g, r);
+    y_buf += 2;
+    uv_buf += 2;
+    dst += 2;  // Advance 2 pixels.
+  }
+  if (width & 1) {
+    YuvPixel2(y_buf[0], uv_buf[0], uv_buf[1], &b, &g, &r);
+    dst[0] = PackRGB565(b, g, r);
+  }
+}
+
+void NV21ToRGB565Row_C(const uint8* y_buf,
+                       const uint8* vu_buf,
+                       uint8* rgb_buf,
+                       int width) {
+  uint16* dst = reinterpret_cast<uint16*>(rgb_buf);
+  uint8 b, g, r;
+  for (int x = 0; x < width - 1; x += 2) {
+    YuvPixel2(y_buf[0], vu_buf[1], vu_buf[0], &b, &g, &r);
+    dst[0] = PackRGB565(b, g, r);
+    YuvPixel2(y_buf[1], vu_buf[1], vu_buf[0], &b, &g, &r);
+    dst[1] = PackRGB565(b, g, r);
+    y_buf += 2;
+    vu_buf += 2;
+    dst += 2;  // Advance 2 pixels.
+  }
+  if (width & 1) {
+    YuvPixel2(y_buf[0], vu_buf[1], vu_buf[0], &b, &g, &r);
+    dst[0] = PackRGB565(b, g, r);
+  }
+}
+
 void I422ToBGRARow_C(const uint8* y_buf,
                      const uint8* u_buf,
                      const uint8* v_buf,
@@ -689,6 +869,21 @@ void MirrorRowUV_C(const uint8* src_uv, uint8* dst_u, uint8* dst_v, int width) {
   }
 }
 
+void MergeUV_C(const uint8* src_u, const uint8* src_v, uint8* dst_uv,
+               int width) {
+  for (int x = 0; x < width - 1; x += 2) {
+    dst_uv[0] = src_u[x];
+    dst_uv[1] = src_v[x];
+    dst_uv[2] = src_u[x + 1];
+    dst_uv[3] = src_v[x + 1];
+    dst_uv += 4;
+  }
+  if (width & 1) {
+    dst_uv[0] = src_u[width - 1];
+    dst_uv[1] = src_v[width - 1];
+  }
+}
+
 void ARGBMirrorRow_C(const uint8* src, uint8* dst, int width) {
   const uint32* src32 = reinterpret_cast<const uint32*>(src);
   uint32* dst32 = reinterpret_cast<uint32*>(dst);
@@ -703,6 +898,20 @@ void ARGBMirrorRow_C(const uint8* src, uint8* dst, int width) {
   }
 }
 
+void UVMirrorRow_C(const uint8* src_uv, uint8* dst_uv, int width) {
+  const uint16* src16 = reinterpret_cast<const uint16*>(src_uv);
+  uint16* dst16 = reinterpret_cast<uint16*>(dst_uv);
+  src16 += width - 1;
+  for (int x = 0; x < width - 1; x += 2) {
+    dst16[x] = src16[0];
+    dst16[x + 1] = src16[-1];
+    src16 -= 2;
+  }
+  if (width & 1) {
+    dst16[width - 1] = src16[0];
+  }
+}
+
 void SplitUV_C(const uint8* src_uv, uint8* dst_u, uint8* dst_v, int width) {
   for (int x = 0; x < width - 1; x += 2) {
     dst_u[x] = src_uv[0];
@@ -872,6 +1081,20 @@ void ARGBBlendRow_C(const uint8* src_argb0, const uint8* src_argb1,
   }
 }
 #undef BLEND
+
+// Blend src0 over src1 with a per pixel alpha that is not premultiplied:
+// dst = (src0 * a + src1 * (255 - a) + 255) >> 8
+// An alpha of 255 returns src0 and 0 returns src1 exactly.
+// dst may be src0 or src1.
+void BlendPlaneRow_C(const uint8* src0, const uint8* src1,
+                     const uint8* alpha, uint8* dst, int width) {
+  for (int x = 0; x < width; ++x) {
+    const uint32 a = alpha[x];
+    const uint32 sum = src0[x] * a + src1[x] * (255 - a) + 255;
+    dst[x] = static_cast<uint8>(sum >> 8);
+  }
+}
+
 #define ATTENUATE(f, a) (a | (a << 8)) * (f | (f << 8)) >> 24
 
 // Multiply source RGB by alpha and store to destination.
@@ -1042,6 +1265,73 @@ YANY(I422ToRAWRow_Any_NEON, I422ToRAWRow_NEON, I422ToRAWRow_C, 1)
 #endif
 #undef YANY
 
+// Wrappers to handle odd width for 16 bit outputs.
+#define Y16ANY(NAMEANY, I420TORGB_SIMD, I420TORGB_C)                           \
+    void NAMEANY(const uint8* y_buf,                                           \
+                 const uint8* u_buf,                                           \
+                 const uint8* v_buf,                                           \
+                 uint8* rgb_buf,                                               \
+                 int width) {                                                  \
+      int n = width & ~7;                                                      \
+      if (n > 0) {                                                             \
+        I420TORGB_SIMD(y_buf, u_buf, v_buf, rgb_buf, n);                       \
+      }                                                                        \
+      I420TORGB_C(y_buf + n, u_buf + (n >> 1), v_buf + (n >> 1),               \
+                  rgb_buf + n * 2, width & 7);                                 \
+    }
+
+// n is a multiple of 8, so the dither phase carries over to the C tail.
+#define Y16DITHERANY(NAMEANY, I420TORGB_SIMD, I420TORGB_C)                     \
+    void NAMEANY(const uint8* y_buf,                                           \
+                 const uint8* u_buf,                                           \
+                 const uint8* v_buf,                                           \
+                 uint8* rgb_buf,                                               \
+                 uint32 dither4,                                               \
+                 int width) {                                                  \
+      int n = width & ~7;                                                      \
+      if (n > 0) {                                                             \
+        I420TORGB_SIMD(y_buf, u_buf, v_buf, rgb_buf, dither4, n);              \
+      }                                                                        \
+      I420TORGB_C(y_buf + n, u_buf + (n >> 1), v_buf + (n >> 1),               \
+                  rgb_buf + n * 2, dither4, width & 7);                        \
+    }
+
+#define NV16ANY(NAMEANY, NV12TORGB_SIMD, NV12TORGB_C)                          \
+    void NAMEANY(const uint8* y_buf,                                           \
+                 const uint8* uv_buf,                                          \
+                 uint8* rgb_buf,                                               \
+                 int width) {                                                  \
+      int n = width & ~7;                                                      \
+      if (n > 0) {                                                             \
+        NV12TORGB_SIMD(y_buf, uv_buf, rgb_buf, n);                             \
+      }                                                                        \
+      NV12TORGB_C(y_buf + n, uv_buf + n, rgb_buf + n * 2, width & 7);          \
+    }
+
+#ifdef HAS_I422TORGB565ROW_SSSE3
+Y16ANY(I422ToRGB565Row_Any_SSSE3, I422ToRGB565Row_SSSE3, I422ToRGB565Row_C)
+Y16ANY(I422ToARGB1555Row_Any_SSSE3, I422ToARGB1555Row_SSSE3,                   \
+       I422ToARGB1555Row_C)
+Y16ANY(I422ToARGB4444Row_Any_SSSE3, I422ToARGB4444Row_SSSE3,                   \
+       I422ToARGB4444Row_C)
+Y16DITHERANY(I422ToRGB565DitherRow_Any_SSSE3, I422ToRGB565DitherRow_SSSE3,     \
+             I422ToRGB565DitherRow_C)
+NV16ANY(NV12ToRGB565Row_Any_SSSE3, NV12ToRGB565Row_SSSE3, NV12ToRGB565Row_C)
+NV16ANY(NV21ToRGB565Row_Any_SSSE3, NV21ToRGB565Row_SSSE3, NV21ToRGB565Row_C)
+#endif
+#ifdef HAS_I422TORGB565ROW_NEON
+Y16ANY(I422ToRGB565Row_Any_NEON, I422ToRGB565Row_NEON, I422ToRGB565Row_C)
+Y16ANY(I422ToARGB1555Row_Any_NEON, I422ToARGB1555Row_NEON, I422ToARGB1555Row_C)
+Y16ANY(I422ToARGB4444Row_Any_NEON, I422ToARGB4444Row_NEON, I422ToARGB4444Row_C)
+Y16DITHERANY(I422ToRGB565DitherRow_Any_NEON, I422ToRGB565DitherRow_NEON,       \
+             I422ToRGB565DitherRow_C)
+NV16ANY(NV12ToRGB565Row_Any_NEON, NV12ToRGB565Row_NEON, NV12ToRGB565Row_C)
+NV16ANY(NV21ToRGB565Row_Any_NEON, NV21ToRGB565Row_NEON, NV21ToRGB565Row_C)
+#endif
+#undef Y16ANY
+#undef Y16DITHERANY
+#undef NV16ANY
+
 #define RGBANY(NAMEANY, ARGBTORGB, BPP)                                        \
     void NAMEANY(const uint8* argb_buf,                                        \
                  uint8* rgb_buf,                                               \
@@ -1075,6 +1365,12 @@ YANY(ARGBToYRow_Any_SSSE3, ARGBToYRow_Unaligned_SSSE3, 4)
 YANY(BGRAToYRow_Any_SSSE3, BGRAToYRow_Unaligned_SSSE3, 4)
 YANY(ABGRToYRow_Any_SSSE3, ABGRToYRow_Unaligned_SSSE3, 4)
 #endif
+#ifdef HAS_ARGBTOYROW_AVX2
+void ARGBToYRow_Any_AVX2(const uint8* src_argb, uint8* dst_y, int width) {
+  ARGBToYRow_AVX2(src_argb, dst_y, width - 32);
+  ARGBToYRow_AVX2(src_argb + (width - 32) * 4, dst_y + (width - 32), 32);
+}
+#endif
 #ifdef HAS_RGBATOYROW_SSSE3
 YANY(RGBAToYRow_Any_SSSE3, RGBAToYRow_Unaligned_SSSE3, 4)
 #endif
@@ -1117,6 +1413,39 @@ UVANY(UYVYToUVRow_Any_NEON, UYVYToUVRow_NEON, UYVYToUVRow_C, 2)
 #endif
 #undef UVANY
 
+#define UVINTERLEAVEANY(NAMEANY, ANYTOUV_SSE, ANYTOUV_C, BPP)                  \
+    void NAMEANY(const uint8* src_argb, int src_stride_argb,                   \
+                 uint8* dst_uv, int width) {                                   \
+      int n = width & ~15;                                                     \
+      ANYTOUV_SSE(src_argb, src_stride_argb, dst_uv, n);                       \
+      ANYTOUV_C(src_argb  + n * BPP, src_stride_argb,                          \
+                dst_uv + n,                                                    \
+                width & 15);                                                   \
+    }
+
+#ifdef HAS_ARGBTOUVINTERLEAVEROW_SSSE3
+UVINTERLEAVEANY(ARGBToUVInterleaveRow_Any_SSSE3,
+                ARGBToUVInterleaveRow_Unaligned_SSSE3,
+                ARGBToUVInterleaveRow_C, 4)
+#endif
+#undef UVINTERLEAVEANY
+
+#define MERGEUVANY(NAMEANY, MERGEUV_SIMD, MERGEUV_C)                           \
+    void NAMEANY(const uint8* src_u, const uint8* src_v,                       \
+                 uint8* dst_uv, int width) {                                   \
+      int n = width & ~15;                                                     \
+      MERGEUV_SIMD(src_u, src_v, dst_uv, n);                                   \
+      MERGEUV_C(src_u + n, src_v + n, dst_uv + n * 2, width & 15);             \
+    }
+
+#ifdef HAS_MERGEUV_SSE2
+MERGEUVANY(MergeUV_Any_SSE2, MergeUV_Unaligned_SSE2, MergeUV_C)
+#endif
+#ifdef HAS_MERGEUV_NEON
+MERGEUVANY(MergeUV_Any_NEON, MergeUV_NEON, MergeUV_C)
+#endif
+#undef MERGEUVANY
+
 #define UV422ANY(NAMEANY, ANYTOUV_SSE, ANYTOUV_C, BPP)                         \
     void NAMEANY(const uint8* src_argb,                                        \
                  uint8* dst_u, uint8* dst_v, int width) {                      \
@@ -1142,6 +1471,106 @@ UV422ANY(UYVYToUV422Row_Any_NEON, UYVYToUV422Row_NEON,                         \
 #endif
 #undef UV422ANY
 
+#ifdef HAS_ARGBAPPLY3DLUTROW_AVX2
+void ARGBApply3DLutRow_Any_AVX2(const uint8* src_argb, uint8* dst_argb,
+                                const uint8* lut_argb, const int32* lut_index,
+                                int lut_size, int width) {
+  int n = width & ~7;
+  if (n > 0) {
+    ARGBApply3DLutRow_AVX2(src_argb, dst_argb, lut_argb, lut_index,
+                           lut_size, n);
+  }
+  ARGBApply3DLutRow_C(src_argb + n * 4, dst_argb + n * 4, lut_argb, lut_index,
+                      lut_size, width & 7);
+}
+#endif
+
+#define BLURCOLUMNANY(NAMEANY, BLUR_SIMD, BLUR_C, MASK)                        \
+    void NAMEANY(const uint8* src, uint16* sum, int width) {                   \
+      int n = width & ~MASK;                                                   \
+      if (n > 0) {                                                             \
+        BLUR_SIMD(src, sum, n);                                                \
+      }                                                                        \
+      BLUR_C(src + n, sum + n, width & MASK);                                  \
+    }
+
+#ifdef HAS_BLURCOLUMNROW_SSE2
+BLURCOLUMNANY(BlurColumnAddRow_Any_SSE2, BlurColumnAddRow_SSE2,
+              BlurColumnAddRow_C, 15)
+BLURCOLUMNANY(BlurColumnSubRow_Any_SSE2, BlurColumnSubRow_SSE2,
+              BlurColumnSubRow_C, 15)
+#endif
+#ifdef HAS_BLURCOLUMNROW_NEON
+BLURCOLUMNANY(BlurColumnAddRow_Any_NEON, BlurColumnAddRow_NEON,
+              BlurColumnAddRow_C, 15)
+BLURCOLUMNANY(BlurColumnSubRow_Any_NEON, BlurColumnSubRow_NEON,
+              BlurColumnSubRow_C, 15)
+#endif
+#undef BLURCOLUMNANY
+
+#ifdef HAS_BLURCUMULATIVESUMROW_SSE2
+void BlurCumulativeSumRow_Any_SSE2(const uint16* sum, int32* cumsum,
+                                   int width) {
+  int n = width & ~7;
+  if (n > 0) {
+    BlurCumulativeSumRow_SSE2(sum, cumsum, n);
+  }
+  BlurCumulativeSumRow_C(sum + n, cumsum + n, width & 7);
+}
+#endif
+
+#define BLURAVERAGEANY(NAMEANY, AVERAGE_SIMD, AVERAGE_C, MASK)                 \
+    void NAMEANY(const int32* cumsum, int diameter, float ooa, float rounding, \
+                 uint8* dst, int count) {                                      \
+      int n = count & ~MASK;                                                   \
+      if (n > 0) {                                                             \
+        AVERAGE_SIMD(cumsum, diameter, ooa, rounding, dst, n);                 \
+      }                                                                        \
+      AVERAGE_C(cumsum + n, diameter, ooa, rounding, dst + n, count & MASK);   \
+    }
+
+#ifdef HAS_BLURCUMULATIVESUMTOAVERAGEROW_SSE2
+BLURAVERAGEANY(BlurCumulativeSumToAverageRow_Any_SSE2,
+               BlurCumulativeSumToAverageRow_SSE2,
+               BlurCumulativeSumToAverageRow_C, 7)
+#endif
+#ifdef HAS_BLURCUMULATIVESUMTOAVERAGEROW_NEON
+BLURAVERAGEANY(BlurCumulativeSumToAverageRow_Any_NEON,
+               BlurCumulativeSumToAverageRow_NEON,
+               BlurCumulativeSumToAverageRow_C, 7)
+#endif
+#undef BLURAVERAGEANY
+
+#ifdef HAS_UNSHARPMASKROW_SSE2
+void UnsharpMaskRow_Any_SSE2(const uint8* src, const uint8* src_blur,
+                             uint8* dst, int amount, int threshold, int width) {
+  int n = width & ~7;
+  if (n > 0) {
+    UnsharpMaskRow_SSE2(src, src_blur, dst, amount, threshold, n);
+  }
+  UnsharpMaskRow_C(src + n, src_blur + n, dst + n, amount, threshold,
+                   width & 7);
+}
+#endif
+
+#define BLENDPLANEANY(NAMEANY, BLEND_SIMD, BLEND_C, MASK)                      \
+    void NAMEANY(const uint8* src0, const uint8* src1,                         \
+                 const uint8* alpha, uint8* dst, int width) {                  \
+      int n = width & ~MASK;                                                   \
+      if (n > 0) {                                                             \
+        BLEND_SIMD(src0, src1, alpha, dst, n);                                 \
+      }                                                                        \
+      BLEND_C(src0 + n, src1 + n, alpha + n, dst + n, width & MASK);           \
+    }
+
+#ifdef HAS_BLENDPLANEROW_SSSE3
+BLENDPLANEANY(BlendPlaneRow_Any_SSSE3, BlendPlaneRow_SSSE3, BlendPlaneRow_C, 7)
+#endif
+#ifdef HAS_BLENDPLANEROW_NEON
+BLENDPLANEANY(BlendPlaneRow_Any_NEON, BlendPlaneRow_NEON, BlendPlaneRow_C, 7)
+#endif
+#undef BLENDPLANEANY
+
 void ComputeCumulativeSumRow_C(const uint8* row, int32* cumsum,
                                const int32* previous_cumsum, int width) {
   int32 row_sum[4] = {0, 0, 0, 0};
@@ -1171,6 +1600,78 @@ void CumulativeSumToAverage_C(const int32* tl, const int32* bl,
   }
 }
 
+void BlurColumnAddRow_C(const uint8* src, uint16* sum, int width) {
+  for (int x = 0; x < width; ++x) {
+    sum[x] = static_cast<uint16>(sum[x] + src[x]);
+  }
+}
+
+void BlurColumnSubRow_C(const uint8* src, uint16* sum, int width) {
+  for (int x = 0; x < width; ++x) {
+    sum[x] = static_cast<uint16>(sum[x] - src[x]);
+  }
+}
+
+void BlurCumulativeSumRow_C(const uint16* sum, int32* cumsum, int width) {
+  int32 row_sum = cumsum[0];
+  for (int x = 0; x < width; ++x) {
+    row_sum += sum[x];
+    cumsum[x + 1] = row_sum;
+  }
+}
+
+void ARGBBlurCumulativeSumRow_C(const uint16* sum, int32* cumsum,
+                                int width) {
+  int32 row_sum[4] = { cumsum[0], cumsum[1], cumsum[2], cumsum[3] };
+  for (int x = 0; x < width; ++x) {
+    row_sum[0] += sum[x * 4 + 0];
+    row_sum[1] += sum[x * 4 + 1];
+    row_sum[2] += sum[x * 4 + 2];
+    row_sum[3] += sum[x * 4 + 3];
+    cumsum[x * 4 + 4] = row_sum[0];
+    cumsum[x * 4 + 5] = row_sum[1];
+    cumsum[x * 4 + 6] = row_sum[2];
+    cumsum[x * 4 + 7] = row_sum[3];
+  }
+}
+
+// rounding of 0 truncates, as CumulativeSumToAverage_C does.
+void BlurCumulativeSumToAverageRow_C(const int32* cumsum, int diameter,
+                                     float ooa, float rounding,
+                                     uint8* dst, int count) {
+  for (int i = 0; i < count; ++i) {
+    dst[i] = static_cast<uint8>(static_cast<int>(
+        (cumsum[i + diameter] - cumsum[i]) * ooa + rounding));
+  }
+}
+
+// Adds amount / 256 of the difference from the blurred image when that
+// difference is larger than threshold.
+void UnsharpMaskRow_C(const uint8* src, const uint8* src_blur, uint8* dst,
+                      int amount, int threshold, int width) {
+  for (int x = 0; x < width; ++x) {
+    const int diff = src[x] - src_blur[x];
+    int v = src[x];
+    if (diff > threshold || -diff > threshold) {
+      v += (diff * amount + 128) >> 8;
+    }
+    dst[x] = static_cast<uint8>(Clip(v));
+  }
+}
+
+void HistogramRow_C(const uint8* src, uint32* histogram, int width) {
+  int x;
+  for (x = 0; x < width - 3; x += 4) {
+    ++histogram[src[x]];
+    ++histogram[256 + src[x + 1]];
+    ++histogram[512 + src[x + 2]];
+    ++histogram[768 + src[x + 3]];
+  }
+  for (; x < width; ++x) {
+    ++histogram[src[x]];
+  }
+}
+
 #define REPEAT8(v) (v) | ((v) << 8)
 #define SHADE(f, v) v * f >> 24
 
@@ -1217,6 +1718,71 @@ void ARGBAffineRow_C(const uint8* src_argb, int src_argb_stride,
   }
 }
 
+// Bilinear filter ARGB pixels from source with a slope to a row of
+// destination. uv is converted to 24.8 fixed point, matching the SSE2 version.
+void ARGBAffineRowBilinear_C(const uint8* src_argb, int src_argb_stride,
+                             uint8* dst_argb, const float* uv_dudv, int width) {
+  float uv[2];
+  uv[0] = uv_dudv[0];
+  uv[1] = uv_dudv[1];
+  for (int i = 0; i < width; ++i) {
+    int x = static_cast<int>(uv[0] * 256.f);
+    int y = static_cast<int>(uv[1] * 256.f);
+    int x1_fraction = x & 255;
+    int x0_fraction = 256 - x1_fraction;
+    int y1_fraction = y & 255;
+    int y0_fraction = 256 - y1_fraction;
+    const uint8* src = src_argb + (y >> 8) * src_argb_stride + (x >> 8) * 4;
+    const uint8* src1 = src + src_argb_stride;
+    for (int j = 0; j < 4; ++j) {
+      int top = (src[j] * x0_fraction + src[j + 4] * x1_fraction) >> 8;
+      int bot = (src1[j] * x0_fraction + src1[j + 4] * x1_fraction) >> 8;
+      dst_argb[j] = (top * y0_fraction + bot * y1_fraction) >> 8;
+    }
+    dst_argb += 4;
+    uv[0] += uv_dudv[2];
+    uv[1] += uv_dudv[3];
+  }
+}
+
+// Copy pixels of a plane from source with a slope to a row of destination.
+void AffineRow_C(const uint8* src, int src_stride,
+                 uint8* dst, const float* uv_dudv, int width) {
+  float uv[2];
+  uv[0] = uv_dudv[0];
+  uv[1] = uv_dudv[1];
+  for (int i = 0; i < width; ++i) {
+    int x = static_cast<int>(uv[0]);
+    int y = static_cast<int>(uv[1]);
+    dst[i] = src[y * src_stride + x];
+    uv[0] += uv_dudv[2];
+    uv[1] += uv_dudv[3];
+  }
+}
+
+// Bilinear filter pixels of a plane from source with a slope.
+void AffineRowBilinear_C(const uint8* src, int src_stride,
+                         uint8* dst, const float* uv_dudv, int width) {
+  float uv[2];
+  uv[0] = uv_dudv[0];
+  uv[1] = uv_dudv[1];
+  for (int i = 0; i < width; ++i) {
+    int x = static_cast<int>(uv[0] * 256.f);
+    int y = static_cast<int>(uv[1] * 256.f);
+    int x1_fraction = x & 255;
+    int x0_fraction = 256 - x1_fraction;
+    int y1_fraction = y & 255;
+    int y0_fraction = 256 - y1_fraction;
+    const uint8* s = src + (y >> 8) * src_stride + (x >> 8);
+    int top = (s[0] * x0_fraction + s[1] * x1_fraction) >> 8;
+    int bot = (s[src_stride] * x0_fraction +
+               s[src_stride + 1] * x1_fraction) >> 8;
+    dst[i] = (top * y0_fraction + bot * y1_fraction) >> 8;
+    uv[0] += uv_dudv[2];
+    uv[1] += uv_dudv[3];
+  }
+}
+
 // C version 2x2 -> 2x1.
 void ARGBInterpolateRow_C(uint8* dst_ptr, const uint8* src_ptr,
                           ptrdiff_t src_stride,
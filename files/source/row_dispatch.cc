@@ -0,0 +1,233 @@
+/*
+ *  Copyright 2012 The LibYuv Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "libyuv/row.h"
+
+#if defined(_WIN32)
+#include <windows.h>  // For InterlockedCompareExchangePointer()
+#endif
+
+#include "libyuv/cpu_id.h"
+#include "libyuv/explain.h"
+
+#ifdef __cplusplus
+namespace libyuv {
+extern "C" {
+#endif
+
+// The flags that select row functions, packed into a table index:
+// NEON is bit 0 and SSE2 to AVX2 are bits 1 to 6.
+static const int kDispatchFlags = kCpuHasNEON | kCpuHasSSE2 | kCpuHasSSSE3 |
+    kCpuHasSSE41 | kCpuHasSSE42 | kCpuHasAVX | kCpuHasAVX2;
+static const int kNumDispatchTables = 128;
+
+static int DispatchIndex(int cpu_flags) {
+  return ((cpu_flags & kCpuHasNEON) >> 2) | ((cpu_flags & 0x7e0) >> 4);
+}
+
+static RowDispatch* volatile dispatch_tables_[kNumDispatchTables];
+
+// Sets the SIMD variants of a tier, 0 for the first and 1 for the narrow one.
+#define SET_ROW_TIER(variants, tier, ANY, UNALIGNED, ALIGNED, MASK)            \
+    variants.functions[kRowAny + 3 * tier] = ANY;                              \
+    variants.functions[kRowUnaligned + 3 * tier] = UNALIGNED;                  \
+    variants.functions[kRowAligned + 3 * tier] = ALIGNED;                      \
+    variants.names[kRowAny + 3 * tier] = #ANY;                                 \
+    variants.names[kRowUnaligned + 3 * tier] = #UNALIGNED;                     \
+    variants.names[kRowAligned + 3 * tier] = #ALIGNED;                         \
+    variants.width_mask[tier] = MASK;                                          \
+    variants.has_aligned[tier] = UNALIGNED != ALIGNED
+
+// Sets the portable function and one tier of SIMD variants. The narrow tier
+// repeats the first one, so no width reaches it.
+#define SET_ROW(variants, C, ANY, UNALIGNED, ALIGNED, MASK)                    \
+    variants.functions[kRowC] = C;                                             \
+    variants.names[kRowC] = #C;                                                \
+    SET_ROW_TIER(variants, 0, ANY, UNALIGNED, ALIGNED, MASK);                  \
+    SET_ROW_TIER(variants, 1, ANY, UNALIGNED, ALIGNED, MASK)
+
+#define SET_ROW_C(variants, C) SET_ROW(variants, C, C, C, C, 0)
+
+static void InitRowDispatch(RowDispatch* dispatch, int cpu_flags) {
+  dispatch->cpu_flags = cpu_flags;
+  SET_ROW_C(dispatch->I422ToARGBRow, I422ToARGBRow_C);
+  SET_ROW_C(dispatch->NV12ToARGBRow, NV12ToARGBRow_C);
+  SET_ROW_C(dispatch->NV21ToARGBRow, NV21ToARGBRow_C);
+  SET_ROW_C(dispatch->ARGBToYRow, ARGBToYRow_C);
+  SET_ROW_C(dispatch->ARGBToUVRow, ARGBToUVRow_C);
+#if defined(HAS_I422TOARGBROW_NEON)
+  if (cpu_flags & kCpuHasNEON) {
+    SET_ROW(dispatch->I422ToARGBRow, I422ToARGBRow_C, I422ToARGBRow_Any_NEON,
+            I422ToARGBRow_NEON, I422ToARGBRow_NEON, 15);
+  }
+#elif defined(HAS_I422TOARGBROW_SSSE3)
+  if (cpu_flags & kCpuHasSSSE3) {
+    SET_ROW(dispatch->I422ToARGBRow, I422ToARGBRow_C, I422ToARGBRow_Any_SSSE3,
+            I422ToARGBRow_Unaligned_SSSE3, I422ToARGBRow_SSSE3, 7);
+  }
+#endif
+#if defined(HAS_NV12TOARGBROW_SSSE3)
+  if (cpu_flags & kCpuHasSSSE3) {
+    SET_ROW(dispatch->NV12ToARGBRow, NV12ToARGBRow_C, NV12ToARGBRow_Any_SSSE3,
+            NV12ToARGBRow_Unaligned_SSSE3, NV12ToARGBRow_SSSE3, 7);
+  }
+#endif
+#if defined(HAS_NV12TOARGBROW_NEON)
+  if (cpu_flags & kCpuHasNEON) {
+    SET_ROW(dispatch->NV12ToARGBRow, NV12ToARGBRow_C, NV12ToARGBRow_Any_NEON,
+            NV12ToARGBRow_NEON, NV12ToARGBRow_NEON, 7);
+  }
+#endif
+#if defined(HAS_NV21TOARGBROW_SSSE3)
+  if (cpu_flags & kCpuHasSSSE3) {
+    SET_ROW(dispatch->NV21ToARGBRow, NV21ToARGBRow_C, NV21ToARGBRow_Any_SSSE3,
+            NV21ToARGBRow_Unaligned_SSSE3, NV21ToARGBRow_SSSE3, 7);
+  }
+#endif
+#if defined(HAS_NV21TOARGBROW_NEON)
+  if (cpu_flags & kCpuHasNEON) {
+    SET_ROW(dispatch->NV21ToARGBRow, NV21ToARGBRow_C, NV21ToARGBRow_Any_NEON,
+            NV21ToARGBRow_NEON, NV21ToARGBRow_NEON, 7);
+  }
+#endif
+#if defined(HAS_ARGBTOYROW_SSSE3)
+  if (cpu_flags & kCpuHasSSSE3) {
+    SET_ROW(dispatch->ARGBToYRow, ARGBToYRow_C, ARGBToYRow_Any_SSSE3,
+            ARGBToYRow_Unaligned_SSSE3, ARGBToYRow_SSSE3, 15);
+  }
+#endif
+#if defined(HAS_ARGBTOYROW_AVX2)
+  if (cpu_flags & kCpuHasAVX2) {
+    SET_ROW_TIER(dispatch->ARGBToYRow, 0, ARGBToYRow_Any_AVX2,
+                 ARGBToYRow_AVX2, ARGBToYRow_AVX2, 31);
+    // Widths 16 to 31 keep the SSSE3 kernels.
+    SET_ROW_TIER(dispatch->ARGBToYRow, 1, ARGBToYRow_Any_SSSE3,
+                 ARGBToYRow_Unaligned_SSSE3, ARGBToYRow_SSSE3, 15);
+  }
+#endif
+#if defined(HAS_ARGBTOUVROW_SSSE3)
+  if (cpu_flags & kCpuHasSSSE3) {
+    SET_ROW(dispatch->ARGBToUVRow, ARGBToUVRow_C, ARGBToUVRow_Any_SSSE3,
+            ARGBToUVRow_Unaligned_SSSE3, ARGBToUVRow_SSSE3, 15);
+  }
+#endif
+}
+
+// Publishes dispatch in slot if the slot is empty. Returns the table that
+// is in the slot afterwards.
+static RowDispatch* PublishRowDispatch(RowDispatch* volatile* slot,
+                                       RowDispatch* dispatch) {
+#if defined(_WIN32)
+  RowDispatch* previous = static_cast<RowDispatch*>(
+      InterlockedCompareExchangePointer(
+          reinterpret_cast<PVOID volatile*>(slot), dispatch, NULL));
+#elif defined(__GNUC__)
+  RowDispatch* previous = __sync_val_compare_and_swap(slot, NULL, dispatch);
+#else
+  RowDispatch* previous = *slot;
+  if (!previous) {
+    *slot = dispatch;
+  }
+#endif
+  if (previous) {
+    delete dispatch;
+    return previous;
+  }
+  return dispatch;
+}
+
+LIBYUV_API
+const RowDispatch* GetRowDispatch() {
+  const int cpu_flags = TestCpuFlag(kDispatchFlags);
+  RowDispatch* volatile* slot = &dispatch_tables_[DispatchIndex(cpu_flags)];
+#if defined(__ATOMIC_ACQUIRE)
+  RowDispatch* dispatch = __atomic_load_n(slot, __ATOMIC_ACQUIRE);
+#else
+  RowDispatch* dispatch = *slot;
+#endif
+  if (!dispatch) {
+    // Threads that race here each build a table and one of them is kept.
+    dispatch = new RowDispatch;
+    InitRowDispatch(dispatch, cpu_flags);
+    dispatch = PublishRowDispatch(slot, dispatch);
+  }
+  return dispatch;
+}
+
+void ExplainKernelC(KernelChoice* choice, const char* path,
+                    const char* kernel) {
+  choice->path = path;
+  choice->kernel = kernel;
+  choice->reason = "no SIMD kernel for these cpu flags";
+  choice->simd = 0;
+}
+
+void ExplainKernel(KernelChoice* choice, const char* kernel,
+                   bool width_ok, bool aligned_ok) {
+  if (!width_ok) {
+    choice->reason = "width is not a multiple of the SIMD step";
+  } else if (!aligned_ok) {
+    choice->reason = "pointer or stride is not 16 byte aligned";
+  } else {
+    choice->kernel = kernel;
+    choice->reason = "SIMD kernel for these cpu flags, width and alignment";
+    choice->simd = 1;
+  }
+}
+
+int SelectRowVariant(const int width_mask[2], int width, bool is_aligned) {
+  for (int tier = 0; tier < 2; ++tier) {
+    const int mask = width_mask[tier];
+    if (mask && width > mask) {
+      const int variant = kRowAny + 3 * tier;
+      return (width & mask) ? variant :
+             is_aligned ? variant + 2 : variant + 1;
+    }
+  }
+  return kRowC;
+}
+
+void ExplainRowVariants(KernelChoice* choice, const char* path,
+                        const char* const names[kRowVariants],
+                        const int width_mask[2], const bool has_aligned[2],
+                        int width, bool is_aligned) {
+  const int variant = SelectRowVariant(width_mask, width, is_aligned);
+  ExplainKernelC(choice, path, names[variant]);
+  if (variant == kRowC) {
+    if (width_mask[0]) {
+      choice->reason = "width is less than the SIMD step";
+    }
+    return;
+  }
+  choice->simd = 1;
+  const int tier = variant >= kRowNarrowAny ? 1 : 0;
+  const int kind = variant - 3 * tier;
+  if (kind == kRowAny) {
+    choice->reason = tier ?
+        "width is less than the widest SIMD step and not a multiple of the "
+        "narrower one, so the Any version of the narrower kernel is used" :
+        "width is not a multiple of the SIMD step, so the Any version is used";
+  } else if (kind == kRowUnaligned && has_aligned[tier]) {
+    choice->reason = tier ?
+        "width is less than the widest SIMD step and a pointer or stride is "
+        "not 16 byte aligned" :
+        "pointer or stride is not 16 byte aligned";
+  } else {
+    choice->reason = tier ?
+        "width is less than the widest SIMD step, so the narrower SIMD "
+        "kernel is used" :
+        "SIMD kernel for these cpu flags, width and alignment";
+  }
+}
+
+#ifdef __cplusplus
+}  // extern "C"
+}  // namespace libyuv
+#endif
@@ -67,7 +67,8 @@ extern "C" {
     "vmov.u8    d21, d16                       \n"
 
 #if defined(HAS_I422TOARGBROW_NEON) || defined(HAS_I422TOBGRAROW_NEON) ||      \
-    defined(HAS_I422TOABGRROW_NEON) || defined(HAS_I422TORGBAROW_NEON)
+    defined(HAS_I422TOABGRROW_NEON) || defined(HAS_I422TORGBAROW_NEON) ||      \
+    defined(HAS_I422TORGB565ROW_NEON)
 static const vec8 kUVToRB  = { 127, 127, 127, 127, 102, 102, 102, 102,
                                0, 0, 0, 0, 0, 0, 0, 0 };
 static const vec8 kUVToG = { -25, -25, -25, -25, -52, -52, -52, -52,
@@ -335,6 +336,229 @@ void NV21ToARGBRow_NEON(const uint8* y_buf,
 }
 #endif  // HAS_NV21TOARGBROW_NEON
 
+#ifdef HAS_I422TORGB565ROW_NEON
+// Pack 8 pixels of B, G and R in d20, d21 and d22 to RGB565 in q0.
+#define ARGBTORGB565                                                           \
+    "vshll.u8    q0, d22, #8                   \n"/* R */                      \
+    "vshll.u8    q8, d21, #8                   \n"/* G */                      \
+    "vshll.u8    q9, d20, #8                   \n"/* B */                      \
+    "vsri.16     q0, q8, #5                    \n"/* RG */                     \
+    "vsri.16     q0, q9, #11                   \n"/* RGB */                    \
+
+#define ARGBTOARGB1555                                                         \
+    "vmov.u8     d23, #255                     \n"/* A */                      \
+    "vshll.u8    q0, d23, #8                   \n"                             \
+    "vshll.u8    q8, d22, #8                   \n"/* R */                      \
+    "vshll.u8    q9, d21, #8                   \n"/* G */                      \
+    "vshll.u8    q10, d20, #8                  \n"/* B */                      \
+    "vsri.16     q0, q8, #1                    \n"/* AR */                     \
+    "vsri.16     q0, q9, #6                    \n"/* ARG */                    \
+    "vsri.16     q0, q10, #11                  \n"/* ARGB */                   \
+
+// d4 holds 0x0f and d5 holds 0xf0 per byte.
+#define ARGBTOARGB4444                                                         \
+    "vshr.u8     d20, d20, #4                  \n"/* B */                      \
+    "vbic.32     d21, d21, d4                  \n"/* G */                      \
+    "vshr.u8     d22, d22, #4                  \n"/* R */                      \
+    "vorr        d0, d20, d21                  \n"/* BG */                     \
+    "vorr        d1, d22, d5                   \n"/* RA */                     \
+    "vzip.u8     d0, d1                        \n"/* BGRA */                   \
+
+// Add 4 bytes of dither in d4, repeated per 4 pixels, to B, G and R.
+#define DITHERRGB                                                              \
+    "vqadd.u8    d20, d20, d4                  \n"                             \
+    "vqadd.u8    d21, d21, d4                  \n"                             \
+    "vqadd.u8    d22, d22, d4                  \n"                             \
+
+void I422ToRGB565Row_NEON(const uint8* y_buf,
+                          const uint8* u_buf,
+                          const uint8* v_buf,
+                          uint8* rgb_buf,
+                          int width) {
+  asm volatile (
+    "vld1.u8    {d24}, [%5]                    \n"
+    "vld1.u8    {d25}, [%6]                    \n"
+    "vmov.u8    d26, #128                      \n"
+    "vmov.u16   q14, #74                       \n"
+    "vmov.u16   q15, #16                       \n"
+    ".p2align  2                               \n"
+  "1:                                          \n"
+    READYUV422
+    YUV422TORGB
+    "subs       %4, %4, #8                     \n"
+    ARGBTORGB565
+    "vst1.8     {q0}, [%3]!                    \n"
+    "bgt        1b                             \n"
+    : "+r"(y_buf),    // %0
+      "+r"(u_buf),    // %1
+      "+r"(v_buf),    // %2
+      "+r"(rgb_buf),  // %3
+      "+r"(width)     // %4
+    : "r"(&kUVToRB),  // %5
+      "r"(&kUVToG)    // %6
+    : "cc", "memory", "q0", "q1", "q2", "q3",
+      "q8", "q9", "q10", "q11", "q12", "q13", "q14", "q15"
+  );
+}
+
+void I422ToARGB1555Row_NEON(const uint8* y_buf,
+                            const uint8* u_buf,
+                            const uint8* v_buf,
+                            uint8* rgb_buf,
+                            int width) {
+  asm volatile (
+    "vld1.u8    {d24}, [%5]                    \n"
+    "vld1.u8    {d25}, [%6]                    \n"
+    "vmov.u8    d26, #128                      \n"
+    "vmov.u16   q14, #74                       \n"
+    "vmov.u16   q15, #16                       \n"
+    ".p2align  2                               \n"
+  "1:                                          \n"
+    READYUV422
+    YUV422TORGB
+    "subs       %4, %4, #8                     \n"
+    ARGBTOARGB1555
+    "vst1.8     {q0}, [%3]!                    \n"
+    "bgt        1b                             \n"
+    : "+r"(y_buf),    // %0
+      "+r"(u_buf),    // %1
+      "+r"(v_buf),    // %2
+      "+r"(rgb_buf),  // %3
+      "+r"(width)     // %4
+    : "r"(&kUVToRB),  // %5
+      "r"(&kUVToG)    // %6
+    : "cc", "memory", "q0", "q1", "q2", "q3",
+      "q8", "q9", "q10", "q11", "q12", "q13", "q14", "q15"
+  );
+}
+
+void I422ToARGB4444Row_NEON(const uint8* y_buf,
+                            const uint8* u_buf,
+                            const uint8* v_buf,
+                            uint8* rgb_buf,
+                            int width) {
+  asm volatile (
+    "vld1.u8    {d24}, [%5]                    \n"
+    "vld1.u8    {d25}, [%6]                    \n"
+    "vmov.u8    d26, #128                      \n"
+    "vmov.u16   q14, #74                       \n"
+    "vmov.u16   q15, #16                       \n"
+    "vmov.u8    d4, #0x0f                      \n"
+    "vmov.u8    d5, #0xf0                      \n"
+    ".p2align  2                               \n"
+  "1:                                          \n"
+    READYUV422
+    YUV422TORGB
+    "subs       %4, %4, #8                     \n"
+    ARGBTOARGB4444
+    "vst1.8     {q0}, [%3]!                    \n"
+    "bgt        1b                             \n"
+    : "+r"(y_buf),    // %0
+      "+r"(u_buf),    // %1
+      "+r"(v_buf),    // %2
+      "+r"(rgb_buf),  // %3
+      "+r"(width)     // %4
+    : "r"(&kUVToRB),  // %5
+      "r"(&kUVToG)    // %6
+    : "cc", "memory", "q0", "q1", "q2", "q3",
+      "q8", "q9", "q10", "q11", "q12", "q13", "q14", "q15"
+  );
+}
+
+void I422ToRGB565DitherRow_NEON(const uint8* y_buf,
+                                const uint8* u_buf,
+                                const uint8* v_buf,
+                                uint8* rgb_buf,
+                                uint32 dither4,
+                                int width) {
+  asm volatile (
+    "vld1.u8    {d24}, [%5]                    \n"
+    "vld1.u8    {d25}, [%6]                    \n"
+    "vmov.u8    d26, #128                      \n"
+    "vmov.u16   q14, #74                       \n"
+    "vmov.u16   q15, #16                       \n"
+    "vdup.32    d4, %7                         \n"
+    ".p2align  2                               \n"
+  "1:                                          \n"
+    READYUV422
+    YUV422TORGB
+    DITHERRGB
+    "subs       %4, %4, #8                     \n"
+    ARGBTORGB565
+    "vst1.8     {q0}, [%3]!                    \n"
+    "bgt        1b                             \n"
+    : "+r"(y_buf),    // %0
+      "+r"(u_buf),    // %1
+      "+r"(v_buf),    // %2
+      "+r"(rgb_buf),  // %3
+      "+r"(width)     // %4
+    : "r"(&kUVToRB),  // %5
+      "r"(&kUVToG),   // %6
+      "r"(dither4)    // %7
+    : "cc", "memory", "q0", "q1", "q2", "q3",
+      "q8", "q9", "q10", "q11", "q12", "q13", "q14", "q15"
+  );
+}
+
+void NV12ToRGB565Row_NEON(const uint8* y_buf,
+                          const uint8* uv_buf,
+                          uint8* rgb_buf,
+                          int width) {
+  asm volatile (
+    "vld1.u8    {d24}, [%4]                    \n"
+    "vld1.u8    {d25}, [%5]                    \n"
+    "vmov.u8    d26, #128                      \n"
+    "vmov.u16   q14, #74                       \n"
+    "vmov.u16   q15, #16                       \n"
+    ".p2align  2                               \n"
+  "1:                                          \n"
+    READNV12
+    YUV422TORGB
+    "subs       %3, %3, #8                     \n"
+    ARGBTORGB565
+    "vst1.8     {q0}, [%2]!                    \n"
+    "bgt        1b                             \n"
+    : "+r"(y_buf),    // %0
+      "+r"(uv_buf),   // %1
+      "+r"(rgb_buf),  // %2
+      "+r"(width)     // %3
+    : "r"(&kUVToRB),  // %4
+      "r"(&kUVToG)    // %5
+    : "cc", "memory", "q0", "q1", "q2", "q3",
+      "q8", "q9", "q10", "q11", "q12", "q13", "q14", "q15"
+  );
+}
+
+void NV21ToRGB565Row_NEON(const uint8* y_buf,
+                          const uint8* uv_buf,
+                          uint8* rgb_buf,
+                          int width) {
+  asm volatile (
+    "vld1.u8    {d24}, [%4]                    \n"
+    "vld1.u8    {d25}, [%5]                    \n"
+    "vmov.u8    d26, #128                      \n"
+    "vmov.u16   q14, #74                       \n"
+    "vmov.u16   q15, #16                       \n"
+    ".p2align  2                               \n"
+  "1:                                          \n"
+    READNV21
+    YUV422TORGB
+    "subs       %3, %3, #8                     \n"
+    ARGBTORGB565
+    "vst1.8     {q0}, [%2]!                    \n"
+    "bgt        1b                             \n"
+    : "+r"(y_buf),    // %0
+      "+r"(uv_buf),   // %1
+      "+r"(rgb_buf),  // %2
+      "+r"(width)     // %3
+    : "r"(&kUVToRB),  // %4
+      "r"(&kUVToG)    // %5
+    : "cc", "memory", "q0", "q1", "q2", "q3",
+      "q8", "q9", "q10", "q11", "q12", "q13", "q14", "q15"
+  );
+}
+#endif  // HAS_I422TORGB565ROW_NEON
+
 #ifdef HAS_SPLITUV_NEON
 // Reads 16 pairs of UV and write even values to dst_u and odd to dst_v
 // Alignment requirement: 16 bytes for pointers, and multiple of 16 pixels.
@@ -357,6 +581,163 @@ void SplitUV_NEON(const uint8* src_uv, uint8* dst_u, uint8* dst_v, int width) {
 }
 #endif  // HAS_SPLITUV_NEON
 
+#ifdef HAS_MERGEUV_NEON
+// Reads 16 U's and V's and writes out 16 pairs of UV.
+void MergeUV_NEON(const uint8* src_u, const uint8* src_v, uint8* dst_uv,
+                  int width) {
+  asm volatile (
+    ".p2align  2                               \n"
+  "1:                                          \n"
+    "vld1.u8    {q0}, [%0]!                    \n"  // load U
+    "vld1.u8    {q1}, [%1]!                    \n"  // load V
+    "subs       %3, %3, #16                    \n"  // 16 processed per loop
+    "vst2.u8    {q0, q1}, [%2]!                \n"  // store 16 pairs of UV
+    "bgt        1b                             \n"
+    : "+r"(src_u),   // %0
+      "+r"(src_v),   // %1
+      "+r"(dst_uv),  // %2
+      "+r"(width)    // %3  // Output registers
+    :                       // Input registers
+    : "memory", "cc", "q0", "q1"  // Clobber List
+  );
+}
+#endif  // HAS_MERGEUV_NEON
+
+#ifdef HAS_BLENDPLANEROW_NEON
+// Blend 8 pixels at a time.
+void BlendPlaneRow_NEON(const uint8* src0, const uint8* src1,
+                        const uint8* alpha, uint8* dst, int width) {
+  asm volatile (
+    "vmov.u8    d6, #255                       \n"
+    "vmov.u16   q2, #255                       \n"
+    ".p2align  2                               \n"
+  "1:                                          \n"
+    "vld1.u8    {d0}, [%0]!                    \n"  // load src0
+    "vld1.u8    {d1}, [%1]!                    \n"  // load src1
+    "vld1.u8    {d2}, [%2]!                    \n"  // load alpha
+    "subs       %4, %4, #8                     \n"  // 8 processed per loop
+    "vsub.u8    d3, d6, d2                     \n"  // 255 - alpha
+    "vmull.u8   q8, d0, d2                     \n"  // src0 * alpha
+    "vmlal.u8   q8, d1, d3                     \n"  // + src1 * (255 - alpha)
+    "vadd.u16   q8, q8, q2                     \n"  // + 255
+    "vshrn.u16  d0, q8, #8                     \n"
+    "vst1.u8    {d0}, [%3]!                    \n"  // store 8 pixels
+    "bgt        1b                             \n"
+    : "+r"(src0),   // %0
+      "+r"(src1),   // %1
+      "+r"(alpha),  // %2
+      "+r"(dst),    // %3
+      "+r"(width)   // %4  // Output registers
+    :                      // Input registers
+    : "memory", "cc", "q0", "q1", "q2", "q3", "q8"  // Clobber List
+  );
+}
+#endif  // HAS_BLENDPLANEROW_NEON
+
+#ifdef HAS_BLURCOLUMNROW_NEON
+// Add 16 pixels at a time to 16 bit column sums.
+void BlurColumnAddRow_NEON(const uint8* src, uint16* sum, int width) {
+  asm volatile (
+    ".p2align  2                               \n"
+  "1:                                          \n"
+    "vld1.u8    {q0}, [%0]!                    \n"  // load 16 pixels
+    "vld1.u16   {q1, q2}, [%1]                 \n"  // load 16 sums
+    "subs       %2, %2, #16                    \n"  // 16 processed per loop
+    "vaddw.u8   q1, q1, d0                     \n"
+    "vaddw.u8   q2, q2, d1                     \n"
+    "vst1.u16   {q1, q2}, [%1]!                \n"  // store 16 sums
+    "bgt        1b                             \n"
+    : "+r"(src),   // %0
+      "+r"(sum),   // %1
+      "+r"(width)  // %2
+    :
+    : "memory", "cc", "q0", "q1", "q2"
+  );
+}
+
+// Subtract 16 pixels at a time from 16 bit column sums.
+void BlurColumnSubRow_NEON(const uint8* src, uint16* sum, int width) {
+  asm volatile (
+    ".p2align  2                               \n"
+  "1:                                          \n"
+    "vld1.u8    {q0}, [%0]!                    \n"  // load 16 pixels
+    "vld1.u16   {q1, q2}, [%1]                 \n"  // load 16 sums
+    "subs       %2, %2, #16                    \n"  // 16 processed per loop
+    "vsubw.u8   q1, q1, d0                     \n"
+    "vsubw.u8   q2, q2, d1                     \n"
+    "vst1.u16   {q1, q2}, [%1]!                \n"  // store 16 sums
+    "bgt        1b                             \n"
+    : "+r"(src),   // %0
+      "+r"(sum),   // %1
+      "+r"(width)  // %2
+    :
+    : "memory", "cc", "q0", "q1", "q2"
+  );
+}
+#endif  // HAS_BLURCOLUMNROW_NEON
+
+#ifdef HAS_ARGBBLURCUMULATIVESUMROW_NEON
+// Running sum of column sums, 1 ARGB pixel at a time.
+void ARGBBlurCumulativeSumRow_NEON(const uint16* sum, int32* cumsum,
+                                   int width) {
+  asm volatile (
+    "vld1.32    {q1}, [%1]!                    \n"  // starting value
+    ".p2align  2                               \n"
+  "1:                                          \n"
+    "vld1.u16   {d0}, [%0]!                    \n"  // load 1 pixel of sums
+    "subs       %2, %2, #1                     \n"  // 1 processed per loop
+    "vaddw.u16  q1, q1, d0                     \n"
+    "vst1.32    {q1}, [%1]!                    \n"
+    "bgt        1b                             \n"
+    : "+r"(sum),     // %0
+      "+r"(cumsum),  // %1
+      "+r"(width)    // %2
+    :
+    : "memory", "cc", "q0", "q1"
+  );
+}
+#endif  // HAS_ARGBBLURCUMULATIVESUMROW_NEON
+
+#ifdef HAS_BLURCUMULATIVESUMTOAVERAGEROW_NEON
+// Average 8 pixels at a time.
+void BlurCumulativeSumToAverageRow_NEON(const int32* cumsum, int diameter,
+                                        float ooa, float rounding,
+                                        uint8* dst, int count) {
+  const int32* cumsum_right = cumsum + diameter;
+  asm volatile (
+    "vld1.32    {d30[], d31[]}, [%4]           \n"  // ooa
+    "vld1.32    {d28[], d29[]}, [%5]           \n"  // rounding
+    ".p2align  2                               \n"
+  "1:                                          \n"
+    "vld1.32    {q0, q1}, [%0]!                \n"  // load 8 left sums
+    "vld1.32    {q2, q3}, [%1]!                \n"  // load 8 right sums
+    "subs       %3, %3, #8                     \n"  // 8 processed per loop
+    "vsub.s32   q2, q2, q0                     \n"
+    "vsub.s32   q3, q3, q1                     \n"
+    "vcvt.f32.s32 q2, q2                       \n"
+    "vcvt.f32.s32 q3, q3                       \n"
+    "vmul.f32   q2, q2, q15                    \n"
+    "vmul.f32   q3, q3, q15                    \n"
+    "vadd.f32   q2, q2, q14                    \n"
+    "vadd.f32   q3, q3, q14                    \n"
+    "vcvt.s32.f32 q2, q2                       \n"
+    "vcvt.s32.f32 q3, q3                       \n"
+    "vqmovn.s32 d0, q2                         \n"
+    "vqmovn.s32 d1, q3                         \n"
+    "vqmovun.s16 d0, q0                        \n"
+    "vst1.u8    {d0}, [%2]!                    \n"  // store 8 pixels
+    "bgt        1b                             \n"
+    : "+r"(cumsum),        // %0
+      "+r"(cumsum_right),  // %1
+      "+r"(dst),           // %2
+      "+r"(count)          // %3
+    : "r"(&ooa),           // %4
+      "r"(&rounding)       // %5
+    : "memory", "cc", "q0", "q1", "q2", "q3", "q14", "q15"
+  );
+}
+#endif  // HAS_BLURCUMULATIVESUMTOAVERAGEROW_NEON
+
 #ifdef HAS_COPYROW_NEON
 // Copy multiple of 64
 void CopyRow_NEON(const uint8* src, uint8* dst, int count) {
@@ -538,6 +919,29 @@ void MirrorRowUV_NEON(const uint8* src, uint8* dst_a, uint8* dst_b, int width) {
 }
 #endif  // HAS_MIRRORROWUV_NEON
 
+#ifdef HAS_UVMIRRORROW_NEON
+// Mirrors a row of interleaved UV, 8 pairs at a time.
+void UVMirrorRow_NEON(const uint8* src_uv, uint8* dst_uv, int width) {
+  asm volatile (
+    "add         %0, %0, %2, lsl #1            \n"  // src_uv + width * 2
+    "sub         %0, #16                       \n"
+    "mov         r12, #-16                     \n"
+    ".p2align  2                               \n"
+  "1:                                          \n"
+    "vld2.8      {d0, d1}, [%0], r12           \n"  // src -= 16
+    "subs        %2, #8                        \n"  // 8 pairs per loop
+    "vrev64.8    q0, q0                        \n"
+    "vst2.8      {d0, d1}, [%1]!               \n"  // dst += 16
+    "bgt         1b                            \n"
+    : "+r"(src_uv),  // %0
+      "+r"(dst_uv),  // %1
+      "+r"(width)    // %2
+    :
+    : "memory", "cc", "r12", "q0"
+  );
+}
+#endif  // HAS_UVMIRRORROW_NEON
+
 #ifdef HAS_BGRATOARGBROW_NEON
 void BGRAToARGBRow_NEON(const uint8* src_bgra, uint8* dst_argb, int pix) {
   asm volatile (
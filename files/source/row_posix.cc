@@ -666,6 +666,7 @@ void ARGBToARGB4444Row_SSE2(const uint8* src, uint8* dst, int pix) {
   );
 }
 
+#if !defined(LIBYUV_SSSE3)  // Else in row_ssse3.cc
 void ARGBToYRow_SSSE3(const uint8* src_argb, uint8* dst_y, int pix) {
   asm volatile (
     "movdqa    %4,%%xmm5                       \n"
@@ -870,6 +871,136 @@ void ARGBToUVRow_Unaligned_SSSE3(const uint8* src_argb0, int src_stride_argb,
 #endif
   );
 }
+#endif  // !defined(LIBYUV_SSSE3)
+
+// Same as ARGBToUVRow_SSSE3 but stores 8 interleaved UV pairs, as used by
+// NV12, instead of 8 U and 8 V.
+void ARGBToUVInterleaveRow_SSSE3(const uint8* src_argb0, int src_stride_argb,
+                                 uint8* dst_uv, int width) {
+  asm volatile (
+    "movdqa    %0,%%xmm4                       \n"
+    "movdqa    %1,%%xmm3                       \n"
+    "movdqa    %2,%%xmm5                       \n"
+  :
+  : "m"(kARGBToU),  // %0
+    "m"(kARGBToV),  // %1
+    "m"(kAddUV128)  // %2
+  );
+  asm volatile (
+    ".p2align  4                               \n"
+  "1:                                          \n"
+    "movdqa    (%0),%%xmm0                     \n"
+    "movdqa    0x10(%0),%%xmm1                 \n"
+    "movdqa    0x20(%0),%%xmm2                 \n"
+    "movdqa    0x30(%0),%%xmm6                 \n"
+    "pavgb     (%0,%3,1),%%xmm0                \n"
+    "pavgb     0x10(%0,%3,1),%%xmm1            \n"
+    "pavgb     0x20(%0,%3,1),%%xmm2            \n"
+    "pavgb     0x30(%0,%3,1),%%xmm6            \n"
+    "lea       0x40(%0),%0                     \n"
+    "movdqa    %%xmm0,%%xmm7                   \n"
+    "shufps    $0x88,%%xmm1,%%xmm0             \n"
+    "shufps    $0xdd,%%xmm1,%%xmm7             \n"
+    "pavgb     %%xmm7,%%xmm0                   \n"
+    "movdqa    %%xmm2,%%xmm7                   \n"
+    "shufps    $0x88,%%xmm6,%%xmm2             \n"
+    "shufps    $0xdd,%%xmm6,%%xmm7             \n"
+    "pavgb     %%xmm7,%%xmm2                   \n"
+    "movdqa    %%xmm0,%%xmm1                   \n"
+    "movdqa    %%xmm2,%%xmm6                   \n"
+    "pmaddubsw %%xmm4,%%xmm0                   \n"
+    "pmaddubsw %%xmm4,%%xmm2                   \n"
+    "pmaddubsw %%xmm3,%%xmm1                   \n"
+    "pmaddubsw %%xmm3,%%xmm6                   \n"
+    "phaddw    %%xmm2,%%xmm0                   \n"
+    "phaddw    %%xmm6,%%xmm1                   \n"
+    "psraw     $0x8,%%xmm0                     \n"
+    "psraw     $0x8,%%xmm1                     \n"
+    "packsswb  %%xmm1,%%xmm0                   \n"
+    "paddb     %%xmm5,%%xmm0                   \n"
+    "movdqa    %%xmm0,%%xmm1                   \n"
+    "psrldq    $0x8,%%xmm1                     \n"
+    "punpcklbw %%xmm1,%%xmm0                   \n"
+    "sub       $0x10,%2                        \n"
+    "movdqu    %%xmm0,(%1)                     \n"
+    "lea       0x10(%1),%1                     \n"
+    "jg        1b                              \n"
+  : "+r"(src_argb0),       // %0
+    "+r"(dst_uv),          // %1
+    "+rm"(width)           // %2
+  : "r"(static_cast<intptr_t>(src_stride_argb))
+  : "memory", "cc"
+#if defined(__SSE2__)
+    , "xmm0", "xmm1", "xmm2", "xmm6", "xmm7"
+#endif
+  );
+}
+
+void ARGBToUVInterleaveRow_Unaligned_SSSE3(const uint8* src_argb0,
+                                           int src_stride_argb,
+                                           uint8* dst_uv, int width) {
+  asm volatile (
+    "movdqa    %0,%%xmm4                       \n"
+    "movdqa    %1,%%xmm3                       \n"
+    "movdqa    %2,%%xmm5                       \n"
+  :
+  : "m"(kARGBToU),         // %0
+    "m"(kARGBToV),         // %1
+    "m"(kAddUV128)         // %2
+  );
+  asm volatile (
+    ".p2align  4                               \n"
+  "1:                                          \n"
+    "movdqu    (%0),%%xmm0                     \n"
+    "movdqu    0x10(%0),%%xmm1                 \n"
+    "movdqu    0x20(%0),%%xmm2                 \n"
+    "movdqu    0x30(%0),%%xmm6                 \n"
+    "movdqu    (%0,%3,1),%%xmm7                \n"
+    "pavgb     %%xmm7,%%xmm0                   \n"
+    "movdqu    0x10(%0,%3,1),%%xmm7            \n"
+    "pavgb     %%xmm7,%%xmm1                   \n"
+    "movdqu    0x20(%0,%3,1),%%xmm7            \n"
+    "pavgb     %%xmm7,%%xmm2                   \n"
+    "movdqu    0x30(%0,%3,1),%%xmm7            \n"
+    "pavgb     %%xmm7,%%xmm6                   \n"
+    "lea       0x40(%0),%0                     \n"
+    "movdqa    %%xmm0,%%xmm7                   \n"
+    "shufps    $0x88,%%xmm1,%%xmm0             \n"
+    "shufps    $0xdd,%%xmm1,%%xmm7             \n"
+    "pavgb     %%xmm7,%%xmm0                   \n"
+    "movdqa    %%xmm2,%%xmm7                   \n"
+    "shufps    $0x88,%%xmm6,%%xmm2             \n"
+    "shufps    $0xdd,%%xmm6,%%xmm7             \n"
+    "pavgb     %%xmm7,%%xmm2                   \n"
+    "movdqa    %%xmm0,%%xmm1                   \n"
+    "movdqa    %%xmm2,%%xmm6                   \n"
+    "pmaddubsw %%xmm4,%%xmm0                   \n"
+    "pmaddubsw %%xmm4,%%xmm2                   \n"
+    "pmaddubsw %%xmm3,%%xmm1                   \n"
+    "pmaddubsw %%xmm3,%%xmm6                   \n"
+    "phaddw    %%xmm2,%%xmm0                   \n"
+    "phaddw    %%xmm6,%%xmm1                   \n"
+    "psraw     $0x8,%%xmm0                     \n"
+    "psraw     $0x8,%%xmm1                     \n"
+    "packsswb  %%xmm1,%%xmm0                   \n"
+    "paddb     %%xmm5,%%xmm0                   \n"
+    "movdqa    %%xmm0,%%xmm1                   \n"
+    "psrldq    $0x8,%%xmm1                     \n"
+    "punpcklbw %%xmm1,%%xmm0                   \n"
+    "sub       $0x10,%2                        \n"
+    "movdqu    %%xmm0,(%1)                     \n"
+    "lea       0x10(%1),%1                     \n"
+    "jg        1b                              \n"
+  : "+r"(src_argb0),       // %0
+    "+r"(dst_uv),          // %1
+    "+rm"(width)           // %2
+  : "r"(static_cast<intptr_t>(src_stride_argb))
+  : "memory", "cc"
+#if defined(__SSE2__)
+    , "xmm0", "xmm1", "xmm2", "xmm6", "xmm7"
+#endif
+  );
+}
 
 void BGRAToYRow_SSSE3(const uint8* src_bgra, uint8* dst_y, int pix) {
   asm volatile (
@@ -1431,6 +1562,7 @@ void OMITFP I444ToARGBRow_SSSE3(const uint8* y_buf,
   );
 }
 
+#if !defined(LIBYUV_SSSE3)  // Else in row_ssse3.cc
 void OMITFP I422ToARGBRow_SSSE3(const uint8* y_buf,
                                 const uint8* u_buf,
                                 const uint8* v_buf,
@@ -1466,6 +1598,7 @@ void OMITFP I422ToARGBRow_SSSE3(const uint8* y_buf,
 #endif
   );
 }
+#endif  // !defined(LIBYUV_SSSE3)
 
 void OMITFP I411ToARGBRow_SSSE3(const uint8* y_buf,
                                 const uint8* u_buf,
@@ -1503,6 +1636,7 @@ void OMITFP I411ToARGBRow_SSSE3(const uint8* y_buf,
   );
 }
 
+#if !defined(LIBYUV_SSSE3)  // Else in row_ssse3.cc
 void OMITFP NV12ToARGBRow_SSSE3(const uint8* y_buf,
                                 const uint8* uv_buf,
                                 uint8* argb_buf,
@@ -1568,6 +1702,7 @@ void OMITFP NV21ToARGBRow_SSSE3(const uint8* y_buf,
 #endif
   );
 }
+#endif  // !defined(LIBYUV_SSSE3)
 
 void OMITFP I444ToARGBRow_Unaligned_SSSE3(const uint8* y_buf,
                                           const uint8* u_buf,
@@ -1605,6 +1740,7 @@ void OMITFP I444ToARGBRow_Unaligned_SSSE3(const uint8* y_buf,
   );
 }
 
+#if !defined(LIBYUV_SSSE3)  // Else in row_ssse3.cc
 void OMITFP I422ToARGBRow_Unaligned_SSSE3(const uint8* y_buf,
                                           const uint8* u_buf,
                                           const uint8* v_buf,
@@ -1640,6 +1776,7 @@ void OMITFP I422ToARGBRow_Unaligned_SSSE3(const uint8* y_buf,
 #endif
   );
 }
+#endif  // !defined(LIBYUV_SSSE3)
 
 void OMITFP I411ToARGBRow_Unaligned_SSSE3(const uint8* y_buf,
                                           const uint8* u_buf,
@@ -1677,6 +1814,7 @@ void OMITFP I411ToARGBRow_Unaligned_SSSE3(const uint8* y_buf,
   );
 }
 
+#if !defined(LIBYUV_SSSE3)  // Else in row_ssse3.cc
 void OMITFP NV12ToARGBRow_Unaligned_SSSE3(const uint8* y_buf,
                                           const uint8* uv_buf,
                                           uint8* argb_buf,
@@ -1742,6 +1880,7 @@ void OMITFP NV21ToARGBRow_Unaligned_SSSE3(const uint8* y_buf,
 #endif
   );
 }
+#endif  // !defined(LIBYUV_SSSE3)
 
 void OMITFP I422ToBGRARow_SSSE3(const uint8* y_buf,
                                 const uint8* u_buf,
@@ -1888,6 +2027,237 @@ void OMITFP I422ToABGRRow_Unaligned_SSSE3(const uint8* y_buf,
 #endif
   );
 }
+
+#ifdef HAS_I422TORGB565ROW_SSSE3
+// Pack 8 pixels of B, G and R in xmm0, xmm1 and xmm2 to 16 bits per pixel.
+// xmm4 must be zero.
+#define STORERGB565                                                            \
+    "punpcklbw  %%xmm2,%%xmm0                  \n"                             \
+    "punpcklbw  %%xmm4,%%xmm1                  \n"                             \
+    "movdqa     %%xmm0,%%xmm2                  \n"                             \
+    "psllw      $0x8,%%xmm0                    \n"                             \
+    "psrlw      $0xb,%%xmm0                    \n"                             \
+    "psrlw      $0xb,%%xmm2                    \n"                             \
+    "psllw      $0xb,%%xmm2                    \n"                             \
+    "psrlw      $0x2,%%xmm1                    \n"                             \
+    "psllw      $0x5,%%xmm1                    \n"                             \
+    "por        %%xmm1,%%xmm0                  \n"                             \
+    "por        %%xmm2,%%xmm0                  \n"                             \
+    "movdqu     %%xmm0,(%[rgb_buf])            \n"                             \
+    "lea        0x10(%[rgb_buf]),%[rgb_buf]    \n"                             \
+
+// xmm5 holds 0x8000 per pixel for alpha.
+#define STOREARGB1555                                                          \
+    "punpcklbw  %%xmm2,%%xmm0                  \n"                             \
+    "punpcklbw  %%xmm4,%%xmm1                  \n"                             \
+    "movdqa     %%xmm0,%%xmm2                  \n"                             \
+    "psllw      $0x8,%%xmm0                    \n"                             \
+    "psrlw      $0xb,%%xmm0                    \n"                             \
+    "psrlw      $0xb,%%xmm2                    \n"                             \
+    "psllw      $0xa,%%xmm2                    \n"                             \
+    "psrlw      $0x3,%%xmm1                    \n"                             \
+    "psllw      $0x5,%%xmm1                    \n"                             \
+    "por        %%xmm1,%%xmm0                  \n"                             \
+    "por        %%xmm2,%%xmm0                  \n"                             \
+    "por        %%xmm5,%%xmm0                  \n"                             \
+    "movdqu     %%xmm0,(%[rgb_buf])            \n"                             \
+    "lea        0x10(%[rgb_buf]),%[rgb_buf]    \n"                             \
+
+// xmm5 holds 0x0f and xmm6 holds 0xf0 per byte.
+#define STOREARGB4444                                                          \
+    "psrlw      $0x4,%%xmm0                    \n"                             \
+    "pand       %%xmm5,%%xmm0                  \n"                             \
+    "pand       %%xmm6,%%xmm1                  \n"                             \
+    "por        %%xmm1,%%xmm0                  \n"                             \
+    "psrlw      $0x4,%%xmm2                    \n"                             \
+    "pand       %%xmm5,%%xmm2                  \n"                             \
+    "por        %%xmm6,%%xmm2                  \n"                             \
+    "punpcklbw  %%xmm2,%%xmm0                  \n"                             \
+    "movdqu     %%xmm0,(%[rgb_buf])            \n"                             \
+    "lea        0x10(%[rgb_buf]),%[rgb_buf]    \n"                             \
+
+// Add 4 bytes of dither in xmm5, repeated per 4 pixels, to B, G and R.
+#define DITHERRGB                                                              \
+    "paddusb    %%xmm5,%%xmm0                  \n"                             \
+    "paddusb    %%xmm5,%%xmm1                  \n"                             \
+    "paddusb    %%xmm5,%%xmm2                  \n"                             \
+
+void OMITFP I422ToRGB565Row_SSSE3(const uint8* y_buf,
+                                  const uint8* u_buf,
+                                  const uint8* v_buf,
+                                  uint8* rgb_buf,
+                                  int width) {
+  asm volatile (
+    "sub       %[u_buf],%[v_buf]               \n"
+    "pxor      %%xmm4,%%xmm4                   \n"
+    ".p2align  4                               \n"
+  "1:                                          \n"
+    READYUV422
+    YUVTORGB
+    STORERGB565
+    "sub       $0x8,%[width]                   \n"
+    "jg        1b                              \n"
+  : [y_buf]"+r"(y_buf),    // %[y_buf]
+    [u_buf]"+r"(u_buf),    // %[u_buf]
+    [v_buf]"+r"(v_buf),    // %[v_buf]
+    [rgb_buf]"+r"(rgb_buf),  // %[rgb_buf]
+    [width]"+rm"(width)    // %[width]
+  : [kYuvConstants]"r"(&kYuvConstants.kUVToB) // %[kYuvConstants]
+  : "memory", "cc"
+#if defined(__SSE2__)
+    , "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5"
+#endif
+  );
+}
+
+void OMITFP I422ToARGB1555Row_SSSE3(const uint8* y_buf,
+                                    const uint8* u_buf,
+                                    const uint8* v_buf,
+                                    uint8* rgb_buf,
+                                    int width) {
+  asm volatile (
+    "sub       %[u_buf],%[v_buf]               \n"
+    "pcmpeqb   %%xmm5,%%xmm5                   \n"
+    "psllw     $0xf,%%xmm5                     \n"
+    "pxor      %%xmm4,%%xmm4                   \n"
+    ".p2align  4                               \n"
+  "1:                                          \n"
+    READYUV422
+    YUVTORGB
+    STOREARGB1555
+    "sub       $0x8,%[width]                   \n"
+    "jg        1b                              \n"
+  : [y_buf]"+r"(y_buf),    // %[y_buf]
+    [u_buf]"+r"(u_buf),    // %[u_buf]
+    [v_buf]"+r"(v_buf),    // %[v_buf]
+    [rgb_buf]"+r"(rgb_buf),  // %[rgb_buf]
+    [width]"+rm"(width)    // %[width]
+  : [kYuvConstants]"r"(&kYuvConstants.kUVToB) // %[kYuvConstants]
+  : "memory", "cc"
+#if defined(__SSE2__)
+    , "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5"
+#endif
+  );
+}
+
+void OMITFP I422ToARGB4444Row_SSSE3(const uint8* y_buf,
+                                    const uint8* u_buf,
+                                    const uint8* v_buf,
+                                    uint8* rgb_buf,
+                                    int width) {
+  asm volatile (
+    "sub       %[u_buf],%[v_buf]               \n"
+    "pcmpeqb   %%xmm5,%%xmm5                   \n"
+    "psrlw     $0xc,%%xmm5                     \n"
+    "movdqa    %%xmm5,%%xmm6                   \n"
+    "psllw     $0x8,%%xmm6                     \n"
+    "por       %%xmm6,%%xmm5                   \n"
+    "pcmpeqb   %%xmm6,%%xmm6                   \n"
+    "pxor      %%xmm5,%%xmm6                   \n"
+    "pxor      %%xmm4,%%xmm4                   \n"
+    ".p2align  4                               \n"
+  "1:                                          \n"
+    READYUV422
+    YUVTORGB
+    STOREARGB4444
+    "sub       $0x8,%[width]                   \n"
+    "jg        1b                              \n"
+  : [y_buf]"+r"(y_buf),    // %[y_buf]
+    [u_buf]"+r"(u_buf),    // %[u_buf]
+    [v_buf]"+r"(v_buf),    // %[v_buf]
+    [rgb_buf]"+r"(rgb_buf),  // %[rgb_buf]
+    [width]"+rm"(width)    // %[width]
+  : [kYuvConstants]"r"(&kYuvConstants.kUVToB) // %[kYuvConstants]
+  : "memory", "cc"
+#if defined(__SSE2__)
+    , "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5", "xmm6"
+#endif
+  );
+}
+
+void OMITFP I422ToRGB565DitherRow_SSSE3(const uint8* y_buf,
+                                        const uint8* u_buf,
+                                        const uint8* v_buf,
+                                        uint8* rgb_buf,
+                                        uint32 dither4,
+                                        int width) {
+  asm volatile (
+    "sub       %[u_buf],%[v_buf]               \n"
+    "movd      %[dither4],%%xmm5               \n"
+    "pshufd    $0x0,%%xmm5,%%xmm5              \n"
+    "pxor      %%xmm4,%%xmm4                   \n"
+    ".p2align  4                               \n"
+  "1:                                          \n"
+    READYUV422
+    YUVTORGB
+    DITHERRGB
+    STORERGB565
+    "sub       $0x8,%[width]                   \n"
+    "jg        1b                              \n"
+  : [y_buf]"+r"(y_buf),    // %[y_buf]
+    [u_buf]"+r"(u_buf),    // %[u_buf]
+    [v_buf]"+r"(v_buf),    // %[v_buf]
+    [rgb_buf]"+r"(rgb_buf),  // %[rgb_buf]
+    [width]"+rm"(width)    // %[width]
+  : [kYuvConstants]"r"(&kYuvConstants.kUVToB),  // %[kYuvConstants]
+    [dither4]"rm"(dither4)  // %[dither4]
+  : "memory", "cc"
+#if defined(__SSE2__)
+    , "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5"
+#endif
+  );
+}
+
+void OMITFP NV12ToRGB565Row_SSSE3(const uint8* y_buf,
+                                  const uint8* uv_buf,
+                                  uint8* rgb_buf,
+                                  int width) {
+  asm volatile (
+    "pxor      %%xmm4,%%xmm4                   \n"
+    ".p2align  4                               \n"
+  "1:                                          \n"
+    READNV12
+    YUVTORGB
+    STORERGB565
+    "sub       $0x8,%[width]                   \n"
+    "jg        1b                              \n"
+  : [y_buf]"+r"(y_buf),    // %[y_buf]
+    [uv_buf]"+r"(uv_buf),    // %[uv_buf]
+    [rgb_buf]"+r"(rgb_buf),  // %[rgb_buf]
+    [width]"+rm"(width)    // %[width]
+  : [kYuvConstants]"r"(&kYuvConstants.kUVToB) // %[kYuvConstants]
+  : "memory", "cc"
+#if defined(__SSE2__)
+    , "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5"
+#endif
+  );
+}
+
+void OMITFP NV21ToRGB565Row_SSSE3(const uint8* y_buf,
+                                  const uint8* vu_buf,
+                                  uint8* rgb_buf,
+                                  int width) {
+  asm volatile (
+    "pxor      %%xmm4,%%xmm4                   \n"
+    ".p2align  4                               \n"
+  "1:                                          \n"
+    READNV12
+    YVUTORGB
+    STORERGB565
+    "sub       $0x8,%[width]                   \n"
+    "jg        1b                              \n"
+  : [y_buf]"+r"(y_buf),    // %[y_buf]
+    [uv_buf]"+r"(vu_buf),    // %[uv_buf]
+    [rgb_buf]"+r"(rgb_buf),  // %[rgb_buf]
+    [width]"+rm"(width)    // %[width]
+  : [kYuvConstants]"r"(&kYuvConstants.kUVToB) // %[kYuvConstants]
+  : "memory", "cc"
+#if defined(__SSE2__)
+    , "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5"
+#endif
+  );
+}
+#endif  // HAS_I422TORGB565ROW_SSSE3
 #endif  // HAS_I422TOARGBROW_SSSE3
 
 #ifdef HAS_YTOARGBROW_SSE2
@@ -2066,6 +2436,37 @@ void ARGBMirrorRow_SSSE3(const uint8* src, uint8* dst, int width) {
 }
 #endif  // HAS_ARGBMIRRORROW_SSSE3
 
+#ifdef HAS_UVMIRRORROW_SSSE3
+// Shuffle table for reversing the UV pairs.
+CONST uvec8 kShuffleUVMirror = {
+  14u, 15u, 12u, 13u, 10u, 11u, 8u, 9u, 6u, 7u, 4u, 5u, 2u, 3u, 0u, 1u
+};
+
+void UVMirrorRow_SSSE3(const uint8* src_uv, uint8* dst_uv, int width) {
+  intptr_t temp_width = static_cast<intptr_t>(width);
+  asm volatile (
+    "movdqa    %3,%%xmm5                       \n"
+    "lea       -0x10(%0),%0                    \n"
+    ".p2align  4                               \n"
+  "1:                                          \n"
+    "movdqa    (%0,%2,2),%%xmm0                \n"
+    "pshufb    %%xmm5,%%xmm0                   \n"
+    "sub       $0x8,%2                         \n"
+    "movdqa    %%xmm0,(%1)                     \n"
+    "lea       0x10(%1),%1                     \n"
+    "jg        1b                              \n"
+  : "+r"(src_uv),  // %0
+    "+r"(dst_uv),  // %1
+    "+r"(temp_width)  // %2
+  : "m"(kShuffleUVMirror)  // %3
+  : "memory", "cc"
+#if defined(__SSE2__)
+    , "xmm0", "xmm5"
+#endif
+  );
+}
+#endif  // HAS_UVMIRRORROW_SSSE3
+
 #ifdef HAS_SPLITUV_SSE2
 void SplitUV_SSE2(const uint8* src_uv, uint8* dst_u, uint8* dst_v, int pix) {
   asm volatile (
@@ -2078,30 +2479,90 @@ void SplitUV_SSE2(const uint8* src_uv, uint8* dst_u, uint8* dst_v, int pix) {
     "movdqa     0x10(%0),%%xmm1                  \n"
     "lea        0x20(%0),%0                      \n"
     "movdqa     %%xmm0,%%xmm2                    \n"
-    "movdqa     %%xmm1,%%xmm3                    \n"
-    "pand       %%xmm5,%%xmm0                    \n"
-    "pand       %%xmm5,%%xmm1                    \n"
-    "packuswb   %%xmm1,%%xmm0                    \n"
-    "psrlw      $0x8,%%xmm2                      \n"
-    "psrlw      $0x8,%%xmm3                      \n"
-    "packuswb   %%xmm3,%%xmm2                    \n"
-    "movdqa     %%xmm0,(%1)                      \n"
-    "movdqa     %%xmm2,(%1,%2)                   \n"
-    "lea        0x10(%1),%1                      \n"
+    "movdqa     %%xmm1,%%xmm3                    \n"
+    "pand       %%xmm5,%%xmm0                    \n"
+    "pand       %%xmm5,%%xmm1                    \n"
+    "packuswb   %%xmm1,%%xmm0                    \n"
+    "psrlw      $0x8,%%xmm2                      \n"
+    "psrlw      $0x8,%%xmm3                      \n"
+    "packuswb   %%xmm3,%%xmm2                    \n"
+    "movdqa     %%xmm0,(%1)                      \n"
+    "movdqa     %%xmm2,(%1,%2)                   \n"
+    "lea        0x10(%1),%1                      \n"
+    "sub        $0x10,%3                         \n"
+    "jg         1b                               \n"
+  : "+r"(src_uv),     // %0
+    "+r"(dst_u),      // %1
+    "+r"(dst_v),      // %2
+    "+r"(pix)         // %3
+  :
+  : "memory", "cc"
+#if defined(__SSE2__)
+    , "xmm0", "xmm1", "xmm2", "xmm3", "xmm5"
+#endif
+  );
+}
+#endif  // HAS_SPLITUV_SSE2
+
+#ifdef HAS_MERGEUV_SSE2
+void MergeUV_SSE2(const uint8* src_u, const uint8* src_v, uint8* dst_uv,
+                  int width) {
+  asm volatile (
+    "sub        %0,%1                            \n"
+    ".p2align  4                               \n"
+  "1:                                            \n"
+    "movdqa     (%0),%%xmm0                      \n"
+    "movdqa     (%0,%1,1),%%xmm1                 \n"
+    "lea        0x10(%0),%0                      \n"
+    "movdqa     %%xmm0,%%xmm2                    \n"
+    "punpcklbw  %%xmm1,%%xmm0                    \n"
+    "punpckhbw  %%xmm1,%%xmm2                    \n"
+    "movdqa     %%xmm0,(%2)                      \n"
+    "movdqa     %%xmm2,0x10(%2)                  \n"
+    "lea        0x20(%2),%2                      \n"
+    "sub        $0x10,%3                         \n"
+    "jg         1b                               \n"
+  : "+r"(src_u),      // %0
+    "+r"(src_v),      // %1
+    "+r"(dst_uv),     // %2
+    "+r"(width)       // %3
+  :
+  : "memory", "cc"
+#if defined(__SSE2__)
+    , "xmm0", "xmm1", "xmm2"
+#endif
+  );
+}
+
+void MergeUV_Unaligned_SSE2(const uint8* src_u, const uint8* src_v,
+                            uint8* dst_uv, int width) {
+  asm volatile (
+    "sub        %0,%1                            \n"
+    ".p2align  4                               \n"
+  "1:                                            \n"
+    "movdqu     (%0),%%xmm0                      \n"
+    "movdqu     (%0,%1,1),%%xmm1                 \n"
+    "lea        0x10(%0),%0                      \n"
+    "movdqa     %%xmm0,%%xmm2                    \n"
+    "punpcklbw  %%xmm1,%%xmm0                    \n"
+    "punpckhbw  %%xmm1,%%xmm2                    \n"
+    "movdqu     %%xmm0,(%2)                      \n"
+    "movdqu     %%xmm2,0x10(%2)                  \n"
+    "lea        0x20(%2),%2                      \n"
     "sub        $0x10,%3                         \n"
     "jg         1b                               \n"
-  : "+r"(src_uv),     // %0
-    "+r"(dst_u),      // %1
-    "+r"(dst_v),      // %2
-    "+r"(pix)         // %3
+  : "+r"(src_u),      // %0
+    "+r"(src_v),      // %1
+    "+r"(dst_uv),     // %2
+    "+r"(width)       // %3
   :
   : "memory", "cc"
 #if defined(__SSE2__)
-    , "xmm0", "xmm1", "xmm2", "xmm3", "xmm5"
+    , "xmm0", "xmm1", "xmm2"
 #endif
   );
 }
-#endif  // HAS_SPLITUV_SSE2
+#endif  // HAS_MERGEUV_SSE2
 
 #ifdef HAS_COPYROW_SSE2
 void CopyRow_SSE2(const uint8* src, uint8* dst, int count) {
@@ -2868,6 +3329,268 @@ void ARGBBlendRow_SSSE3(const uint8* src_argb0, const uint8* src_argb1,
 }
 #endif  // HAS_ARGBBLENDROW_SSSE3
 
+#ifdef HAS_ARGBBLENDROW_AVX2
+// Same as SSSE3 on 8 pixels at a time. The tail is blended 1 pixel at a time
+// with VEX encoded xmm instructions to avoid SSE/AVX transition stalls.
+void ARGBBlendRow_AVX2(const uint8* src_argb0, const uint8* src_argb1,
+                       uint8* dst_argb, int width) {
+  asm volatile (
+    "vpcmpeqb  %%ymm7,%%ymm7,%%ymm7            \n"
+    "vpsrlw    $0xf,%%ymm7,%%ymm7              \n"
+    "vpcmpeqb  %%ymm6,%%ymm6,%%ymm6            \n"
+    "vpsrlw    $0x8,%%ymm6,%%ymm6              \n"
+    "vpcmpeqb  %%ymm5,%%ymm5,%%ymm5            \n"
+    "vpsllw    $0x8,%%ymm5,%%ymm5              \n"
+    "vpcmpeqb  %%ymm4,%%ymm4,%%ymm4            \n"
+    "vpslld    $0x18,%%ymm4,%%ymm4             \n"
+    "vbroadcasti128 %4,%%ymm8                  \n"
+    "sub       $0x8,%3                         \n"
+    "jl        49f                             \n"
+
+    // 8 pixel loop.
+    ".p2align  2                               \n"
+  "40:                                         \n"
+    "vmovdqu   (%0),%%ymm0                     \n"
+    "lea       0x20(%0),%0                     \n"
+    "vpxor     %%ymm4,%%ymm0,%%ymm3            \n"
+    "vpshufb   %%ymm8,%%ymm3,%%ymm3            \n"
+    "vpaddw    %%ymm7,%%ymm3,%%ymm3            \n"
+    "vmovdqu   (%1),%%ymm1                     \n"
+    "lea       0x20(%1),%1                     \n"
+    "vpand     %%ymm6,%%ymm1,%%ymm2            \n"
+    "vpsrlw    $0x8,%%ymm1,%%ymm1              \n"
+    "vpmullw   %%ymm3,%%ymm2,%%ymm2            \n"
+    "vpmullw   %%ymm3,%%ymm1,%%ymm1            \n"
+    "vpsrlw    $0x8,%%ymm2,%%ymm2              \n"
+    "vpand     %%ymm5,%%ymm1,%%ymm1            \n"
+    "vpor      %%ymm4,%%ymm0,%%ymm0            \n"
+    "vpaddusb  %%ymm2,%%ymm0,%%ymm0            \n"
+    "vpaddusb  %%ymm1,%%ymm0,%%ymm0            \n"
+    "vmovdqu   %%ymm0,(%2)                     \n"
+    "lea       0x20(%2),%2                     \n"
+    "sub       $0x8,%3                         \n"
+    "jge       40b                             \n"
+
+  "49:                                         \n"
+    "add       $0x7,%3                         \n"
+    "jl        99f                             \n"
+
+    // 1 pixel loop.
+  "91:                                         \n"
+    "vmovd     (%0),%%xmm0                     \n"
+    "lea       0x4(%0),%0                      \n"
+    "vpxor     %%xmm4,%%xmm0,%%xmm3            \n"
+    "vpshufb   %%xmm8,%%xmm3,%%xmm3            \n"
+    "vpaddw    %%xmm7,%%xmm3,%%xmm3            \n"
+    "vmovd     (%1),%%xmm1                     \n"
+    "lea       0x4(%1),%1                      \n"
+    "vpand     %%xmm6,%%xmm1,%%xmm2            \n"
+    "vpsrlw    $0x8,%%xmm1,%%xmm1              \n"
+    "vpmullw   %%xmm3,%%xmm2,%%xmm2            \n"
+    "vpmullw   %%xmm3,%%xmm1,%%xmm1            \n"
+    "vpsrlw    $0x8,%%xmm2,%%xmm2              \n"
+    "vpand     %%xmm5,%%xmm1,%%xmm1            \n"
+    "vpor      %%xmm4,%%xmm0,%%xmm0            \n"
+    "vpaddusb  %%xmm2,%%xmm0,%%xmm0            \n"
+    "vpaddusb  %%xmm1,%%xmm0,%%xmm0            \n"
+    "vmovd     %%xmm0,(%2)                     \n"
+    "lea       0x4(%2),%2                      \n"
+    "sub       $0x1,%3                         \n"
+    "jge       91b                             \n"
+  "99:                                         \n"
+    "vzeroupper                                \n"
+  : "+r"(src_argb0),    // %0
+    "+r"(src_argb1),    // %1
+    "+r"(dst_argb),     // %2
+    "+r"(width)         // %3
+  : "m"(kShuffleAlpha)  // %4
+  : "memory", "cc",
+    "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5", "xmm6", "xmm7", "xmm8"
+  );
+}
+#endif  // HAS_ARGBBLENDROW_AVX2
+
+#ifdef HAS_BLENDPLANEROW_SSSE3
+// Blend 8 pixels at a time.
+// Pixels are biased by 128 so pmaddubsw can take them as signed bytes and
+// alpha, 255 - alpha as unsigned weights. The sum fits in 16 bits and
+// 32768 + 127 adds the bias back along with the rounding.
+void BlendPlaneRow_SSSE3(const uint8* src0, const uint8* src1,
+                         const uint8* alpha, uint8* dst, int width) {
+  asm volatile (
+    "pcmpeqb   %%xmm5,%%xmm5                   \n"
+    "psllw     $0x8,%%xmm5                     \n"
+    "pcmpeqb   %%xmm6,%%xmm6                   \n"
+    "psllw     $0x7,%%xmm6                     \n"
+    "packsswb  %%xmm6,%%xmm6                   \n"
+    "pcmpeqb   %%xmm7,%%xmm7                   \n"
+    "psllw     $0xf,%%xmm7                     \n"
+    "pcmpeqb   %%xmm4,%%xmm4                   \n"
+    "psrlw     $0x9,%%xmm4                     \n"
+    "por       %%xmm4,%%xmm7                   \n"
+    "sub       %0,%1                           \n"
+    "sub       %0,%2                           \n"
+    "sub       %0,%3                           \n"
+
+    // 8 pixel loop.
+    ".p2align  4                               \n"
+  "1:                                          \n"
+    "movq      (%0,%2,1),%%xmm0                \n"
+    "punpcklbw %%xmm0,%%xmm0                   \n"
+    "pxor      %%xmm5,%%xmm0                   \n"
+    "movq      (%0),%%xmm1                     \n"
+    "movq      (%0,%1,1),%%xmm2                \n"
+    "punpcklbw %%xmm2,%%xmm1                   \n"
+    "psubb     %%xmm6,%%xmm1                   \n"
+    "pmaddubsw %%xmm1,%%xmm0                   \n"
+    "paddw     %%xmm7,%%xmm0                   \n"
+    "psrlw     $0x8,%%xmm0                     \n"
+    "packuswb  %%xmm0,%%xmm0                   \n"
+    "movq      %%xmm0,(%0,%3,1)                \n"
+    "lea       0x8(%0),%0                      \n"
+    "sub       $0x8,%4                         \n"
+    "jg        1b                              \n"
+  : "+r"(src0),   // %0
+    "+r"(src1),   // %1
+    "+r"(alpha),  // %2
+    "+r"(dst),    // %3
+    "+r"(width)   // %4
+  :
+  : "memory", "cc"
+#if defined(__SSE2__)
+    , "xmm0", "xmm1", "xmm2", "xmm4", "xmm5", "xmm6", "xmm7"
+#endif
+  );
+}
+#endif  // HAS_BLENDPLANEROW_SSSE3
+
+#ifdef HAS_ARGBAPPLY3DLUTROW_AVX2
+// Gather, weight and accumulate one tetrahedron vertex for 8 pixels.
+// Even bytes (B, R) accumulate in ymm12 and odd bytes (G, A) in ymm13.
+#define LUTVERTEX(OFFSET, WEIGHT)                                              \
+    "vpcmpeqd   %%ymm7,%%ymm7,%%ymm7            \n"                            \
+    "vpgatherdd %%ymm7,(%3,%%" #OFFSET ",4),%%ymm5  \n"                        \
+    "vpsrlw     $0x8,%%ymm5,%%ymm7              \n"                            \
+    "vpand      0xe0(%5),%%ymm5,%%ymm5          \n"                            \
+    "vpmullw    %%" #WEIGHT ",%%ymm5,%%ymm5         \n"                        \
+    "vpmullw    %%" #WEIGHT ",%%ymm7,%%ymm7         \n"                        \
+    "vpaddw     %%ymm5,%%ymm12,%%ymm12          \n"                            \
+    "vpaddw     %%ymm7,%%ymm13,%%ymm13          \n"
+
+// Copy the low word of each dword to the high word.
+#define LUTWEIGHT(WEIGHT)                                                      \
+    "vpslld     $0x10,%%" #WEIGHT ",%%ymm7          \n"                        \
+    "vpor       %%ymm7,%%" #WEIGHT ",%%" #WEIGHT "      \n"
+
+// Same math as ARGBApply3DLutRow_C on 8 pixels at a time. The tetrahedron is
+// chosen without branches: vertex A steps along the axis of the largest
+// fraction and B along all but the axis of the smallest.
+void ARGBApply3DLutRow_AVX2(const uint8* src_argb, uint8* dst_argb,
+                            const uint8* lut_argb, const int32* lut_index,
+                            int lut_size, int width) {
+  const int32 step_g = lut_size;
+  const int32 step_b = lut_size * lut_size;
+  const int32 kConstants[10] = {
+    0xff, 0x1ff, step_g, step_b, 1, 1 + step_g + step_b, 256,
+    0x00ff00ff, 0x00800080, static_cast<int32>(0xff000000u)
+  };
+  int32 constants[10 * 8];
+  for (int i = 0; i < 10 * 8; ++i) {
+    constants[i] = kConstants[i >> 3];
+  }
+  asm volatile (
+    ".p2align  4                               \n"
+  "1:                                          \n"
+    "vmovdqu    (%0),%%ymm0                     \n"
+    "lea        0x20(%0),%0                     \n"
+    "vpand      (%5),%%ymm0,%%ymm1              \n"
+    "vpsrld     $0x8,%%ymm0,%%ymm2              \n"
+    "vpand      (%5),%%ymm2,%%ymm2              \n"
+    "vpsrld     $0x10,%%ymm0,%%ymm3             \n"
+    "vpand      (%5),%%ymm3,%%ymm3              \n"
+    "vpcmpeqd   %%ymm7,%%ymm7,%%ymm7            \n"
+    "vpgatherdd %%ymm7,(%4,%%ymm1,4),%%ymm4     \n"
+    "vpcmpeqd   %%ymm7,%%ymm7,%%ymm7            \n"
+    "vpgatherdd %%ymm7,0x400(%4,%%ymm2,4),%%ymm5 \n"
+    "vpcmpeqd   %%ymm7,%%ymm7,%%ymm7            \n"
+    "vpgatherdd %%ymm7,0x800(%4,%%ymm3,4),%%ymm6 \n"
+    // Fractions and the offset of the cell.
+    "vpand      0x20(%5),%%ymm4,%%ymm1          \n"
+    "vpand      0x20(%5),%%ymm5,%%ymm2          \n"
+    "vpand      0x20(%5),%%ymm6,%%ymm3          \n"
+    "vpsrld     $0x9,%%ymm4,%%ymm4              \n"
+    "vpsrld     $0x9,%%ymm5,%%ymm5              \n"
+    "vpsrld     $0x9,%%ymm6,%%ymm6              \n"
+    "vpaddd     %%ymm5,%%ymm4,%%ymm4            \n"
+    "vpaddd     %%ymm6,%%ymm4,%%ymm4            \n"
+    // Largest, smallest and middle fraction.
+    "vpmaxsd    %%ymm2,%%ymm3,%%ymm5            \n"
+    "vpmaxsd    %%ymm1,%%ymm5,%%ymm5            \n"
+    "vpminsd    %%ymm2,%%ymm3,%%ymm6            \n"
+    "vpminsd    %%ymm1,%%ymm6,%%ymm6            \n"
+    "vpaddd     %%ymm1,%%ymm2,%%ymm7            \n"
+    "vpaddd     %%ymm3,%%ymm7,%%ymm7            \n"
+    "vpsubd     %%ymm5,%%ymm7,%%ymm7            \n"
+    "vpsubd     %%ymm6,%%ymm7,%%ymm7            \n"
+    // Step of the largest: R, else B, else G.
+    "vmovdqu    0x40(%5),%%ymm9                 \n"
+    "vpcmpeqd   %%ymm5,%%ymm1,%%ymm8            \n"
+    "vpblendvb  %%ymm8,0x60(%5),%%ymm9,%%ymm9   \n"
+    "vpcmpeqd   %%ymm5,%%ymm3,%%ymm8            \n"
+    "vpblendvb  %%ymm8,0x80(%5),%%ymm9,%%ymm9   \n"
+    // Step of the smallest: B, else R, else G.
+    "vmovdqu    0x40(%5),%%ymm10                \n"
+    "vpcmpeqd   %%ymm6,%%ymm3,%%ymm8            \n"
+    "vpblendvb  %%ymm8,0x80(%5),%%ymm10,%%ymm10 \n"
+    "vpcmpeqd   %%ymm6,%%ymm1,%%ymm8            \n"
+    "vpblendvb  %%ymm8,0x60(%5),%%ymm10,%%ymm10 \n"
+    // Vertex offsets: ymm4 = 0, ymm9 = A, ymm10 = B, ymm11 = 1.
+    "vpaddd     %%ymm4,%%ymm9,%%ymm9            \n"
+    "vmovdqu    0xa0(%5),%%ymm11                \n"
+    "vpsubd     %%ymm10,%%ymm11,%%ymm10         \n"
+    "vpaddd     %%ymm4,%%ymm10,%%ymm10          \n"
+    "vpaddd     %%ymm4,%%ymm11,%%ymm11          \n"
+    // Vertex weights: ymm1 = 0, ymm2 = A, ymm3 = B, ymm6 = 1.
+    "vmovdqu    0xc0(%5),%%ymm1                 \n"
+    "vpsubd     %%ymm5,%%ymm1,%%ymm1            \n"
+    "vpsubd     %%ymm7,%%ymm5,%%ymm2            \n"
+    "vpsubd     %%ymm6,%%ymm7,%%ymm3            \n"
+    LUTWEIGHT(ymm1)
+    LUTWEIGHT(ymm2)
+    LUTWEIGHT(ymm3)
+    LUTWEIGHT(ymm6)
+    "vmovdqu    0x100(%5),%%ymm12               \n"
+    "vmovdqu    0x100(%5),%%ymm13               \n"
+    LUTVERTEX(ymm4, ymm1)
+    LUTVERTEX(ymm9, ymm2)
+    LUTVERTEX(ymm10, ymm3)
+    LUTVERTEX(ymm11, ymm6)
+    "vpsrlw     $0x8,%%ymm12,%%ymm12            \n"
+    "vpsrlw     $0x8,%%ymm13,%%ymm13            \n"
+    "vpsllw     $0x8,%%ymm13,%%ymm13            \n"
+    "vpor       %%ymm13,%%ymm12,%%ymm12         \n"
+    "vmovdqu    0x120(%5),%%ymm7                \n"
+    "vpblendvb  %%ymm7,%%ymm0,%%ymm12,%%ymm12   \n"
+    "vmovdqu    %%ymm12,(%1)                    \n"
+    "lea        0x20(%1),%1                     \n"
+    "sub        $0x8,%2                         \n"
+    "jg         1b                              \n"
+    "vzeroupper                                 \n"
+  : "+r"(src_argb),   // %0
+    "+r"(dst_argb),   // %1
+    "+r"(width)       // %2
+  : "r"(lut_argb),    // %3
+    "r"(lut_index),   // %4
+    "r"(constants)    // %5
+  : "memory", "cc",
+    "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5", "xmm6", "xmm7",
+    "xmm8", "xmm9", "xmm10", "xmm11", "xmm12", "xmm13"
+  );
+}
+#undef LUTVERTEX
+#undef LUTWEIGHT
+#endif  // HAS_ARGBAPPLY3DLUTROW_AVX2
+
 #ifdef HAS_ARGBATTENUATE_SSE2
 // Attenuate 4 pixels at a time.
 // aligned to 16 bytes
@@ -3439,6 +4162,253 @@ void CumulativeSumToAverage_SSE2(const int32* topleft, const int32* botleft,
   );
 }
 #endif  // HAS_CUMULATIVESUMTOAVERAGE_SSE2
+
+#ifdef HAS_BLURCOLUMNROW_SSE2
+// Add 16 pixels at a time to 16 bit column sums.
+void BlurColumnAddRow_SSE2(const uint8* src, uint16* sum, int width) {
+  asm volatile (
+    "pxor      %%xmm5,%%xmm5                   \n"
+    ".p2align  4                               \n"
+  "1:                                          \n"
+    "movdqu    (%0),%%xmm0                     \n"
+    "lea       0x10(%0),%0                     \n"
+    "movdqa    %%xmm0,%%xmm1                   \n"
+    "punpcklbw %%xmm5,%%xmm0                   \n"
+    "punpckhbw %%xmm5,%%xmm1                   \n"
+    "movdqu    (%1),%%xmm2                     \n"
+    "movdqu    0x10(%1),%%xmm3                 \n"
+    "paddw     %%xmm0,%%xmm2                   \n"
+    "paddw     %%xmm1,%%xmm3                   \n"
+    "movdqu    %%xmm2,(%1)                     \n"
+    "movdqu    %%xmm3,0x10(%1)                 \n"
+    "lea       0x20(%1),%1                     \n"
+    "sub       $0x10,%2                        \n"
+    "jg        1b                              \n"
+  : "+r"(src),   // %0
+    "+r"(sum),   // %1
+    "+r"(width)  // %2
+  :
+  : "memory", "cc"
+#if defined(__SSE2__)
+    , "xmm0", "xmm1", "xmm2", "xmm3", "xmm5"
+#endif
+  );
+}
+
+// Subtract 16 pixels at a time from 16 bit column sums.
+void BlurColumnSubRow_SSE2(const uint8* src, uint16* sum, int width) {
+  asm volatile (
+    "pxor      %%xmm5,%%xmm5                   \n"
+    ".p2align  4                               \n"
+  "1:                                          \n"
+    "movdqu    (%0),%%xmm0                     \n"
+    "lea       0x10(%0),%0                     \n"
+    "movdqa    %%xmm0,%%xmm1                   \n"
+    "punpcklbw %%xmm5,%%xmm0                   \n"
+    "punpckhbw %%xmm5,%%xmm1                   \n"
+    "movdqu    (%1),%%xmm2                     \n"
+    "movdqu    0x10(%1),%%xmm3                 \n"
+    "psubw     %%xmm0,%%xmm2                   \n"
+    "psubw     %%xmm1,%%xmm3                   \n"
+    "movdqu    %%xmm2,(%1)                     \n"
+    "movdqu    %%xmm3,0x10(%1)                 \n"
+    "lea       0x20(%1),%1                     \n"
+    "sub       $0x10,%2                        \n"
+    "jg        1b                              \n"
+  : "+r"(src),   // %0
+    "+r"(sum),   // %1
+    "+r"(width)  // %2
+  :
+  : "memory", "cc"
+#if defined(__SSE2__)
+    , "xmm0", "xmm1", "xmm2", "xmm3", "xmm5"
+#endif
+  );
+}
+#endif  // HAS_BLURCOLUMNROW_SSE2
+
+#ifdef HAS_BLURCUMULATIVESUMROW_SSE2
+// Running sum of 8 column sums at a time. Each group of 4 is summed with two
+// shifted adds, then the total so far is added and carried to the next group.
+void BlurCumulativeSumRow_SSE2(const uint16* sum, int32* cumsum, int width) {
+  asm volatile (
+    "movd      (%1),%%xmm4                     \n"
+    "pshufd    $0x0,%%xmm4,%%xmm4              \n"
+    "pxor      %%xmm5,%%xmm5                   \n"
+    ".p2align  4                               \n"
+  "1:                                          \n"
+    "movdqu    (%0),%%xmm0                     \n"
+    "lea       0x10(%0),%0                     \n"
+    "movdqa    %%xmm0,%%xmm1                   \n"
+    "punpcklwd %%xmm5,%%xmm0                   \n"
+    "punpckhwd %%xmm5,%%xmm1                   \n"
+    "movdqa    %%xmm0,%%xmm2                   \n"
+    "pslldq    $0x4,%%xmm2                     \n"
+    "paddd     %%xmm2,%%xmm0                   \n"
+    "movdqa    %%xmm0,%%xmm2                   \n"
+    "pslldq    $0x8,%%xmm2                     \n"
+    "paddd     %%xmm2,%%xmm0                   \n"
+    "paddd     %%xmm4,%%xmm0                   \n"
+    "pshufd    $0xff,%%xmm0,%%xmm4             \n"
+    "movdqa    %%xmm1,%%xmm2                   \n"
+    "pslldq    $0x4,%%xmm2                     \n"
+    "paddd     %%xmm2,%%xmm1                   \n"
+    "movdqa    %%xmm1,%%xmm2                   \n"
+    "pslldq    $0x8,%%xmm2                     \n"
+    "paddd     %%xmm2,%%xmm1                   \n"
+    "paddd     %%xmm4,%%xmm1                   \n"
+    "pshufd    $0xff,%%xmm1,%%xmm4             \n"
+    "movdqu    %%xmm0,0x4(%1)                  \n"
+    "movdqu    %%xmm1,0x14(%1)                 \n"
+    "lea       0x20(%1),%1                     \n"
+    "sub       $0x8,%2                         \n"
+    "jg        1b                              \n"
+  : "+r"(sum),     // %0
+    "+r"(cumsum),  // %1
+    "+r"(width)    // %2
+  :
+  : "memory", "cc"
+#if defined(__SSE2__)
+    , "xmm0", "xmm1", "xmm2", "xmm4", "xmm5"
+#endif
+  );
+}
+#endif  // HAS_BLURCUMULATIVESUMROW_SSE2
+
+#ifdef HAS_ARGBBLURCUMULATIVESUMROW_SSE2
+// Running sum of column sums, 1 ARGB pixel at a time.
+void ARGBBlurCumulativeSumRow_SSE2(const uint16* sum, int32* cumsum,
+                                   int width) {
+  asm volatile (
+    "movdqu    (%1),%%xmm0                     \n"
+    "pxor      %%xmm5,%%xmm5                   \n"
+    ".p2align  4                               \n"
+  "1:                                          \n"
+    "movq      (%0),%%xmm1                     \n"
+    "lea       0x8(%0),%0                      \n"
+    "punpcklwd %%xmm5,%%xmm1                   \n"
+    "paddd     %%xmm1,%%xmm0                   \n"
+    "movdqu    %%xmm0,0x10(%1)                 \n"
+    "lea       0x10(%1),%1                     \n"
+    "sub       $0x1,%2                         \n"
+    "jg        1b                              \n"
+  : "+r"(sum),     // %0
+    "+r"(cumsum),  // %1
+    "+r"(width)    // %2
+  :
+  : "memory", "cc"
+#if defined(__SSE2__)
+    , "xmm0", "xmm1", "xmm5"
+#endif
+  );
+}
+#endif  // HAS_ARGBBLURCUMULATIVESUMROW_SSE2
+
+#ifdef HAS_BLURCUMULATIVESUMTOAVERAGEROW_SSE2
+// Average 8 pixels at a time.
+void BlurCumulativeSumToAverageRow_SSE2(const int32* cumsum, int diameter,
+                                        float ooa, float rounding,
+                                        uint8* dst, int count) {
+  asm volatile (
+    "movss     %4,%%xmm4                       \n"
+    "pshufd    $0x0,%%xmm4,%%xmm4              \n"
+    "movss     %5,%%xmm5                       \n"
+    "pshufd    $0x0,%%xmm5,%%xmm5              \n"
+    ".p2align  4                               \n"
+  "1:                                          \n"
+    "movdqu    (%0,%3,4),%%xmm0                \n"
+    "movdqu    0x10(%0,%3,4),%%xmm1            \n"
+    "movdqu    (%0),%%xmm2                     \n"
+    "movdqu    0x10(%0),%%xmm3                 \n"
+    "lea       0x20(%0),%0                     \n"
+    "psubd     %%xmm2,%%xmm0                   \n"
+    "psubd     %%xmm3,%%xmm1                   \n"
+    "cvtdq2ps  %%xmm0,%%xmm0                   \n"
+    "cvtdq2ps  %%xmm1,%%xmm1                   \n"
+    "mulps     %%xmm4,%%xmm0                   \n"
+    "mulps     %%xmm4,%%xmm1                   \n"
+    "addps     %%xmm5,%%xmm0                   \n"
+    "addps     %%xmm5,%%xmm1                   \n"
+    "cvttps2dq %%xmm0,%%xmm0                   \n"
+    "cvttps2dq %%xmm1,%%xmm1                   \n"
+    "packssdw  %%xmm1,%%xmm0                   \n"
+    "packuswb  %%xmm0,%%xmm0                   \n"
+    "movq      %%xmm0,(%1)                     \n"
+    "lea       0x8(%1),%1                      \n"
+    "sub       $0x8,%2                         \n"
+    "jg        1b                              \n"
+  : "+r"(cumsum),  // %0
+    "+r"(dst),     // %1
+    "+r"(count)    // %2
+  : "r"(static_cast<intptr_t>(diameter)),  // %3
+    "m"(ooa),      // %4
+    "m"(rounding)  // %5
+  : "memory", "cc"
+#if defined(__SSE2__)
+    , "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5"
+#endif
+  );
+}
+#endif  // HAS_BLURCUMULATIVESUMTOAVERAGEROW_SSE2
+
+#ifdef HAS_UNSHARPMASKROW_SSE2
+// Sharpen 8 pixels at a time. pmaddwd of (diff, 1) with (amount, 128)
+// gives diff * amount + 128, which is masked off where |diff| <= threshold.
+void UnsharpMaskRow_SSE2(const uint8* src, const uint8* src_blur, uint8* dst,
+                         int amount, int threshold, int width) {
+  const uint32 amount_round = static_cast<uint32>(amount) | (128u << 16);
+  asm volatile (
+    "movd      %4,%%xmm6                       \n"
+    "pshufd    $0x0,%%xmm6,%%xmm6              \n"
+    "movd      %5,%%xmm7                       \n"
+    "pshuflw   $0x0,%%xmm7,%%xmm7              \n"
+    "punpcklqdq %%xmm7,%%xmm7                  \n"
+    "pxor      %%xmm5,%%xmm5                   \n"
+    "pcmpeqb   %%xmm4,%%xmm4                   \n"
+    "psrlw     $0xf,%%xmm4                     \n"
+    "sub       %0,%1                           \n"
+    "sub       %0,%2                           \n"
+    ".p2align  4                               \n"
+  "1:                                          \n"
+    "movq      (%0),%%xmm0                     \n"
+    "punpcklbw %%xmm5,%%xmm0                   \n"
+    "movq      (%0,%1,1),%%xmm1                \n"
+    "punpcklbw %%xmm5,%%xmm1                   \n"
+    "movdqa    %%xmm0,%%xmm2                   \n"
+    "psubw     %%xmm1,%%xmm2                   \n"
+    "movdqa    %%xmm5,%%xmm3                   \n"
+    "psubw     %%xmm2,%%xmm3                   \n"
+    "pmaxsw    %%xmm2,%%xmm3                   \n"
+    "pcmpgtw   %%xmm7,%%xmm3                   \n"
+    "movdqa    %%xmm2,%%xmm1                   \n"
+    "punpcklwd %%xmm4,%%xmm2                   \n"
+    "punpckhwd %%xmm4,%%xmm1                   \n"
+    "pmaddwd   %%xmm6,%%xmm2                   \n"
+    "pmaddwd   %%xmm6,%%xmm1                   \n"
+    "psrad     $0x8,%%xmm2                     \n"
+    "psrad     $0x8,%%xmm1                     \n"
+    "packssdw  %%xmm1,%%xmm2                   \n"
+    "pand      %%xmm3,%%xmm2                   \n"
+    "paddsw    %%xmm2,%%xmm0                   \n"
+    "packuswb  %%xmm0,%%xmm0                   \n"
+    "movq      %%xmm0,(%0,%2,1)                \n"
+    "lea       0x8(%0),%0                      \n"
+    "sub       $0x8,%3                         \n"
+    "jg        1b                              \n"
+  : "+r"(src),       // %0
+    "+r"(src_blur),  // %1
+    "+r"(dst),       // %2
+    "+r"(width)      // %3
+  : "rm"(amount_round),  // %4
+    "rm"(threshold)      // %5
+  : "memory", "cc"
+#if defined(__SSE2__)
+    , "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5", "xmm6", "xmm7"
+#endif
+  );
+}
+#endif  // HAS_UNSHARPMASKROW_SSE2
+
 #ifdef HAS_ARGBSHADE_SSE2
 // Shade 4 pixels at a time by specified value.
 // Aligned to 16 bytes.
@@ -3589,6 +4559,91 @@ void ARGBAffineRow_SSE2(const uint8* src_argb, int src_argb_stride,
 }
 #endif  // HAS_ARGBAFFINEROW_SSE2
 
+#ifdef HAS_ARGBAFFINEROWBILINEAR_SSE2
+// Bilinear filter ARGB pixels from source with a slope to a row of
+// destination. One pixel per loop. uv is stepped with the same float adds as
+// the C version, so the results are identical.
+void ARGBAffineRowBilinear_SSE2(const uint8* src_argb, int src_argb_stride,
+                                uint8* dst_argb, const float* uv_dudv,
+                                int width) {
+  intptr_t src_argb_stride_temp = src_argb_stride;
+  intptr_t temp = 0;
+  asm volatile (
+    "movq      (%3),%%xmm2                     \n"
+    "movq      0x8(%3),%%xmm7                  \n"
+    "mov       %1,%5                           \n"
+    "shl       $0x10,%5                        \n"
+    "add       $0x4,%5                         \n"
+    "movd      %5,%%xmm5                       \n"
+    "pshufd    $0x0,%%xmm5,%%xmm5              \n"
+    "mov       $0x43800000,%5                  \n"
+    "movd      %5,%%xmm6                       \n"
+    "pshufd    $0x0,%%xmm6,%%xmm6              \n"
+    "mov       $0x100,%5                       \n"
+    "movd      %5,%%xmm8                       \n"
+    "pshufd    $0x0,%%xmm8,%%xmm8              \n"
+    "pxor      %%xmm4,%%xmm4                   \n"
+
+    // 1 pixel loop
+    ".p2align  4                               \n"
+  "1:                                          \n"
+    "movdqa    %%xmm2,%%xmm0                   \n"
+    "mulps     %%xmm6,%%xmm0                   \n"
+    "addps     %%xmm7,%%xmm2                   \n"
+    "cvttps2dq %%xmm0,%%xmm0                   \n"
+    "movdqa    %%xmm0,%%xmm1                   \n"
+    "psrad     $0x8,%%xmm0                     \n"
+    "packssdw  %%xmm0,%%xmm0                   \n"
+    "pmaddwd   %%xmm5,%%xmm0                   \n"
+    "movd      %%xmm0,%k5                      \n"
+    "pslld     $0x18,%%xmm1                    \n"
+    "psrld     $0x18,%%xmm1                    \n"
+    "movdqa    %%xmm8,%%xmm3                   \n"
+    "psubd     %%xmm1,%%xmm3                   \n"
+    "pslld     $0x10,%%xmm1                    \n"
+    "por       %%xmm3,%%xmm1                   \n"
+    "pshufd    $0x55,%%xmm1,%%xmm9             \n"
+    "pshufd    $0x0,%%xmm1,%%xmm1              \n"
+    "movq      (%0,%5,1),%%xmm0                \n"
+    "add       %1,%5                           \n"
+    "movq      (%0,%5,1),%%xmm3                \n"
+    "punpcklqdq %%xmm3,%%xmm0                  \n"
+    "pshufd    $0xd8,%%xmm0,%%xmm0             \n"
+    "pshufd    $0x4e,%%xmm0,%%xmm3             \n"
+    "punpcklbw %%xmm3,%%xmm0                   \n"
+    "movdqa    %%xmm0,%%xmm3                   \n"
+    "punpcklbw %%xmm4,%%xmm0                   \n"
+    "punpckhbw %%xmm4,%%xmm3                   \n"
+    "pmaddwd   %%xmm1,%%xmm0                   \n"
+    "pmaddwd   %%xmm1,%%xmm3                   \n"
+    "psrld     $0x8,%%xmm0                     \n"
+    "psrld     $0x8,%%xmm3                     \n"
+    "pslld     $0x10,%%xmm3                    \n"
+    "por       %%xmm3,%%xmm0                   \n"
+    "pmaddwd   %%xmm9,%%xmm0                   \n"
+    "psrld     $0x8,%%xmm0                     \n"
+    "packssdw  %%xmm0,%%xmm0                   \n"
+    "packuswb  %%xmm0,%%xmm0                   \n"
+    "movd      %%xmm0,(%2)                     \n"
+    "lea       0x4(%2),%2                      \n"
+    "sub       $0x1,%4                         \n"
+    "jg        1b                              \n"
+  : "+r"(src_argb),  // %0
+    "+r"(src_argb_stride_temp),  // %1
+    "+r"(dst_argb),  // %2
+    "+r"(uv_dudv),   // %3
+    "+rm"(width),    // %4
+    "+r"(temp)   // %5
+  :
+  : "memory", "cc"
+#if defined(__SSE2__)
+    , "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5", "xmm6", "xmm7", "xmm8",
+      "xmm9"
+#endif
+  );
+}
+#endif  // HAS_ARGBAFFINEROWBILINEAR_SSE2
+
 // Bilinear row filtering combines 4x2 -> 4x1. SSSE3 version
 void ARGBInterpolateRow_SSSE3(uint8* dst_ptr, const uint8* src_ptr,
                               ptrdiff_t src_stride, int dst_width,
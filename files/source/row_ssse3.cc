@@ -0,0 +1,267 @@
+/*
+ *  Copyright 2012 The LibYuv Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "libyuv/row.h"
+
+#if !defined(YUV_DISABLE_ASM) && defined(LIBYUV_SSSE3) && \
+    (defined(__x86_64__) || defined(__i386__))
+#include <tmmintrin.h>
+#endif
+
+#ifdef __cplusplus
+namespace libyuv {
+extern "C" {
+#endif
+
+// This module is for GCC x86 and x64 builds that compile it with -mssse3 and
+// define LIBYUV_SSSE3. The functions here replace the inline assembly
+// versions in row_posix.cc, and are bit exact with them, but are written with
+// intrinsics so the compiler can schedule, unroll and inline them.
+#if !defined(YUV_DISABLE_ASM) && defined(LIBYUV_SSSE3) && \
+    (defined(__x86_64__) || defined(__i386__))
+
+static __inline __m128i Load(const uint8* p, bool aligned) {
+  return aligned ? _mm_load_si128(reinterpret_cast<const __m128i*>(p)) :
+                   _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+
+static __inline void Store(uint8* p, __m128i v, bool aligned) {
+  if (aligned) {
+    _mm_store_si128(reinterpret_cast<__m128i*>(p), v);
+  } else {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+  }
+}
+
+#ifdef HAS_ARGBTOYROW_SSSE3
+
+// 16 pixels per loop.
+static __inline void ARGBToYRow(const uint8* src_argb, uint8* dst_y, int pix,
+                                bool aligned) {
+  const __m128i kARGBToY = _mm_set1_epi32(0x0021410d);  // 13, 65, 33, 0
+  const __m128i kAddY16 = _mm_set1_epi8(16);
+  for (; pix > 0; pix -= 16) {
+    __m128i y0 = _mm_maddubs_epi16(Load(src_argb, aligned), kARGBToY);
+    __m128i y1 = _mm_maddubs_epi16(Load(src_argb + 16, aligned), kARGBToY);
+    __m128i y2 = _mm_maddubs_epi16(Load(src_argb + 32, aligned), kARGBToY);
+    __m128i y3 = _mm_maddubs_epi16(Load(src_argb + 48, aligned), kARGBToY);
+    y0 = _mm_srli_epi16(_mm_hadd_epi16(y0, y1), 7);
+    y2 = _mm_srli_epi16(_mm_hadd_epi16(y2, y3), 7);
+    Store(dst_y, _mm_add_epi8(_mm_packus_epi16(y0, y2), kAddY16), aligned);
+    src_argb += 64;
+    dst_y += 16;
+  }
+}
+
+void ARGBToYRow_SSSE3(const uint8* src_argb, uint8* dst_y, int pix) {
+  ARGBToYRow(src_argb, dst_y, pix, true);
+}
+
+void ARGBToYRow_Unaligned_SSSE3(const uint8* src_argb, uint8* dst_y, int pix) {
+  ARGBToYRow(src_argb, dst_y, pix, false);
+}
+
+// Averages 2x2 pixels of 32 pixels from 2 rows into 16 pixels.
+static __inline __m128i SubsampleARGB(const uint8* src_argb0,
+                                      const uint8* src_argb1, bool aligned) {
+  __m128i a0 = _mm_avg_epu8(Load(src_argb0, aligned),
+                            Load(src_argb1, aligned));
+  __m128i a1 = _mm_avg_epu8(Load(src_argb0 + 16, aligned),
+                            Load(src_argb1 + 16, aligned));
+  __m128 even = _mm_shuffle_ps(_mm_castsi128_ps(a0), _mm_castsi128_ps(a1),
+                               0x88);
+  __m128 odd = _mm_shuffle_ps(_mm_castsi128_ps(a0), _mm_castsi128_ps(a1),
+                              0xdd);
+  return _mm_avg_epu8(_mm_castps_si128(even), _mm_castps_si128(odd));
+}
+
+// 16 pixels of 2 rows per loop, to 8 U and 8 V.
+static __inline void ARGBToUVRow(const uint8* src_argb0, int src_stride_argb,
+                                 uint8* dst_u, uint8* dst_v, int width,
+                                 bool aligned) {
+  const __m128i kARGBToU = _mm_set1_epi32(0x00dab670);  // 112, -74, -38, 0
+  const __m128i kARGBToV = _mm_set1_epi32(0x0070a2ee);  // -18, -94, 112, 0
+  const __m128i kAddUV128 = _mm_set1_epi8(-128);
+  const uint8* src_argb1 = src_argb0 + src_stride_argb;
+  for (; width > 0; width -= 16) {
+    __m128i p0 = SubsampleARGB(src_argb0, src_argb1, aligned);
+    __m128i p1 = SubsampleARGB(src_argb0 + 32, src_argb1 + 32, aligned);
+    __m128i u = _mm_hadd_epi16(_mm_maddubs_epi16(p0, kARGBToU),
+                               _mm_maddubs_epi16(p1, kARGBToU));
+    __m128i v = _mm_hadd_epi16(_mm_maddubs_epi16(p0, kARGBToV),
+                               _mm_maddubs_epi16(p1, kARGBToV));
+    __m128i uv = _mm_add_epi8(_mm_packs_epi16(_mm_srai_epi16(u, 8),
+                                              _mm_srai_epi16(v, 8)),
+                              kAddUV128);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst_u), uv);
+    _mm_storeh_pi(reinterpret_cast<__m64*>(dst_v), _mm_castsi128_ps(uv));
+    src_argb0 += 64;
+    src_argb1 += 64;
+    dst_u += 8;
+    dst_v += 8;
+  }
+}
+
+void ARGBToUVRow_SSSE3(const uint8* src_argb0, int src_stride_argb,
+                       uint8* dst_u, uint8* dst_v, int width) {
+  ARGBToUVRow(src_argb0, src_stride_argb, dst_u, dst_v, width, true);
+}
+
+void ARGBToUVRow_Unaligned_SSSE3(const uint8* src_argb0, int src_stride_argb,
+                                 uint8* dst_u, uint8* dst_v, int width) {
+  ARGBToUVRow(src_argb0, src_stride_argb, dst_u, dst_v, width, false);
+}
+
+#endif  // HAS_ARGBTOYROW_SSSE3
+
+#ifdef HAS_I422TOARGBROW_SSSE3
+#define UB 127 /* min(63,static_cast<int8>(2.018 * 64)) */
+#define UG -25 /* static_cast<int8>(-0.391 * 64 - 0.5) */
+#define UR 0
+
+#define VB 0
+#define VG -52 /* static_cast<int8>(-0.813 * 64 - 0.5) */
+#define VR 102 /* static_cast<int8>(1.596 * 64 + 0.5) */
+
+// Bias
+#define BB UB * 128 + VB * 128
+#define BG UG * 128 + VG * 128
+#define BR UR * 128 + VR * 128
+
+#define YG 74 /* static_cast<int8>(1.164 * 64 + 0.5) */
+
+// A pair of signed bytes, lo then hi, as the 16 bit lane pmaddubsw reads.
+#define BYTEPAIR(lo, hi) static_cast<short>(((hi) & 0xff) << 8 | ((lo) & 0xff))
+
+// Converts 8 pixels: 8 interleaved UV (or VU, with the constants swapped)
+// and 8 Y, to 8 ARGB pixels.
+static __inline void YuvToARGB(__m128i uv, const uint8* y_buf,
+                               uint8* argb_buf, bool swap_uv, bool aligned) {
+  const __m128i kUVToB = _mm_set1_epi16(swap_uv ? BYTEPAIR(VB, UB) :
+                                                  BYTEPAIR(UB, VB));
+  const __m128i kUVToG = _mm_set1_epi16(swap_uv ? BYTEPAIR(VG, UG) :
+                                                  BYTEPAIR(UG, VG));
+  const __m128i kUVToR = _mm_set1_epi16(swap_uv ? BYTEPAIR(VR, UR) :
+                                                  BYTEPAIR(UR, VR));
+  __m128i b = _mm_sub_epi16(_mm_maddubs_epi16(uv, kUVToB),
+                            _mm_set1_epi16(BB));
+  __m128i g = _mm_sub_epi16(_mm_maddubs_epi16(uv, kUVToG),
+                            _mm_set1_epi16(BG));
+  __m128i r = _mm_sub_epi16(_mm_maddubs_epi16(uv, kUVToR),
+                            _mm_set1_epi16(BR));
+  // (y - 16) * YG, as y * YG - 16 * YG so that it is one pmaddubsw rather
+  // than the shifts and adds the compiler makes of a pmullw by a constant.
+  // Neither overflows 16 bits, so this is exact.
+  __m128i y = _mm_unpacklo_epi8(
+      _mm_loadl_epi64(reinterpret_cast<const __m128i*>(y_buf)),
+      _mm_setzero_si128());
+  y = _mm_sub_epi16(_mm_maddubs_epi16(y, _mm_set1_epi16(YG)),
+                    _mm_set1_epi16(16 * YG));
+  b = _mm_srai_epi16(_mm_adds_epi16(b, y), 6);
+  g = _mm_srai_epi16(_mm_adds_epi16(g, y), 6);
+  r = _mm_srai_epi16(_mm_adds_epi16(r, y), 6);
+  __m128i bg = _mm_unpacklo_epi8(_mm_packus_epi16(b, b),
+                                 _mm_packus_epi16(g, g));
+  __m128i ra = _mm_unpacklo_epi8(_mm_packus_epi16(r, r),
+                                 _mm_set1_epi8(-1));
+  Store(argb_buf, _mm_unpacklo_epi16(bg, ra), aligned);
+  Store(argb_buf + 16, _mm_unpackhi_epi16(bg, ra), aligned);
+}
+
+// Reads 4 U and 4 V and upsamples them to 8 UV.
+static __inline __m128i ReadYUV422(const uint8* u_buf, const uint8* v_buf) {
+  __m128i u = _mm_cvtsi32_si128(*reinterpret_cast<const int*>(u_buf));
+  __m128i v = _mm_cvtsi32_si128(*reinterpret_cast<const int*>(v_buf));
+  __m128i uv = _mm_unpacklo_epi8(u, v);
+  return _mm_unpacklo_epi16(uv, uv);
+}
+
+// Reads 4 UV from NV12 and upsamples them to 8 UV.
+static __inline __m128i ReadNV12(const uint8* uv_buf) {
+  __m128i uv = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(uv_buf));
+  return _mm_unpacklo_epi16(uv, uv);
+}
+
+static __inline void I422ToARGBRow(const uint8* y_buf, const uint8* u_buf,
+                                   const uint8* v_buf, uint8* argb_buf,
+                                   int width, bool aligned) {
+  for (; width > 0; width -= 8) {
+    YuvToARGB(ReadYUV422(u_buf, v_buf), y_buf, argb_buf, false, aligned);
+    y_buf += 8;
+    u_buf += 4;
+    v_buf += 4;
+    argb_buf += 32;
+  }
+}
+
+// NV21 is NV12 with V first, which swapping the constants handles.
+static __inline void NV12ToARGBRow(const uint8* y_buf, const uint8* uv_buf,
+                                   uint8* argb_buf, int width, bool swap_uv,
+                                   bool aligned) {
+  for (; width > 0; width -= 8) {
+    YuvToARGB(ReadNV12(uv_buf), y_buf, argb_buf, swap_uv, aligned);
+    y_buf += 8;
+    uv_buf += 8;
+    argb_buf += 32;
+  }
+}
+
+void I422ToARGBRow_SSSE3(const uint8* y_buf,
+                         const uint8* u_buf,
+                         const uint8* v_buf,
+                         uint8* argb_buf,
+                         int width) {
+  I422ToARGBRow(y_buf, u_buf, v_buf, argb_buf, width, true);
+}
+
+void I422ToARGBRow_Unaligned_SSSE3(const uint8* y_buf,
+                                   const uint8* u_buf,
+                                   const uint8* v_buf,
+                                   uint8* argb_buf,
+                                   int width) {
+  I422ToARGBRow(y_buf, u_buf, v_buf, argb_buf, width, false);
+}
+
+void NV12ToARGBRow_SSSE3(const uint8* y_buf,
+                         const uint8* uv_buf,
+                         uint8* argb_buf,
+                         int width) {
+  NV12ToARGBRow(y_buf, uv_buf, argb_buf, width, false, true);
+}
+
+void NV12ToARGBRow_Unaligned_SSSE3(const uint8* y_buf,
+                                   const uint8* uv_buf,
+                                   uint8* argb_buf,
+                                   int width) {
+  NV12ToARGBRow(y_buf, uv_buf, argb_buf, width, false, false);
+}
+
+void NV21ToARGBRow_SSSE3(const uint8* y_buf,
+                         const uint8* vu_buf,
+                         uint8* argb_buf,
+                         int width) {
+  NV12ToARGBRow(y_buf, vu_buf, argb_buf, width, true, true);
+}
+
+void NV21ToARGBRow_Unaligned_SSSE3(const uint8* y_buf,
+                                   const uint8* vu_buf,
+                                   uint8* argb_buf,
+                                   int width) {
+  NV12ToARGBRow(y_buf, vu_buf, argb_buf, width, true, false);
+}
+
+#endif  // HAS_I422TOARGBROW_SSSE3
+
+#endif  // !defined(YUV_DISABLE_ASM) && defined(LIBYUV_SSSE3) ...
+
+#ifdef __cplusplus
+}  // extern "C"
+}  // namespace libyuv
+#endif
@@ -1062,6 +1062,137 @@ __asm {
   }
 }
 
+// Same as ARGBToUVRow_SSSE3 but stores 8 interleaved UV pairs, as used by
+// NV12, instead of 8 U and 8 V.
+__declspec(naked) __declspec(align(16))
+void ARGBToUVInterleaveRow_SSSE3(const uint8* src_argb0, int src_stride_argb,
+                                 uint8* dst_uv, int width) {
+__asm {
+    push       esi
+    mov        eax, [esp + 4 + 4]   // src_argb
+    mov        esi, [esp + 4 + 8]   // src_stride_argb
+    mov        edx, [esp + 4 + 12]  // dst_uv
+    mov        ecx, [esp + 4 + 16]  // pix
+    movdqa     xmm7, kARGBToU
+    movdqa     xmm6, kARGBToV
+    movdqa     xmm5, kAddUV128
+
+    align      16
+ convertloop:
+    /* step 1 - subsample 16x2 argb pixels to 8x1 */
+    movdqa     xmm0, [eax]
+    movdqa     xmm1, [eax + 16]
+    movdqa     xmm2, [eax + 32]
+    movdqa     xmm3, [eax + 48]
+    pavgb      xmm0, [eax + esi]
+    pavgb      xmm1, [eax + esi + 16]
+    pavgb      xmm2, [eax + esi + 32]
+    pavgb      xmm3, [eax + esi + 48]
+    lea        eax,  [eax + 64]
+    movdqa     xmm4, xmm0
+    shufps     xmm0, xmm1, 0x88
+    shufps     xmm4, xmm1, 0xdd
+    pavgb      xmm0, xmm4
+    movdqa     xmm4, xmm2
+    shufps     xmm2, xmm3, 0x88
+    shufps     xmm4, xmm3, 0xdd
+    pavgb      xmm2, xmm4
+
+    // step 2 - convert to U and V
+    movdqa     xmm1, xmm0
+    movdqa     xmm3, xmm2
+    pmaddubsw  xmm0, xmm7  // U
+    pmaddubsw  xmm2, xmm7
+    pmaddubsw  xmm1, xmm6  // V
+    pmaddubsw  xmm3, xmm6
+    phaddw     xmm0, xmm2
+    phaddw     xmm1, xmm3
+    psraw      xmm0, 8
+    psraw      xmm1, 8
+    packsswb   xmm0, xmm1
+    paddb      xmm0, xmm5            // -> unsigned
+
+    // step 3 - interleave and store 8 UV pairs
+    movdqa     xmm1, xmm0
+    psrldq     xmm1, 8
+    punpcklbw  xmm0, xmm1
+    sub        ecx, 16
+    movdqu     [edx], xmm0
+    lea        edx, [edx + 16]
+    jg         convertloop
+
+    pop        esi
+    ret
+  }
+}
+
+__declspec(naked) __declspec(align(16))
+void ARGBToUVInterleaveRow_Unaligned_SSSE3(const uint8* src_argb0,
+                                           int src_stride_argb,
+                                           uint8* dst_uv, int width) {
+__asm {
+    push       esi
+    mov        eax, [esp + 4 + 4]   // src_argb
+    mov        esi, [esp + 4 + 8]   // src_stride_argb
+    mov        edx, [esp + 4 + 12]  // dst_uv
+    mov        ecx, [esp + 4 + 16]  // pix
+    movdqa     xmm7, kARGBToU
+    movdqa     xmm6, kARGBToV
+    movdqa     xmm5, kAddUV128
+
+    align      16
+ convertloop:
+    /* step 1 - subsample 16x2 argb pixels to 8x1 */
+    movdqu     xmm0, [eax]
+    movdqu     xmm1, [eax + 16]
+    movdqu     xmm2, [eax + 32]
+    movdqu     xmm3, [eax + 48]
+    movdqu     xmm4, [eax + esi]
+    pavgb      xmm0, xmm4
+    movdqu     xmm4, [eax + esi + 16]
+    pavgb      xmm1, xmm4
+    movdqu     xmm4, [eax + esi + 32]
+    pavgb      xmm2, xmm4
+    movdqu     xmm4, [eax + esi + 48]
+    pavgb      xmm3, xmm4
+    lea        eax,  [eax + 64]
+    movdqa     xmm4, xmm0
+    shufps     xmm0, xmm1, 0x88
+    shufps     xmm4, xmm1, 0xdd
+    pavgb      xmm0, xmm4
+    movdqa     xmm4, xmm2
+    shufps     xmm2, xmm3, 0x88
+    shufps     xmm4, xmm3, 0xdd
+    pavgb      xmm2, xmm4
+
+    // step 2 - convert to U and V
+    movdqa     xmm1, xmm0
+    movdqa     xmm3, xmm2
+    pmaddubsw  xmm0, xmm7  // U
+    pmaddubsw  xmm2, xmm7
+    pmaddubsw  xmm1, xmm6  // V
+    pmaddubsw  xmm3, xmm6
+    phaddw     xmm0, xmm2
+    phaddw     xmm1, xmm3
+    psraw      xmm0, 8
+    psraw      xmm1, 8
+    packsswb   xmm0, xmm1
+    paddb      xmm0, xmm5            // -> unsigned
+
+    // step 3 - interleave and store 8 UV pairs
+    movdqa     xmm1, xmm0
+    psrldq     xmm1, 8
+    punpcklbw  xmm0, xmm1
+    sub        ecx, 16
+    movdqu     [edx], xmm0
+    lea        edx, [edx + 16]
+    jg         convertloop
+
+    pop        esi
+    ret
+  }
+}
+
 __declspec(naked) __declspec(align(16))
 void BGRAToUVRow_SSSE3(const uint8* src_argb0, int src_stride_argb,
                        uint8* dst_u, uint8* dst_v, int width) {
@@ -2270,6 +2401,272 @@ void I422ToRGBARow_Unaligned_SSSE3(const uint8* y_buf,
   }
 }
 
+#ifdef HAS_I422TORGB565ROW_SSSE3
+// Pack 8 pixels of B, G and R in xmm0, xmm1 and xmm2 to 16 bits per pixel.
+// xmm4 must be zero.
+#define STORERGB565 __asm {                                                    \
+    __asm punpcklbw  xmm0, xmm2           /* RB */                             \
+    __asm punpcklbw  xmm1, xmm4           /* G */                              \
+    __asm movdqa     xmm2, xmm0                                                \
+    __asm psllw      xmm0, 8                                                   \
+    __asm psrlw      xmm0, 11             /* B */                              \
+    __asm psrlw      xmm2, 11                                                  \
+    __asm psllw      xmm2, 11             /* R */                              \
+    __asm psrlw      xmm1, 2                                                   \
+    __asm psllw      xmm1, 5              /* G */                              \
+    __asm por        xmm0, xmm1           /* BG */                             \
+    __asm por        xmm0, xmm2           /* BGR */                            \
+    __asm movdqu     [edx], xmm0                                               \
+    __asm lea        edx,  [edx + 16]                                          \
+  }
+
+// xmm5 holds 0x8000 per pixel for alpha.
+#define STOREARGB1555 __asm {                                                  \
+    __asm punpcklbw  xmm0, xmm2           /* RB */                             \
+    __asm punpcklbw  xmm1, xmm4           /* G */                              \
+    __asm movdqa     xmm2, xmm0                                                \
+    __asm psllw      xmm0, 8                                                   \
+    __asm psrlw      xmm0, 11             /* B */                              \
+    __asm psrlw      xmm2, 11                                                  \
+    __asm psllw      xmm2, 10             /* R */                              \
+    __asm psrlw      xmm1, 3                                                   \
+    __asm psllw      xmm1, 5              /* G */                              \
+    __asm por        xmm0, xmm1           /* BG */                             \
+    __asm por        xmm0, xmm2           /* BGR */                            \
+    __asm por        xmm0, xmm5           /* ARGB */                           \
+    __asm movdqu     [edx], xmm0                                               \
+    __asm lea        edx,  [edx + 16]                                          \
+  }
+
+// xmm5 holds 0x0f and xmm6 holds 0xf0 per byte.
+#define STOREARGB4444 __asm {                                                  \
+    __asm psrlw      xmm0, 4                                                   \
+    __asm pand       xmm0, xmm5           /* B */                              \
+    __asm pand       xmm1, xmm6           /* G */                              \
+    __asm por        xmm0, xmm1           /* BG */                             \
+    __asm psrlw      xmm2, 4                                                   \
+    __asm pand       xmm2, xmm5           /* R */                              \
+    __asm por        xmm2, xmm6           /* RA */                             \
+    __asm punpcklbw  xmm0, xmm2           /* BGRA */                           \
+    __asm movdqu     [edx], xmm0                                               \
+    __asm lea        edx,  [edx + 16]                                          \
+  }
+
+// Add 4 bytes of dither in xmm5, repeated per 4 pixels, to B, G and R.
+#define DITHERRGB __asm {                                                      \
+    __asm paddusb    xmm0, xmm5                                                \
+    __asm paddusb    xmm1, xmm5                                                \
+    __asm paddusb    xmm2, xmm5                                                \
+  }
+
+// 8 pixels, unaligned.
+// 4 UV values upsampled to 8 UV, mixed with 8 Y producing 8 16 bit pixels.
+__declspec(naked) __declspec(align(16))
+void I422ToRGB565Row_SSSE3(const uint8* y_buf,
+                           const uint8* u_buf,
+                           const uint8* v_buf,
+                           uint8* rgb_buf,
+                           int width) {
+  __asm {
+    push       esi
+    push       edi
+    mov        eax, [esp + 8 + 4]   // Y
+    mov        esi, [esp + 8 + 8]   // U
+    mov        edi, [esp + 8 + 12]  // V
+    mov        edx, [esp + 8 + 16]  // rgb
+    mov        ecx, [esp + 8 + 20]  // width
+    sub        edi, esi
+    pxor       xmm4, xmm4
+
+    align      16
+ convertloop:
+    READYUV422
+    YUVTORGB
+    STORERGB565
+
+    sub        ecx, 8
+    jg         convertloop
+
+    pop        edi
+    pop        esi
+    ret
+  }
+}
+
+// 8 pixels, unaligned.
+// 4 UV values upsampled to 8 UV, mixed with 8 Y producing 8 16 bit pixels.
+__declspec(naked) __declspec(align(16))
+void I422ToARGB1555Row_SSSE3(const uint8* y_buf,
+                             const uint8* u_buf,
+                             const uint8* v_buf,
+                             uint8* rgb_buf,
+                             int width) {
+  __asm {
+    push       esi
+    push       edi
+    mov        eax, [esp + 8 + 4]   // Y
+    mov        esi, [esp + 8 + 8]   // U
+    mov        edi, [esp + 8 + 12]  // V
+    mov        edx, [esp + 8 + 16]  // rgb
+    mov        ecx, [esp + 8 + 20]  // width
+    sub        edi, esi
+    pcmpeqb    xmm5, xmm5           // generate mask 0x8000
+    psllw      xmm5, 15
+    pxor       xmm4, xmm4
+
+    align      16
+ convertloop:
+    READYUV422
+    YUVTORGB
+    STOREARGB1555
+
+    sub        ecx, 8
+    jg         convertloop
+
+    pop        edi
+    pop        esi
+    ret
+  }
+}
+
+// 8 pixels, unaligned.
+// 4 UV values upsampled to 8 UV, mixed with 8 Y producing 8 16 bit pixels.
+__declspec(naked) __declspec(align(16))
+void I422ToARGB4444Row_SSSE3(const uint8* y_buf,
+                             const uint8* u_buf,
+                             const uint8* v_buf,
+                             uint8* rgb_buf,
+                             int width) {
+  __asm {
+    push       esi
+    push       edi
+    mov        eax, [esp + 8 + 4]   // Y
+    mov        esi, [esp + 8 + 8]   // U
+    mov        edi, [esp + 8 + 12]  // V
+    mov        edx, [esp + 8 + 16]  // rgb
+    mov        ecx, [esp + 8 + 20]  // width
+    sub        edi, esi
+    pcmpeqb    xmm5, xmm5           // generate mask 0x0f0f
+    psrlw      xmm5, 12
+    movdqa     xmm6, xmm5
+    psllw      xmm6, 8
+    por        xmm5, xmm6
+    pcmpeqb    xmm6, xmm6           // generate mask 0xf0f0
+    pxor       xmm6, xmm5
+    pxor       xmm4, xmm4
+
+    align      16
+ convertloop:
+    READYUV422
+    YUVTORGB
+    STOREARGB4444
+
+    sub        ecx, 8
+    jg         convertloop
+
+    pop        edi
+    pop        esi
+    ret
+  }
+}
+
+// 8 pixels, unaligned.
+// 4 UV values upsampled to 8 UV, mixed with 8 Y producing 8 16 bit pixels.
+__declspec(naked) __declspec(align(16))
+void I422ToRGB565DitherRow_SSSE3(const uint8* y_buf,
+                                 const uint8* u_buf,
+                                 const uint8* v_buf,
+                                 uint8* rgb_buf,
+                                 uint32 dither4,
+                                 int width) {
+  __asm {
+    push       esi
+    push       edi
+    mov        eax, [esp + 8 + 4]   // Y
+    mov        esi, [esp + 8 + 8]   // U
+    mov        edi, [esp + 8 + 12]  // V
+    mov        edx, [esp + 8 + 16]  // rgb
+    movd       xmm5, [esp + 8 + 20]  // dither4
+    pshufd     xmm5, xmm5, 0
+    mov        ecx, [esp + 8 + 24]  // width
+    sub        edi, esi
+    pxor       xmm4, xmm4
+
+    align      16
+ convertloop:
+    READYUV422
+    YUVTORGB
+    DITHERRGB
+    STORERGB565
+
+    sub        ecx, 8
+    jg         convertloop
+
+    pop        edi
+    pop        esi
+    ret
+  }
+}
+
+// 8 pixels, unaligned.
+// 4 UV values upsampled to 8 UV, mixed with 8 Y producing 8 RGB565 (16 bytes).
+__declspec(naked) __declspec(align(16))
+void NV12ToRGB565Row_SSSE3(const uint8* y_buf,
+                           const uint8* uv_buf,
+                           uint8* rgb_buf,
+                           int width) {
+  __asm {
+    push       esi
+    mov        eax, [esp + 4 + 4]   // Y
+    mov        esi, [esp + 4 + 8]   // UV
+    mov        edx, [esp + 4 + 12]  // rgb
+    mov        ecx, [esp + 4 + 16]  // width
+    pxor       xmm4, xmm4
+
+    align      16
+ convertloop:
+    READNV12
+    YUVTORGB
+    STORERGB565
+
+    sub        ecx, 8
+    jg         convertloop
+
+    pop        esi
+    ret
+  }
+}
+
+// 8 pixels, unaligned.
+// 4 UV values upsampled to 8 UV, mixed with 8 Y producing 8 RGB565 (16 bytes).
+__declspec(naked) __declspec(align(16))
+void NV21ToRGB565Row_SSSE3(const uint8* y_buf,
+                           const uint8* vu_buf,
+                           uint8* rgb_buf,
+                           int width) {
+  __asm {
+    push       esi
+    mov        eax, [esp + 4 + 4]   // Y
+    mov        esi, [esp + 4 + 8]   // VU
+    mov        edx, [esp + 4 + 12]  // rgb
+    mov        ecx, [esp + 4 + 16]  // width
+    pxor       xmm4, xmm4
+
+    align      16
+ convertloop:
+    READNV12
+    YVUTORGB
+    STORERGB565
+
+    sub        ecx, 8
+    jg         convertloop
+
+    pop        esi
+    ret
+  }
+}
+#endif  // HAS_I422TORGB565ROW_SSSE3
+
 #endif  // HAS_I422TOARGBROW_SSSE3
 
 #ifdef HAS_YTOARGBROW_SSE2
@@ -2442,6 +2839,34 @@ __asm {
 }
 #endif  // HAS_ARGBMIRRORROW_SSSE3
 
+#ifdef HAS_UVMIRRORROW_SSSE3
+// Shuffle table for reversing the UV pairs.
+static const uvec8 kShuffleUVMirror = {
+  14u, 15u, 12u, 13u, 10u, 11u, 8u, 9u, 6u, 7u, 4u, 5u, 2u, 3u, 0u, 1u
+};
+
+__declspec(naked) __declspec(align(16))
+void UVMirrorRow_SSSE3(const uint8* src_uv, uint8* dst_uv, int width) {
+__asm {
+    mov       eax, [esp + 4]   // src_uv
+    mov       edx, [esp + 8]   // dst_uv
+    mov       ecx, [esp + 12]  // width
+    movdqa    xmm5, kShuffleUVMirror
+    lea       eax, [eax - 16]
+
+    align      16
+ convertloop:
+    movdqa    xmm0, [eax + ecx * 2]
+    pshufb    xmm0, xmm5
+    sub       ecx, 8
+    movdqa    [edx], xmm0
+    lea       edx, [edx + 16]
+    jg        convertloop
+    ret
+  }
+}
+#endif  // HAS_UVMIRRORROW_SSSE3
+
 #ifdef HAS_SPLITUV_SSE2
 __declspec(naked) __declspec(align(16))
 void SplitUV_SSE2(const uint8* src_uv, uint8* dst_u, uint8* dst_v, int pix) {
@@ -2480,6 +2905,68 @@ void SplitUV_SSE2(const uint8* src_uv, uint8* dst_u, uint8* dst_v, int pix) {
 }
 #endif  // HAS_SPLITUV_SSE2
 
+#ifdef HAS_MERGEUV_SSE2
+__declspec(naked) __declspec(align(16))
+void MergeUV_SSE2(const uint8* src_u, const uint8* src_v, uint8* dst_uv,
+                  int width) {
+  __asm {
+    push       edi
+    mov        eax, [esp + 4 + 4]    // src_u
+    mov        edx, [esp + 4 + 8]    // src_v
+    mov        edi, [esp + 4 + 12]   // dst_uv
+    mov        ecx, [esp + 4 + 16]   // width
+    sub        edx, eax
+
+    align      16
+  convertloop:
+    movdqa     xmm0, [eax]           // read 16 U's
+    movdqa     xmm1, [eax + edx]     // and 16 V's
+    lea        eax,  [eax + 16]
+    movdqa     xmm2, xmm0
+    punpcklbw  xmm0, xmm1            // first 8 UV pairs
+    punpckhbw  xmm2, xmm1            // next 8 UV pairs
+    movdqa     [edi], xmm0
+    movdqa     [edi + 16], xmm2
+    lea        edi, [edi + 32]
+    sub        ecx, 16
+    jg         convertloop
+
+    pop        edi
+    ret
+  }
+}
+
+__declspec(naked) __declspec(align(16))
+void MergeUV_Unaligned_SSE2(const uint8* src_u, const uint8* src_v,
+                            uint8* dst_uv, int width) {
+  __asm {
+    push       edi
+    mov        eax, [esp + 4 + 4]    // src_u
+    mov        edx, [esp + 4 + 8]    // src_v
+    mov        edi, [esp + 4 + 12]   // dst_uv
+    mov        ecx, [esp + 4 + 16]   // width
+    sub        edx, eax
+
+    align      16
+  convertloop:
+    movdqu     xmm0, [eax]           // read 16 U's
+    movdqu     xmm1, [eax + edx]     // and 16 V's
+    lea        eax,  [eax + 16]
+    movdqa     xmm2, xmm0
+    punpcklbw  xmm0, xmm1            // first 8 UV pairs
+    punpckhbw  xmm2, xmm1            // next 8 UV pairs
+    movdqu     [edi], xmm0
+    movdqu     [edi + 16], xmm2
+    lea        edi, [edi + 32]
+    sub        ecx, 16
+    jg         convertloop
+
+    pop        edi
+    ret
+  }
+}
+#endif  // HAS_MERGEUV_SSE2
+
 #ifdef HAS_COPYROW_SSE2
 // CopyRow copys 'count' bytes using a 16 byte load/store, 32 bytes at time.
 __declspec(naked) __declspec(align(16))
@@ -3277,6 +3764,61 @@ void ARGBBlendRow_SSSE3(const uint8* src_argb0, const uint8* src_argb1,
 }
 #endif  // HAS_ARGBBLENDROW_SSSE3
 
+#ifdef HAS_BLENDPLANEROW_SSSE3
+// Blend 8 pixels at a time.
+// Pixels are biased by 128 so pmaddubsw can take them as signed bytes and
+// alpha, 255 - alpha as unsigned weights. The sum fits in 16 bits and
+// 32768 + 127 adds the bias back along with the rounding.
+__declspec(naked) __declspec(align(16))
+void BlendPlaneRow_SSSE3(const uint8* src0, const uint8* src1,
+                         const uint8* alpha, uint8* dst, int width) {
+  __asm {
+    push       esi
+    push       edi
+    mov        eax, [esp + 8 + 4]   // src0
+    mov        esi, [esp + 8 + 8]   // src1
+    mov        edi, [esp + 8 + 12]  // alpha
+    mov        edx, [esp + 8 + 16]  // dst
+    mov        ecx, [esp + 8 + 20]  // width
+    pcmpeqb    xmm5, xmm5       // generate mask 0xff00ff00
+    psllw      xmm5, 8
+    pcmpeqb    xmm6, xmm6       // generate 0x80 bytes
+    psllw      xmm6, 7
+    packsswb   xmm6, xmm6
+    pcmpeqb    xmm7, xmm7       // generate 0x807f words
+    psllw      xmm7, 15
+    pcmpeqb    xmm4, xmm4
+    psrlw      xmm4, 9
+    por        xmm7, xmm4
+    sub        esi, eax
+    sub        edi, eax
+    sub        edx, eax
+
+    align      16
+  convertloop8:
+    movq       xmm0, qword ptr [eax + edi]  // alpha
+    punpcklbw  xmm0, xmm0
+    pxor       xmm0, xmm5       // a, 255 - a
+    movq       xmm1, qword ptr [eax]        // src0
+    movq       xmm2, qword ptr [eax + esi]  // src1
+    punpcklbw  xmm1, xmm2
+    psubb      xmm1, xmm6       // bias src0, src1 to signed
+    pmaddubsw  xmm0, xmm1
+    paddw      xmm0, xmm7       // unbias and round
+    psrlw      xmm0, 8
+    packuswb   xmm0, xmm0
+    movq       qword ptr [eax + edx], xmm0
+    lea        eax, [eax + 8]
+    sub        ecx, 8
+    jg         convertloop8
+
+    pop        edi
+    pop        esi
+    ret
+  }
+}
+#endif  // HAS_BLENDPLANEROW_SSSE3
+
 #ifdef HAS_ARGBATTENUATE_SSE2
 // Attenuate 4 pixels at a time.
 // Aligned to 16 bytes.
@@ -3891,6 +4433,247 @@ void ComputeCumulativeSumRow_SSE2(const uint8* row, int32* cumsum,
 }
 #endif  // HAS_COMPUTECUMULATIVESUMROW_SSE2
 
+#ifdef HAS_BLURCOLUMNROW_SSE2
+// Add 16 pixels at a time to 16 bit column sums.
+__declspec(naked) __declspec(align(16))
+void BlurColumnAddRow_SSE2(const uint8* src, uint16* sum, int width) {
+  __asm {
+    mov        eax, [esp + 4]   // src
+    mov        edx, [esp + 8]   // sum
+    mov        ecx, [esp + 12]  // width
+    pxor       xmm5, xmm5
+
+    align      16
+  convertloop:
+    movdqu     xmm0, [eax]
+    lea        eax,  [eax + 16]
+    movdqa     xmm1, xmm0
+    punpcklbw  xmm0, xmm5
+    punpckhbw  xmm1, xmm5
+    movdqu     xmm2, [edx]
+    movdqu     xmm3, [edx + 16]
+    paddw      xmm2, xmm0
+    paddw      xmm3, xmm1
+    movdqu     [edx], xmm2
+    movdqu     [edx + 16], xmm3
+    lea        edx,  [edx + 32]
+    sub        ecx, 16
+    jg         convertloop
+    ret
+  }
+}
+
+// Subtract 16 pixels at a time from 16 bit column sums.
+__declspec(naked) __declspec(align(16))
+void BlurColumnSubRow_SSE2(const uint8* src, uint16* sum, int width) {
+  __asm {
+    mov        eax, [esp + 4]   // src
+    mov        edx, [esp + 8]   // sum
+    mov        ecx, [esp + 12]  // width
+    pxor       xmm5, xmm5
+
+    align      16
+  convertloop:
+    movdqu     xmm0, [eax]
+    lea        eax,  [eax + 16]
+    movdqa     xmm1, xmm0
+    punpcklbw  xmm0, xmm5
+    punpckhbw  xmm1, xmm5
+    movdqu     xmm2, [edx]
+    movdqu     xmm3, [edx + 16]
+    psubw      xmm2, xmm0
+    psubw      xmm3, xmm1
+    movdqu     [edx], xmm2
+    movdqu     [edx + 16], xmm3
+    lea        edx,  [edx + 32]
+    sub        ecx, 16
+    jg         convertloop
+    ret
+  }
+}
+#endif  // HAS_BLURCOLUMNROW_SSE2
+
+#ifdef HAS_BLURCUMULATIVESUMROW_SSE2
+// Running sum of 8 column sums at a time. Each group of 4 is summed with two
+// shifted adds, then the total so far is added and carried to the next group.
+__declspec(naked) __declspec(align(16))
+void BlurCumulativeSumRow_SSE2(const uint16* sum, int32* cumsum, int width) {
+  __asm {
+    mov        eax, [esp + 4]   // sum
+    mov        edx, [esp + 8]   // cumsum
+    mov        ecx, [esp + 12]  // width
+    movd       xmm4, [edx]      // starting value
+    pshufd     xmm4, xmm4, 0
+    pxor       xmm5, xmm5
+
+    align      16
+  convertloop:
+    movdqu     xmm0, [eax]
+    lea        eax,  [eax + 16]
+    movdqa     xmm1, xmm0
+    punpcklwd  xmm0, xmm5
+    punpckhwd  xmm1, xmm5
+    movdqa     xmm2, xmm0
+    pslldq     xmm2, 4
+    paddd      xmm0, xmm2
+    movdqa     xmm2, xmm0
+    pslldq     xmm2, 8
+    paddd      xmm0, xmm2
+    paddd      xmm0, xmm4
+    pshufd     xmm4, xmm0, 0xff  // carry
+    movdqa     xmm2, xmm1
+    pslldq     xmm2, 4
+    paddd      xmm1, xmm2
+    movdqa     xmm2, xmm1
+    pslldq     xmm2, 8
+    paddd      xmm1, xmm2
+    paddd      xmm1, xmm4
+    pshufd     xmm4, xmm1, 0xff
+    movdqu     [edx + 4], xmm0
+    movdqu     [edx + 20], xmm1
+    lea        edx,  [edx + 32]
+    sub        ecx, 8
+    jg         convertloop
+    ret
+  }
+}
+#endif  // HAS_BLURCUMULATIVESUMROW_SSE2
+
+#ifdef HAS_ARGBBLURCUMULATIVESUMROW_SSE2
+// Running sum of column sums, 1 ARGB pixel at a time.
+__declspec(naked) __declspec(align(16))
+void ARGBBlurCumulativeSumRow_SSE2(const uint16* sum, int32* cumsum,
+                                   int width) {
+  __asm {
+    mov        eax, [esp + 4]   // sum
+    mov        edx, [esp + 8]   // cumsum
+    mov        ecx, [esp + 12]  // width
+    movdqu     xmm0, [edx]      // starting value
+    pxor       xmm5, xmm5
+
+    align      16
+  convertloop:
+    movq       xmm1, qword ptr [eax]
+    lea        eax,  [eax + 8]
+    punpcklwd  xmm1, xmm5
+    paddd      xmm0, xmm1
+    movdqu     [edx + 16], xmm0
+    lea        edx,  [edx + 16]
+    sub        ecx, 1
+    jg         convertloop
+    ret
+  }
+}
+#endif  // HAS_ARGBBLURCUMULATIVESUMROW_SSE2
+
+#ifdef HAS_BLURCUMULATIVESUMTOAVERAGEROW_SSE2
+// Average 8 pixels at a time.
+__declspec(naked) __declspec(align(16))
+void BlurCumulativeSumToAverageRow_SSE2(const int32* cumsum, int diameter,
+                                        float ooa, float rounding,
+                                        uint8* dst, int count) {
+  __asm {
+    push       esi
+    mov        eax, [esp + 4 + 4]   // cumsum
+    mov        esi, [esp + 4 + 8]   // diameter
+    movss      xmm4, [esp + 4 + 12]  // ooa
+    movss      xmm5, [esp + 4 + 16]  // rounding
+    mov        edx, [esp + 4 + 20]  // dst
+    mov        ecx, [esp + 4 + 24]  // count
+    pshufd     xmm4, xmm4, 0
+    pshufd     xmm5, xmm5, 0
+
+    align      16
+  convertloop:
+    movdqu     xmm0, [eax + esi * 4]
+    movdqu     xmm1, [eax + esi * 4 + 16]
+    movdqu     xmm2, [eax]
+    movdqu     xmm3, [eax + 16]
+    lea        eax,  [eax + 32]
+    psubd      xmm0, xmm2
+    psubd      xmm1, xmm3
+    cvtdq2ps   xmm0, xmm0
+    cvtdq2ps   xmm1, xmm1
+    mulps      xmm0, xmm4
+    mulps      xmm1, xmm4
+    addps      xmm0, xmm5
+    addps      xmm1, xmm5
+    cvttps2dq  xmm0, xmm0
+    cvttps2dq  xmm1, xmm1
+    packssdw   xmm0, xmm1
+    packuswb   xmm0, xmm0
+    movq       qword ptr [edx], xmm0
+    lea        edx,  [edx + 8]
+    sub        ecx, 8
+    jg         convertloop
+
+    pop        esi
+    ret
+  }
+}
+#endif  // HAS_BLURCUMULATIVESUMTOAVERAGEROW_SSE2
+
+#ifdef HAS_UNSHARPMASKROW_SSE2
+// Sharpen 8 pixels at a time. pmaddwd of (diff, 1) with (amount, 128)
+// gives diff * amount + 128, which is masked off where |diff| <= threshold.
+__declspec(naked) __declspec(align(16))
+void UnsharpMaskRow_SSE2(const uint8* src, const uint8* src_blur, uint8* dst,
+                         int amount, int threshold, int width) {
+  __asm {
+    push       esi
+    push       edi
+    mov        eax, [esp + 8 + 4]   // src
+    mov        esi, [esp + 8 + 8]   // src_blur
+    mov        edi, [esp + 8 + 12]  // dst
+    mov        edx, [esp + 8 + 16]  // amount
+    or         edx, 0x00800000      // 128 in the high word
+    movd       xmm6, edx
+    pshufd     xmm6, xmm6, 0
+    movd       xmm7, [esp + 8 + 20]  // threshold
+    pshuflw    xmm7, xmm7, 0
+    punpcklqdq xmm7, xmm7
+    mov        ecx, [esp + 8 + 24]  // width
+    pxor       xmm5, xmm5
+    pcmpeqb    xmm4, xmm4       // generate 1 words
+    psrlw      xmm4, 15
+    sub        esi, eax
+    sub        edi, eax
+
+    align      16
+  convertloop:
+    movq       xmm0, qword ptr [eax]        // src
+    punpcklbw  xmm0, xmm5
+    movq       xmm1, qword ptr [eax + esi]  // src_blur
+    punpcklbw  xmm1, xmm5
+    movdqa     xmm2, xmm0
+    psubw      xmm2, xmm1       // diff
+    movdqa     xmm3, xmm5
+    psubw      xmm3, xmm2
+    pmaxsw     xmm3, xmm2       // abs(diff)
+    pcmpgtw    xmm3, xmm7       // abs(diff) > threshold
+    movdqa     xmm1, xmm2
+    punpcklwd  xmm2, xmm4
+    punpckhwd  xmm1, xmm4
+    pmaddwd    xmm2, xmm6       // diff * amount + 128
+    pmaddwd    xmm1, xmm6
+    psrad      xmm2, 8
+    psrad      xmm1, 8
+    packssdw   xmm2, xmm1
+    pand       xmm2, xmm3
+    paddsw     xmm0, xmm2
+    packuswb   xmm0, xmm0
+    movq       qword ptr [eax + edi], xmm0
+    lea        eax, [eax + 8]
+    sub        ecx, 8
+    jg         convertloop
+
+    pop        edi
+    pop        esi
+    ret
+  }
+}
+#endif  // HAS_UNSHARPMASKROW_SSE2
+
 #ifdef HAS_ARGBSHADE_SSE2
 // Shade 4 pixels at a time by specified value.
 // Aligned to 16 bytes.
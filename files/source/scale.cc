@@ -15,7 +15,9 @@
 #include <stdlib.h>  // For getenv()
 
 #include "libyuv/cpu_id.h"
+#include "libyuv/explain.h"
 #include "libyuv/planar_functions.h"  // For CopyPlane
+#include "libyuv/rotate.h"
 #include "libyuv/row.h"
 
 #ifdef __cplusplus
@@ -1116,6 +1118,8 @@ static void ScaleFilterRows_SSSE3(uint8* dst_ptr, const uint8* src_ptr,
 // Generated using gcc disassembly on Visual C object file:
 // objdump -D yuvscaler.obj >yuvscaler.txt
 #define HAS_SCALEROWDOWN2_SSE2
+#define HAS_SCALEROWDOWN4_SSE2
+#if !defined(LIBYUV_SSE2)  // Else in scale_sse2.cc, declared in row.h
 static void ScaleRowDown2_SSE2(const uint8* src_ptr, ptrdiff_t src_stride,
                                uint8* dst_ptr, int dst_width) {
   asm volatile (
@@ -1249,7 +1253,6 @@ static void ScaleRowDown2Int_Unaligned_SSE2(const uint8* src_ptr,
   );
 }
 
-#define HAS_SCALEROWDOWN4_SSE2
 static void ScaleRowDown4_SSE2(const uint8* src_ptr, ptrdiff_t src_stride,
                                uint8* dst_ptr, int dst_width) {
   asm volatile (
@@ -1333,6 +1336,8 @@ static void ScaleRowDown4Int_SSE2(const uint8* src_ptr, ptrdiff_t src_stride,
   );
 }
 
+#endif  // !defined(LIBYUV_SSE2)
+
 #define HAS_SCALEROWDOWN8_SSE2
 static void ScaleRowDown8_SSE2(const uint8* src_ptr, ptrdiff_t src_stride,
                                uint8* dst_ptr, int dst_width) {
@@ -2600,6 +2605,7 @@ static void ScaleAddCols1_C(int dst_width, int boxheight, int x, int dx,
                             const uint16* src_ptr, uint8* dst_ptr) {
   int boxwidth = (dx >> 16);
   int scaleval = 65536 / (boxwidth * boxheight);
+  x >>= 16;
   for (int i = 0; i < dst_width; ++i) {
     *dst_ptr++ = SumPixels(boxwidth, src_ptr + x) * scaleval >> 16;
     x += boxwidth;
@@ -2802,48 +2808,272 @@ static void ScalePlaneSimple(int src_width, int src_height,
   }
 }
 
-/**
- * Scale plane to/from any dimensions.
- */
-static void ScalePlaneAnySize(int src_width, int src_height,
-                              int dst_width, int dst_height,
-                              int src_stride, int dst_stride,
-                              const uint8* src_ptr, uint8* dst_ptr,
-                              FilterMode filtering) {
+// The functions that ScalePlane picks from.
+enum ScalePlaneMethod {
+  kCopyPlane,
+  kScalePlaneDown2,
+  kScalePlaneDown4,
+  kScalePlaneDown8,
+  kScalePlaneDown34,
+  kScalePlaneDown38,
+  kScalePlaneBox,
+  kScalePlaneBilinear,
+  kScalePlaneBilinearSimple,
+  kScalePlaneSimple
+};
+
+// Function names, indexed by ScalePlaneMethod.
+static const char* const kScalePlaneMethodNames[] = {
+  "CopyPlane",
+  "ScalePlaneDown2",
+  "ScalePlaneDown4",
+  "ScalePlaneDown8",
+  "ScalePlaneDown34",
+  "ScalePlaneDown38",
+  "ScalePlaneBox",
+  "ScalePlaneBilinear",
+  "ScalePlaneBilinearSimple",
+  "ScalePlaneSimple"
+};
+
+// Picks the function that ScalePlane and ExplainScalePlane use for these
+// sizes. Specialized scales improve performance for common resolutions,
+// for example all the 1/2 scalings use ScalePlaneDown2.
+static ScalePlaneMethod ChooseScalePlaneMethod(int src_width, int src_height,
+                                               int dst_width, int dst_height,
+                                               FilterMode filtering) {
+  if (dst_width == src_width && dst_height == src_height) {
+    // Straight copy.
+    return kCopyPlane;
+  }
+  const bool down = dst_width <= src_width && dst_height <= src_height;
+  // For testing, allow the optimized versions to be disabled.
+  if (down && !use_reference_impl_) {
+    if (4 * dst_width == 3 * src_width && 4 * dst_height == 3 * src_height) {
+      return kScalePlaneDown34;
+    }
+    if (2 * dst_width == src_width && 2 * dst_height == src_height) {
+      return kScalePlaneDown2;
+    }
+    // 3/8 rounded up for odd sized chroma height.
+    if (8 * dst_width == 3 * src_width &&
+        dst_height == ((src_height * 3 + 7) / 8)) {
+      return kScalePlaneDown38;
+    }
+    if (4 * dst_width == src_width && 4 * dst_height == src_height &&
+        filtering != kFilterBilinear) {
+      return kScalePlaneDown4;
+    }
+    if (8 * dst_width == src_width && 8 * dst_height == src_height &&
+        filtering != kFilterBilinear) {
+      return kScalePlaneDown8;
+    }
+  }
   if (!filtering) {
-    ScalePlaneSimple(src_width, src_height, dst_width, dst_height,
-                     src_stride, dst_stride, src_ptr, dst_ptr);
-  } else {
-    // fall back to non-optimized version
-    ScalePlaneBilinear(src_width, src_height, dst_width, dst_height,
-                       src_stride, dst_stride, src_ptr, dst_ptr);
+    return kScalePlaneSimple;
+  }
+  // An arbitrary scale down uses bilinear between 1/2x and 1x. It only
+  // takes ScalePlaneBox when src_height * 2 <= dst_height, which a scale
+  // down never has, so kFilterBox is bilinear too.
+  if (down && filtering != kFilterBilinear && src_height * 2 <= dst_height) {
+    return kScalePlaneBox;
+  }
+  if (!IS_ALIGNED(src_width, 8) || (src_width > kMaxInputWidth)) {
+    return kScalePlaneBilinearSimple;
+  }
+  return kScalePlaneBilinear;
+}
+
+// Sets choice to the row kernel that method runs. The checks follow the
+// function of method. Where it runs more than one row function the choice
+// is for the one that has SIMD versions.
+static void ExplainScalePlaneKernel(ScalePlaneMethod method,
+                                    const uint8* src, int src_stride,
+                                    int src_width, int src_height,
+                                    const uint8* dst, int dst_stride,
+                                    int dst_width, int dst_height,
+                                    FilterMode filtering,
+                                    KernelChoice* choice) {
+  const bool src_aligned = IS_ALIGNED(src, 16) && IS_ALIGNED(src_stride, 16);
+  const bool dst_aligned = IS_ALIGNED(dst, 16) && IS_ALIGNED(dst_stride, 16);
+  const char* path = kScalePlaneMethodNames[method];
+  // ChooseScalePlaneMethod never takes ScalePlaneBox for a scale down.
+  const bool box_fallback = filtering == kFilterBox &&
+      dst_width <= src_width && dst_height <= src_height;
+  switch (method) {
+    case kCopyPlane:
+      ExplainKernelC(choice, path, "CopyRow_C");
+#if defined(HAS_COPYROW_NEON)
+      if (TestCpuFlag(kCpuHasNEON)) {
+        ExplainKernel(choice, "CopyRow_NEON", IS_ALIGNED(dst_width, 64), true);
+      }
+#endif
+#if defined(HAS_COPYROW_X86)
+      if (TestCpuFlag(kCpuHasX86)) {
+        ExplainKernel(choice, "CopyRow_X86", IS_ALIGNED(dst_width, 4), true);
+      }
+#endif
+#if defined(HAS_COPYROW_SSE2)
+      if (TestCpuFlag(kCpuHasSSE2)) {
+        ExplainKernel(choice, "CopyRow_SSE2", IS_ALIGNED(dst_width, 32),
+                      src_aligned && dst_aligned);
+      }
+#endif
+      break;
+    case kScalePlaneDown2:
+      ExplainKernelC(choice, path,
+                     filtering ? "ScaleRowDown2Int_C" : "ScaleRowDown2_C");
+#if defined(HAS_SCALEROWDOWN2_NEON)
+      if (TestCpuFlag(kCpuHasNEON)) {
+        ExplainKernel(choice, filtering ? "ScaleRowDown2Int_NEON" :
+                      "ScaleRowDown2_NEON",
+                      IS_ALIGNED(dst_width, 16), true);
+      }
+#elif defined(HAS_SCALEROWDOWN2_SSE2)
+      if (TestCpuFlag(kCpuHasSSE2)) {
+        ExplainKernel(choice, filtering ? "ScaleRowDown2Int_Unaligned_SSE2" :
+                      "ScaleRowDown2_Unaligned_SSE2",
+                      IS_ALIGNED(dst_width, 16), true);
+        if (choice->simd) {
+          ExplainKernel(choice, filtering ? "ScaleRowDown2Int_SSE2" :
+                        "ScaleRowDown2_SSE2", true, src_aligned && dst_aligned);
+        }
+      }
+#endif
+      break;
+    case kScalePlaneDown4:
+      ExplainKernelC(choice, path,
+                     filtering ? "ScaleRowDown4Int_C" : "ScaleRowDown4_C");
+#if defined(HAS_SCALEROWDOWN4_NEON)
+      if (TestCpuFlag(kCpuHasNEON)) {
+        ExplainKernel(choice, filtering ? "ScaleRowDown4Int_NEON" :
+                      "ScaleRowDown4_NEON",
+                      IS_ALIGNED(dst_width, 4), true);
+      }
+#elif defined(HAS_SCALEROWDOWN4_SSE2)
+      if (TestCpuFlag(kCpuHasSSE2)) {
+        ExplainKernel(choice, filtering ? "ScaleRowDown4Int_SSE2" :
+                      "ScaleRowDown4_SSE2",
+                      IS_ALIGNED(dst_width, 8), src_aligned);
+      }
+#endif
+      break;
+    case kScalePlaneDown8:
+      ExplainKernelC(choice, path,
+                     filtering && (dst_width <= kMaxOutputWidth) ?
+                     "ScaleRowDown8Int_C" : "ScaleRowDown8_C");
+#if defined(HAS_SCALEROWDOWN8_SSE2)
+      if (TestCpuFlag(kCpuHasSSE2)) {
+        ExplainKernel(choice, filtering ? "ScaleRowDown8Int_SSE2" :
+                      "ScaleRowDown8_SSE2",
+                      IS_ALIGNED(dst_width, 4), src_aligned);
+      }
+#endif
+      break;
+    case kScalePlaneDown34:
+      ExplainKernelC(choice, path,
+                     filtering ? "ScaleRowDown34_0_Int_C" : "ScaleRowDown34_C");
+#if defined(HAS_SCALEROWDOWN34_NEON)
+      if (TestCpuFlag(kCpuHasNEON)) {
+        ExplainKernel(choice, filtering ? "ScaleRowDown34_0_Int_NEON" :
+                      "ScaleRowDown34_NEON", dst_width % 24 == 0, true);
+      }
+#endif
+#if defined(HAS_SCALEROWDOWN34_SSE2)
+      if (TestCpuFlag(kCpuHasSSE2) && filtering) {
+        ExplainKernel(choice, "ScaleRowDown34_0_Int_SSE2",
+                      dst_width % 24 == 0, src_aligned);
+      }
+#endif
+#if defined(HAS_SCALEROWDOWN34_SSSE3)
+      if (TestCpuFlag(kCpuHasSSSE3)) {
+        ExplainKernel(choice, filtering ? "ScaleRowDown34_0_Int_SSSE3" :
+                      "ScaleRowDown34_SSSE3", dst_width % 24 == 0, src_aligned);
+      }
+#endif
+      break;
+    case kScalePlaneDown38:
+      ExplainKernelC(choice, path,
+                     filtering ? "ScaleRowDown38_3_Int_C" : "ScaleRowDown38_C");
+#if defined(HAS_SCALEROWDOWN38_NEON)
+      if (TestCpuFlag(kCpuHasNEON)) {
+        ExplainKernel(choice, filtering ? "ScaleRowDown38_3_Int_NEON" :
+                      "ScaleRowDown38_NEON", dst_width % 12 == 0, true);
+      }
+#elif defined(HAS_SCALEROWDOWN38_SSSE3)
+      if (TestCpuFlag(kCpuHasSSSE3)) {
+        ExplainKernel(choice, filtering ? "ScaleRowDown38_3_Int_SSSE3" :
+                      "ScaleRowDown38_SSSE3", dst_width % 24 == 0, src_aligned);
+      }
+#endif
+      break;
+    case kScalePlaneBilinear:
+      ExplainKernelC(choice, path, "ScaleFilterRows_C");
+#if defined(HAS_SCALEFILTERROWS_NEON)
+      if (TestCpuFlag(kCpuHasNEON)) {
+        ExplainKernel(choice, "ScaleFilterRows_NEON", true, true);
+      }
+#endif
+#if defined(HAS_SCALEFILTERROWS_SSE2)
+      if (TestCpuFlag(kCpuHasSSE2)) {
+        ExplainKernel(choice, "ScaleFilterRows_SSE2", true, src_aligned);
+      }
+#endif
+#if defined(HAS_SCALEFILTERROWS_SSSE3)
+      if (TestCpuFlag(kCpuHasSSSE3)) {
+        ExplainKernel(choice, "ScaleFilterRows_SSSE3", true, src_aligned);
+      }
+#endif
+      if (choice->simd && box_fallback) {
+        choice->reason = "kFilterBox fell back to bilinear in ScalePlaneDown";
+      }
+      break;
+    default:
+      // ScalePlaneSimple, ScalePlaneBilinearSimple and ScalePlaneBox are
+      // written in C only, so the reason is why the path was taken.
+      ExplainKernelC(choice, path, path);
+      if (use_reference_impl_) {
+        choice->reason = "SetUseReferenceImpl(true) disables the specialized "
+                         "scalers";
+      } else if (method == kScalePlaneSimple) {
+        choice->reason = "point sampling is done in C";
+      } else if (method == kScalePlaneBox) {
+        choice->reason = "box filtering is done in C";
+      } else if (box_fallback) {
+        choice->reason = "kFilterBox fell back to bilinear in ScalePlaneDown, "
+                         "and src_width is not a multiple of 8 or over "
+                         "kMaxInputWidth";
+      } else {
+        choice->reason = "src_width is not a multiple of 8 or over "
+                         "kMaxInputWidth";
+      }
   }
 }
 
-/**
- * Scale plane down, any size
- *
- * This is an optimized version for scaling down a plane to any size.
- * The current implementation is ~10 times faster compared to the
- * reference implementation for e.g. XGA->LowResPAL
- *
- */
-static void ScalePlaneDown(int src_width, int src_height,
-                           int dst_width, int dst_height,
-                           int src_stride, int dst_stride,
-                           const uint8* src_ptr, uint8* dst_ptr,
-                           FilterMode filtering) {
-  if (!filtering) {
-    ScalePlaneSimple(src_width, src_height, dst_width, dst_height,
-                     src_stride, dst_stride, src_ptr, dst_ptr);
-  } else if (filtering == kFilterBilinear || src_height * 2 > dst_height) {
-    // between 1/2x and 1x use bilinear
-    ScalePlaneBilinear(src_width, src_height, dst_width, dst_height,
-                       src_stride, dst_stride, src_ptr, dst_ptr);
-  } else {
-    ScalePlaneBox(src_width, src_height, dst_width, dst_height,
-                  src_stride, dst_stride, src_ptr, dst_ptr);
+LIBYUV_API
+int ExplainScalePlane(const uint8* src, int src_stride,
+                      int src_width, int src_height,
+                      const uint8* dst, int dst_stride,
+                      int dst_width, int dst_height,
+                      FilterMode filtering, KernelChoice* choice) {
+  if (!choice || src_width <= 0 || src_height <= 0 ||
+      dst_width <= 0 || dst_height <= 0) {
+    return -1;
+  }
+#ifdef CPU_X86
+  // Same override as ScalePlane.
+  char *filter_override = getenv("LIBYUV_FILTER");
+  if (filter_override) {
+    filtering = (FilterMode)atoi(filter_override);  // NOLINT
   }
+#endif
+  const ScalePlaneMethod method =
+      ChooseScalePlaneMethod(src_width, src_height, dst_width, dst_height,
+                             filtering);
+  ExplainScalePlaneKernel(method, src, src_stride, src_width, src_height,
+                          dst, dst_stride, dst_width, dst_height,
+                          filtering, choice);
+  return 0;
 }
 
 // Scale a plane.
@@ -2863,52 +3093,53 @@ void ScalePlane(const uint8* src, int src_stride,
     filtering = (FilterMode)atoi(filter_override);  // NOLINT
   }
 #endif
-  // Use specialized scales to improve performance for common resolutions.
-  // For example, all the 1/2 scalings will use ScalePlaneDown2()
-  if (dst_width == src_width && dst_height == src_height) {
-    // Straight copy.
-    CopyPlane(src, src_stride, dst, dst_stride, dst_width, dst_height);
-  } else if (dst_width <= src_width && dst_height <= src_height) {
-    // Scale down.
-    if (use_reference_impl_) {
-      // For testing, allow the optimized versions to be disabled.
-      ScalePlaneDown(src_width, src_height, dst_width, dst_height,
-                     src_stride, dst_stride, src, dst, filtering);
-    } else if (4 * dst_width == 3 * src_width &&
-               4 * dst_height == 3 * src_height) {
-      // optimized, 3/4
-      ScalePlaneDown34(src_width, src_height, dst_width, dst_height,
-                       src_stride, dst_stride, src, dst, filtering);
-    } else if (2 * dst_width == src_width && 2 * dst_height == src_height) {
-      // optimized, 1/2
+  INSTRUMENT_START();
+  const ScalePlaneMethod method =
+      ChooseScalePlaneMethod(src_width, src_height, dst_width, dst_height,
+                             filtering);
+  switch (method) {
+    case kCopyPlane:
+      CopyPlane(src, src_stride, dst, dst_stride, dst_width, dst_height);
+      break;
+    case kScalePlaneDown2:
       ScalePlaneDown2(src_width, src_height, dst_width, dst_height,
                       src_stride, dst_stride, src, dst, filtering);
-    // 3/8 rounded up for odd sized chroma height.
-    } else if (8 * dst_width == 3 * src_width &&
-               dst_height == ((src_height * 3 + 7) / 8)) {
-      // optimized, 3/8
-      ScalePlaneDown38(src_width, src_height, dst_width, dst_height,
-                       src_stride, dst_stride, src, dst, filtering);
-    } else if (4 * dst_width == src_width && 4 * dst_height == src_height &&
-               filtering != kFilterBilinear) {
-      // optimized, 1/4
+      break;
+    case kScalePlaneDown4:
       ScalePlaneDown4(src_width, src_height, dst_width, dst_height,
                       src_stride, dst_stride, src, dst, filtering);
-    } else if (8 * dst_width == src_width && 8 * dst_height == src_height &&
-               filtering != kFilterBilinear) {
-      // optimized, 1/8
+      break;
+    case kScalePlaneDown8:
       ScalePlaneDown8(src_width, src_height, dst_width, dst_height,
                       src_stride, dst_stride, src, dst, filtering);
-    } else {
-      // Arbitrary downsample
-      ScalePlaneDown(src_width, src_height, dst_width, dst_height,
-                     src_stride, dst_stride, src, dst, filtering);
-    }
-  } else {
-    // Arbitrary scale up and/or down.
-    ScalePlaneAnySize(src_width, src_height, dst_width, dst_height,
-                      src_stride, dst_stride, src, dst, filtering);
-  }
+      break;
+    case kScalePlaneDown34:
+      ScalePlaneDown34(src_width, src_height, dst_width, dst_height,
+                       src_stride, dst_stride, src, dst, filtering);
+      break;
+    case kScalePlaneDown38:
+      ScalePlaneDown38(src_width, src_height, dst_width, dst_height,
+                       src_stride, dst_stride, src, dst, filtering);
+      break;
+    case kScalePlaneBox:
+      ScalePlaneBox(src_width, src_height, dst_width, dst_height,
+                    src_stride, dst_stride, src, dst);
+      break;
+    case kScalePlaneBilinear:
+      ScalePlaneBilinear(src_width, src_height, dst_width, dst_height,
+                         src_stride, dst_stride, src, dst);
+      break;
+    case kScalePlaneBilinearSimple:
+      ScalePlaneBilinearSimple(src_width, src_height, dst_width, dst_height,
+                               src_stride, dst_stride, src, dst);
+      break;
+    case kScalePlaneSimple:
+      ScalePlaneSimple(src_width, src_height, dst_width, dst_height,
+                       src_stride, dst_stride, src, dst);
+      break;
+  }
+  INSTRUMENT_STOP("ScalePlane", kScalePlaneMethodNames[method],
+                  dst_width, dst_height);
 }
 
 // Scale an I420 image.
@@ -2916,31 +3147,17 @@ void ScalePlane(const uint8* src, int src_stride,
 
 #define UNDER_ALLOCATED_HACK 1
 
-LIBYUV_API
-int I420Scale(const uint8* src_y, int src_stride_y,
-              const uint8* src_u, int src_stride_u,
-              const uint8* src_v, int src_stride_v,
-              int src_width, int src_height,
-              uint8* dst_y, int dst_stride_y,
-              uint8* dst_u, int dst_stride_u,
-              uint8* dst_v, int dst_stride_v,
-              int dst_width, int dst_height,
-              FilterMode filtering) {
-  if (!src_y || !src_u || !src_v || src_width <= 0 || src_height == 0 ||
-      !dst_y || !dst_u || !dst_v || dst_width <= 0 || dst_height <= 0) {
-    return -1;
-  }
-  // Negative height means invert the image.
-  if (src_height < 0) {
-    src_height = -src_height;
-    int halfheight = (src_height + 1) >> 1;
-    src_y = src_y + (src_height - 1) * src_stride_y;
-    src_u = src_u + (halfheight - 1) * src_stride_u;
-    src_v = src_v + (halfheight - 1) * src_stride_v;
-    src_stride_y = -src_stride_y;
-    src_stride_u = -src_stride_u;
-    src_stride_v = -src_stride_v;
-  }
+// Sizes of the chroma planes that I420Scale scales.
+static void I420ScaleHalfSizes(const uint8* src_u, int src_stride_u,
+                               const uint8* src_v,
+                               int src_width, int src_height,
+                               const uint8* dst_u, int dst_stride_u,
+                               const uint8* dst_v,
+                               int dst_width, int dst_height,
+                               int* src_halfwidth_out,
+                               int* src_halfheight_out,
+                               int* dst_halfwidth_out,
+                               int* dst_halfheight_out) {
   int src_halfwidth = (src_width + 1) >> 1;
   int src_halfheight = (src_height + 1) >> 1;
   int dst_halfwidth = (dst_width + 1) >> 1;
@@ -2967,6 +3184,42 @@ int I420Scale(const uint8* src_y, int src_stride_y,
     dst_halfheight = dst_height >> 1;
   }
 #endif
+  *src_halfwidth_out = src_halfwidth;
+  *src_halfheight_out = src_halfheight;
+  *dst_halfwidth_out = dst_halfwidth;
+  *dst_halfheight_out = dst_halfheight;
+}
+
+LIBYUV_API
+int I420Scale(const uint8* src_y, int src_stride_y,
+              const uint8* src_u, int src_stride_u,
+              const uint8* src_v, int src_stride_v,
+              int src_width, int src_height,
+              uint8* dst_y, int dst_stride_y,
+              uint8* dst_u, int dst_stride_u,
+              uint8* dst_v, int dst_stride_v,
+              int dst_width, int dst_height,
+              FilterMode filtering) {
+  if (!src_y || !src_u || !src_v || src_width <= 0 || src_height == 0 ||
+      !dst_y || !dst_u || !dst_v || dst_width <= 0 || dst_height <= 0) {
+    return -1;
+  }
+  // Negative height means invert the image.
+  if (src_height < 0) {
+    src_height = -src_height;
+    int halfheight = (src_height + 1) >> 1;
+    src_y = src_y + (src_height - 1) * src_stride_y;
+    src_u = src_u + (halfheight - 1) * src_stride_u;
+    src_v = src_v + (halfheight - 1) * src_stride_v;
+    src_stride_y = -src_stride_y;
+    src_stride_u = -src_stride_u;
+    src_stride_v = -src_stride_v;
+  }
+  int src_halfwidth, src_halfheight, dst_halfwidth, dst_halfheight;
+  I420ScaleHalfSizes(src_u, src_stride_u, src_v, src_width, src_height,
+                     dst_u, dst_stride_u, dst_v, dst_width, dst_height,
+                     &src_halfwidth, &src_halfheight,
+                     &dst_halfwidth, &dst_halfheight);
 
   ScalePlane(src_y, src_stride_y, src_width, src_height,
              dst_y, dst_stride_y, dst_width, dst_height,
@@ -2980,6 +3233,48 @@ int I420Scale(const uint8* src_y, int src_stride_y,
   return 0;
 }
 
+LIBYUV_API
+int ExplainI420Scale(const uint8* src_y, int src_stride_y,
+                     const uint8* src_u, int src_stride_u,
+                     const uint8* src_v, int src_stride_v,
+                     int src_width, int src_height,
+                     const uint8* dst_y, int dst_stride_y,
+                     const uint8* dst_u, int dst_stride_u,
+                     const uint8* dst_v, int dst_stride_v,
+                     int dst_width, int dst_height,
+                     FilterMode filtering, KernelChoice choices[3]) {
+  if (!src_y || !src_u || !src_v || src_width <= 0 || src_height == 0 ||
+      !dst_y || !dst_u || !dst_v || dst_width <= 0 || dst_height <= 0 ||
+      !choices) {
+    return -1;
+  }
+  if (src_height < 0) {
+    src_height = -src_height;
+    int halfheight = (src_height + 1) >> 1;
+    src_y = src_y + (src_height - 1) * src_stride_y;
+    src_u = src_u + (halfheight - 1) * src_stride_u;
+    src_v = src_v + (halfheight - 1) * src_stride_v;
+    src_stride_y = -src_stride_y;
+    src_stride_u = -src_stride_u;
+    src_stride_v = -src_stride_v;
+  }
+  int src_halfwidth, src_halfheight, dst_halfwidth, dst_halfheight;
+  I420ScaleHalfSizes(src_u, src_stride_u, src_v, src_width, src_height,
+                     dst_u, dst_stride_u, dst_v, dst_width, dst_height,
+                     &src_halfwidth, &src_halfheight,
+                     &dst_halfwidth, &dst_halfheight);
+  ExplainScalePlane(src_y, src_stride_y, src_width, src_height,
+                    dst_y, dst_stride_y, dst_width, dst_height,
+                    filtering, &choices[0]);
+  ExplainScalePlane(src_u, src_stride_u, src_halfwidth, src_halfheight,
+                    dst_u, dst_stride_u, dst_halfwidth, dst_halfheight,
+                    filtering, &choices[1]);
+  ExplainScalePlane(src_v, src_stride_v, src_halfwidth, src_halfheight,
+                    dst_v, dst_stride_v, dst_halfwidth, dst_halfheight,
+                    filtering, &choices[2]);
+  return 0;
+}
+
 // Deprecated api
 LIBYUV_API
 int Scale(const uint8* src_y, const uint8* src_u, const uint8* src_v,
@@ -3074,6 +3369,374 @@ int ScaleOffset(const uint8* src, int src_width, int src_height,
                dst_halfwidth, dst_halfwidth, dst_width, aheight, interpolate);
 }
 
+// Rotate and scale in one pass.
+// Rows of the rotated image are produced on demand into a small window of
+// 16 byte aligned rows, which the scalers then read as their source.
+// Rotating by 90 or 270 transposes a band of source columns at a time, so
+// no rotated intermediate frame is written.
+
+// Number of rotated rows produced per window refill.
+static const int kRotateScaleRows = 32;
+
+struct RotatedPlane {
+  const uint8* src;
+  int src_stride;
+  int src_width;   // Source width in pixels; UV pairs if interleaved.
+  int src_height;
+  bool interleaved;  // NV12 style UV. Rows are split into 2 windows.
+  RotationMode mode;
+  int width;   // Width after rotation.
+  int height;  // Height after rotation.
+};
+
+// Produce rotated rows [y, y + rows) into dst_a (and dst_b if interleaved).
+static void RotatedPlaneRows(const RotatedPlane* p, int y, int rows,
+                             uint8* dst_a, uint8* dst_b, int dst_stride) {
+  switch (p->mode) {
+    case kRotate90:
+      // Rotated row y is source column y, read bottom to top.
+      if (p->interleaved) {
+        RotateUV90(p->src + y * 2, p->src_stride,
+                   dst_a, dst_stride, dst_b, dst_stride,
+                   rows, p->src_height);
+      } else {
+        RotatePlane90(p->src + y, p->src_stride, dst_a, dst_stride,
+                      rows, p->src_height);
+      }
+      break;
+    case kRotate270: {
+      // Rotated row y is source column (width - 1 - y), read top to bottom.
+      int x = p->src_width - y - rows;
+      if (p->interleaved) {
+        RotateUV270(p->src + x * 2, p->src_stride,
+                    dst_a, dst_stride, dst_b, dst_stride,
+                    rows, p->src_height);
+      } else {
+        RotatePlane270(p->src + x, p->src_stride, dst_a, dst_stride,
+                       rows, p->src_height);
+      }
+      break;
+    }
+    case kRotate180: {
+      const uint8* src = p->src + (p->src_height - y - rows) * p->src_stride;
+      if (p->interleaved) {
+        RotateUV180(src, p->src_stride, dst_a, dst_stride, dst_b, dst_stride,
+                    p->src_width, rows);
+      } else {
+        RotatePlane180(src, p->src_stride, dst_a, dst_stride,
+                       p->src_width, rows);
+      }
+      break;
+    }
+    default: {
+      const uint8* src = p->src + y * p->src_stride;
+      if (p->interleaved) {
+        void (*SplitUV)(const uint8* src_uv, uint8* dst_u, uint8* dst_v,
+                        int pix) = SplitUV_C;
+#if defined(HAS_SPLITUV_NEON)
+        if (TestCpuFlag(kCpuHasNEON) && IS_ALIGNED(p->src_width, 16)) {
+          SplitUV = SplitUV_NEON;
+        }
+#elif defined(HAS_SPLITUV_SSE2)
+        if (TestCpuFlag(kCpuHasSSE2) && IS_ALIGNED(p->src_width, 16) &&
+            IS_ALIGNED(src, 16) && IS_ALIGNED(p->src_stride, 16)) {
+          SplitUV = SplitUV_SSE2;
+        }
+#endif
+        for (int i = 0; i < rows; ++i) {
+          SplitUV(src, dst_a, dst_b, p->src_width);
+          src += p->src_stride;
+          dst_a += dst_stride;
+          dst_b += dst_stride;
+        }
+      } else {
+        CopyPlane(src, p->src_stride, dst_a, dst_stride, p->src_width, rows);
+      }
+      break;
+    }
+  }
+}
+
+// Scale a rotated plane into dst_a (and dst_b if interleaved).
+// Point sampling and bilinear match ScalePlaneSimple and ScalePlaneBilinear.
+// Box differs from ScalePlaneBox in tiling from the top left, which gives
+// the boxes of ScalePlaneDown2 and ScalePlaneDown4 for 2x and 4x.
+static void ScaleRotatedPlane(const RotatedPlane* p,
+                              uint8* dst_a, int dst_stride_a,
+                              uint8* dst_b, int dst_stride_b,
+                              int dst_width, int dst_height,
+                              FilterMode filtering) {
+  const int src_width = p->width;
+  const int src_height = p->height;
+  const bool box = filtering == kFilterBox && dst_width <= src_width &&
+                   dst_height * 2 <= src_height;
+  int dx = (src_width << 16) / dst_width;
+  int dy = (src_height << 16) / dst_height;
+  int x = (dx >= 65536) ? ((dx >> 1) - 32768) : (dx >> 1);
+  int y = (dy >= 65536) ? ((dy >> 1) - 32768) : (dy >> 1);
+  int maxy = (src_height > 1) ? ((src_height - 1) << 16) - 1 : 0;
+  if (box) {
+    // Boxes tile the source from the top left so none reads past the edge.
+    x = 0;
+    y = 0;
+    maxy = src_height << 16;
+  }
+
+  int win_rows = kRotateScaleRows;
+  if (box && (dy >> 16) + 2 > win_rows) {
+    win_rows = (dy >> 16) + 2;
+  }
+  // Padding lets the row functions run whole vectors past the width, and
+  // the extra row is read with a zero fraction by the bilinear filter on
+  // a single row image.
+  const int win_stride = (src_width + 15) & ~15;
+  const int win_size = win_stride * (win_rows + 1);
+  uint8* win_mem = new uint8[win_size * (p->interleaved ? 2 : 1) + 15];
+  uint8* win_a = ALIGNP(win_mem, 16);
+  uint8* win_b = win_a + win_size;
+  memset(win_a, 0, win_size * (p->interleaved ? 2 : 1));
+
+  void (*ScaleFilterRows)(uint8* dst_ptr, const uint8* src_ptr,
+                          ptrdiff_t src_stride,
+                          int dst_width, int source_y_fraction) =
+      ScaleFilterRows_C;
+#if defined(HAS_SCALEFILTERROWS_NEON)
+  if (TestCpuFlag(kCpuHasNEON)) {
+    ScaleFilterRows = ScaleFilterRows_NEON;
+  }
+#endif
+#if defined(HAS_SCALEFILTERROWS_SSE2)
+  if (TestCpuFlag(kCpuHasSSE2)) {
+    ScaleFilterRows = ScaleFilterRows_SSE2;
+  }
+#endif
+#if defined(HAS_SCALEFILTERROWS_SSSE3)
+  if (TestCpuFlag(kCpuHasSSSE3)) {
+    ScaleFilterRows = ScaleFilterRows_SSSE3;
+  }
+#endif
+  void (*ScaleAddRows)(const uint8* src_ptr, ptrdiff_t src_stride,
+                       uint16* dst_ptr, int src_width, int src_height) =
+      ScaleAddRows_C;
+#if defined(HAS_SCALEADDROWS_SSE2)
+  if (TestCpuFlag(kCpuHasSSE2)) {
+    ScaleAddRows = ScaleAddRows_SSE2;
+  }
+#endif
+  void (*ScaleAddCols)(int dst_width, int boxheight, int x, int dx,
+                       const uint16* src_ptr, uint8* dst_ptr) =
+      (dx & 0xffff) ? ScaleAddCols2_C : ScaleAddCols1_C;
+
+  SIMD_ALIGNED(uint8 row[kMaxInputWidth + 16]);
+  SIMD_ALIGNED(uint16 sumrow[kMaxInputWidth + 16]);
+  int win_y = 0;
+  int win_n = 0;
+  for (int j = 0; j < dst_height; ++j) {
+    int iy = y >> 16;
+    int yf = (y >> 8) & 255;
+    y += dy;
+    if (y > maxy) {
+      y = maxy;
+    }
+    int rows = 1;
+    if (box) {
+      rows = (y >> 16) - iy;
+    } else if (filtering != kFilterNone && iy + 1 < src_height) {
+      rows = 2;
+    }
+    if (iy < win_y || iy + rows > win_y + win_n) {
+      win_y = iy;
+      win_n = src_height - iy;
+      if (win_n > win_rows) {
+        win_n = win_rows;
+      }
+      RotatedPlaneRows(p, win_y, win_n, win_a, win_b, win_stride);
+    }
+    for (int i = 0; i < (p->interleaved ? 2 : 1); ++i) {
+      const uint8* src = (i ? win_b : win_a) + (iy - win_y) * win_stride;
+      uint8* dst = i ? dst_b + j * dst_stride_b : dst_a + j * dst_stride_a;
+      if (box) {
+        ScaleAddRows(src, win_stride, sumrow, src_width, rows);
+        ScaleAddCols(dst_width, rows, x, dx, sumrow, dst);
+      } else if (filtering != kFilterNone) {
+        ScaleFilterRows(row, src, win_stride, src_width, yf);
+        row[src_width] = row[src_width - 1];
+        ScaleFilterCols_C(dst, row, dst_width, x, dx);
+      } else {
+        int xs = x;
+        for (int k = 0; k < dst_width; ++k) {
+          dst[k] = src[xs >> 16];
+          xs += dx;
+        }
+      }
+    }
+  }
+  delete [] win_mem;
+}
+
+static void RotateScalePlane(const uint8* src, int src_stride,
+                             int src_width, int src_height, bool interleaved,
+                             uint8* dst_a, int dst_stride_a,
+                             uint8* dst_b, int dst_stride_b,
+                             int dst_width, int dst_height,
+                             RotationMode mode, FilterMode filtering) {
+  RotatedPlane p;
+  p.src = src;
+  p.src_stride = src_stride;
+  p.src_width = src_width;
+  p.src_height = src_height;
+  p.interleaved = interleaved;
+  p.mode = mode;
+  if (mode == kRotate90 || mode == kRotate270) {
+    p.width = src_height;
+    p.height = src_width;
+  } else {
+    p.width = src_width;
+    p.height = src_height;
+  }
+  ScaleRotatedPlane(&p, dst_a, dst_stride_a, dst_b, dst_stride_b,
+                    dst_width, dst_height, filtering);
+}
+
+LIBYUV_API
+int I420RotateScale(const uint8* src_y, int src_stride_y,
+                    const uint8* src_u, int src_stride_u,
+                    const uint8* src_v, int src_stride_v,
+                    int src_width, int src_height,
+                    uint8* dst_y, int dst_stride_y,
+                    uint8* dst_u, int dst_stride_u,
+                    uint8* dst_v, int dst_stride_v,
+                    int dst_width, int dst_height,
+                    RotationMode mode, FilterMode filtering) {
+  if (!src_y || !src_u || !src_v || src_width <= 0 || src_height == 0 ||
+      !dst_y || !dst_u || !dst_v || dst_width <= 0 || dst_height <= 0 ||
+      (mode != kRotate0 && mode != kRotate90 &&
+       mode != kRotate180 && mode != kRotate270)) {
+    return -1;
+  }
+  if (mode == kRotate0) {
+    return I420Scale(src_y, src_stride_y, src_u, src_stride_u,
+                     src_v, src_stride_v, src_width, src_height,
+                     dst_y, dst_stride_y, dst_u, dst_stride_u,
+                     dst_v, dst_stride_v, dst_width, dst_height, filtering);
+  }
+  // Negative height means invert the image.
+  if (src_height < 0) {
+    src_height = -src_height;
+    int halfheight = (src_height + 1) >> 1;
+    src_y = src_y + (src_height - 1) * src_stride_y;
+    src_u = src_u + (halfheight - 1) * src_stride_u;
+    src_v = src_v + (halfheight - 1) * src_stride_v;
+    src_stride_y = -src_stride_y;
+    src_stride_u = -src_stride_u;
+    src_stride_v = -src_stride_v;
+  }
+  int src_halfwidth = (src_width + 1) >> 1;
+  int src_halfheight = (src_height + 1) >> 1;
+  int dst_halfwidth = (dst_width + 1) >> 1;
+  int dst_halfheight = (dst_height + 1) >> 1;
+  int rotated_width = (mode == kRotate180) ? src_width : src_height;
+  if (rotated_width > kMaxInputWidth) {
+    // Too wide for the row buffers. Rotate into a frame and scale that.
+    int rotated_height = (mode == kRotate180) ? src_height : src_width;
+    int rotated_halfwidth = (rotated_width + 1) >> 1;
+    int rotated_halfheight = (rotated_height + 1) >> 1;
+    int y_size = rotated_width * rotated_height;
+    int uv_size = rotated_halfwidth * rotated_halfheight;
+    uint8* buf = new uint8[y_size + uv_size * 2];
+    I420Rotate(src_y, src_stride_y, src_u, src_stride_u, src_v, src_stride_v,
+               buf, rotated_width,
+               buf + y_size, rotated_halfwidth,
+               buf + y_size + uv_size, rotated_halfwidth,
+               src_width, src_height, mode);
+    I420Scale(buf, rotated_width,
+              buf + y_size, rotated_halfwidth,
+              buf + y_size + uv_size, rotated_halfwidth,
+              rotated_width, rotated_height,
+              dst_y, dst_stride_y, dst_u, dst_stride_u, dst_v, dst_stride_v,
+              dst_width, dst_height, filtering);
+    delete [] buf;
+    return 0;
+  }
+  RotateScalePlane(src_y, src_stride_y, src_width, src_height, false,
+                   dst_y, dst_stride_y, NULL, 0,
+                   dst_width, dst_height, mode, filtering);
+  RotateScalePlane(src_u, src_stride_u, src_halfwidth, src_halfheight, false,
+                   dst_u, dst_stride_u, NULL, 0,
+                   dst_halfwidth, dst_halfheight, mode, filtering);
+  RotateScalePlane(src_v, src_stride_v, src_halfwidth, src_halfheight, false,
+                   dst_v, dst_stride_v, NULL, 0,
+                   dst_halfwidth, dst_halfheight, mode, filtering);
+  return 0;
+}
+
+LIBYUV_API
+int NV12ToI420RotateScale(const uint8* src_y, int src_stride_y,
+                          const uint8* src_uv, int src_stride_uv,
+                          int src_width, int src_height,
+                          uint8* dst_y, int dst_stride_y,
+                          uint8* dst_u, int dst_stride_u,
+                          uint8* dst_v, int dst_stride_v,
+                          int dst_width, int dst_height,
+                          RotationMode mode, FilterMode filtering) {
+  if (!src_y || !src_uv || src_width <= 0 || src_height == 0 ||
+      !dst_y || !dst_u || !dst_v || dst_width <= 0 || dst_height <= 0 ||
+      (mode != kRotate0 && mode != kRotate90 &&
+       mode != kRotate180 && mode != kRotate270)) {
+    return -1;
+  }
+  // Negative height means invert the image.
+  if (src_height < 0) {
+    src_height = -src_height;
+    int halfheight = (src_height + 1) >> 1;
+    src_y = src_y + (src_height - 1) * src_stride_y;
+    src_uv = src_uv + (halfheight - 1) * src_stride_uv;
+    src_stride_y = -src_stride_y;
+    src_stride_uv = -src_stride_uv;
+  }
+  int src_halfwidth = (src_width + 1) >> 1;
+  int src_halfheight = (src_height + 1) >> 1;
+  int dst_halfwidth = (dst_width + 1) >> 1;
+  int dst_halfheight = (dst_height + 1) >> 1;
+  int rotated_width = (mode == kRotate90 || mode == kRotate270) ?
+      src_height : src_width;
+  if (rotated_width > kMaxInputWidth) {
+    // Too wide for the row buffers. Rotate into a frame and scale that.
+    int rotated_height = (mode == kRotate90 || mode == kRotate270) ?
+        src_width : src_height;
+    int rotated_halfwidth = (rotated_width + 1) >> 1;
+    int rotated_halfheight = (rotated_height + 1) >> 1;
+    int y_size = rotated_width * rotated_height;
+    int uv_size = rotated_halfwidth * rotated_halfheight;
+    uint8* buf = new uint8[y_size + uv_size * 2];
+    NV12ToI420Rotate(src_y, src_stride_y, src_uv, src_stride_uv,
+                     buf, rotated_width,
+                     buf + y_size, rotated_halfwidth,
+                     buf + y_size + uv_size, rotated_halfwidth,
+                     src_width, src_height, mode);
+    I420Scale(buf, rotated_width,
+              buf + y_size, rotated_halfwidth,
+              buf + y_size + uv_size, rotated_halfwidth,
+              rotated_width, rotated_height,
+              dst_y, dst_stride_y, dst_u, dst_stride_u, dst_v, dst_stride_v,
+              dst_width, dst_height, filtering);
+    delete [] buf;
+    return 0;
+  }
+  if (mode == kRotate0) {
+    ScalePlane(src_y, src_stride_y, src_width, src_height,
+               dst_y, dst_stride_y, dst_width, dst_height, filtering);
+  } else {
+    RotateScalePlane(src_y, src_stride_y, src_width, src_height, false,
+                     dst_y, dst_stride_y, NULL, 0,
+                     dst_width, dst_height, mode, filtering);
+  }
+  RotateScalePlane(src_uv, src_stride_uv, src_halfwidth, src_halfheight, true,
+                   dst_u, dst_stride_u, dst_v, dst_stride_v,
+                   dst_halfwidth, dst_halfheight, mode, filtering);
+  return 0;
+}
+
 #ifdef __cplusplus
 }  // extern "C"
 }  // namespace libyuv
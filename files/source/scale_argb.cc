@@ -8,15 +8,17 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
-#include "libyuv/scale.h"
+#include "libyuv/scale_argb.h"
 
 #include <assert.h>
 #include <string.h>
 #include <stdlib.h>  // For getenv()
 
 #include "libyuv/cpu_id.h"
+#include "libyuv/frame.h"
 #include "libyuv/planar_functions.h"  // For CopyARGB
 #include "libyuv/row.h"
+#include "libyuv/video_common.h"
 
 #ifdef __cplusplus
 namespace libyuv {
@@ -969,13 +971,6 @@ static void ScaleARGB(const uint8* src, int src_stride,
                       uint8* dst, int dst_stride,
                       int dst_width, int dst_height,
                       FilterMode filtering) {
-#ifdef CPU_X86
-  // environment variable overrides for testing.
-  char *filter_override = getenv("LIBYUV_FILTER");
-  if (filter_override) {
-    filtering = (FilterMode)atoi(filter_override);  // NOLINT
-  }
-#endif
   if (dst_width == src_width && dst_height == src_height) {
     // Straight copy.
     ARGBCopy(src, src_stride, dst, dst_stride, dst_width, dst_height);
@@ -1006,6 +1001,48 @@ static void ScaleARGB(const uint8* src, int src_stride,
                    src_stride, dst_stride, src, dst, filtering);
 }
 
+#ifdef LIBYUV_INSTRUMENT
+// Name of the function that ScaleARGB uses for these sizes. The checks
+// follow ScaleARGB and ScaleARGBAnySize.
+static const char* ScaleARGBPath(int src_width, int src_height,
+                                 int dst_width, int dst_height,
+                                 FilterMode filtering) {
+  if (dst_width == src_width && dst_height == src_height) {
+    return "ARGBCopy";
+  }
+  if (2 * dst_width == src_width && 2 * dst_height == src_height) {
+    return "ScaleARGBDown2";
+  }
+  const int scale_down_x = src_width / dst_width;
+  const int scale_down_y = src_height / dst_height;
+  if (dst_width * scale_down_x == src_width &&
+      dst_height * scale_down_y == src_height) {
+    if (!(scale_down_x & 1) && !(scale_down_y & 1)) {
+      return "ScaleARGBDownEven";
+    }
+    if ((scale_down_x & 1) && (scale_down_y & 1)) {
+      filtering = kFilterNone;
+    }
+  }
+  if (!filtering || (src_width > kMaxInputWidth)) {
+    return "ScaleARGBSimple";
+  }
+  return "ScaleARGBBilinear";
+}
+#endif
+
+// Returns filtering, or the filter mode set by the LIBYUV_FILTER
+// environment variable, for testing.
+static FilterMode FilterOverride(FilterMode filtering) {
+#ifdef CPU_X86
+  char *filter_override = getenv("LIBYUV_FILTER");
+  if (filter_override) {
+    filtering = (FilterMode)atoi(filter_override);  // NOLINT
+  }
+#endif
+  return filtering;
+}
+
 // ScaleARGB an ARGB image.
 LIBYUV_API
 int ARGBScale(const uint8* src_argb, int src_stride_argb,
@@ -1025,7 +1062,58 @@ int ARGBScale(const uint8* src_argb, int src_stride_argb,
   }
   ScaleARGB(src_argb, src_stride_argb, src_width, src_height,
             dst_argb, dst_stride_argb, dst_width, dst_height,
-            filtering);
+            FilterOverride(filtering));
+  return 0;
+}
+
+struct ARGBScaleBatchParam {
+  const YuvFrame* src_frames;
+  YuvFrame* dst_frames;
+  FilterMode filtering;
+};
+
+// Scales frames first to first + count - 1, as a band of RunFrameBands.
+static void ScaleARGBFrames(void* param, int first, int count) {
+  const ARGBScaleBatchParam* p =
+      static_cast<const ARGBScaleBatchParam*>(param);
+  for (int i = first; i < first + count; ++i) {
+    const YuvFrame& src = p->src_frames[i];
+    const YuvFrame& dst = p->dst_frames[i];
+    INSTRUMENT_START();
+    ScaleARGB(src.plane[0], src.stride[0], src.width, src.height,
+              dst.plane[0], dst.stride[0], dst.width, dst.height,
+              p->filtering);
+    // Each frame is its own call, so the path recorded is the one its
+    // sizes chose.
+    INSTRUMENT_STOP("ARGBScaleBatch",
+                    ScaleARGBPath(src.width, src.height,
+                                  dst.width, dst.height, p->filtering),
+                    dst.width, dst.height);
+  }
+}
+
+// Scale ARGB frames, each to the size of its destination frame.
+LIBYUV_API
+int ARGBScaleBatch(const YuvFrame* src_frames, YuvFrame* dst_frames,
+                   int count, FilterMode filtering, int num_threads) {
+  if (!src_frames || !dst_frames || count <= 0) {
+    return -1;
+  }
+  for (int i = 0; i < count; ++i) {
+    const YuvFrame& src = src_frames[i];
+    const YuvFrame& dst = dst_frames[i];
+    if (src.fourcc != FOURCC_ARGB || dst.fourcc != FOURCC_ARGB ||
+        !src.plane[0] || !dst.plane[0] ||
+        src.width <= 0 || src.height <= 0 ||
+        dst.width <= 0 || dst.height <= 0) {
+      return -1;
+    }
+  }
+  ARGBScaleBatchParam p;
+  p.src_frames = src_frames;
+  p.dst_frames = dst_frames;
+  p.filtering = FilterOverride(filtering);
+  RunFrameBands(ScaleARGBFrames, &p, count, num_threads);
   return 0;
 }
 
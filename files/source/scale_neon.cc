@@ -69,6 +69,35 @@ void ScaleRowDown2Int_NEON(const uint8* src_ptr, ptrdiff_t src_stride,
    );
 }
 
+// Blends 16x2 UV pixels to 8x1.
+void ScaleUVRowDown2Int_NEON(const uint8* src_ptr, ptrdiff_t src_stride,
+                             uint8* dst, int dst_width) {
+  asm volatile (
+    // change the stride to row 2 pointer
+    "add        %1, %0                         \n"
+    "1:                                        \n"
+    "vld4.u8    {d0, d1, d2, d3}, [%0]!        \n"  // load row 1 UVUV
+    "vld4.u8    {d4, d5, d6, d7}, [%1]!        \n"  // load row 2 UVUV
+    "vaddl.u8   q8, d0, d2                     \n"  // row 1 add adjacent U
+    "vaddl.u8   q9, d1, d3                     \n"  // row 1 add adjacent V
+    "vaddw.u8   q8, q8, d4                     \n"  // add row 2 U
+    "vaddw.u8   q9, q9, d5                     \n"  // add row 2 V
+    "vaddw.u8   q8, q8, d6                     \n"
+    "vaddw.u8   q9, q9, d7                     \n"
+    "vrshrn.u16 d0, q8, #2                     \n"  // downshift, round and pack
+    "vrshrn.u16 d1, q9, #2                     \n"
+    "vst2.u8    {d0, d1}, [%2]!                \n"  // store 8 UV pixels
+    "subs       %3, %3, #8                     \n"  // 8 processed per loop
+    "bgt        1b                             \n"
+    : "+r"(src_ptr),          // %0
+      "+r"(src_stride),       // %1
+      "+r"(dst),              // %2
+      "+r"(dst_width)         // %3
+    :
+    : "memory", "cc", "q0", "q1", "q2", "q3", "q8", "q9"  // Clobber List
+   );
+}
+
 void ScaleRowDown4_NEON(const uint8* src_ptr, ptrdiff_t /* src_stride */,
                         uint8* dst_ptr, int dst_width) {
   asm volatile (
@@ -0,0 +1,153 @@
+/*
+ *  Copyright 2012 The LibYuv Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "libyuv/basic_types.h"
+#include "libyuv/row.h"
+
+#if !defined(YUV_DISABLE_ASM) && defined(LIBYUV_SSE2) && \
+    (defined(__x86_64__) || defined(__i386__))
+#include <emmintrin.h>
+#endif
+
+#ifdef __cplusplus
+namespace libyuv {
+extern "C" {
+#endif
+
+// This module is for GCC x86 and x64 builds that compile the intrinsics
+// kernels and define LIBYUV_SSE2. The functions here replace the inline
+// assembly versions in scale.cc and are bit exact with them.
+#if !defined(YUV_DISABLE_ASM) && defined(LIBYUV_SSE2) && \
+    (defined(__x86_64__) || defined(__i386__))
+
+static __inline __m128i Load(const uint8* p, bool aligned) {
+  return aligned ? _mm_load_si128(reinterpret_cast<const __m128i*>(p)) :
+                   _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+
+// Averages each pair of pixels, rounding up.
+static __inline __m128i AverageHorizontal(__m128i v) {
+  const __m128i kMaskLo = _mm_set1_epi16(0x00ff);
+  return _mm_avg_epu16(_mm_srli_epi16(v, 8), _mm_and_si128(v, kMaskLo));
+}
+
+// Reads 32 pixels, throws half away and writes 16 pixels.
+static __inline void ScaleRowDown2(const uint8* src_ptr, uint8* dst_ptr,
+                                   int dst_width, bool aligned) {
+  const __m128i kMaskLo = _mm_set1_epi16(0x00ff);
+  for (; dst_width > 0; dst_width -= 16) {
+    __m128i p0 = _mm_and_si128(Load(src_ptr, aligned), kMaskLo);
+    __m128i p1 = _mm_and_si128(Load(src_ptr + 16, aligned), kMaskLo);
+    __m128i* dst = reinterpret_cast<__m128i*>(dst_ptr);
+    if (aligned) {
+      _mm_store_si128(dst, _mm_packus_epi16(p0, p1));
+    } else {
+      _mm_storeu_si128(dst, _mm_packus_epi16(p0, p1));
+    }
+    src_ptr += 32;
+    dst_ptr += 16;
+  }
+}
+
+// Blends 32x2 rectangle to 16x1.
+static __inline void ScaleRowDown2Int(const uint8* src_ptr,
+                                      ptrdiff_t src_stride,
+                                      uint8* dst_ptr, int dst_width,
+                                      bool aligned) {
+  for (; dst_width > 0; dst_width -= 16) {
+    __m128i p0 = _mm_avg_epu8(Load(src_ptr, aligned),
+                              Load(src_ptr + src_stride, aligned));
+    __m128i p1 = _mm_avg_epu8(Load(src_ptr + 16, aligned),
+                              Load(src_ptr + src_stride + 16, aligned));
+    __m128i d = _mm_packus_epi16(AverageHorizontal(p0), AverageHorizontal(p1));
+    __m128i* dst = reinterpret_cast<__m128i*>(dst_ptr);
+    if (aligned) {
+      _mm_store_si128(dst, d);
+    } else {
+      _mm_storeu_si128(dst, d);
+    }
+    src_ptr += 32;
+    dst_ptr += 16;
+  }
+}
+
+void ScaleRowDown2_SSE2(const uint8* src_ptr, ptrdiff_t /* src_stride */,
+                        uint8* dst_ptr, int dst_width) {
+  ScaleRowDown2(src_ptr, dst_ptr, dst_width, true);
+}
+
+void ScaleRowDown2Int_SSE2(const uint8* src_ptr, ptrdiff_t src_stride,
+                           uint8* dst_ptr, int dst_width) {
+  ScaleRowDown2Int(src_ptr, src_stride, dst_ptr, dst_width, true);
+}
+
+void ScaleRowDown2_Unaligned_SSE2(const uint8* src_ptr,
+                                  ptrdiff_t /* src_stride */,
+                                  uint8* dst_ptr, int dst_width) {
+  ScaleRowDown2(src_ptr, dst_ptr, dst_width, false);
+}
+
+void ScaleRowDown2Int_Unaligned_SSE2(const uint8* src_ptr,
+                                     ptrdiff_t src_stride,
+                                     uint8* dst_ptr, int dst_width) {
+  ScaleRowDown2Int(src_ptr, src_stride, dst_ptr, dst_width, false);
+}
+
+// Point samples 32 pixels to 8 pixels.
+// Alignment requirement: src_ptr 16 byte aligned.
+void ScaleRowDown4_SSE2(const uint8* src_ptr, ptrdiff_t /* src_stride */,
+                        uint8* dst_ptr, int dst_width) {
+  const __m128i kMaskByte0 = _mm_set1_epi32(0x000000ff);
+  for (; dst_width > 0; dst_width -= 8) {
+    const __m128i* src = reinterpret_cast<const __m128i*>(src_ptr);
+    __m128i p0 = _mm_and_si128(_mm_load_si128(src), kMaskByte0);
+    __m128i p1 = _mm_and_si128(_mm_load_si128(src + 1), kMaskByte0);
+    p0 = _mm_packus_epi16(p0, p1);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst_ptr),
+                     _mm_packus_epi16(p0, p0));
+    src_ptr += 32;
+    dst_ptr += 8;
+  }
+}
+
+// Blends 32x4 rectangle to 8x1.
+// Alignment requirement: src_ptr 16 byte aligned.
+void ScaleRowDown4Int_SSE2(const uint8* src_ptr, ptrdiff_t src_stride,
+                           uint8* dst_ptr, int dst_width) {
+  for (; dst_width > 0; dst_width -= 8) {
+    const __m128i* src0 = reinterpret_cast<const __m128i*>(src_ptr);
+    const __m128i* src1 =
+        reinterpret_cast<const __m128i*>(src_ptr + src_stride);
+    const __m128i* src2 =
+        reinterpret_cast<const __m128i*>(src_ptr + src_stride * 2);
+    const __m128i* src3 =
+        reinterpret_cast<const __m128i*>(src_ptr + src_stride * 3);
+    // Rows 0 and 1 and rows 2 and 3 are averaged first, then the two pairs.
+    __m128i p0 = _mm_avg_epu8(
+        _mm_avg_epu8(_mm_load_si128(src0), _mm_load_si128(src1)),
+        _mm_avg_epu8(_mm_load_si128(src2), _mm_load_si128(src3)));
+    __m128i p1 = _mm_avg_epu8(
+        _mm_avg_epu8(_mm_load_si128(src0 + 1), _mm_load_si128(src1 + 1)),
+        _mm_avg_epu8(_mm_load_si128(src2 + 1), _mm_load_si128(src3 + 1)));
+    p0 = _mm_packus_epi16(AverageHorizontal(p0), AverageHorizontal(p1));
+    p0 = AverageHorizontal(p0);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst_ptr),
+                     _mm_packus_epi16(p0, p0));
+    src_ptr += 32;
+    dst_ptr += 8;
+  }
+}
+
+#endif  // !defined(YUV_DISABLE_ASM) && defined(LIBYUV_SSE2) ...
+
+#ifdef __cplusplus
+}  // extern "C"
+}  // namespace libyuv
+#endif
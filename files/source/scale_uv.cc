@@ -0,0 +1,614 @@
+/*
+ *  Copyright 2012 The LibYuv Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "libyuv/scale.h"
+
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>  // For getenv()
+
+#include "libyuv/cpu_id.h"
+#include "libyuv/planar_functions.h"  // For CopyPlane
+#include "libyuv/row.h"
+
+#ifdef __cplusplus
+namespace libyuv {
+extern "C" {
+#endif
+
+// UV scaling scales the interleaved chroma plane of NV12 and NV21, where each
+// pixel is a 2 byte UV pair. Like ARGB scaling it uses bilinear or point,
+// plus an optimized 1/2 box, but not the box filter.
+
+#if !defined(YUV_DISABLE_ASM) && defined(__ARM_NEON__)
+#define HAS_SCALEUVROWDOWN2INT_NEON
+void ScaleUVRowDown2Int_NEON(const uint8* src_ptr, ptrdiff_t src_stride,
+                             uint8* dst_ptr, int dst_width);
+#endif
+
+/**
+ * SSE2 downscalers with bilinear interpolation.
+ */
+
+#if !defined(YUV_DISABLE_ASM) && defined(_M_IX86)
+
+#define HAS_SCALEUVROWDOWN2INT_SSE2
+// Blends 16x2 UV pixels to 8x1.
+// Alignment requirement: src_ptr 16 byte aligned, dst_ptr 16 byte aligned.
+__declspec(naked) __declspec(align(16))
+static void ScaleUVRowDown2Int_SSE2(const uint8* src_ptr,
+                                    ptrdiff_t src_stride,
+                                    uint8* dst_ptr, int dst_width) {
+  __asm {
+    push       esi
+    mov        eax, [esp + 4 + 4]    // src_ptr
+    mov        esi, [esp + 4 + 8]    // src_stride
+    mov        edx, [esp + 4 + 12]   // dst_ptr
+    mov        ecx, [esp + 4 + 16]   // dst_width
+
+    align      16
+  wloop:
+    movdqa     xmm0, [eax]
+    movdqa     xmm1, [eax + 16]
+    movdqa     xmm2, [eax + esi]
+    movdqa     xmm3, [eax + esi + 16]
+    lea        eax,  [eax + 32]
+    pavgb      xmm0, xmm2            // average rows
+    pavgb      xmm1, xmm3
+    pshuflw    xmm0, xmm0, 0xd8      // even pixels to low half, odd to high
+    pshufhw    xmm0, xmm0, 0xd8
+    pshufd     xmm0, xmm0, 0xd8
+    pshuflw    xmm1, xmm1, 0xd8
+    pshufhw    xmm1, xmm1, 0xd8
+    pshufd     xmm1, xmm1, 0xd8
+    movdqa     xmm2, xmm0            // average columns (16 to 8 pixels)
+    punpcklqdq xmm0, xmm1            // even pixels
+    punpckhqdq xmm2, xmm1            // odd pixels
+    pavgb      xmm0, xmm2
+    sub        ecx, 8
+    movdqa     [edx], xmm0
+    lea        edx, [edx + 16]
+    jg         wloop
+
+    pop        esi
+    ret
+  }
+}
+
+// Bilinear row filtering combines 8x2 -> 8x1. SSSE3 version.
+#define HAS_SCALEUVFILTERROWS_SSSE3
+__declspec(naked) __declspec(align(16))
+static void ScaleUVFilterRows_SSSE3(uint8* dst_ptr, const uint8* src_ptr,
+                                    ptrdiff_t src_stride, int dst_width,
+                                    int source_y_fraction) {
+  __asm {
+    push       esi
+    push       edi
+    mov        edi, [esp + 8 + 4]   // dst_ptr
+    mov        esi, [esp + 8 + 8]   // src_ptr
+    mov        edx, [esp + 8 + 12]  // src_stride
+    mov        ecx, [esp + 8 + 16]  // dst_width
+    mov        eax, [esp + 8 + 20]  // source_y_fraction (0..255)
+    sub        edi, esi
+    shr        eax, 1
+    cmp        eax, 0
+    je         xloop1
+    cmp        eax, 64
+    je         xloop2
+    movd       xmm0, eax  // high fraction 0..127
+    neg        eax
+    add        eax, 128
+    movd       xmm5, eax  // low fraction 128..1
+    punpcklbw  xmm5, xmm0
+    punpcklwd  xmm5, xmm5
+    pshufd     xmm5, xmm5, 0
+
+    align      16
+  xloop:
+    movdqa     xmm0, [esi]
+    movdqa     xmm2, [esi + edx]
+    movdqa     xmm1, xmm0
+    punpcklbw  xmm0, xmm2
+    punpckhbw  xmm1, xmm2
+    pmaddubsw  xmm0, xmm5
+    pmaddubsw  xmm1, xmm5
+    psrlw      xmm0, 7
+    psrlw      xmm1, 7
+    packuswb   xmm0, xmm1
+    sub        ecx, 8
+    movdqa     [esi + edi], xmm0
+    lea        esi, [esi + 16]
+    jg         xloop
+
+    pshufhw    xmm0, xmm0, 0xff
+    punpckhqdq xmm0, xmm0
+    movdqa     [esi + edi], xmm0    // duplicate last pixel for filtering
+    pop        edi
+    pop        esi
+    ret
+
+    align      16
+  xloop1:
+    movdqa     xmm0, [esi]
+    sub        ecx, 8
+    movdqa     [esi + edi], xmm0
+    lea        esi, [esi + 16]
+    jg         xloop1
+
+    pshufhw    xmm0, xmm0, 0xff
+    punpckhqdq xmm0, xmm0
+    movdqa     [esi + edi], xmm0
+    pop        edi
+    pop        esi
+    ret
+
+    align      16
+  xloop2:
+    movdqa     xmm0, [esi]
+    pavgb      xmm0, [esi + edx]
+    sub        ecx, 8
+    movdqa     [esi + edi], xmm0
+    lea        esi, [esi + 16]
+    jg         xloop2
+
+    pshufhw    xmm0, xmm0, 0xff
+    punpckhqdq xmm0, xmm0
+    movdqa     [esi + edi], xmm0
+    pop        edi
+    pop        esi
+    ret
+  }
+}
+
+#elif !defined(YUV_DISABLE_ASM) && (defined(__x86_64__) || defined(__i386__))
+
+#define HAS_SCALEUVROWDOWN2INT_SSE2
+static void ScaleUVRowDown2Int_SSE2(const uint8* src_ptr,
+                                    ptrdiff_t src_stride,
+                                    uint8* dst_ptr, int dst_width) {
+  asm volatile (
+    ".p2align  4                               \n"
+  "1:                                          \n"
+    "movdqa    (%0),%%xmm0                     \n"
+    "movdqa    0x10(%0),%%xmm1                 \n"
+    "movdqa    (%0,%3,1),%%xmm2                \n"
+    "movdqa    0x10(%0,%3,1),%%xmm3            \n"
+    "lea       0x20(%0),%0                     \n"
+    "pavgb     %%xmm2,%%xmm0                   \n"
+    "pavgb     %%xmm3,%%xmm1                   \n"
+    "pshuflw   $0xd8,%%xmm0,%%xmm0             \n"
+    "pshufhw   $0xd8,%%xmm0,%%xmm0             \n"
+    "pshufd    $0xd8,%%xmm0,%%xmm0             \n"
+    "pshuflw   $0xd8,%%xmm1,%%xmm1             \n"
+    "pshufhw   $0xd8,%%xmm1,%%xmm1             \n"
+    "pshufd    $0xd8,%%xmm1,%%xmm1             \n"
+    "movdqa    %%xmm0,%%xmm2                   \n"
+    "punpcklqdq %%xmm1,%%xmm0                  \n"
+    "punpckhqdq %%xmm1,%%xmm2                  \n"
+    "pavgb     %%xmm2,%%xmm0                   \n"
+    "sub       $0x8,%2                         \n"
+    "movdqa    %%xmm0,(%1)                     \n"
+    "lea       0x10(%1),%1                     \n"
+    "jg        1b                              \n"
+  : "+r"(src_ptr),    // %0
+    "+r"(dst_ptr),    // %1
+    "+r"(dst_width)   // %2
+  : "r"(static_cast<intptr_t>(src_stride))   // %3
+  : "memory", "cc"
+#if defined(__SSE2__)
+    , "xmm0", "xmm1", "xmm2", "xmm3"
+#endif
+  );
+}
+
+// Bilinear row filtering combines 8x2 -> 8x1. SSSE3 version
+#define HAS_SCALEUVFILTERROWS_SSSE3
+static void ScaleUVFilterRows_SSSE3(uint8* dst_ptr, const uint8* src_ptr,
+                                    ptrdiff_t src_stride, int dst_width,
+                                    int source_y_fraction) {
+  asm volatile (
+    "sub       %1,%0                           \n"
+    "shr       %3                              \n"
+    "cmp       $0x0,%3                         \n"
+    "je        2f                              \n"
+    "cmp       $0x40,%3                        \n"
+    "je        3f                              \n"
+    "movd      %3,%%xmm0                       \n"
+    "neg       %3                              \n"
+    "add       $0x80,%3                        \n"
+    "movd      %3,%%xmm5                       \n"
+    "punpcklbw %%xmm0,%%xmm5                   \n"
+    "punpcklwd %%xmm5,%%xmm5                   \n"
+    "pshufd    $0x0,%%xmm5,%%xmm5              \n"
+    ".p2align  4                               \n"
+  "1:                                          \n"
+    "movdqa    (%1),%%xmm0                     \n"
+    "movdqa    (%1,%4,1),%%xmm2                \n"
+    "movdqa    %%xmm0,%%xmm1                   \n"
+    "punpcklbw %%xmm2,%%xmm0                   \n"
+    "punpckhbw %%xmm2,%%xmm1                   \n"
+    "pmaddubsw %%xmm5,%%xmm0                   \n"
+    "pmaddubsw %%xmm5,%%xmm1                   \n"
+    "psrlw     $0x7,%%xmm0                     \n"
+    "psrlw     $0x7,%%xmm1                     \n"
+    "packuswb  %%xmm1,%%xmm0                   \n"
+    "sub       $0x8,%2                         \n"
+    "movdqa    %%xmm0,(%1,%0,1)                \n"
+    "lea       0x10(%1),%1                     \n"
+    "jg        1b                              \n"
+    "jmp       4f                              \n"
+    ".p2align  4                               \n"
+  "2:                                          \n"
+    "movdqa    (%1),%%xmm0                     \n"
+    "sub       $0x8,%2                         \n"
+    "movdqa    %%xmm0,(%1,%0,1)                \n"
+    "lea       0x10(%1),%1                     \n"
+    "jg        2b                              \n"
+    "jmp       4f                              \n"
+    ".p2align  4                               \n"
+  "3:                                          \n"
+    "movdqa    (%1),%%xmm0                     \n"
+    "pavgb     (%1,%4,1),%%xmm0                \n"
+    "sub       $0x8,%2                         \n"
+    "movdqa    %%xmm0,(%1,%0,1)                \n"
+    "lea       0x10(%1),%1                     \n"
+    "jg        3b                              \n"
+  "4:                                          \n"
+    ".p2align  4                               \n"
+    "pshufhw   $0xff,%%xmm0,%%xmm0             \n"
+    "punpckhqdq %%xmm0,%%xmm0                  \n"
+    "movdqa    %%xmm0,(%1,%0,1)                \n"
+  : "+r"(dst_ptr),     // %0
+    "+r"(src_ptr),     // %1
+    "+r"(dst_width),   // %2
+    "+r"(source_y_fraction)  // %3
+  : "r"(static_cast<intptr_t>(src_stride))  // %4
+  : "memory", "cc"
+#if defined(__SSE2__)
+    , "xmm0", "xmm1", "xmm2", "xmm5"
+#endif
+  );
+}
+#endif  // defined(__x86_64__) || defined(__i386__)
+
+static void ScaleUVRowDown2_C(const uint8* src_ptr,
+                              ptrdiff_t /* src_stride */,
+                              uint8* dst_ptr, int dst_width) {
+  const uint16* src = reinterpret_cast<const uint16*>(src_ptr);
+  uint16* dst = reinterpret_cast<uint16*>(dst_ptr);
+
+  for (int x = 0; x < dst_width - 1; x += 2) {
+    dst[0] = src[0];
+    dst[1] = src[2];
+    src += 4;
+    dst += 2;
+  }
+  if (dst_width & 1) {
+    dst[0] = src[0];
+  }
+}
+
+static void ScaleUVRowDown2Int_C(const uint8* src_ptr, ptrdiff_t src_stride,
+                                 uint8* dst_ptr, int dst_width) {
+  for (int x = 0; x < dst_width; ++x) {
+    dst_ptr[0] = (src_ptr[0] + src_ptr[2] +
+                  src_ptr[src_stride] + src_ptr[src_stride + 2] + 2) >> 2;
+    dst_ptr[1] = (src_ptr[1] + src_ptr[3] +
+                  src_ptr[src_stride + 1] + src_ptr[src_stride + 3] + 2) >> 2;
+    src_ptr += 4;
+    dst_ptr += 2;
+  }
+}
+
+static void ScaleUVRowDownEven_C(const uint8* src_ptr,
+                                 ptrdiff_t /* src_stride */,
+                                 int src_stepx,
+                                 uint8* dst_ptr, int dst_width) {
+  const uint16* src = reinterpret_cast<const uint16*>(src_ptr);
+  uint16* dst = reinterpret_cast<uint16*>(dst_ptr);
+
+  for (int x = 0; x < dst_width - 1; x += 2) {
+    dst[0] = src[0];
+    dst[1] = src[src_stepx];
+    src += src_stepx * 2;
+    dst += 2;
+  }
+  if (dst_width & 1) {
+    dst[0] = src[0];
+  }
+}
+
+static void ScaleUVRowDownEvenInt_C(const uint8* src_ptr,
+                                    ptrdiff_t src_stride,
+                                    int src_stepx,
+                                    uint8* dst_ptr, int dst_width) {
+  for (int x = 0; x < dst_width; ++x) {
+    dst_ptr[0] = (src_ptr[0] + src_ptr[2] +
+                  src_ptr[src_stride] + src_ptr[src_stride + 2] + 2) >> 2;
+    dst_ptr[1] = (src_ptr[1] + src_ptr[3] +
+                  src_ptr[src_stride + 1] + src_ptr[src_stride + 3] + 2) >> 2;
+    src_ptr += src_stepx * 2;
+    dst_ptr += 2;
+  }
+}
+
+// (1-f)a + fb can be replaced with a + f(b-a)
+#define BLENDER(a, b, f) (static_cast<int>(a) + \
+    ((f) * (static_cast<int>(b) - static_cast<int>(a)) >> 16))
+
+static void ScaleUVFilterCols_C(uint8* dst_ptr, const uint8* src_ptr,
+                                int dst_width, int x, int dx) {
+  for (int j = 0; j < dst_width; ++j) {
+    int xi = (x >> 16) * 2;
+    int xf = x & 0xffff;
+    dst_ptr[0] = BLENDER(src_ptr[xi], src_ptr[xi + 2], xf);
+    dst_ptr[1] = BLENDER(src_ptr[xi + 1], src_ptr[xi + 3], xf);
+    x += dx;
+    dst_ptr += 2;
+  }
+}
+
+static const int kMaxInputWidth = 2560;
+
+// C version 2x2 -> 2x1
+static void ScaleUVFilterRows_C(uint8* dst_ptr, const uint8* src_ptr,
+                                ptrdiff_t src_stride,
+                                int dst_width, int source_y_fraction) {
+  assert(dst_width > 0);
+  int y1_fraction = source_y_fraction;
+  int y0_fraction = 256 - y1_fraction;
+  const uint8* src_ptr1 = src_ptr + src_stride;
+  for (int x = 0; x < dst_width * 2; ++x) {
+    dst_ptr[x] = (src_ptr[x] * y0_fraction + src_ptr1[x] * y1_fraction) >> 8;
+  }
+  // Duplicate the last pixel (2 bytes) for filtering.
+  dst_ptr += dst_width * 2;
+  dst_ptr[0] = dst_ptr[-2];
+  dst_ptr[1] = dst_ptr[-1];
+}
+
+/**
+ * ScaleUV UV, 1/2
+ *
+ * This is an optimized version for scaling down a UV plane to 1/2 of
+ * its original size.
+ *
+ */
+static void ScaleUVDown2(int /* src_width */, int /* src_height */,
+                         int dst_width, int dst_height,
+                         int src_stride, int dst_stride,
+                         const uint8* src_ptr, uint8* dst_ptr,
+                         FilterMode filtering) {
+  void (*ScaleUVRowDown2)(const uint8* src_ptr, ptrdiff_t src_stride,
+                          uint8* dst_ptr, int dst_width) =
+      filtering ? ScaleUVRowDown2Int_C : ScaleUVRowDown2_C;
+#if defined(HAS_SCALEUVROWDOWN2INT_NEON)
+  if (filtering && TestCpuFlag(kCpuHasNEON) && IS_ALIGNED(dst_width, 8)) {
+    ScaleUVRowDown2 = ScaleUVRowDown2Int_NEON;
+  }
+#elif defined(HAS_SCALEUVROWDOWN2INT_SSE2)
+  if (filtering && TestCpuFlag(kCpuHasSSE2) &&
+      IS_ALIGNED(dst_width, 8) &&
+      IS_ALIGNED(src_ptr, 16) && IS_ALIGNED(src_stride, 16) &&
+      IS_ALIGNED(dst_ptr, 16) && IS_ALIGNED(dst_stride, 16)) {
+    ScaleUVRowDown2 = ScaleUVRowDown2Int_SSE2;
+  }
+#endif
+
+  for (int y = 0; y < dst_height; ++y) {
+    ScaleUVRowDown2(src_ptr, src_stride, dst_ptr, dst_width);
+    src_ptr += (src_stride << 1);
+    dst_ptr += dst_stride;
+  }
+}
+
+/**
+ * ScaleUV UV Even
+ *
+ * This is an optimized version for scaling down a UV plane to even
+ * multiple of its original size.
+ *
+ */
+static void ScaleUVDownEven(int src_width, int src_height,
+                            int dst_width, int dst_height,
+                            int src_stride, int dst_stride,
+                            const uint8* src_ptr, uint8* dst_ptr,
+                            FilterMode filtering) {
+  assert(IS_ALIGNED(src_width, 2));
+  assert(IS_ALIGNED(src_height, 2));
+  void (*ScaleUVRowDownEven)(const uint8* src_ptr, ptrdiff_t src_stride,
+                             int src_step, uint8* dst_ptr, int dst_width) =
+      filtering ? ScaleUVRowDownEvenInt_C : ScaleUVRowDownEven_C;
+  int src_step = src_width / dst_width;
+  // Adjust to point to center of box.
+  int row_step = src_height / dst_height;
+  int row_stride = row_step * src_stride;
+  src_ptr += ((row_step >> 1) - 1) * src_stride + ((src_step >> 1) - 1) * 2;
+  for (int y = 0; y < dst_height; ++y) {
+    ScaleUVRowDownEven(src_ptr, src_stride, src_step, dst_ptr, dst_width);
+    src_ptr += row_stride;
+    dst_ptr += dst_stride;
+  }
+}
+
+/**
+ * ScaleUV UV to/from any dimensions, with bilinear
+ * interpolation.
+ */
+
+static void ScaleUVBilinear(int src_width, int src_height,
+                            int dst_width, int dst_height,
+                            int src_stride, int dst_stride,
+                            const uint8* src_ptr, uint8* dst_ptr) {
+  assert(dst_width > 0);
+  assert(dst_height > 0);
+  assert(src_width <= kMaxInputWidth);
+  SIMD_ALIGNED(uint8 row[kMaxInputWidth * 2 + 16]);
+  void (*ScaleUVFilterRows)(uint8* dst_ptr, const uint8* src_ptr,
+                            ptrdiff_t src_stride,
+                            int dst_width, int source_y_fraction) =
+      ScaleUVFilterRows_C;
+#if defined(HAS_SCALEUVFILTERROWS_SSSE3)
+  if (TestCpuFlag(kCpuHasSSSE3) && IS_ALIGNED(src_width, 8) &&
+      IS_ALIGNED(src_stride, 16) && IS_ALIGNED(src_ptr, 16)) {
+    ScaleUVFilterRows = ScaleUVFilterRows_SSSE3;
+  }
+#endif
+  int dx = (src_width << 16) / dst_width;
+  int dy = (src_height << 16) / dst_height;
+  int x = (dx >= 65536) ? ((dx >> 1) - 32768) : (dx >> 1);
+  int y = (dy >= 65536) ? ((dy >> 1) - 32768) : (dy >> 1);
+  int maxy = (src_height > 1) ? ((src_height - 1) << 16) - 1 : 0;
+  // A single row is filtered with itself.
+  ptrdiff_t filter_stride = (src_height > 1) ? src_stride : 0;
+  for (int j = 0; j < dst_height; ++j) {
+    int yi = y >> 16;
+    int yf = (y >> 8) & 255;
+    const uint8* src = src_ptr + yi * src_stride;
+    ScaleUVFilterRows(row, src, filter_stride, src_width, yf);
+    ScaleUVFilterCols_C(dst_ptr, row, dst_width, x, dx);
+    dst_ptr += dst_stride;
+    y += dy;
+    if (y > maxy) {
+      y = maxy;
+    }
+  }
+}
+
+// Scales a single row of UV pixels using point sampling.
+static void ScaleUVCols(uint8* dst_ptr, const uint8* src_ptr,
+                        int dst_width, int x, int dx) {
+  const uint16* src = reinterpret_cast<const uint16*>(src_ptr);
+  uint16* dst = reinterpret_cast<uint16*>(dst_ptr);
+  for (int j = 0; j < dst_width - 1; j += 2) {
+    dst[0] = src[x >> 16];
+    x += dx;
+    dst[1] = src[x >> 16];
+    x += dx;
+    dst += 2;
+  }
+  if (dst_width & 1) {
+    dst[0] = src[x >> 16];
+  }
+}
+
+/**
+ * ScaleUV UV to/from any dimensions, without interpolation.
+ * Fixed point math is used for performance: The upper 16 bits
+ * of x and dx is the integer part of the source position and
+ * the lower 16 bits are the fixed decimal part.
+ */
+
+static void ScaleUVSimple(int src_width, int src_height,
+                          int dst_width, int dst_height,
+                          int src_stride, int dst_stride,
+                          const uint8* src_ptr, uint8* dst_ptr) {
+  int dx = (src_width << 16) / dst_width;
+  int dy = (src_height << 16) / dst_height;
+  int x = (dx >= 65536) ? ((dx >> 1) - 32768) : (dx >> 1);
+  int y = (dy >= 65536) ? ((dy >> 1) - 32768) : (dy >> 1);
+  for (int i = 0; i < dst_height; ++i) {
+    ScaleUVCols(dst_ptr, src_ptr + (y >> 16) * src_stride, dst_width, x, dx);
+    dst_ptr += dst_stride;
+    y += dy;
+  }
+}
+
+// ScaleUV a UV plane.
+//
+// This function in turn calls a scaling function
+// suitable for handling the desired resolutions.
+static void ScaleUV(const uint8* src, int src_stride,
+                    int src_width, int src_height,
+                    uint8* dst, int dst_stride,
+                    int dst_width, int dst_height,
+                    FilterMode filtering) {
+#ifdef CPU_X86
+  // environment variable overrides for testing.
+  char *filter_override = getenv("LIBYUV_FILTER");
+  if (filter_override) {
+    filtering = (FilterMode)atoi(filter_override);  // NOLINT
+  }
+#endif
+  if (dst_width == src_width && dst_height == src_height) {
+    // Straight copy.
+    CopyPlane(src, src_stride, dst, dst_stride, dst_width * 2, dst_height);
+    return;
+  }
+  if (2 * dst_width == src_width && 2 * dst_height == src_height) {
+    // Optimized 1/2.
+    ScaleUVDown2(src_width, src_height, dst_width, dst_height,
+                 src_stride, dst_stride, src, dst, filtering);
+    return;
+  }
+  int scale_down_x = src_width / dst_width;
+  int scale_down_y = src_height / dst_height;
+  if (dst_width * scale_down_x == src_width &&
+      dst_height * scale_down_y == src_height) {
+    if (!(scale_down_x & 1) && !(scale_down_y & 1)) {
+      // Optimized even scale down. ie 4, 6, 8, 10x
+      ScaleUVDownEven(src_width, src_height, dst_width, dst_height,
+                      src_stride, dst_stride, src, dst, filtering);
+      return;
+    }
+    if ((scale_down_x & 1) && (scale_down_y & 1)) {
+      filtering = kFilterNone;
+    }
+  }
+  // Arbitrary scale up and/or down.
+  if (!filtering || (src_width > kMaxInputWidth)) {
+    ScaleUVSimple(src_width, src_height, dst_width, dst_height,
+                  src_stride, dst_stride, src, dst);
+  } else {
+    ScaleUVBilinear(src_width, src_height, dst_width, dst_height,
+                    src_stride, dst_stride, src, dst);
+  }
+}
+
+// Scale an NV12 image. The UV plane is scaled as interleaved pairs.
+LIBYUV_API
+int NV12Scale(const uint8* src_y, int src_stride_y,
+              const uint8* src_uv, int src_stride_uv,
+              int src_width, int src_height,
+              uint8* dst_y, int dst_stride_y,
+              uint8* dst_uv, int dst_stride_uv,
+              int dst_width, int dst_height,
+              FilterMode filtering) {
+  if (!src_y || !src_uv || src_width <= 0 || src_height == 0 ||
+      !dst_y || !dst_uv || dst_width <= 0 || dst_height <= 0) {
+    return -1;
+  }
+  // Negative height means invert the image.
+  if (src_height < 0) {
+    src_height = -src_height;
+    int halfheight = (src_height + 1) >> 1;
+    src_y = src_y + (src_height - 1) * src_stride_y;
+    src_uv = src_uv + (halfheight - 1) * src_stride_uv;
+    src_stride_y = -src_stride_y;
+    src_stride_uv = -src_stride_uv;
+  }
+  int src_halfwidth = (src_width + 1) >> 1;
+  int src_halfheight = (src_height + 1) >> 1;
+  int dst_halfwidth = (dst_width + 1) >> 1;
+  int dst_halfheight = (dst_height + 1) >> 1;
+
+  ScalePlane(src_y, src_stride_y, src_width, src_height,
+             dst_y, dst_stride_y, dst_width, dst_height,
+             filtering);
+  ScaleUV(src_uv, src_stride_uv, src_halfwidth, src_halfheight,
+          dst_uv, dst_stride_uv, dst_halfwidth, dst_halfheight,
+          filtering);
+  return 0;
+}
+
+#ifdef __cplusplus
+}  // extern "C"
+}  // namespace libyuv
+#endif
@@ -15,6 +15,7 @@
 #include "../unit_test/unit_test.h"
 #include "libyuv/basic_types.h"
 #include "libyuv/compare.h"
+#include "libyuv/convert_argb.h"
 #include "libyuv/cpu_id.h"
 
 namespace libyuv {
@@ -447,4 +448,175 @@ TEST_F(libyuvTest, Ssim) {
   free_aligned_buffer_16(src_b)
 }
 
+TEST_F(libyuvTest, TestPlaneHistogram) {
+  const int kStride = 1283;
+  const int kHeight = 67;
+  align_buffer_16(src, kStride * kHeight)
+  srandom(time(NULL));
+  for (int i = 0; i < kStride * kHeight; ++i) {
+    src[i] = (random() & 0xff);
+  }
+  // Region of interest at (5, 7) of odd size.
+  const int kWidth = 1001;
+  const int kRoiHeight = 33;
+  const uint8* roi = src + 7 * kStride + 5;
+  uint32 histogram[256];
+  uint32 expected[256];
+  memset(histogram, 0, sizeof(histogram));
+  memset(expected, 0, sizeof(expected));
+  for (int y = 0; y < kRoiHeight; ++y) {
+    for (int x = 0; x < kWidth; ++x) {
+      ++expected[roi[y * kStride + x]];
+    }
+  }
+  for (int i = 0; i < benchmark_iterations_; ++i) {
+    memset(histogram, 0, sizeof(histogram));
+    EXPECT_EQ(0, PlaneHistogram(roi, kStride, kWidth, kRoiHeight, histogram));
+  }
+  for (int i = 0; i < 256; ++i) {
+    EXPECT_EQ(expected[i], histogram[i]);
+  }
+  // Counts are added and orientation does not matter.
+  EXPECT_EQ(0, PlaneHistogram(roi, kStride, kWidth, -kRoiHeight, histogram));
+  for (int i = 0; i < 256; ++i) {
+    EXPECT_EQ(expected[i] * 2, histogram[i]);
+  }
+
+  // ARGB is 4 tables of B, G, R and A.
+  const int kArgbWidth = 317;
+  uint32 argb_histogram[1024];
+  uint32 argb_expected[1024];
+  memset(argb_histogram, 0, sizeof(argb_histogram));
+  memset(argb_expected, 0, sizeof(argb_expected));
+  for (int y = 0; y < kRoiHeight; ++y) {
+    for (int x = 0; x < kArgbWidth * 4; ++x) {
+      ++argb_expected[(x & 3) * 256 + roi[y * kStride + x]];
+    }
+  }
+  EXPECT_EQ(0, ARGBHistogram(roi, kStride, kArgbWidth, kRoiHeight,
+                             argb_histogram));
+  for (int i = 0; i < 1024; ++i) {
+    EXPECT_EQ(argb_expected[i], argb_histogram[i]);
+  }
+  EXPECT_EQ(-1, PlaneHistogram(roi, kStride, 0, kRoiHeight, histogram));
+  free_aligned_buffer_16(src)
+}
+
+static void TestStats(const uint8* src, int stride, int width, int height) {
+  uint64 expected_sum = 0;
+  uint64 expected_sum_squares = 0;
+  int expected_min = 255;
+  int expected_max = 0;
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      const int v = src[y * stride + x];
+      expected_sum += v;
+      expected_sum_squares += v * v;
+      expected_min = v < expected_min ? v : expected_min;
+      expected_max = v > expected_max ? v : expected_max;
+    }
+  }
+  for (int cpu = 0; cpu < 2; ++cpu) {
+    MaskCpuFlags(cpu ? -1 : kCpuInitialized);
+    uint64 sum = 0;
+    uint64 sum_squares = 0;
+    int min = -1;
+    int max = -1;
+    EXPECT_EQ(0, PlaneStats(src, stride, width, height,
+                            &sum, &sum_squares, &min, &max));
+    EXPECT_EQ(expected_sum, sum);
+    EXPECT_EQ(expected_sum_squares, sum_squares);
+    EXPECT_EQ(expected_min, min);
+    EXPECT_EQ(expected_max, max);
+  }
+  MaskCpuFlags(-1);
+}
+
+TEST_F(libyuvTest, TestPlaneStats) {
+  // Wider than the 32K blocks that the row sums are computed in.
+  const int kStride = 40000;
+  const int kHeight = 3;
+  align_buffer_16(src, kStride * kHeight)
+
+  memset(src, 255, kStride * kHeight);
+  TestStats(src, kStride, kStride, kHeight);
+
+  srandom(time(NULL));
+  for (int i = 0; i < kStride * kHeight; ++i) {
+    src[i] = (random() & 0xff);
+  }
+  TestStats(src, kStride, kStride, kHeight);
+  // Region of interest with a misaligned start and an odd width.
+  TestStats(src + kStride + 3, kStride, 37, 2);
+  TestStats(src + 1, kStride, 7, 3);
+  // Min and max in the middle of a 16 pixel block.
+  memset(src, 100, kStride * kHeight);
+  src[kStride + 21] = 3;
+  src[2 * kStride + 40] = 250;
+  TestStats(src, kStride, 1280, kHeight);
+
+  uint64 sum;
+  uint64 sum_squares;
+  int min;
+  int max;
+  for (int i = 0; i < benchmark_iterations_; ++i) {
+    PlaneStats(src, kStride, kStride, kHeight, &sum, &sum_squares, &min, &max);
+  }
+  EXPECT_EQ(-1, PlaneStats(src, kStride, kStride, kHeight,
+                           NULL, &sum_squares, &min, &max));
+  free_aligned_buffer_16(src)
+}
+
+TEST_F(libyuvTest, TestI420ToARGBHistogram) {
+  const int kWidth = 101;
+  const int kHeight = 35;
+  const int kHalfWidth = (kWidth + 1) / 2;
+  const int kHalfHeight = (kHeight + 1) / 2;
+  align_buffer_16(src_y, kWidth * kHeight)
+  align_buffer_16(src_uv, kHalfWidth * 2 * kHalfHeight * 2)
+  align_buffer_16(dst_argb_c, kWidth * 4 * kHeight)
+  align_buffer_16(dst_argb_opt, kWidth * 4 * kHeight)
+  srandom(time(NULL));
+  for (int i = 0; i < kWidth * kHeight; ++i) {
+    src_y[i] = (random() & 0xff);
+  }
+  for (int i = 0; i < kHalfWidth * 2 * kHalfHeight * 2; ++i) {
+    src_uv[i] = (random() & 0xff);
+  }
+  uint32 expected[256];
+  memset(expected, 0, sizeof(expected));
+  PlaneHistogram(src_y, kWidth, kWidth, kHeight, expected);
+
+  uint32 histogram[256];
+  memset(histogram, 0, sizeof(histogram));
+  I420ToARGB(src_y, kWidth, src_uv, kHalfWidth,
+             src_uv + kHalfWidth * kHalfHeight, kHalfWidth,
+             dst_argb_c, kWidth * 4, kWidth, kHeight);
+  EXPECT_EQ(0, I420ToARGBHistogram(src_y, kWidth, src_uv, kHalfWidth,
+                                   src_uv + kHalfWidth * kHalfHeight,
+                                   kHalfWidth,
+                                   dst_argb_opt, kWidth * 4,
+                                   kWidth, kHeight, histogram));
+  for (int i = 0; i < 256; ++i) {
+    EXPECT_EQ(expected[i], histogram[i]);
+  }
+  EXPECT_EQ(0, memcmp(dst_argb_c, dst_argb_opt, kWidth * 4 * kHeight));
+
+  memset(histogram, 0, sizeof(histogram));
+  NV12ToARGB(src_y, kWidth, src_uv, kHalfWidth * 2,
+             dst_argb_c, kWidth * 4, kWidth, kHeight);
+  EXPECT_EQ(0, NV12ToARGBHistogram(src_y, kWidth, src_uv, kHalfWidth * 2,
+                                   dst_argb_opt, kWidth * 4,
+                                   kWidth, kHeight, histogram));
+  for (int i = 0; i < 256; ++i) {
+    EXPECT_EQ(expected[i], histogram[i]);
+  }
+  EXPECT_EQ(0, memcmp(dst_argb_c, dst_argb_opt, kWidth * 4 * kHeight));
+
+  free_aligned_buffer_16(src_y)
+  free_aligned_buffer_16(src_uv)
+  free_aligned_buffer_16(dst_argb_c)
+  free_aligned_buffer_16(dst_argb_opt)
+}
+
 }  // namespace libyuv
@@ -13,6 +13,7 @@
 
 #include "libyuv/basic_types.h"
 #include "libyuv/cpu_id.h"
+#include "libyuv/row.h"
 #include "libyuv/version.h"
 #include "../unit_test/unit_test.h"
 
@@ -41,6 +42,81 @@ TEST_F(libyuvTest, TestCpuHas) {
   printf("Has AVX2 %x\n", has_avx2);
 }
 
+TEST_F(libyuvTest, TestRowDispatch) {
+  MaskCpuFlags(0);
+  const RowDispatch* c_dispatch = GetRowDispatch();
+  EXPECT_EQ(0, c_dispatch->cpu_flags);
+  EXPECT_EQ(c_dispatch->I422ToARGBRow.functions[kRowC],
+            c_dispatch->I422ToARGBRow.functions[kRowAligned]);
+  EXPECT_EQ(c_dispatch->ARGBToYRow.functions[kRowC],
+            c_dispatch->ARGBToYRow.functions[kRowAny]);
+
+  // Masking the flags gives another table and unmasking the first one again.
+  MaskCpuFlags(-1);
+  const RowDispatch* dispatch = GetRowDispatch();
+  EXPECT_EQ(dispatch, GetRowDispatch());
+  EXPECT_EQ(c_dispatch->I422ToARGBRow.functions[kRowC],
+            dispatch->I422ToARGBRow.functions[kRowC]);
+  if (TestCpuFlag(kCpuHasSSSE3 | kCpuHasNEON)) {
+    EXPECT_NE(c_dispatch, dispatch);
+    EXPECT_NE(dispatch->I422ToARGBRow.functions[kRowC],
+              dispatch->I422ToARGBRow.functions[kRowUnaligned]);
+  }
+  MaskCpuFlags(0);
+  EXPECT_EQ(c_dispatch, GetRowDispatch());
+  MaskCpuFlags(-1);
+}
+
+struct ThreadMaskBands {
+  int cpu_flags[2];
+  int cpu_mask[2];
+};
+
+// The second band clears the flags of its own thread only.
+static void ThreadMaskBand(void* param, int y, int) {
+  ThreadMaskBands* bands = static_cast<ThreadMaskBands*>(param);
+  const int band = y ? 1 : 0;
+  bands->cpu_mask[band] = GetThreadCpuMask();
+  if (band) {
+    SetThreadCpuMask(0);
+  }
+  bands->cpu_flags[band] = TestCpuFlag(-1);
+}
+
+TEST_F(libyuvTest, TestThreadCpuMask) {
+  const int cpu_flags = TestCpuFlag(-1);
+  SetThreadCpuMask(~kCpuHasSSSE3);
+  EXPECT_EQ(cpu_flags & ~kCpuHasSSSE3, TestCpuFlag(-1));
+  EXPECT_EQ(0, TestCpuFlag(kCpuHasSSSE3));
+  SetThreadCpuMask(-1);
+  EXPECT_EQ(cpu_flags, TestCpuFlag(-1));
+
+  // Threads started by RunBands get the mask of the calling thread.
+  ThreadMaskBands bands;
+  SetThreadCpuMask(~kCpuHasNEON);
+  RunBands(ThreadMaskBand, &bands, 32, 2);
+  EXPECT_EQ(~kCpuHasNEON, bands.cpu_mask[0]);
+  EXPECT_EQ(~kCpuHasNEON, bands.cpu_mask[1]);
+  EXPECT_EQ(cpu_flags & ~kCpuHasNEON, bands.cpu_flags[0]);
+  if (BandCount(32, 2) == 2) {
+    EXPECT_EQ(kCpuInitialized, bands.cpu_flags[1]);
+    EXPECT_EQ(~kCpuHasNEON, GetThreadCpuMask());
+    EXPECT_EQ(cpu_flags & ~kCpuHasNEON, TestCpuFlag(-1));
+  }
+  SetThreadCpuMask(-1);
+  EXPECT_EQ(cpu_flags, TestCpuFlag(-1));
+}
+
+// Batches split into bands of frames, so a few frames still use threads.
+TEST_F(libyuvTest, TestFrameBandCount) {
+  EXPECT_EQ(1, FrameBandCount(1, 4));
+  EXPECT_EQ(1, FrameBandCount(3, 1));
+  if (BandCount(32, 2) == 2) {
+    EXPECT_EQ(3, FrameBandCount(3, 4));
+    EXPECT_EQ(4, FrameBandCount(64, 4));
+  }
+}
+
 #if defined(__i386__) || defined(__x86_64__) || \
     defined(_M_IX86) || defined(_M_X64)
 TEST_F(libyuvTest, TestCpuId) {
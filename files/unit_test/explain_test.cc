@@ -0,0 +1,202 @@
+/*
+ *  Copyright 2012 The LibYuv Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "libyuv/basic_types.h"
+#include "libyuv/cpu_id.h"
+#include "libyuv/explain.h"
+#include "libyuv/row.h"
+#include "libyuv/scale.h"
+#include "../unit_test/unit_test.h"
+
+namespace libyuv {
+
+TEST_F(libyuvTest, TestExplainI420ToARGB) {
+  const int kWidth = 1280;
+  const int kHeight = 4;
+  align_buffer_16(src_y, kWidth * kHeight)
+  align_buffer_16(src_uv, kWidth * kHeight / 2)
+  align_buffer_16(dst_argb, (kWidth * 4 + 16) * kHeight + 16)
+  uint8* src_u = src_uv;
+  uint8* src_v = src_uv + kWidth * kHeight / 4;
+
+  KernelChoice choice;
+  EXPECT_EQ(-1, ExplainI420ToARGB(src_y, kWidth, src_u, kWidth / 2,
+                                  src_v, kWidth / 2, NULL, kWidth * 4,
+                                  kWidth, kHeight, &choice));
+
+  EXPECT_EQ(0, ExplainI420ToARGB(src_y, kWidth, src_u, kWidth / 2,
+                                 src_v, kWidth / 2, dst_argb, kWidth * 4,
+                                 kWidth, kHeight, &choice));
+  EXPECT_STREQ("I420ToARGB", choice.path);
+  if (TestCpuFlag(kCpuHasSSSE3) || TestCpuFlag(kCpuHasNEON)) {
+    EXPECT_EQ(1, choice.simd);
+  }
+  if (TestCpuFlag(kCpuHasSSSE3)) {
+    EXPECT_STREQ("I422ToARGBRow_SSSE3", choice.kernel);
+    // A stride that is not a multiple of 16 keeps SIMD, but unaligned.
+    EXPECT_EQ(0, ExplainI420ToARGB(src_y, kWidth, src_u, kWidth / 2,
+                                   src_v, kWidth / 2, dst_argb, kWidth * 4 + 4,
+                                   kWidth, kHeight, &choice));
+    EXPECT_STREQ("I422ToARGBRow_Unaligned_SSSE3", choice.kernel);
+    EXPECT_EQ(1, choice.simd);
+    // An odd width uses the Any version.
+    EXPECT_EQ(0, ExplainI420ToARGB(src_y, kWidth, src_u, kWidth / 2,
+                                   src_v, kWidth / 2, dst_argb, kWidth * 4,
+                                   kWidth - 1, kHeight, &choice));
+    EXPECT_STREQ("I422ToARGBRow_Any_SSSE3", choice.kernel);
+    EXPECT_STREQ("width is not a multiple of the SIMD step, so the Any "
+                 "version is used", choice.reason);
+  }
+
+  // A width under the SIMD step, or no SIMD cpu flags, use C.
+  EXPECT_EQ(0, ExplainI420ToARGB(src_y, kWidth, src_u, kWidth / 2,
+                                 src_v, kWidth / 2, dst_argb, kWidth * 4,
+                                 4, kHeight, &choice));
+  EXPECT_STREQ("I422ToARGBRow_C", choice.kernel);
+  EXPECT_EQ(0, choice.simd);
+  if (TestCpuFlag(kCpuHasSSSE3) || TestCpuFlag(kCpuHasNEON)) {
+    EXPECT_STREQ("width is less than the SIMD step", choice.reason);
+  }
+  MaskCpuFlags(0);
+  EXPECT_EQ(0, ExplainI420ToARGB(src_y, kWidth, src_u, kWidth / 2,
+                                 src_v, kWidth / 2, dst_argb, kWidth * 4,
+                                 kWidth, kHeight, &choice));
+  MaskCpuFlags(-1);
+  EXPECT_STREQ("I422ToARGBRow_C", choice.kernel);
+  EXPECT_EQ(0, choice.simd);
+  EXPECT_STREQ("no SIMD kernel for these cpu flags", choice.reason);
+
+  free_aligned_buffer_16(src_y)
+  free_aligned_buffer_16(src_uv)
+  free_aligned_buffer_16(dst_argb)
+}
+
+TEST_F(libyuvTest, TestExplainARGBToI420) {
+  const int kWidth = 640;
+  const int kHeight = 4;
+  align_buffer_16(src_argb, kWidth * 4 * kHeight)
+  align_buffer_16(dst_y, kWidth * kHeight)
+  align_buffer_16(dst_uv, kWidth * kHeight / 2)
+
+  KernelChoice choices[2];
+  EXPECT_EQ(0, ExplainARGBToI420(src_argb, kWidth * 4,
+                                 dst_y + 1, kWidth,
+                                 dst_uv, kWidth / 2,
+                                 dst_uv + kWidth * kHeight / 4, kWidth / 2,
+                                 kWidth, kHeight, choices));
+  // The AVX2 kernel is only in builds that define LIBYUV_AVX2, where the
+  // table steps 32 pixels.
+  const bool has_avx2 = TestCpuFlag(kCpuHasAVX2) &&
+      GetRowDispatch()->ARGBToYRow.width_mask[0] == 31;
+  if (has_avx2) {
+    // The AVX2 kernel has no aligned version, so it is the best there is.
+    EXPECT_STREQ("ARGBToYRow_AVX2", choices[0].kernel);
+    EXPECT_STREQ("SIMD kernel for these cpu flags, width and alignment",
+                 choices[0].reason);
+  } else if (TestCpuFlag(kCpuHasSSSE3)) {
+    // Only the Y row writes dst_y, so only it loses the aligned version.
+    EXPECT_STREQ("ARGBToYRow_Unaligned_SSSE3", choices[0].kernel);
+    EXPECT_STREQ("pointer or stride is not 16 byte aligned",
+                 choices[0].reason);
+  }
+  if (TestCpuFlag(kCpuHasSSSE3)) {
+    EXPECT_STREQ("ARGBToUVRow_SSSE3", choices[1].kernel);
+    EXPECT_EQ(1, choices[0].simd);
+  }
+
+  // Widths 16 to 31 are under the AVX2 step and run the SSSE3 kernels.
+  EXPECT_EQ(0, ExplainARGBToI420(src_argb, kWidth * 4, dst_y, kWidth,
+                                 dst_uv, kWidth / 2,
+                                 dst_uv + kWidth * kHeight / 4, kWidth / 2,
+                                 16, kHeight, choices));
+  if (TestCpuFlag(kCpuHasSSSE3)) {
+    EXPECT_STREQ("ARGBToYRow_SSSE3", choices[0].kernel);
+    EXPECT_EQ(1, choices[0].simd);
+  }
+  EXPECT_EQ(0, ExplainARGBToI420(src_argb, kWidth * 4, dst_y, kWidth,
+                                 dst_uv, kWidth / 2,
+                                 dst_uv + kWidth * kHeight / 4, kWidth / 2,
+                                 24, kHeight, choices));
+  if (TestCpuFlag(kCpuHasSSSE3)) {
+    EXPECT_STREQ("ARGBToYRow_Any_SSSE3", choices[0].kernel);
+    EXPECT_EQ(1, choices[0].simd);
+  }
+  if (has_avx2) {
+    EXPECT_STREQ("width is less than the widest SIMD step and not a multiple "
+                 "of the narrower one, so the Any version of the narrower "
+                 "kernel is used", choices[0].reason);
+  }
+
+  free_aligned_buffer_16(src_argb)
+  free_aligned_buffer_16(dst_y)
+  free_aligned_buffer_16(dst_uv)
+}
+
+TEST_F(libyuvTest, TestExplainI420Scale) {
+  const int kSrcWidth = 1920;
+  const int kSrcHeight = 1080;
+  const int kDstWidth = 1280;
+  const int kDstHeight = 720;
+  align_buffer_16(src, kSrcWidth * kSrcHeight * 3 / 2)
+  align_buffer_16(dst, kSrcWidth * kSrcHeight * 3 / 2)
+  uint8* src_u = src + kSrcWidth * kSrcHeight;
+  uint8* src_v = src_u + kSrcWidth * kSrcHeight / 4;
+  uint8* dst_u = dst + kSrcWidth * kSrcHeight;
+  uint8* dst_v = dst_u + kSrcWidth * kSrcHeight / 4;
+
+  KernelChoice choices[3];
+  EXPECT_EQ(0, ExplainI420Scale(src, kSrcWidth, src_u, kSrcWidth / 2,
+                                src_v, kSrcWidth / 2, kSrcWidth, kSrcHeight,
+                                dst, kDstWidth, dst_u, kDstWidth / 2,
+                                dst_v, kDstWidth / 2, kDstWidth, kDstHeight,
+                                kFilterBox, choices));
+  // ScalePlaneDown never picks ScalePlaneBox, so kFilterBox is bilinear.
+  EXPECT_STREQ("ScalePlaneBilinear", choices[0].path);
+  EXPECT_STREQ("ScalePlaneBilinear", choices[1].path);
+  EXPECT_STREQ("ScalePlaneBilinear", choices[2].path);
+  if (TestCpuFlag(kCpuHasSSSE3)) {
+    EXPECT_STREQ("ScaleFilterRows_SSSE3", choices[0].kernel);
+    EXPECT_STREQ("kFilterBox fell back to bilinear in ScalePlaneDown",
+                 choices[0].reason);
+    EXPECT_EQ(1, choices[0].simd);
+  }
+
+  // 1/2 with a stride that is not a multiple of 16.
+  KernelChoice choice;
+  EXPECT_EQ(0, ExplainScalePlane(src, kSrcWidth + 4, kSrcWidth, kSrcHeight,
+                                 dst, kSrcWidth / 2, kSrcWidth / 2,
+                                 kSrcHeight / 2, kFilterBox, &choice));
+  EXPECT_STREQ("ScalePlaneDown2", choice.path);
+  if (TestCpuFlag(kCpuHasSSE2)) {
+    EXPECT_STREQ("ScaleRowDown2Int_Unaligned_SSE2", choice.kernel);
+    EXPECT_EQ(1, choice.simd);
+  }
+
+  SetUseReferenceImpl(true);
+  EXPECT_EQ(0, ExplainScalePlane(src, kSrcWidth, kSrcWidth, kSrcHeight,
+                                 dst, kSrcWidth / 2, kSrcWidth / 2,
+                                 kSrcHeight / 2, kFilterNone, &choice));
+  SetUseReferenceImpl(false);
+  EXPECT_STREQ("ScalePlaneSimple", choice.path);
+  EXPECT_EQ(0, choice.simd);
+
+  EXPECT_EQ(0, ExplainScalePlane(src, kSrcWidth, kSrcWidth, kSrcHeight,
+                                 dst, kSrcWidth, kSrcWidth, kSrcHeight,
+                                 kFilterBox, &choice));
+  EXPECT_STREQ("CopyPlane", choice.path);
+
+  free_aligned_buffer_16(src)
+  free_aligned_buffer_16(dst)
+}
+
+}  // namespace libyuv
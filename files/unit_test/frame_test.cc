@@ -0,0 +1,151 @@
+/*
+ *  Copyright 2012 The LibYuv Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "libyuv/basic_types.h"
+#include "libyuv/convert_argb.h"
+#include "libyuv/cpu_id.h"
+#include "libyuv/explain.h"
+#include "libyuv/frame.h"
+#include "libyuv/row.h"
+#include "libyuv/video_common.h"
+#include "../unit_test/unit_test.h"
+
+namespace libyuv {
+
+TEST_F(libyuvTest, TestAllocFrame) {
+  YuvFrame frame;
+  EXPECT_EQ(0, AllocFrame(&frame, FOURCC_I420, 97, 33));
+  EXPECT_EQ(FOURCC_I420, frame.fourcc);
+  EXPECT_EQ(97, frame.width);
+  EXPECT_EQ(33, frame.height);
+  EXPECT_EQ(128, frame.stride[0]);
+  EXPECT_EQ(64, frame.stride[1]);
+  EXPECT_EQ(64, frame.stride[2]);
+  EXPECT_EQ(frame.size, FrameBufferSize(FOURCC_I420, 97, 33));
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_TRUE(IS_ALIGNED(frame.plane[i], kFrameAlignment));
+  }
+  // The padding after each plane is part of the frame.
+  EXPECT_LE(frame.plane[0] + 128 * 33 + kFramePadding, frame.plane[1]);
+  EXPECT_LE(frame.plane[1] + 64 * 17 + kFramePadding, frame.plane[2]);
+  EXPECT_LE(frame.plane[2] + 64 * 17 + kFramePadding,
+            frame.buffer + frame.size);
+  memset(frame.buffer, 0, frame.size);
+  EXPECT_EQ(0, FreeFrame(&frame));
+  EXPECT_TRUE(frame.buffer == NULL);
+
+  EXPECT_EQ(0, AllocFrame(&frame, FOURCC_NV12, 96, 96));
+  EXPECT_EQ(128, frame.stride[1]);
+  EXPECT_TRUE(frame.plane[2] == NULL);
+  EXPECT_EQ(0, FreeFrame(&frame));
+
+  EXPECT_EQ(0, AllocFrame(&frame, FOURCC_ARGB, 17, 1));
+  EXPECT_EQ(128, frame.stride[0]);
+  EXPECT_TRUE(frame.plane[1] == NULL);
+  EXPECT_EQ(0, FreeFrame(&frame));
+
+  EXPECT_EQ(-1, AllocFrame(&frame, FOURCC_YUY2, 64, 64));
+  EXPECT_EQ(-1, AllocFrame(&frame, FOURCC_I420, 0, 64));
+  EXPECT_EQ(-1, AllocFrame(NULL, FOURCC_I420, 64, 64));
+  EXPECT_EQ(0u, FrameBufferSize(FOURCC_ARGB, 64, -64));
+}
+
+TEST_F(libyuvTest, TestInitFrame) {
+  const int kWidth = 96;
+  const int kHeight = 96;
+  const size_t size = FrameBufferSize(FOURCC_ARGB, kWidth, kHeight);
+  align_buffer_page_end(buffer, static_cast<int>(size) + kFrameAlignment)
+  uint8* aligned = ALIGNP(buffer, kFrameAlignment);
+  YuvFrame frame;
+  EXPECT_EQ(-1, InitFrame(&frame, FOURCC_ARGB, kWidth, kHeight,
+                          aligned + 16));
+  EXPECT_EQ(0, InitFrame(&frame, FOURCC_ARGB, kWidth, kHeight, aligned));
+  EXPECT_TRUE(frame.plane[0] == aligned);
+  EXPECT_EQ(kWidth * 4, frame.stride[0]);
+  // The caller owns the memory, so FreeFrame only clears the frame.
+  EXPECT_TRUE(frame.buffer == NULL);
+  EXPECT_EQ(0, FreeFrame(&frame));
+  free_aligned_buffer_page_end(buffer)
+}
+
+TEST_F(libyuvTest, TestFramePool) {
+  FramePool* pool = CreateFramePool(2);
+  ASSERT_TRUE(pool != NULL);
+  YuvFrame frames[3];
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(0, AcquireFrame(pool, &frames[i], FOURCC_I420, 96, 96));
+  }
+  uint8* buffer0 = frames[0].buffer;
+  uint8* buffer1 = frames[1].buffer;
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(0, ReleaseFrame(pool, &frames[i]));
+    EXPECT_TRUE(frames[i].buffer == NULL);
+  }
+
+  // The pool keeps 2 frames of each size, so the third was freed and the
+  // last one kept comes back first.
+  YuvFrame frame;
+  EXPECT_EQ(0, AcquireFrame(pool, &frame, FOURCC_I420, 96, 96));
+  EXPECT_TRUE(frame.buffer == buffer1);
+  EXPECT_TRUE(IS_ALIGNED(frame.plane[1], kFrameAlignment));
+  EXPECT_EQ(0, ReleaseFrame(pool, &frame));
+  EXPECT_EQ(0, AcquireFrame(pool, &frame, FOURCC_I420, 96, 96));
+  EXPECT_TRUE(frame.buffer == buffer1);
+  EXPECT_EQ(0, ReleaseFrame(pool, &frame));
+
+  // Other sizes and formats have their own frames.
+  EXPECT_EQ(0, AcquireFrame(pool, &frame, FOURCC_ARGB, 96, 96));
+  EXPECT_TRUE(frame.buffer != buffer0 && frame.buffer != buffer1);
+  EXPECT_EQ(0, ReleaseFrame(pool, &frame));
+  EXPECT_EQ(0, AcquireFrame(pool, &frame, FOURCC_I420, 96, 64));
+  EXPECT_TRUE(frame.buffer != buffer0 && frame.buffer != buffer1);
+  EXPECT_EQ(0, ReleaseFrame(pool, &frame));
+
+  // A frame acquired from the pool can outlive it.
+  EXPECT_EQ(0, AcquireFrame(pool, &frame, FOURCC_NV12, 64, 64));
+  DestroyFramePool(pool);
+  EXPECT_EQ(-1, ReleaseFrame(NULL, &frame));
+  EXPECT_EQ(0, FreeFrame(&frame));
+  EXPECT_TRUE(CreateFramePool(-1) == NULL);
+}
+
+// Frames from AllocFrame take the aligned row functions.
+TEST_F(libyuvTest, TestFrameConvert) {
+  YuvFrame src;
+  YuvFrame dst;
+  EXPECT_EQ(0, AllocFrame(&src, FOURCC_I420, 96, 96));
+  EXPECT_EQ(0, AllocFrame(&dst, FOURCC_ARGB, 96, 96));
+  memset(src.plane[0], 128, src.stride[0] * 96);
+  memset(src.plane[1], 128, src.stride[1] * 48);
+  memset(src.plane[2], 128, src.stride[2] * 48);
+  EXPECT_EQ(0, I420ToARGB(src.plane[0], src.stride[0],
+                          src.plane[1], src.stride[1],
+                          src.plane[2], src.stride[2],
+                          dst.plane[0], dst.stride[0], 96, 96));
+  for (int y = 0; y < 96; ++y) {
+    EXPECT_EQ(255, dst.plane[0][y * dst.stride[0] + 95 * 4 + 3]);
+  }
+  KernelChoice choice;
+  EXPECT_EQ(0, ExplainI420ToARGB(src.plane[0], src.stride[0],
+                                 src.plane[1], src.stride[1],
+                                 src.plane[2], src.stride[2],
+                                 dst.plane[0], dst.stride[0], 96, 96,
+                                 &choice));
+  if (TestCpuFlag(kCpuHasSSSE3)) {
+    EXPECT_STREQ("I422ToARGBRow_SSSE3", choice.kernel);
+  }
+  EXPECT_EQ(0, FreeFrame(&src));
+  EXPECT_EQ(0, FreeFrame(&dst));
+}
+
+}  // namespace libyuv
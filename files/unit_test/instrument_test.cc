@@ -0,0 +1,124 @@
+/*
+ *  Copyright 2012 The LibYuv Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "libyuv/basic_types.h"
+#include "libyuv/convert_argb.h"
+#include "libyuv/frame.h"
+#include "libyuv/instrument.h"
+#include "libyuv/scale.h"
+#include "libyuv/scale_argb.h"
+#include "libyuv/video_common.h"
+#include "../unit_test/unit_test.h"
+
+namespace libyuv {
+
+static void CountCalls(void* opaque, const char* function, const char*,
+                       int width, int height, uint64) {
+  if (!strcmp(function, "ScalePlane")) {
+    EXPECT_EQ(32, width);
+    EXPECT_EQ(16, height);
+    ++*static_cast<int*>(opaque);
+  }
+}
+
+// Finds the totals of function, and of kernel unless kernel is NULL.
+static const InstrumentStats* FindStats(const InstrumentStats* stats, int n,
+                                        const char* function,
+                                        const char* kernel) {
+  for (int i = 0; i < n; ++i) {
+    if (!strcmp(stats[i].function, function) &&
+        (!kernel || !strcmp(stats[i].kernel, kernel))) {
+      return &stats[i];
+    }
+  }
+  return NULL;
+}
+
+TEST_F(libyuvTest, TestInstrument) {
+  if (ResetInstrumentStats() != 0) {
+    // Built without LIBYUV_INSTRUMENT.
+    EXPECT_EQ(-1, GetInstrumentStats(NULL, 0));
+    EXPECT_EQ(-1, SetInstrumentCallback(CountCalls, NULL));
+    return;
+  }
+  const int kWidth = 64;
+  const int kHeight = 32;
+  align_buffer_16(src_y, kWidth * kHeight)
+  align_buffer_16(src_uv, kWidth * kHeight / 2)
+  align_buffer_16(dst_argb, kWidth * 4 * kHeight)
+  memset(src_y, 128, kWidth * kHeight);
+  memset(src_uv, 128, kWidth * kHeight / 2);
+
+  int calls = 0;
+  EXPECT_EQ(0, SetInstrumentCallback(CountCalls, &calls));
+  for (int i = 0; i < 2; ++i) {
+    I420ToARGB(src_y, kWidth, src_uv, kWidth / 2,
+               src_uv + kWidth * kHeight / 4, kWidth / 2,
+               dst_argb, kWidth * 4, kWidth, kHeight);
+  }
+  ScalePlane(src_y, kWidth, kWidth, kHeight, dst_argb, kWidth,
+             kWidth / 2, kHeight / 2, kFilterBox);
+  EXPECT_EQ(0, SetInstrumentCallback(NULL, NULL));
+  ScalePlane(src_y, kWidth, kWidth, kHeight, dst_argb, kWidth,
+             kWidth / 2, kHeight / 2, kFilterBox);
+  EXPECT_EQ(1, calls);
+
+  InstrumentStats stats[64];
+  const int n = GetInstrumentStats(stats, 64);
+  EXPECT_LE(2, n);
+  const InstrumentStats* convert = FindStats(stats, n, "I420ToARGB", NULL);
+  ASSERT_TRUE(convert != NULL);
+  EXPECT_EQ(2u, convert->calls);
+  EXPECT_EQ(static_cast<uint64>(2 * kWidth * kHeight), convert->pixels);
+  EXPECT_TRUE(strstr(convert->kernel, "I422ToARGBRow_") != NULL);
+  const InstrumentStats* scale = FindStats(stats, n, "ScalePlane", NULL);
+  ASSERT_TRUE(scale != NULL);
+  EXPECT_EQ(2u, scale->calls);
+  EXPECT_STREQ("ScalePlaneDown2", scale->kernel);
+  printf("%s used %s\n", convert->function, convert->kernel);
+
+  // Each frame of a batch is recorded as a call with the path its own
+  // sizes chose.
+  YuvFrame src_frames[2];
+  YuvFrame dst_frames[2];
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_EQ(0, AllocFrame(&src_frames[i], FOURCC_ARGB, 16, 8));
+    EXPECT_EQ(0, AllocFrame(&dst_frames[i], FOURCC_ARGB, 8 << i, 4 << i));
+    memset(src_frames[i].buffer, 0, src_frames[i].size);
+  }
+  EXPECT_EQ(0, ARGBScaleBatch(src_frames, dst_frames, 2, kFilterBilinear, 2));
+  const int num_stats = GetInstrumentStats(stats, 64);
+  const InstrumentStats* down2 =
+      FindStats(stats, num_stats, "ARGBScaleBatch", "ScaleARGBDown2");
+  ASSERT_TRUE(down2 != NULL);
+  EXPECT_EQ(1u, down2->calls);
+  EXPECT_EQ(static_cast<uint64>(8 * 4), down2->pixels);
+  const InstrumentStats* copy =
+      FindStats(stats, num_stats, "ARGBScaleBatch", "ARGBCopy");
+  ASSERT_TRUE(copy != NULL);
+  EXPECT_EQ(1u, copy->calls);
+  EXPECT_EQ(static_cast<uint64>(16 * 8), copy->pixels);
+  for (int i = 0; i < 2; ++i) {
+    FreeFrame(&src_frames[i]);
+    FreeFrame(&dst_frames[i]);
+  }
+
+  EXPECT_EQ(0, ResetInstrumentStats());
+  EXPECT_EQ(0, GetInstrumentStats(stats, 64));
+
+  free_aligned_buffer_16(src_y)
+  free_aligned_buffer_16(src_uv)
+  free_aligned_buffer_16(dst_argb)
+}
+
+}  // namespace libyuv
@@ -0,0 +1,225 @@
+/*
+ *  Copyright 2012 The LibYuv Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libyuv/basic_types.h"
+#include "libyuv/convert.h"
+#include "libyuv/mjpeg_decoder.h"
+#include "../unit_test/unit_test.h"
+
+#ifdef HAVE_JPEG
+extern "C" {
+#include <jpeglib.h>
+}
+#endif
+
+namespace libyuv {
+
+// SOI, DRI, SOF0 for 1920x1080 4:2:2, SOS. Tables are omitted as the parser
+// only skips them.
+static const uint8 kTestHeader[] = {
+  0xff, 0xd8,
+  0xff, 0xdd, 0x00, 0x04, 0x00, 0x78,
+  0xff, 0xc0, 0x00, 0x11, 0x08, 0x04, 0x38, 0x07, 0x80, 0x03,
+  0x01, 0x21, 0x00, 0x02, 0x11, 0x01, 0x03, 0x11, 0x01,
+  0xff, 0xda, 0x00, 0x0c, 0x03, 0x01, 0x00, 0x02, 0x11, 0x03, 0x11,
+  0x00, 0x3f, 0x00,
+};
+
+TEST_F(libyuvTest, ParseJpegHeader) {
+  JpegHeader header;
+  EXPECT_TRUE(ParseJpegHeader(kTestHeader, sizeof(kTestHeader), &header));
+  EXPECT_EQ(1920, header.width);
+  EXPECT_EQ(1080, header.height);
+  EXPECT_EQ(3, header.num_components);
+  EXPECT_EQ(3, header.comps_in_scan);
+  EXPECT_EQ(2, header.horiz_samp_factor[0]);
+  EXPECT_EQ(1, header.vert_samp_factor[0]);
+  EXPECT_EQ(1, header.horiz_samp_factor[1]);
+  EXPECT_EQ(1, header.vert_samp_factor[2]);
+  EXPECT_EQ(120, header.restart_interval);
+  EXPECT_FALSE(header.progressive);
+  EXPECT_EQ(kJpegYuv422, header.subsampling);
+
+  int width = 0;
+  int height = 0;
+  EXPECT_EQ(0, MJPGSize(kTestHeader, sizeof(kTestHeader), &width, &height));
+  EXPECT_EQ(1920, width);
+  EXPECT_EQ(1080, height);
+
+  // Truncated before SOS.
+  EXPECT_FALSE(ParseJpegHeader(kTestHeader, 27, &header));
+  // Not a jpeg.
+  EXPECT_FALSE(ParseJpegHeader(kTestHeader + 2, sizeof(kTestHeader) - 2,
+                               &header));
+  EXPECT_EQ(-1, MJPGSize(kTestHeader, 27, &width, &height));
+}
+
+#ifdef HAVE_JPEG
+
+// Destination manager writing into a caller provided buffer, which works with
+// jpeglib versions that lack jpeg_mem_dest().
+struct TestJpegDest {
+  jpeg_destination_mgr base;  // Must be at the top
+  uint8* data;
+  size_t size;
+};
+
+static void TestInitDestination(j_compress_ptr cinfo) {
+  TestJpegDest* dest = reinterpret_cast<TestJpegDest*>(cinfo->dest);
+  dest->base.next_output_byte = dest->data;
+  dest->base.free_in_buffer = dest->size;
+}
+
+static boolean TestEmptyOutputBuffer(j_compress_ptr) {
+  return FALSE;  // Buffer is sized for the whole image.
+}
+
+static void TestTermDestination(j_compress_ptr) {
+}
+
+// Encodes a YCbCr 4:2:0 gradient with a restart marker every
+// restart_in_rows MCU rows. Returns the size of the jpeg.
+static size_t EncodeTestJpeg(uint8* dst, size_t dst_size,
+                             int width, int height, int restart_in_rows) {
+  jpeg_compress_struct cinfo;
+  jpeg_error_mgr jerr;
+  cinfo.err = jpeg_std_error(&jerr);
+  jpeg_create_compress(&cinfo);
+  TestJpegDest dest;
+  dest.base.init_destination = &TestInitDestination;
+  dest.base.empty_output_buffer = &TestEmptyOutputBuffer;
+  dest.base.term_destination = &TestTermDestination;
+  dest.data = dst;
+  dest.size = dst_size;
+  cinfo.dest = &dest.base;
+  cinfo.image_width = width;
+  cinfo.image_height = height;
+  cinfo.input_components = 3;
+  cinfo.in_color_space = JCS_RGB;
+  jpeg_set_defaults(&cinfo);
+  jpeg_set_quality(&cinfo, 90, TRUE);
+  cinfo.restart_in_rows = restart_in_rows;
+  jpeg_start_compress(&cinfo, TRUE);
+  uint8* row = new uint8[width * 3];
+  while (cinfo.next_scanline < cinfo.image_height) {
+    int y = cinfo.next_scanline;
+    for (int x = 0; x < width; ++x) {
+      row[x * 3 + 0] = static_cast<uint8>(x + y);
+      row[x * 3 + 1] = static_cast<uint8>(x * 3 - y);
+      row[x * 3 + 2] = static_cast<uint8>((x ^ y) * 7);
+    }
+    JSAMPROW rows[1] = { row };
+    jpeg_write_scanlines(&cinfo, rows, 1);
+  }
+  jpeg_finish_compress(&cinfo);
+  size_t size = dst_size - dest.base.free_in_buffer;
+  jpeg_destroy_compress(&cinfo);
+  delete [] row;
+  return size;
+}
+
+static void TestRestartGroups(int width, int height, int restart_in_rows) {
+  const size_t kJpegSize = width * height * 4 + 4096;
+  uint8* jpeg = new uint8[kJpegSize];
+  size_t jpeg_size = EncodeTestJpeg(jpeg, kJpegSize, width, height,
+                                    restart_in_rows);
+
+  MJpegDecoder decoder;
+  ASSERT_TRUE(decoder.LoadFrame(jpeg, jpeg_size));
+  EXPECT_GT(decoder.GetRestartInterval(), 0);
+  int mcu_rows = (height + decoder.GetImageScanlinesPerImcuRow() - 1) /
+                 decoder.GetImageScanlinesPerImcuRow();
+  EXPECT_EQ((mcu_rows + restart_in_rows - 1) / restart_in_rows,
+            decoder.GetNumRestartGroups());
+
+  int total_size = 0;
+  for (int i = 0; i < decoder.GetNumComponents(); ++i) {
+    total_size += decoder.GetComponentSize(i);
+  }
+  uint8* dst_c = new uint8[total_size];
+  uint8* dst_opt = new uint8[total_size];
+  memset(dst_c, 1, total_size);
+  memset(dst_opt, 2, total_size);
+
+  uint8* planes[3];
+  planes[0] = dst_c;
+  planes[1] = planes[0] + decoder.GetComponentSize(0);
+  planes[2] = planes[1] + decoder.GetComponentSize(1);
+  decoder.SetNumThreads(1);
+  EXPECT_TRUE(decoder.DecodeToBuffers(planes, width, height));
+  EXPECT_EQ(dst_c + total_size, planes[2]);
+
+  ASSERT_TRUE(decoder.LoadFrame(jpeg, jpeg_size));
+  planes[0] = dst_opt;
+  planes[1] = planes[0] + decoder.GetComponentSize(0);
+  planes[2] = planes[1] + decoder.GetComponentSize(1);
+  decoder.SetNumThreads(4);
+  EXPECT_TRUE(decoder.DecodeToBuffers(planes, width, height));
+  EXPECT_EQ(dst_opt + total_size, planes[2]);
+
+  EXPECT_EQ(0, memcmp(dst_c, dst_opt, total_size));
+
+  delete [] dst_c;
+  delete [] dst_opt;
+  delete [] jpeg;
+}
+
+TEST_F(libyuvTest, MJpegRestartGroups) {
+  TestRestartGroups(640, 480, 1);
+}
+
+TEST_F(libyuvTest, MJpegRestartGroupsOdd) {
+  TestRestartGroups(333, 197, 2);
+}
+
+TEST_F(libyuvTest, ParseJpegHeaderMatchesDecoder) {
+  const int kWidth = 333;
+  const int kHeight = 197;
+  const size_t kJpegSize = kWidth * kHeight * 4 + 4096;
+  uint8* jpeg = new uint8[kJpegSize];
+  size_t jpeg_size = EncodeTestJpeg(jpeg, kJpegSize, kWidth, kHeight, 2);
+  JpegHeader header;
+  EXPECT_TRUE(ParseJpegHeader(jpeg, jpeg_size, &header));
+  MJpegDecoder decoder;
+  ASSERT_TRUE(decoder.LoadFrame(jpeg, jpeg_size));
+  EXPECT_EQ(decoder.GetWidth(), header.width);
+  EXPECT_EQ(decoder.GetHeight(), header.height);
+  EXPECT_EQ(decoder.GetNumComponents(), header.num_components);
+  for (int i = 0; i < header.num_components; ++i) {
+    EXPECT_EQ(decoder.GetHorizSampFactor(i), header.horiz_samp_factor[i]);
+    EXPECT_EQ(decoder.GetVertSampFactor(i), header.vert_samp_factor[i]);
+  }
+  EXPECT_EQ(decoder.GetRestartInterval(), header.restart_interval);
+  EXPECT_EQ(kJpegYuv420, header.subsampling);
+  decoder.UnloadFrame();
+  delete [] jpeg;
+}
+
+TEST_F(libyuvTest, MJpegNoRestartMarkers) {
+  const int kWidth = 64;
+  const int kHeight = 64;
+  const size_t kJpegSize = kWidth * kHeight * 4 + 4096;
+  uint8* jpeg = new uint8[kJpegSize];
+  size_t jpeg_size = EncodeTestJpeg(jpeg, kJpegSize, kWidth, kHeight, 0);
+  MJpegDecoder decoder;
+  ASSERT_TRUE(decoder.LoadFrame(jpeg, jpeg_size));
+  EXPECT_EQ(0, decoder.GetRestartInterval());
+  EXPECT_EQ(1, decoder.GetNumRestartGroups());
+  decoder.UnloadFrame();
+  delete [] jpeg;
+}
+
+#endif  // HAVE_JPEG
+
+}  // namespace libyuv
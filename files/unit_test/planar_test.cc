@@ -8,16 +8,22 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <math.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
 #include "libyuv/convert_argb.h"
 #include "libyuv/convert_from.h"
 #include "libyuv/compare.h"
+#include "libyuv/convert.h"
 #include "libyuv/cpu_id.h"
+#include "libyuv/explain.h"
 #include "libyuv/format_conversion.h"
+#include "libyuv/frame.h"
 #include "libyuv/planar_functions.h"
 #include "libyuv/rotate.h"
+#include "libyuv/video_common.h"
 #include "../unit_test/unit_test.h"
 
 #if defined(_MSC_VER)
@@ -28,6 +34,55 @@
 
 namespace libyuv {
 
+// Row kernels of the conversions that have an Explain function, for the
+// perf baseline. Others return NULL.
+static const char* PlanarToBKernel(const char* name,
+                                   const uint8* src_y, int src_stride_y,
+                                   const uint8* src_u, int src_stride_u,
+                                   const uint8* src_v, int src_stride_v,
+                                   const uint8* dst, int dst_stride,
+                                   int width, int height) {
+  KernelChoice choice;
+  if (!strcmp(name, "I420ToARGB") &&
+      !ExplainI420ToARGB(src_y, src_stride_y, src_u, src_stride_u,
+                         src_v, src_stride_v, dst, dst_stride,
+                         width, height, &choice)) {
+    return choice.kernel;
+  }
+  return NULL;
+}
+
+static const char* BiPlanarToBKernel(const char* name,
+                                     const uint8* src_y, int src_stride_y,
+                                     const uint8* src_uv, int src_stride_uv,
+                                     const uint8* dst, int dst_stride,
+                                     int width, int height) {
+  KernelChoice choice;
+  if (!strcmp(name, "NV12ToARGB") &&
+      !ExplainNV12ToARGB(src_y, src_stride_y, src_uv, src_stride_uv,
+                         dst, dst_stride, width, height, &choice)) {
+    return choice.kernel;
+  }
+  return NULL;
+}
+
+// The Y row kernel, which does most of the work.
+static const char* AToPlanarKernel(const char* name,
+                                   const uint8* src, int src_stride,
+                                   const uint8* dst_y, int dst_stride_y,
+                                   const uint8* dst_u, int dst_stride_u,
+                                   const uint8* dst_v, int dst_stride_v,
+                                   int width, int height) {
+  KernelChoice choices[2];
+  if (!strcmp(name, "ARGBToI420") &&
+      !ExplainARGBToI420(src, src_stride, dst_y, dst_stride_y,
+                         dst_u, dst_stride_u, dst_v, dst_stride_v,
+                         width, height, choices)) {
+    return choices[0].kernel;
+  }
+  return NULL;
+}
+
 #define TESTPLANARTOBI(FMT_PLANAR, SUBSAMP_X, SUBSAMP_Y, FMT_B, BPP_B, N, NEG) \
 TEST_F(libyuvTest, FMT_PLANAR##To##FMT_B##N##_OptVsC) {                        \
   const int kWidth = 1280;                                                     \
@@ -48,19 +103,28 @@ TEST_F(libyuvTest, FMT_PLANAR##To##FMT_B##N##_OptVsC) {                        \
       src_v[(i * kWidth / SUBSAMP_X) + j] = (random() & 0xff);                 \
     }                                                                          \
   MaskCpuFlags(kCpuInitialized);                                               \
-  FMT_PLANAR##To##FMT_B(src_y, kWidth,                                         \
-                        src_u, kWidth / SUBSAMP_X,                             \
-                        src_v, kWidth / SUBSAMP_X,                             \
-                        dst_argb_c, kStride,                                   \
-                        kWidth, NEG kHeight);                                  \
+  PerfTimer c_timer(1);                                                        \
+  while (c_timer.Running()) {                                                  \
+    FMT_PLANAR##To##FMT_B(src_y, kWidth,                                       \
+                          src_u, kWidth / SUBSAMP_X,                           \
+                          src_v, kWidth / SUBSAMP_X,                           \
+                          dst_argb_c, kStride,                                 \
+                          kWidth, NEG kHeight);                                \
+  }                                                                            \
   MaskCpuFlags(-1);                                                            \
-  for (int i = 0; i < benchmark_iterations_; ++i) {                            \
+  PerfTimer timer(benchmark_iterations_);                                      \
+  while (timer.Running()) {                                                    \
     FMT_PLANAR##To##FMT_B(src_y, kWidth,                                       \
                           src_u, kWidth / SUBSAMP_X,                           \
                           src_v, kWidth / SUBSAMP_X,                           \
                           dst_argb_opt, kStride,                               \
                           kWidth, NEG kHeight);                                \
   }                                                                            \
+  PerfCheck(NULL, timer, c_timer, kWidth * kHeight,                            \
+            PlanarToBKernel(#FMT_PLANAR "To" #FMT_B, src_y, kWidth,            \
+                            src_u, kWidth / SUBSAMP_X,                         \
+                            src_v, kWidth / SUBSAMP_X,                         \
+                            dst_argb_opt, kStride, kWidth, NEG kHeight));      \
   int max_diff = 0;                                                            \
   for (int i = 0; i < kHeight; ++i) {                                          \
     for (int j = 0; j < kWidth * BPP_B; ++j) {                                 \
@@ -127,17 +191,26 @@ TEST_F(libyuvTest, FMT_PLANAR##To##FMT_B##N##_OptVsC) {                        \
       src_uv[(i * kWidth / SUBSAMP_X) * 2 + j] = (random() & 0xff);            \
     }                                                                          \
   MaskCpuFlags(kCpuInitialized);                                               \
-  FMT_PLANAR##To##FMT_B(src_y, kWidth,                                         \
-                        src_uv, kWidth / SUBSAMP_X * 2,                        \
-                        dst_argb_c, kWidth * BPP_B,                            \
-                        kWidth, NEG kHeight);                                  \
+  PerfTimer c_timer(1);                                                        \
+  while (c_timer.Running()) {                                                  \
+    FMT_PLANAR##To##FMT_B(src_y, kWidth,                                       \
+                          src_uv, kWidth / SUBSAMP_X * 2,                      \
+                          dst_argb_c, kWidth * BPP_B,                          \
+                          kWidth, NEG kHeight);                                \
+  }                                                                            \
   MaskCpuFlags(-1);                                                            \
-  for (int i = 0; i < benchmark_iterations_; ++i) {                            \
+  PerfTimer timer(benchmark_iterations_);                                      \
+  while (timer.Running()) {                                                    \
     FMT_PLANAR##To##FMT_B(src_y, kWidth,                                       \
                           src_uv, kWidth / SUBSAMP_X * 2,                      \
                           dst_argb_opt, kWidth * BPP_B,                        \
                           kWidth, NEG kHeight);                                \
   }                                                                            \
+  PerfCheck(NULL, timer, c_timer, kWidth * kHeight,                            \
+            BiPlanarToBKernel(#FMT_PLANAR "To" #FMT_B, src_y, kWidth,          \
+                              src_uv, kWidth / SUBSAMP_X * 2,                  \
+                              dst_argb_opt, kWidth * BPP_B,                    \
+                              kWidth, NEG kHeight));                           \
   int max_diff = 0;                                                            \
   for (int i = 0; i < kHeight; ++i) {                                          \
     for (int j = 0; j < kWidth * BPP_B; ++j) {                                 \
@@ -182,19 +255,29 @@ TEST_F(libyuvTest, FMT_A##To##FMT_PLANAR##N##_OptVsC) {                        \
     for (int j = 0; j < kStride; ++j)                                          \
       src_argb[(i * kStride) + j] = (random() & 0xff);                         \
   MaskCpuFlags(kCpuInitialized);                                               \
-  FMT_A##To##FMT_PLANAR(src_argb, kStride,                                     \
-                        dst_y_c, kWidth,                                       \
-                        dst_u_c, kWidth / SUBSAMP_X,                           \
-                        dst_v_c, kWidth / SUBSAMP_X,                           \
-                        kWidth, NEG kHeight);                                  \
+  PerfTimer c_timer(1);                                                        \
+  while (c_timer.Running()) {                                                  \
+    FMT_A##To##FMT_PLANAR(src_argb, kStride,                                   \
+                          dst_y_c, kWidth,                                     \
+                          dst_u_c, kWidth / SUBSAMP_X,                         \
+                          dst_v_c, kWidth / SUBSAMP_X,                         \
+                          kWidth, NEG kHeight);                                \
+  }                                                                            \
   MaskCpuFlags(-1);                                                            \
-  for (int i = 0; i < benchmark_iterations_; ++i) {                            \
+  PerfTimer timer(benchmark_iterations_);                                      \
+  while (timer.Running()) {                                                    \
     FMT_A##To##FMT_PLANAR(src_argb, kStride,                                   \
                           dst_y_opt, kWidth,                                   \
                           dst_u_opt, kWidth / SUBSAMP_X,                       \
                           dst_v_opt, kWidth / SUBSAMP_X,                       \
                           kWidth, NEG kHeight);                                \
   }                                                                            \
+  PerfCheck(NULL, timer, c_timer, kWidth * kHeight,                            \
+            AToPlanarKernel(#FMT_A "To" #FMT_PLANAR, src_argb, kStride,        \
+                            dst_y_opt, kWidth,                                 \
+                            dst_u_opt, kWidth / SUBSAMP_X,                     \
+                            dst_v_opt, kWidth / SUBSAMP_X,                     \
+                            kWidth, NEG kHeight));                             \
   int max_diff = 0;                                                            \
   for (int i = 0; i < kHeight; ++i) {                                          \
     for (int j = 0; j < kWidth; ++j) {                                         \
@@ -278,15 +361,20 @@ TEST_F(libyuvTest, FMT_A##To##FMT_B##N##_OptVsC) {                             \
     src_argb[i] = (random() & 0xff);                                           \
   }                                                                            \
   MaskCpuFlags(kCpuInitialized);                                               \
-  FMT_A##To##FMT_B(src_argb, kWidth * STRIDE_A,                                \
-                   dst_argb_c, kWidth * BPP_B,                                 \
-                   kWidth, NEG kHeight);                                       \
+  PerfTimer c_timer(1);                                                        \
+  while (c_timer.Running()) {                                                  \
+    FMT_A##To##FMT_B(src_argb, kWidth * STRIDE_A,                              \
+                     dst_argb_c, kWidth * BPP_B,                               \
+                     kWidth, NEG kHeight);                                     \
+  }                                                                            \
   MaskCpuFlags(-1);                                                            \
-  for (int i = 0; i < benchmark_iterations_; ++i) {                            \
+  PerfTimer timer(benchmark_iterations_);                                      \
+  while (timer.Running()) {                                                    \
     FMT_A##To##FMT_B(src_argb, kWidth * STRIDE_A,                              \
                      dst_argb_opt, kWidth * BPP_B,                             \
                      kWidth, NEG kHeight);                                     \
   }                                                                            \
+  PerfCheck(NULL, timer, c_timer, kWidth * kHeight, NULL);                     \
   int max_diff = 0;                                                            \
   for (int i = 0; i < kHeight * kWidth * BPP_B; ++i) {                         \
     int abs_diff =                                                             \
@@ -383,6 +471,543 @@ TESTATOBRANDOM(RGB565, 2, 2, ARGB, 4)
 TESTATOBRANDOM(ARGB1555, 2, 2, ARGB, 4)
 TESTATOBRANDOM(ARGB4444, 2, 2, ARGB, 4)
 
+// Fills an attenuated ARGB image with transparent and opaque areas.
+static void FillLayer(uint8* argb, int width, int height) {
+  for (int i = 0; i < width * height; ++i) {
+    int x = i % width;
+    int a = (x / 40) % 3 == 0 ? 0 : (x / 40) % 3 == 1 ? 255 : random() & 0xff;
+    if (a == 0) {
+      argb[i * 4 + 0] = argb[i * 4 + 1] = argb[i * 4 + 2] = 0;
+    } else {
+      argb[i * 4 + 0] = (random() & 0xff) * a / 255;
+      argb[i * 4 + 1] = (random() & 0xff) * a / 255;
+      argb[i * 4 + 2] = (random() & 0xff) * a / 255;
+    }
+    argb[i * 4 + 3] = a;
+  }
+}
+
+TEST_F(libyuvTest, TestARGBBlend) {
+  const int kWidth = 1283;
+  align_buffer_16(src_argb0, kWidth * 4)
+  align_buffer_16(src_argb1, kWidth * 4)
+  align_buffer_16(dst_c, kWidth * 4)
+  align_buffer_16(dst_opt, kWidth * 4)
+  FillLayer(src_argb0, kWidth, 1);
+  for (int i = 0; i < kWidth * 4; ++i) {
+    src_argb1[i] = (random() & 0xff);
+  }
+  // Odd widths and offsets exercise the single pixel loops.
+  for (int w = 1; w < 40; w += 3) {
+    for (int off = 0; off < 4; ++off) {
+      MaskCpuFlags(kCpuInitialized);
+      ARGBBlend(src_argb0 + off * 4, 0, src_argb1, 0, dst_c, 0, w, 1);
+      MaskCpuFlags(-1);
+      ARGBBlend(src_argb0 + off * 4, 0, src_argb1, 0, dst_opt, 0, w, 1);
+      EXPECT_EQ(0, memcmp(dst_c, dst_opt, w * 4));
+    }
+  }
+  MaskCpuFlags(kCpuInitialized);
+  ARGBBlend(src_argb0, 0, src_argb1, 0, dst_c, 0, kWidth, 1);
+  MaskCpuFlags(-1);
+  for (int i = 0; i < benchmark_iterations_; ++i) {
+    ARGBBlend(src_argb0, 0, src_argb1, 0, dst_opt, 0, kWidth, 1);
+  }
+  EXPECT_EQ(0, memcmp(dst_c, dst_opt, kWidth * 4));
+  free_aligned_buffer_16(src_argb0)
+  free_aligned_buffer_16(src_argb1)
+  free_aligned_buffer_16(dst_c)
+  free_aligned_buffer_16(dst_opt)
+}
+
+TEST_F(libyuvTest, TestARGBComposite) {
+  const int kWidth = 640;
+  const int kHeight = 360;
+  const int kNumLayers = 4;
+  const int kLayerWidth[kNumLayers] = { 640, 301, 200, 517 };
+  const int kLayerHeight[kNumLayers] = { 360, 97, 50, 120 };
+  const int kLayerX[kNumLayers] = { 0, 17, -30, 400 };
+  const int kLayerY[kNumLayers] = { 0, 100, -10, 300 };
+  const int kLayerAlpha[kNumLayers] = { 255, 255, 128, 200 };
+  uint8* layer_argb[kNumLayers];
+  ARGBLayer layers[kNumLayers];
+  for (int i = 0; i < kNumLayers; ++i) {
+    layer_argb[i] = new uint8[kLayerWidth[i] * kLayerHeight[i] * 4];
+    FillLayer(layer_argb[i], kLayerWidth[i], kLayerHeight[i]);
+    layers[i].src_argb = layer_argb[i];
+    layers[i].src_stride_argb = kLayerWidth[i] * 4;
+    layers[i].x = kLayerX[i];
+    layers[i].y = kLayerY[i];
+    layers[i].width = kLayerWidth[i];
+    layers[i].height = kLayerHeight[i];
+    layers[i].alpha = kLayerAlpha[i];
+  }
+  align_buffer_16(src_argb, kWidth * kHeight * 4)
+  align_buffer_16(dst_ref, kWidth * kHeight * 4)
+  align_buffer_16(dst_c, kWidth * kHeight * 4)
+  align_buffer_16(dst_opt, kWidth * kHeight * 4)
+  align_buffer_16(faded, kWidth * kHeight * 4)
+  for (int i = 0; i < kWidth * kHeight * 4; ++i) {
+    src_argb[i] = (i & 3) == 3 ? 255 : (random() & 0xff);
+  }
+
+  for (int f = 0; f < 2; ++f) {
+    MaskCpuFlags(f ? -1 : kCpuInitialized);
+    // Reference blends each clipped layer over the whole image in turn.
+    memcpy(dst_ref, src_argb, kWidth * kHeight * 4);
+    for (int i = 0; i < kNumLayers; ++i) {
+      int x0 = kLayerX[i] < 0 ? 0 : kLayerX[i];
+      int y0 = kLayerY[i] < 0 ? 0 : kLayerY[i];
+      int x1 = kLayerX[i] + kLayerWidth[i];
+      int y1 = kLayerY[i] + kLayerHeight[i];
+      x1 = x1 < kWidth ? x1 : kWidth;
+      y1 = y1 < kHeight ? y1 : kHeight;
+      int stride = kLayerWidth[i] * 4;
+      const uint8* src = layer_argb[i] + (y0 - kLayerY[i]) * stride +
+                         (x0 - kLayerX[i]) * 4;
+      if (kLayerAlpha[i] != 255) {
+        ARGBShade(src, stride, faded, kWidth * 4, x1 - x0, y1 - y0,
+                  kLayerAlpha[i] * 0x01010101u);
+        src = faded;
+        stride = kWidth * 4;
+      }
+      uint8* dst = dst_ref + y0 * kWidth * 4 + x0 * 4;
+      ARGBBlend(src, stride, dst, kWidth * 4, dst, kWidth * 4,
+                x1 - x0, y1 - y0);
+    }
+    uint8* dst = f ? dst_opt : dst_c;
+    memcpy(dst, src_argb, kWidth * kHeight * 4);
+    EXPECT_EQ(0, ARGBComposite(layers, kNumLayers, dst, kWidth * 4,
+                               kWidth, kHeight));
+    EXPECT_EQ(0, memcmp(dst_ref, dst, kWidth * kHeight * 4));
+  }
+  EXPECT_EQ(0, memcmp(dst_c, dst_opt, kWidth * kHeight * 4));
+
+  for (int i = 0; i < benchmark_iterations_; ++i) {
+    ARGBComposite(layers, kNumLayers, dst_opt, kWidth * 4, kWidth, kHeight);
+  }
+  EXPECT_EQ(-1, ARGBComposite(NULL, 1, dst_opt, kWidth * 4, kWidth, kHeight));
+  layers[1].alpha = 256;
+  EXPECT_EQ(-1, ARGBComposite(layers, kNumLayers, dst_opt, kWidth * 4,
+                              kWidth, kHeight));
+
+  for (int i = 0; i < kNumLayers; ++i) {
+    delete [] layer_argb[i];
+  }
+  free_aligned_buffer_16(src_argb)
+  free_aligned_buffer_16(dst_ref)
+  free_aligned_buffer_16(dst_c)
+  free_aligned_buffer_16(dst_opt)
+  free_aligned_buffer_16(faded)
+}
+
+TEST_F(libyuvTest, TestBlendPlane) {
+  const int kWidth = 1283;
+  const int kHeight = 4;
+  align_buffer_16(src_y0, kWidth * kHeight)
+  align_buffer_16(src_y1, kWidth * kHeight)
+  align_buffer_16(alpha, kWidth * kHeight)
+  align_buffer_16(dst_c, kWidth * kHeight)
+  align_buffer_16(dst_opt, kWidth * kHeight)
+  for (int i = 0; i < kWidth * kHeight; ++i) {
+    src_y0[i] = (random() & 0xff);
+    src_y1[i] = (random() & 0xff);
+    alpha[i] = (random() & 0xff);
+  }
+  alpha[0] = 0;
+  alpha[1] = 255;
+  for (int w = 1; w < 40; w += 3) {
+    MaskCpuFlags(kCpuInitialized);
+    BlendPlane(src_y0, 0, src_y1, 0, alpha, 0, dst_c, 0, w, 1);
+    MaskCpuFlags(-1);
+    BlendPlane(src_y0, 0, src_y1, 0, alpha, 0, dst_opt, 0, w, 1);
+    EXPECT_EQ(0, memcmp(dst_c, dst_opt, w));
+  }
+  MaskCpuFlags(kCpuInitialized);
+  BlendPlane(src_y0, kWidth, src_y1, kWidth, alpha, kWidth,
+             dst_c, kWidth, kWidth, kHeight);
+  MaskCpuFlags(-1);
+  for (int i = 0; i < benchmark_iterations_; ++i) {
+    BlendPlane(src_y0, kWidth, src_y1, kWidth, alpha, kWidth,
+               dst_opt, kWidth, kWidth, kHeight);
+  }
+  EXPECT_EQ(0, memcmp(dst_c, dst_opt, kWidth * kHeight));
+  EXPECT_EQ(src_y1[0], dst_opt[0]);
+  EXPECT_EQ(src_y0[1], dst_opt[1]);
+  for (int i = 0; i < kWidth * kHeight; ++i) {
+    EXPECT_EQ((src_y0[i] * alpha[i] + src_y1[i] * (255 - alpha[i]) + 255) >> 8,
+              dst_opt[i]);
+  }
+  free_aligned_buffer_16(src_y0)
+  free_aligned_buffer_16(src_y1)
+  free_aligned_buffer_16(alpha)
+  free_aligned_buffer_16(dst_c)
+  free_aligned_buffer_16(dst_opt)
+}
+
+static int BlendPixel(int f, int b, int a) {
+  return (f * a + b * (255 - a) + 255) >> 8;
+}
+
+TEST_F(libyuvTest, I420Blend) {
+  const int kWidth = 640;
+  const int kHeight = 360;
+  const int kHalfWidth = kWidth / 2;
+  const int kHalfHeight = kHeight / 2;
+  const int kOverWidth = 301;
+  const int kOverHeight = 97;
+  const int kOverHalfWidth = (kOverWidth + 1) / 2;
+  const int kOverHalfHeight = (kOverHeight + 1) / 2;
+  // Clipped on the left and bottom.
+  const int kX = -30;
+  const int kY = 300;
+  align_buffer_16(over_y, kOverWidth * kOverHeight)
+  align_buffer_16(over_u, kOverHalfWidth * kOverHalfHeight)
+  align_buffer_16(over_v, kOverHalfWidth * kOverHalfHeight)
+  align_buffer_16(over_a, kOverWidth * kOverHeight)
+  align_buffer_16(src_y, kWidth * kHeight)
+  align_buffer_16(src_u, kHalfWidth * kHalfHeight)
+  align_buffer_16(src_v, kHalfWidth * kHalfHeight)
+  align_buffer_16(dst_y_c, kWidth * kHeight)
+  align_buffer_16(dst_u_c, kHalfWidth * kHalfHeight)
+  align_buffer_16(dst_v_c, kHalfWidth * kHalfHeight)
+  align_buffer_16(dst_y_opt, kWidth * kHeight)
+  align_buffer_16(dst_u_opt, kHalfWidth * kHalfHeight)
+  align_buffer_16(dst_v_opt, kHalfWidth * kHalfHeight)
+  align_buffer_16(dst_y_nv12, kWidth * kHeight)
+  align_buffer_16(dst_uv_nv12, kWidth * kHalfHeight)
+  for (int i = 0; i < kOverWidth * kOverHeight; ++i) {
+    over_y[i] = (random() & 0xff);
+    over_a[i] = (random() & 0xff);
+  }
+  for (int i = 0; i < kOverHalfWidth * kOverHalfHeight; ++i) {
+    over_u[i] = (random() & 0xff);
+    over_v[i] = (random() & 0xff);
+  }
+  for (int i = 0; i < kWidth * kHeight; ++i) {
+    src_y[i] = (random() & 0xff);
+  }
+  for (int i = 0; i < kHalfWidth * kHalfHeight; ++i) {
+    src_u[i] = (random() & 0xff);
+    src_v[i] = (random() & 0xff);
+  }
+  for (int f = 0; f < 2; ++f) {
+    MaskCpuFlags(f ? -1 : kCpuInitialized);
+    uint8* dst_y = f ? dst_y_opt : dst_y_c;
+    uint8* dst_u = f ? dst_u_opt : dst_u_c;
+    uint8* dst_v = f ? dst_v_opt : dst_v_c;
+    memcpy(dst_y, src_y, kWidth * kHeight);
+    memcpy(dst_u, src_u, kHalfWidth * kHalfHeight);
+    memcpy(dst_v, src_v, kHalfWidth * kHalfHeight);
+    EXPECT_EQ(0, I420Blend(over_y, kOverWidth, over_u, kOverHalfWidth,
+                           over_v, kOverHalfWidth, over_a, kOverWidth,
+                           kOverWidth, kOverHeight,
+                           dst_y, kWidth, dst_u, kHalfWidth, dst_v, kHalfWidth,
+                           kWidth, kHeight, kX, kY));
+  }
+  EXPECT_EQ(0, memcmp(dst_y_c, dst_y_opt, kWidth * kHeight));
+  EXPECT_EQ(0, memcmp(dst_u_c, dst_u_opt, kHalfWidth * kHalfHeight));
+  EXPECT_EQ(0, memcmp(dst_v_c, dst_v_opt, kHalfWidth * kHalfHeight));
+
+  int max_diff = 0;
+  for (int y = 0; y < kHeight; ++y) {
+    for (int x = 0; x < kWidth; ++x) {
+      int ox = x - kX;
+      int oy = y - kY;
+      int expected = src_y[y * kWidth + x];
+      if (ox >= 0 && ox < kOverWidth && oy >= 0 && oy < kOverHeight) {
+        expected = BlendPixel(over_y[oy * kOverWidth + ox], expected,
+                              over_a[oy * kOverWidth + ox]);
+      }
+      int diff = abs(expected - dst_y_opt[y * kWidth + x]);
+      max_diff = diff > max_diff ? diff : max_diff;
+    }
+  }
+  for (int y = 0; y < kHalfHeight; ++y) {
+    for (int x = 0; x < kHalfWidth; ++x) {
+      int ox = x - kX / 2;
+      int oy = y - kY / 2;
+      int expected_u = src_u[y * kHalfWidth + x];
+      int expected_v = src_v[y * kHalfWidth + x];
+      if (ox >= 0 && ox < kOverHalfWidth && oy >= 0 && oy < kOverHalfHeight) {
+        int x1 = ox * 2 + 1 < kOverWidth ? ox * 2 + 1 : ox * 2;
+        int y1 = oy * 2 + 1 < kOverHeight ? oy * 2 + 1 : oy * 2;
+        int a = (over_a[oy * 2 * kOverWidth + ox * 2] +
+                 over_a[oy * 2 * kOverWidth + x1] +
+                 over_a[y1 * kOverWidth + ox * 2] +
+                 over_a[y1 * kOverWidth + x1] + 2) >> 2;
+        if (x1 == ox * 2) {
+          a = (over_a[oy * 2 * kOverWidth + ox * 2] +
+               over_a[y1 * kOverWidth + ox * 2] + 1) >> 1;
+        }
+        expected_u = BlendPixel(over_u[oy * kOverHalfWidth + ox], expected_u,
+                                a);
+        expected_v = BlendPixel(over_v[oy * kOverHalfWidth + ox], expected_v,
+                                a);
+      }
+      int diff = abs(expected_u - dst_u_opt[y * kHalfWidth + x]);
+      max_diff = diff > max_diff ? diff : max_diff;
+      diff = abs(expected_v - dst_v_opt[y * kHalfWidth + x]);
+      max_diff = diff > max_diff ? diff : max_diff;
+    }
+  }
+  EXPECT_EQ(0, max_diff);
+
+  // NV12 matches I420 with the chroma interleaved.
+  memcpy(dst_y_nv12, src_y, kWidth * kHeight);
+  for (int i = 0; i < kHalfWidth * kHalfHeight; ++i) {
+    dst_uv_nv12[i * 2 + 0] = src_u[i];
+    dst_uv_nv12[i * 2 + 1] = src_v[i];
+  }
+  for (int i = 0; i < benchmark_iterations_; ++i) {
+    EXPECT_EQ(0, NV12Blend(over_y, kOverWidth, over_u, kOverHalfWidth,
+                           over_v, kOverHalfWidth, over_a, kOverWidth,
+                           kOverWidth, kOverHeight,
+                           dst_y_nv12, kWidth, dst_uv_nv12, kWidth,
+                           kWidth, kHeight, kX, kY));
+    if (i == 0) {
+      EXPECT_EQ(0, memcmp(dst_y_opt, dst_y_nv12, kWidth * kHeight));
+      for (int j = 0; j < kHalfWidth * kHalfHeight; ++j) {
+        EXPECT_EQ(dst_u_opt[j], dst_uv_nv12[j * 2 + 0]);
+        EXPECT_EQ(dst_v_opt[j], dst_uv_nv12[j * 2 + 1]);
+      }
+    }
+  }
+  EXPECT_EQ(-1, I420Blend(over_y, kOverWidth, over_u, kOverHalfWidth,
+                          over_v, kOverHalfWidth, over_a, kOverWidth,
+                          kOverWidth, kOverHeight,
+                          dst_y_opt, kWidth, dst_u_opt, kHalfWidth,
+                          dst_v_opt, kHalfWidth, kWidth, kHeight, 1, 0));
+
+  free_aligned_buffer_16(over_y)
+  free_aligned_buffer_16(over_u)
+  free_aligned_buffer_16(over_v)
+  free_aligned_buffer_16(over_a)
+  free_aligned_buffer_16(src_y)
+  free_aligned_buffer_16(src_u)
+  free_aligned_buffer_16(src_v)
+  free_aligned_buffer_16(dst_y_c)
+  free_aligned_buffer_16(dst_u_c)
+  free_aligned_buffer_16(dst_v_c)
+  free_aligned_buffer_16(dst_y_opt)
+  free_aligned_buffer_16(dst_u_opt)
+  free_aligned_buffer_16(dst_v_opt)
+  free_aligned_buffer_16(dst_y_nv12)
+  free_aligned_buffer_16(dst_uv_nv12)
+}
+
+// An overlay wider than kMaxStride is blended in strips. The result is the
+// same as blending its left and right halves in 2 calls.
+TEST_F(libyuvTest, I420BlendWide) {
+  const int kWidth = 12100;
+  const int kHeight = 6;
+  const int kHalfWidth = kWidth / 2;
+  const int kHalfHeight = kHeight / 2;
+  const int kOverWidth = 12001;
+  const int kOverHeight = 5;
+  const int kOverHalfWidth = (kOverWidth + 1) / 2;
+  const int kOverHalfHeight = (kOverHeight + 1) / 2;
+  const int kSplit = 6000;
+  const int kX = 50;
+  align_buffer_16(over_y, kOverWidth * kOverHeight)
+  align_buffer_16(over_u, kOverHalfWidth * kOverHalfHeight)
+  align_buffer_16(over_v, kOverHalfWidth * kOverHalfHeight)
+  align_buffer_16(over_a, kOverWidth * kOverHeight)
+  align_buffer_16(dst_y, kWidth * kHeight)
+  align_buffer_16(dst_u, kHalfWidth * kHalfHeight)
+  align_buffer_16(dst_v, kHalfWidth * kHalfHeight)
+  align_buffer_16(dst_y_ref, kWidth * kHeight)
+  align_buffer_16(dst_u_ref, kHalfWidth * kHalfHeight)
+  align_buffer_16(dst_v_ref, kHalfWidth * kHalfHeight)
+  align_buffer_16(dst_uv, kWidth * kHalfHeight)
+  for (int i = 0; i < kOverWidth * kOverHeight; ++i) {
+    over_y[i] = (random() & 0xff);
+    over_a[i] = (random() & 0xff);
+  }
+  for (int i = 0; i < kOverHalfWidth * kOverHalfHeight; ++i) {
+    over_u[i] = (random() & 0xff);
+    over_v[i] = (random() & 0xff);
+  }
+  for (int i = 0; i < kWidth * kHeight; ++i) {
+    dst_y[i] = dst_y_ref[i] = (random() & 0xff);
+  }
+  for (int i = 0; i < kHalfWidth * kHalfHeight; ++i) {
+    dst_u[i] = dst_u_ref[i] = (random() & 0xff);
+    dst_v[i] = dst_v_ref[i] = (random() & 0xff);
+    dst_uv[i * 2 + 0] = dst_u[i];
+    dst_uv[i * 2 + 1] = dst_v[i];
+  }
+
+  EXPECT_EQ(0, I420Blend(over_y, kOverWidth, over_u, kOverHalfWidth,
+                         over_v, kOverHalfWidth, over_a, kOverWidth,
+                         kOverWidth, kOverHeight,
+                         dst_y, kWidth, dst_u, kHalfWidth, dst_v, kHalfWidth,
+                         kWidth, kHeight, kX, 0));
+  EXPECT_EQ(0, I420Blend(over_y, kOverWidth, over_u, kOverHalfWidth,
+                         over_v, kOverHalfWidth, over_a, kOverWidth,
+                         kSplit, kOverHeight,
+                         dst_y_ref, kWidth, dst_u_ref, kHalfWidth,
+                         dst_v_ref, kHalfWidth, kWidth, kHeight, kX, 0));
+  EXPECT_EQ(0, I420Blend(over_y + kSplit, kOverWidth,
+                         over_u + kSplit / 2, kOverHalfWidth,
+                         over_v + kSplit / 2, kOverHalfWidth,
+                         over_a + kSplit, kOverWidth,
+                         kOverWidth - kSplit, kOverHeight,
+                         dst_y_ref, kWidth, dst_u_ref, kHalfWidth,
+                         dst_v_ref, kHalfWidth, kWidth, kHeight,
+                         kX + kSplit, 0));
+  EXPECT_EQ(0, memcmp(dst_y, dst_y_ref, kWidth * kHeight));
+  EXPECT_EQ(0, memcmp(dst_u, dst_u_ref, kHalfWidth * kHalfHeight));
+  EXPECT_EQ(0, memcmp(dst_v, dst_v_ref, kHalfWidth * kHalfHeight));
+
+  EXPECT_EQ(0, NV12Blend(over_y, kOverWidth, over_u, kOverHalfWidth,
+                         over_v, kOverHalfWidth, over_a, kOverWidth,
+                         kOverWidth, kOverHeight,
+                         dst_y_ref, kWidth, dst_uv, kWidth,
+                         kWidth, kHeight, kX, 0));
+  for (int i = 0; i < kHalfWidth * kHalfHeight; ++i) {
+    EXPECT_EQ(dst_u[i], dst_uv[i * 2 + 0]);
+    EXPECT_EQ(dst_v[i], dst_uv[i * 2 + 1]);
+  }
+
+  free_aligned_buffer_16(over_y)
+  free_aligned_buffer_16(over_u)
+  free_aligned_buffer_16(over_v)
+  free_aligned_buffer_16(over_a)
+  free_aligned_buffer_16(dst_y)
+  free_aligned_buffer_16(dst_u)
+  free_aligned_buffer_16(dst_v)
+  free_aligned_buffer_16(dst_y_ref)
+  free_aligned_buffer_16(dst_u_ref)
+  free_aligned_buffer_16(dst_v_ref)
+  free_aligned_buffer_16(dst_uv)
+}
+
+// The ARGB overlay is the same as unattenuating its visible part, converting
+// that to I420 with alpha and calling I420Blend. 3000 pixels wide takes 2
+// strips.
+static void TestI420BlendARGB(int width, int height,
+                              int over_width, int over_height, int x, int y,
+                              int benchmark_iterations) {
+  const int half_width = (width + 1) / 2;
+  const int half_height = (height + 1) / 2;
+  const int over_half_width = (over_width + 1) / 2;
+  const int over_half_height = (over_height + 1) / 2;
+  align_buffer_16(over_argb, over_width * over_height * 4)
+  align_buffer_16(over_unatt, over_width * over_height * 4)
+  align_buffer_16(over_y, over_width * over_height)
+  align_buffer_16(over_u, over_half_width * over_half_height)
+  align_buffer_16(over_v, over_half_width * over_half_height)
+  align_buffer_16(over_a, over_width * over_height)
+  align_buffer_16(src_y, width * height)
+  align_buffer_16(src_u, half_width * half_height)
+  align_buffer_16(src_v, half_width * half_height)
+  align_buffer_16(dst_y_ref, width * height)
+  align_buffer_16(dst_u_ref, half_width * half_height)
+  align_buffer_16(dst_v_ref, half_width * half_height)
+  align_buffer_16(dst_y, width * height)
+  align_buffer_16(dst_u, half_width * half_height)
+  align_buffer_16(dst_v, half_width * half_height)
+  align_buffer_16(dst_uv, half_width * 2 * half_height)
+  FillLayer(over_argb, over_width, over_height);
+  for (int i = 0; i < width * height; ++i) {
+    src_y[i] = (random() & 0xff);
+  }
+  for (int i = 0; i < half_width * half_height; ++i) {
+    src_u[i] = (random() & 0xff);
+    src_v[i] = (random() & 0xff);
+  }
+  // Reference converts the visible part of the overlay.
+  int x0 = x < 0 ? 0 : x;
+  int y0 = y < 0 ? 0 : y;
+  int crop_width = (x + over_width < width ? x + over_width : width) - x0;
+  int crop_height = (y + over_height < height ? y + over_height : height) - y0;
+  int crop_half_width = (crop_width + 1) / 2;
+  const uint8* crop_argb = over_argb + (y0 - y) * over_width * 4 +
+                           (x0 - x) * 4;
+  ARGBUnattenuate(crop_argb, over_width * 4, over_unatt, crop_width * 4,
+                  crop_width, crop_height);
+  ARGBToI420(over_unatt, crop_width * 4, over_y, crop_width,
+             over_u, crop_half_width, over_v, crop_half_width,
+             crop_width, crop_height);
+  for (int i = 0; i < crop_width * crop_height; ++i) {
+    over_a[i] = over_unatt[i * 4 + 3];
+  }
+  memcpy(dst_y_ref, src_y, width * height);
+  memcpy(dst_u_ref, src_u, half_width * half_height);
+  memcpy(dst_v_ref, src_v, half_width * half_height);
+  I420Blend(over_y, crop_width, over_u, crop_half_width,
+            over_v, crop_half_width, over_a, crop_width,
+            crop_width, crop_height,
+            dst_y_ref, width, dst_u_ref, half_width, dst_v_ref, half_width,
+            width, height, x0, y0);
+
+  memcpy(dst_y, src_y, width * height);
+  memcpy(dst_u, src_u, half_width * half_height);
+  memcpy(dst_v, src_v, half_width * half_height);
+  EXPECT_EQ(0, I420BlendARGB(over_argb, over_width * 4,
+                             over_width, over_height,
+                             dst_y, width, dst_u, half_width,
+                             dst_v, half_width, width, height, x, y));
+  EXPECT_EQ(0, memcmp(dst_y_ref, dst_y, width * height));
+  // ARGBToUVRow SSSE3 and C round differently, and the overlay columns
+  // that fall to the C remainder depend on the clipped width.
+  for (int i = 0; i < half_width * half_height; ++i) {
+    EXPECT_NEAR(dst_u_ref[i], dst_u[i], 1);
+    EXPECT_NEAR(dst_v_ref[i], dst_v[i], 1);
+  }
+
+  memcpy(dst_y_ref, src_y, width * height);
+  for (int i = 0; i < half_width * half_height; ++i) {
+    dst_uv[i * 2 + 0] = src_u[i];
+    dst_uv[i * 2 + 1] = src_v[i];
+  }
+  EXPECT_EQ(0, NV12BlendARGB(over_argb, over_width * 4,
+                             over_width, over_height,
+                             dst_y_ref, width, dst_uv, half_width * 2,
+                             width, height, x, y));
+  EXPECT_EQ(0, memcmp(dst_y, dst_y_ref, width * height));
+  for (int i = 0; i < half_width * half_height; ++i) {
+    EXPECT_EQ(dst_u[i], dst_uv[i * 2 + 0]);
+    EXPECT_EQ(dst_v[i], dst_uv[i * 2 + 1]);
+  }
+
+  for (int i = 0; i < benchmark_iterations; ++i) {
+    I420BlendARGB(over_argb, over_width * 4, over_width, over_height,
+                  dst_y, width, dst_u, half_width, dst_v, half_width,
+                  width, height, x, y);
+  }
+
+  free_aligned_buffer_16(over_argb)
+  free_aligned_buffer_16(over_unatt)
+  free_aligned_buffer_16(over_y)
+  free_aligned_buffer_16(over_u)
+  free_aligned_buffer_16(over_v)
+  free_aligned_buffer_16(over_a)
+  free_aligned_buffer_16(src_y)
+  free_aligned_buffer_16(src_u)
+  free_aligned_buffer_16(src_v)
+  free_aligned_buffer_16(dst_y_ref)
+  free_aligned_buffer_16(dst_u_ref)
+  free_aligned_buffer_16(dst_v_ref)
+  free_aligned_buffer_16(dst_y)
+  free_aligned_buffer_16(dst_u)
+  free_aligned_buffer_16(dst_v)
+  free_aligned_buffer_16(dst_uv)
+}
+
+TEST_F(libyuvTest, I420BlendARGB) {
+  TestI420BlendARGB(1280, 720, 320, 120, 940, 40, benchmark_iterations_);
+}
+
+TEST_F(libyuvTest, I420BlendARGBClipped) {
+  TestI420BlendARGB(641, 361, 301, 97, -30, 300, 1);
+}
+
+TEST_F(libyuvTest, I420BlendARGBWide) {
+  TestI420BlendARGB(3200, 40, 3000, 21, 100, 10, 1);
+}
+
 TEST_F(libyuvTest, TestAttenuate) {
   SIMD_ALIGNED(uint8 orig_pixels[256][4]);
   SIMD_ALIGNED(uint8 atten_pixels[256][4]);
@@ -791,6 +1416,102 @@ TEST_F(libyuvTest, TestARGBQuantize) {
   }
 }
 
+TEST_F(libyuvTest, TestARGBEffectChain) {
+  const int kWidth = 1280;
+  const int kHeight = 72;
+  const int kSize = kWidth * kHeight * 4;
+  align_buffer_16(src_argb, kSize)
+  align_buffer_16(dst_ref, kSize)
+  align_buffer_16(dst_chain, kSize)
+  for (int i = 0; i < kSize; ++i) {
+    src_argb[i] = (random() & 0xff);
+  }
+  SIMD_ALIGNED(uint8 table_argb[256 * 4]);
+  for (int i = 0; i < 256 * 4; ++i) {
+    table_argb[i] = (random() & 0xff);
+  }
+  static const int8 kMatrix[12] = {
+    64, 32, 32, 0, 32, 64, 32, 0, 32, 32, 64, 0,
+  };
+  ARGBEffectChain* chain = new ARGBEffectChain;
+
+  // Per channel effects fold into 1 table with identical results.
+  memcpy(dst_ref, src_argb, kSize);
+  ARGBColorTable(dst_ref, kWidth * 4, table_argb, 0, 0, kWidth, kHeight);
+  ARGBQuantize(dst_ref, kWidth * 4, (65536 + (8 / 2)) / 8, 8, 8 / 2,
+               0, 0, kWidth, kHeight);
+  ARGBShade(dst_ref, kWidth * 4, dst_ref, kWidth * 4, kWidth, kHeight,
+            0x80ffc040u);
+  EXPECT_EQ(0, ARGBEffectChainInit(chain));
+  EXPECT_EQ(0, ARGBEffectChainAddColorTable(chain, table_argb));
+  EXPECT_EQ(0, ARGBEffectChainAddQuantize(chain, (65536 + (8 / 2)) / 8, 8,
+                                          8 / 2));
+  EXPECT_EQ(0, ARGBEffectChainAddShade(chain, 0x80ffc040u));
+  EXPECT_EQ(1, chain->num_effects);
+  memcpy(dst_chain, src_argb, kSize);
+  EXPECT_EQ(0, ARGBEffectChainApply(chain, dst_chain, kWidth * 4,
+                                    0, 0, kWidth, kHeight));
+  EXPECT_EQ(0, memcmp(dst_ref, dst_chain, kSize));
+
+  // Linear effects fold into 1 matrix, rounding once.
+  memcpy(dst_ref, src_argb, kSize);
+  ARGBGray(dst_ref, kWidth * 4, 0, 0, kWidth, kHeight);
+  ARGBColorMatrix(dst_ref, kWidth * 4, kMatrix, 0, 0, kWidth, kHeight);
+  ARGBSepia(dst_ref, kWidth * 4, 0, 0, kWidth, kHeight);
+  EXPECT_EQ(0, ARGBEffectChainInit(chain));
+  EXPECT_EQ(0, ARGBEffectChainAddGray(chain));
+  EXPECT_EQ(0, ARGBEffectChainAddColorMatrix(chain, kMatrix));
+  EXPECT_EQ(0, ARGBEffectChainAddSepia(chain));
+  EXPECT_EQ(1, chain->num_effects);
+  memcpy(dst_chain, src_argb, kSize);
+  EXPECT_EQ(0, ARGBEffectChainApply(chain, dst_chain, kWidth * 4,
+                                    0, 0, kWidth, kHeight));
+  int max_diff = 0;
+  for (int i = 0; i < kSize; ++i) {
+    int diff = abs(dst_ref[i] - dst_chain[i]);
+    max_diff = diff > max_diff ? diff : max_diff;
+  }
+  EXPECT_LE(max_diff, 3);
+
+  // Sepia can clamp, so the gray after it is not folded and the chain runs
+  // the same rows as the single effects, on a rectangle.
+  memcpy(dst_ref, src_argb, kSize);
+  ARGBSepia(dst_ref, kWidth * 4, 16, 8, kWidth - 32, kHeight - 8);
+  ARGBColorTable(dst_ref, kWidth * 4, table_argb, 16, 8, kWidth - 32,
+                 kHeight - 8);
+  ARGBSepia(dst_ref, kWidth * 4, 16, 8, kWidth - 32, kHeight - 8);
+  ARGBGray(dst_ref, kWidth * 4, 16, 8, kWidth - 32, kHeight - 8);
+  EXPECT_EQ(0, ARGBEffectChainInit(chain));
+  EXPECT_EQ(0, ARGBEffectChainAddSepia(chain));
+  EXPECT_EQ(0, ARGBEffectChainAddColorTable(chain, table_argb));
+  EXPECT_EQ(0, ARGBEffectChainAddSepia(chain));
+  EXPECT_EQ(0, ARGBEffectChainAddGray(chain));
+  EXPECT_EQ(4, chain->num_effects);
+  for (int f = 0; f < 2; ++f) {
+    MaskCpuFlags(f ? -1 : kCpuInitialized);
+    memcpy(dst_chain, src_argb, kSize);
+    EXPECT_EQ(0, ARGBEffectChainApply(chain, dst_chain, kWidth * 4,
+                                      16, 8, kWidth - 32, kHeight - 8));
+    EXPECT_EQ(0, memcmp(dst_ref, dst_chain, kSize));
+  }
+  for (int i = 0; i < benchmark_iterations_; ++i) {
+    ARGBEffectChainApply(chain, dst_chain, kWidth * 4, 0, 0, kWidth, kHeight);
+  }
+
+  EXPECT_EQ(0, ARGBEffectChainInit(chain));
+  for (int i = 0; i < kMaxARGBEffects; ++i) {
+    EXPECT_EQ(0, (i & 1) ? ARGBEffectChainAddShade(chain, 0x80808080u) :
+                           ARGBEffectChainAddSepia(chain));
+  }
+  EXPECT_EQ(-1, ARGBEffectChainAddSepia(chain));
+  EXPECT_EQ(-1, ARGBEffectChainAddQuantize(chain, 8192, 0, 0));
+
+  delete chain;
+  free_aligned_buffer_16(src_argb)
+  free_aligned_buffer_16(dst_ref)
+  free_aligned_buffer_16(dst_chain)
+}
+
 TEST_F(libyuvTest, TestARGBMirror) {
   SIMD_ALIGNED(uint8 orig_pixels[256][4]);
   SIMD_ALIGNED(uint8 dst_pixels[256][4]);
@@ -988,6 +1709,867 @@ TEST_F(libyuvTest, TestAffine) {
 #endif
 }
 
+TEST_F(libyuvTest, ARGBAffineIdentity) {
+  const int kWidth = 67;
+  const int kHeight = 33;
+  const int kStride = kWidth * 4 + 12;
+  align_buffer_16(src_argb, kStride * kHeight)
+  align_buffer_16(dst_argb, kStride * kHeight)
+  srandom(time(NULL));
+  for (int i = 0; i < kStride * kHeight; ++i) {
+    src_argb[i] = (random() & 0xff);
+  }
+  const float kIdentity[6] = { 1.f, 0.f, 0.f, 0.f, 1.f, 0.f };
+  for (int f = 0; f < 2; ++f) {
+    memset(dst_argb, 0, kStride * kHeight);
+    EXPECT_EQ(0, ARGBAffine(src_argb, kStride, kWidth, kHeight,
+                            dst_argb, kStride, kWidth, kHeight,
+                            kIdentity, static_cast<FilterMode>(f),
+                            kAffineBorderClamp, 0u, 1));
+    for (int y = 0; y < kHeight; ++y) {
+      EXPECT_EQ(0, memcmp(src_argb + y * kStride, dst_argb + y * kStride,
+                          kWidth * 4));
+    }
+  }
+  free_aligned_buffer_16(src_argb)
+  free_aligned_buffer_16(dst_argb)
+}
+
+TEST_F(libyuvTest, ARGBAffineBorder) {
+  SIMD_ALIGNED(uint32 src_argb[16][16]);
+  SIMD_ALIGNED(uint32 dst_argb[16][16]);
+  for (int y = 0; y < 16; ++y) {
+    for (int x = 0; x < 16; ++x) {
+      src_argb[y][x] = y * 256 + x;
+    }
+  }
+  // Shift right by 3 and up by 2.
+  const float kTranslate[6] = { 1.f, 0.f, -3.f, 0.f, 1.f, 2.f };
+  const uint32 kValue = 0x80402010u;
+  for (int f = 0; f < 2; ++f) {
+    ARGBAffine(reinterpret_cast<uint8*>(src_argb), 16 * 4, 16, 16,
+               reinterpret_cast<uint8*>(dst_argb), 16 * 4, 16, 16,
+               kTranslate, static_cast<FilterMode>(f),
+               kAffineBorderConstant, kValue, 1);
+    for (int y = 0; y < 16; ++y) {
+      for (int x = 0; x < 16; ++x) {
+        if (x < 3 || y >= 14) {
+          EXPECT_EQ(kValue, dst_argb[y][x]);
+        } else {
+          EXPECT_EQ(static_cast<uint32>((y + 2) * 256 + x - 3),
+                    dst_argb[y][x]);
+        }
+      }
+    }
+    ARGBAffine(reinterpret_cast<uint8*>(src_argb), 16 * 4, 16, 16,
+               reinterpret_cast<uint8*>(dst_argb), 16 * 4, 16, 16,
+               kTranslate, static_cast<FilterMode>(f),
+               kAffineBorderClamp, kValue, 1);
+    EXPECT_EQ(static_cast<uint32>(2 * 256), dst_argb[0][0]);
+    EXPECT_EQ(static_cast<uint32>(15 * 256 + 12), dst_argb[15][15]);
+  }
+}
+
+// Video stabilization style warp: a small rotation and zoom about the center.
+static void StabilizeMatrix(int width, int height, float* matrix) {
+  const float kAngle = 0.05f;
+  const float kZoom = 0.95f;
+  float c = cosf(kAngle) * kZoom;
+  float s = sinf(kAngle) * kZoom;
+  float cx = width * 0.5f;
+  float cy = height * 0.5f;
+  matrix[0] = c;
+  matrix[1] = -s;
+  matrix[2] = cx - c * cx + s * cy;
+  matrix[3] = s;
+  matrix[4] = c;
+  matrix[5] = cy - s * cx - c * cy;
+}
+
+TEST_F(libyuvTest, ARGBAffine_OptVsC) {
+  const int kWidth = benchmark_width_;
+  const int kHeight = benchmark_height_;
+  const int kSize = kWidth * kHeight * 4;
+  align_buffer_16(src_argb, kSize)
+  align_buffer_16(dst_argb_c, kSize)
+  align_buffer_16(dst_argb_opt, kSize)
+  srandom(time(NULL));
+  for (int i = 0; i < kSize; ++i) {
+    src_argb[i] = (random() & 0xff);
+  }
+  float matrix[6];
+  StabilizeMatrix(kWidth, kHeight, matrix);
+  for (int f = 0; f < 2; ++f) {
+    memset(dst_argb_c, 1, kSize);
+    memset(dst_argb_opt, 2, kSize);
+    MaskCpuFlags(0);
+    PerfTimer c_timer(1);
+    while (c_timer.Running()) {
+      ARGBAffine(src_argb, kWidth * 4, kWidth, kHeight,
+                 dst_argb_c, kWidth * 4, kWidth, kHeight,
+                 matrix, static_cast<FilterMode>(f),
+                 kAffineBorderClamp, 0u, 1);
+    }
+    MaskCpuFlags(-1);
+    PerfTimer timer(benchmark_iterations_);
+    while (timer.Running()) {
+      ARGBAffine(src_argb, kWidth * 4, kWidth, kHeight,
+                 dst_argb_opt, kWidth * 4, kWidth, kHeight,
+                 matrix, static_cast<FilterMode>(f),
+                 kAffineBorderClamp, 0u, 4);
+    }
+    PerfCheck(f ? "Bilinear" : "None", timer, c_timer, kWidth * kHeight,
+              NULL);
+    // Point sampling SSE2 steps uv 4 pixels at a time, so a sample on a
+    // pixel boundary may round the other way.
+    int max_diff = 0;
+    int num_diff = 0;
+    for (int i = 0; i < kSize; ++i) {
+      int abs_diff = abs(dst_argb_c[i] - dst_argb_opt[i]);
+      if (abs_diff > max_diff) {
+        max_diff = abs_diff;
+      }
+      if (abs_diff) {
+        ++num_diff;
+      }
+    }
+    if (f) {
+      EXPECT_EQ(0, max_diff);
+    } else {
+      EXPECT_LE(num_diff, kSize / 100);
+    }
+  }
+  free_aligned_buffer_16(src_argb)
+  free_aligned_buffer_16(dst_argb_c)
+  free_aligned_buffer_16(dst_argb_opt)
+}
+
+TEST_F(libyuvTest, ARGBAffineThreads) {
+  const int kWidth = 640;
+  const int kHeight = 360;
+  const int kSize = kWidth * kHeight * 4;
+  align_buffer_16(src_argb, kSize)
+  align_buffer_16(dst_argb_1, kSize)
+  align_buffer_16(dst_argb_4, kSize)
+  for (int i = 0; i < kSize; ++i) {
+    src_argb[i] = (random() & 0xff);
+  }
+  float matrix[6];
+  StabilizeMatrix(kWidth, kHeight, matrix);
+  for (int f = 0; f < 2; ++f) {
+    ARGBAffine(src_argb, kWidth * 4, kWidth, kHeight,
+               dst_argb_1, kWidth * 4, kWidth, kHeight,
+               matrix, static_cast<FilterMode>(f),
+               kAffineBorderConstant, 0xff000000u, 1);
+    ARGBAffine(src_argb, kWidth * 4, kWidth, kHeight,
+               dst_argb_4, kWidth * 4, kWidth, kHeight,
+               matrix, static_cast<FilterMode>(f),
+               kAffineBorderConstant, 0xff000000u, 4);
+    EXPECT_EQ(0, memcmp(dst_argb_1, dst_argb_4, kSize));
+  }
+  free_aligned_buffer_16(src_argb)
+  free_aligned_buffer_16(dst_argb_1)
+  free_aligned_buffer_16(dst_argb_4)
+}
+
+// A 180 degree rotation matrix matches I420Rotate, including chroma.
+TEST_F(libyuvTest, I420Affine180) {
+  const int kWidth = 64;
+  const int kHeight = 48;
+  const int kHalfWidth = kWidth / 2;
+  const int kHalfHeight = kHeight / 2;
+  const int kSize = kWidth * kHeight + kHalfWidth * kHalfHeight * 2;
+  align_buffer_16(src, kSize)
+  align_buffer_16(dst_rotate, kSize)
+  align_buffer_16(dst_affine, kSize)
+  for (int i = 0; i < kSize; ++i) {
+    src[i] = (random() & 0xff);
+  }
+  uint8* src_u = src + kWidth * kHeight;
+  uint8* src_v = src_u + kHalfWidth * kHalfHeight;
+  I420Rotate(src, kWidth, src_u, kHalfWidth, src_v, kHalfWidth,
+             dst_rotate, kWidth,
+             dst_rotate + kWidth * kHeight, kHalfWidth,
+             dst_rotate + kWidth * kHeight + kHalfWidth * kHalfHeight,
+             kHalfWidth, kWidth, kHeight, kRotate180);
+  const float k180[6] = { -1.f, 0.f, kWidth - 1.f, 0.f, -1.f, kHeight - 1.f };
+  for (int f = 0; f < 2; ++f) {
+    memset(dst_affine, 0, kSize);
+    EXPECT_EQ(0, I420Affine(src, kWidth, src_u, kHalfWidth, src_v, kHalfWidth,
+                            kWidth, kHeight,
+                            dst_affine, kWidth,
+                            dst_affine + kWidth * kHeight, kHalfWidth,
+                            dst_affine + kWidth * kHeight +
+                                kHalfWidth * kHalfHeight, kHalfWidth,
+                            kWidth, kHeight, k180,
+                            static_cast<FilterMode>(f),
+                            kAffineBorderConstant, 16, 128, 128, 1));
+    EXPECT_EQ(0, memcmp(dst_rotate, dst_affine, kSize));
+  }
+  free_aligned_buffer_16(src)
+  free_aligned_buffer_16(dst_rotate)
+  free_aligned_buffer_16(dst_affine)
+}
+
+// Reference box blur with edges left out of the average.
+static void BoxBlurReference(const uint8* src, uint8* dst,
+                             int width, int height, int radius) {
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      int sum = 0;
+      int area = 0;
+      for (int j = y - radius; j <= y + radius; ++j) {
+        for (int i = x - radius; i <= x + radius; ++i) {
+          if (j >= 0 && j < height && i >= 0 && i < width) {
+            sum += src[j * width + i];
+            ++area;
+          }
+        }
+      }
+      dst[y * width + x] =
+          static_cast<uint8>(static_cast<int>(sum * (1.0f / area) + 0.5f));
+    }
+  }
+}
+
+TEST_F(libyuvTest, TestPlaneBlur) {
+  const int kWidth = 1283;
+  const int kHeight = 37;
+  const int kSize = kWidth * kHeight;
+  align_buffer_16(src_y, kSize)
+  align_buffer_16(dst_ref, kSize)
+  align_buffer_16(dst_c, kSize)
+  align_buffer_16(dst_opt, kSize)
+  for (int i = 0; i < kSize; ++i) {
+    src_y[i] = (random() & 0xff);
+  }
+
+  // A box taller than the image and narrow widths clip on all sides.
+  static const int kRadius[] = { 0, 1, 5, 20 };
+  static const int kTestWidth[] = { kWidth, 17, 5 };
+  for (int r = 0; r < 4; ++r) {
+    for (int w = 0; w < 3; ++w) {
+      const int width = kTestWidth[w];
+      BoxBlurReference(src_y, dst_ref, width, kHeight, kRadius[r]);
+      MaskCpuFlags(kCpuInitialized);
+      PlaneBlur(src_y, width, dst_c, width, width, kHeight, kRadius[r], 1);
+      MaskCpuFlags(-1);
+      PlaneBlur(src_y, width, dst_opt, width, width, kHeight, kRadius[r], 1);
+      EXPECT_EQ(0, memcmp(dst_ref, dst_c, width * kHeight));
+      EXPECT_EQ(0, memcmp(dst_ref, dst_opt, width * kHeight));
+    }
+  }
+
+  // Repeated passes in place match repeated passes out of place.
+  PlaneBlur(src_y, kWidth, dst_c, kWidth, kWidth, kHeight, 4, 1);
+  PlaneBlur(dst_c, kWidth, dst_ref, kWidth, kWidth, kHeight, 4, 1);
+  PlaneBlur(dst_ref, kWidth, dst_c, kWidth, kWidth, kHeight, 4, 1);
+  memcpy(dst_opt, src_y, kSize);
+  PlaneBlur(dst_opt, kWidth, dst_opt, kWidth, kWidth, kHeight, 4, 3);
+  EXPECT_EQ(0, memcmp(dst_c, dst_opt, kSize));
+
+  // Inverting in place matches inverting out of place.
+  PlaneBlur(src_y, kWidth, dst_c, kWidth, kWidth, -kHeight, 4, 3);
+  memcpy(dst_opt, src_y, kSize);
+  PlaneBlur(dst_opt, kWidth, dst_opt, kWidth, kWidth, -kHeight, 4, 3);
+  EXPECT_EQ(0, memcmp(dst_c, dst_opt, kSize));
+
+  // A flat plane stays flat.
+  memset(src_y, 200, kSize);
+  PlaneBlur(src_y, kWidth, dst_opt, kWidth, kWidth, kHeight, 7, 3);
+  for (int i = 0; i < kSize; ++i) {
+    EXPECT_EQ(200, dst_opt[i]);
+  }
+  EXPECT_EQ(-1, PlaneBlur(src_y, kWidth, dst_opt, kWidth, kWidth, kHeight,
+                          128, 1));
+  EXPECT_EQ(-1, PlaneBlur(src_y, kWidth, dst_opt, kWidth, kWidth, kHeight,
+                          1, 0));
+  for (int i = 0; i < benchmark_iterations_; ++i) {
+    PlaneBlur(src_y, kWidth, dst_opt, kWidth, kWidth, kHeight, 5, 3);
+  }
+
+  free_aligned_buffer_16(src_y)
+  free_aligned_buffer_16(dst_ref)
+  free_aligned_buffer_16(dst_c)
+  free_aligned_buffer_16(dst_opt)
+}
+
+// ARGBBoxBlur matches ARGBBlur with C row functions, which truncates the
+// average where the SSE2 version rounds.
+TEST_F(libyuvTest, TestARGBBoxBlur) {
+  const int kWidth = 643;
+  const int kHeight = 71;
+  const int kSize = kWidth * kHeight * 4;
+  align_buffer_16(src_argb, kSize)
+  align_buffer_16(dst_ref, kSize)
+  align_buffer_16(dst_c, kSize)
+  align_buffer_16(dst_opt, kSize)
+  align_buffer_16(cumsum, kSize * 4)
+  for (int i = 0; i < kSize; ++i) {
+    src_argb[i] = (random() & 0xff);
+  }
+  int32* cumsum32 = reinterpret_cast<int32*>(cumsum);
+
+  // ARGBBlur needs a width of at least radius * 2 + 1. Narrower images are
+  // only compared C vs SIMD.
+  static const int kRadius[] = { 1, 5, 40 };
+  static const int kTestWidth[] = { kWidth, 81, 17, 2 };
+  for (int r = 0; r < 3; ++r) {
+    for (int w = 0; w < 4; ++w) {
+      const int width = kTestWidth[w];
+      const int stride = width * 4;
+      MaskCpuFlags(kCpuInitialized);
+      EXPECT_EQ(0, ARGBBoxBlur(src_argb, stride, dst_c, stride,
+                               width, kHeight, kRadius[r], 1, 1));
+      MaskCpuFlags(-1);
+      EXPECT_EQ(0, ARGBBoxBlur(src_argb, stride, dst_opt, stride,
+                               width, kHeight, kRadius[r], 1, 4));
+      EXPECT_EQ(0, memcmp(dst_c, dst_opt, stride * kHeight));
+      if (width >= kRadius[r] * 2 + 1) {
+        MaskCpuFlags(kCpuInitialized);
+        ARGBBlur(src_argb, stride, dst_ref, stride, cumsum32, stride,
+                 width, kHeight, kRadius[r]);
+        MaskCpuFlags(-1);
+        EXPECT_EQ(0, memcmp(dst_ref, dst_c, stride * kHeight));
+      }
+    }
+  }
+
+  // 3 iterations in place on 4 threads match ARGBBlur 3 times.
+  MaskCpuFlags(kCpuInitialized);
+  ARGBBlur(src_argb, kWidth * 4, dst_ref, kWidth * 4, cumsum32, kWidth * 4,
+           kWidth, kHeight, 3);
+  ARGBBlur(dst_ref, kWidth * 4, dst_c, kWidth * 4, cumsum32, kWidth * 4,
+           kWidth, kHeight, 3);
+  ARGBBlur(dst_c, kWidth * 4, dst_ref, kWidth * 4, cumsum32, kWidth * 4,
+           kWidth, kHeight, 3);
+  MaskCpuFlags(-1);
+  memcpy(dst_opt, src_argb, kSize);
+  EXPECT_EQ(0, ARGBBoxBlur(dst_opt, kWidth * 4, dst_opt, kWidth * 4,
+                           kWidth, kHeight, 3, 3, 4));
+  EXPECT_EQ(0, memcmp(dst_ref, dst_opt, kSize));
+  EXPECT_EQ(0, ARGBBoxBlur(src_argb, kWidth * 4, dst_c, kWidth * 4,
+                           kWidth, kHeight, 3, 3, 1));
+  EXPECT_EQ(0, memcmp(dst_ref, dst_c, kSize));
+
+  // Inverting in place on 4 threads matches inverting out of place.
+  EXPECT_EQ(0, ARGBBoxBlur(src_argb, kWidth * 4, dst_c, kWidth * 4,
+                           kWidth, -kHeight, 3, 3, 1));
+  memcpy(dst_opt, src_argb, kSize);
+  EXPECT_EQ(0, ARGBBoxBlur(dst_opt, kWidth * 4, dst_opt, kWidth * 4,
+                           kWidth, -kHeight, 3, 3, 4));
+  EXPECT_EQ(0, memcmp(dst_c, dst_opt, kSize));
+
+  EXPECT_EQ(-1, ARGBBoxBlur(src_argb, kWidth * 4, dst_opt, kWidth * 4,
+                            kWidth, kHeight, 0, 1, 1));
+  EXPECT_EQ(-1, ARGBBoxBlur(src_argb, kWidth * 4, dst_opt, kWidth * 4,
+                            kWidth, 1, 1, 1, 1));
+  for (int i = 0; i < benchmark_iterations_; ++i) {
+    ARGBBoxBlur(src_argb, kWidth * 4, dst_opt, kWidth * 4,
+                kWidth, kHeight, 5, 1, 1);
+  }
+
+  free_aligned_buffer_16(src_argb)
+  free_aligned_buffer_16(dst_ref)
+  free_aligned_buffer_16(dst_c)
+  free_aligned_buffer_16(dst_opt)
+  free_aligned_buffer_16(cumsum)
+}
+
+TEST_F(libyuvTest, TestPlaneUnsharpMask) {
+  const int kWidth = 1283;
+  const int kHeight = 37;
+  const int kSize = kWidth * kHeight;
+  align_buffer_16(src_y, kSize)
+  align_buffer_16(blur, kSize)
+  align_buffer_16(dst_c, kSize)
+  align_buffer_16(dst_opt, kSize)
+  for (int i = 0; i < kSize; ++i) {
+    src_y[i] = (random() & 0xff);
+  }
+
+  MaskCpuFlags(kCpuInitialized);
+  EXPECT_EQ(0, PlaneUnsharpMask(src_y, kWidth, dst_c, kWidth,
+                                kWidth, kHeight, 2, 384, 4));
+  MaskCpuFlags(-1);
+  for (int i = 0; i < benchmark_iterations_; ++i) {
+    EXPECT_EQ(0, PlaneUnsharpMask(src_y, kWidth, dst_opt, kWidth,
+                                  kWidth, kHeight, 2, 384, 4));
+  }
+  EXPECT_EQ(0, memcmp(dst_c, dst_opt, kSize));
+
+  // Compare with the formula on the blurred plane.
+  PlaneBlur(src_y, kWidth, blur, kWidth, kWidth, kHeight, 2, 3);
+  for (int i = 0; i < kSize; ++i) {
+    const int diff = src_y[i] - blur[i];
+    int expected = src_y[i];
+    if (abs(diff) > 4) {
+      expected += (diff * 384 + 128) >> 8;
+    }
+    expected = expected < 0 ? 0 : (expected > 255 ? 255 : expected);
+    EXPECT_EQ(expected, dst_opt[i]);
+  }
+
+  // In place.
+  memcpy(dst_c, src_y, kSize);
+  EXPECT_EQ(0, PlaneUnsharpMask(dst_c, kWidth, dst_c, kWidth,
+                                kWidth, kHeight, 2, 384, 4));
+  EXPECT_EQ(0, memcmp(dst_c, dst_opt, kSize));
+
+  // Inverting in place matches inverting out of place.
+  EXPECT_EQ(0, PlaneUnsharpMask(src_y, kWidth, dst_opt, kWidth,
+                                kWidth, -kHeight, 2, 384, 4));
+  memcpy(dst_c, src_y, kSize);
+  EXPECT_EQ(0, PlaneUnsharpMask(dst_c, kWidth, dst_c, kWidth,
+                                kWidth, -kHeight, 2, 384, 4));
+  EXPECT_EQ(0, memcmp(dst_c, dst_opt, kSize));
+
+  // Nothing is above a threshold of 255.
+  PlaneUnsharpMask(src_y, kWidth, dst_opt, kWidth, kWidth, kHeight,
+                   2, 384, 255);
+  EXPECT_EQ(0, memcmp(src_y, dst_opt, kSize));
+
+  free_aligned_buffer_16(src_y)
+  free_aligned_buffer_16(blur)
+  free_aligned_buffer_16(dst_c)
+  free_aligned_buffer_16(dst_opt)
+}
+
+// Fills a 3D LUT with out = f(in) for a map of B, G, R to B, G, R.
+// map[i] names the input channel of output channel i, or -1 for random.
+static void Fill3DLut(uint8* lut_argb, int lut_size, const int* map) {
+  for (int b = 0; b < lut_size; ++b) {
+    for (int g = 0; g < lut_size; ++g) {
+      for (int r = 0; r < lut_size; ++r) {
+        const int bgr[3] = { b, g, r };
+        uint8* entry = lut_argb + ((b * lut_size + g) * lut_size + r) * 4;
+        for (int i = 0; i < 3; ++i) {
+          entry[i] = map[i] < 0 ? (random() & 0xff) :
+              (bgr[map[i]] * 255 + (lut_size - 1) / 2) / (lut_size - 1);
+        }
+        entry[3] = (random() & 0xff);
+      }
+    }
+  }
+}
+
+TEST_F(libyuvTest, ARGBApply3DLut) {
+  const int kWidth = 1283;
+  const int kHeight = 64;
+  const int kLutSize = 33;
+  const int kSize = kWidth * kHeight * 4;
+  align_buffer_16(src_argb, kSize)
+  align_buffer_16(dst_c, kSize)
+  align_buffer_16(dst_opt, kSize)
+  align_buffer_16(lut_argb, kLutSize * kLutSize * kLutSize * 4)
+  for (int i = 0; i < kSize; ++i) {
+    src_argb[i] = (random() & 0xff);
+  }
+
+  // Tetrahedral interpolation is exact for linear maps, up to rounding.
+  // Swapping channels catches mixed up axes.
+  static const int kSwap[3] = { 2, 0, 1 };
+  Fill3DLut(lut_argb, kLutSize, kSwap);
+  for (int f = 0; f < 2; ++f) {
+    MaskCpuFlags(f ? -1 : kCpuInitialized);
+    uint8* dst = f ? dst_opt : dst_c;
+    EXPECT_EQ(0, ARGBApply3DLut(src_argb, kWidth * 4, dst, kWidth * 4,
+                                lut_argb, kLutSize, kWidth, kHeight, 1));
+  }
+  EXPECT_EQ(0, memcmp(dst_c, dst_opt, kSize));
+  int max_diff = 0;
+  for (int i = 0; i < kWidth * kHeight; ++i) {
+    const uint8* s = src_argb + i * 4;
+    const uint8* d = dst_opt + i * 4;
+    for (int j = 0; j < 3; ++j) {
+      int diff = abs(s[kSwap[j]] - d[j]);
+      max_diff = diff > max_diff ? diff : max_diff;
+    }
+    EXPECT_EQ(s[3], d[3]);
+  }
+  EXPECT_LE(max_diff, 1);
+
+  // Random LUT, in place, C vs SIMD and 1 vs 4 threads.
+  static const int kRandom[3] = { -1, -1, -1 };
+  Fill3DLut(lut_argb, kLutSize, kRandom);
+  MaskCpuFlags(kCpuInitialized);
+  memcpy(dst_c, src_argb, kSize);
+  ARGBApply3DLut(dst_c, kWidth * 4, dst_c, kWidth * 4, lut_argb, kLutSize,
+                 kWidth, kHeight, 1);
+  MaskCpuFlags(-1);
+  ARGBApply3DLut(src_argb, kWidth * 4, dst_opt, kWidth * 4, lut_argb,
+                 kLutSize, kWidth, kHeight, 4);
+  EXPECT_EQ(0, memcmp(dst_c, dst_opt, kSize));
+  for (int i = 0; i < benchmark_iterations_; ++i) {
+    ARGBApply3DLut(src_argb, kWidth * 4, dst_opt, kWidth * 4, lut_argb,
+                   kLutSize, kWidth, kHeight, 1);
+  }
+
+  // A 2 point LUT is trilinear over the whole cube; corners map exactly.
+  const int kSmall = 2;
+  Fill3DLut(lut_argb, kSmall, kRandom);
+  SIMD_ALIGNED(uint8 corners[8 * 4]);
+  SIMD_ALIGNED(uint8 corners_out[8 * 4]);
+  for (int i = 0; i < 8; ++i) {
+    corners[i * 4 + 0] = (i & 4) ? 255 : 0;
+    corners[i * 4 + 1] = (i & 2) ? 255 : 0;
+    corners[i * 4 + 2] = (i & 1) ? 255 : 0;
+    corners[i * 4 + 3] = 255;
+  }
+  ARGBApply3DLut(corners, 0, corners_out, 0, lut_argb, kSmall, 8, 1, 1);
+  for (int i = 0; i < 8; ++i) {
+    const int index = ((i >> 2) * kSmall + ((i >> 1) & 1)) * kSmall + (i & 1);
+    EXPECT_EQ(lut_argb[index * 4 + 0], corners_out[i * 4 + 0]);
+    EXPECT_EQ(lut_argb[index * 4 + 1], corners_out[i * 4 + 1]);
+    EXPECT_EQ(lut_argb[index * 4 + 2], corners_out[i * 4 + 2]);
+  }
+  EXPECT_EQ(-1, ARGBApply3DLut(src_argb, kWidth * 4, dst_opt, kWidth * 4,
+                               lut_argb, 1, kWidth, kHeight, 1));
+
+  free_aligned_buffer_16(src_argb)
+  free_aligned_buffer_16(dst_c)
+  free_aligned_buffer_16(dst_opt)
+  free_aligned_buffer_16(lut_argb)
+}
+
+// I420Apply3DLut matches converting to ARGB, applying the LUT and converting
+// back when the frame is a multiple of 16 wide, so both convert with the
+// same row functions.
+TEST_F(libyuvTest, I420Apply3DLut) {
+  const int kWidth = 1280;
+  const int kHeight = 73;
+  const int kHalfWidth = kWidth / 2;
+  const int kHalfHeight = (kHeight + 1) / 2;
+  const int kLutSize = 17;
+  align_buffer_16(src_y, kWidth * kHeight)
+  align_buffer_16(src_u, kHalfWidth * kHalfHeight)
+  align_buffer_16(src_v, kHalfWidth * kHalfHeight)
+  align_buffer_16(argb, kWidth * kHeight * 4)
+  align_buffer_16(dst_y_ref, kWidth * kHeight)
+  align_buffer_16(dst_u_ref, kHalfWidth * kHalfHeight)
+  align_buffer_16(dst_v_ref, kHalfWidth * kHalfHeight)
+  align_buffer_16(dst_y, kWidth * kHeight)
+  align_buffer_16(dst_u, kHalfWidth * kHalfHeight)
+  align_buffer_16(dst_v, kHalfWidth * kHalfHeight)
+  align_buffer_16(lut_argb, kLutSize * kLutSize * kLutSize * 4)
+  for (int i = 0; i < kWidth * kHeight; ++i) {
+    src_y[i] = (random() & 0xff);
+  }
+  for (int i = 0; i < kHalfWidth * kHalfHeight; ++i) {
+    src_u[i] = (random() & 0xff);
+    src_v[i] = (random() & 0xff);
+  }
+  static const int kRandom[3] = { -1, -1, -1 };
+  Fill3DLut(lut_argb, kLutSize, kRandom);
+
+  I420ToARGB(src_y, kWidth, src_u, kHalfWidth, src_v, kHalfWidth,
+             argb, kWidth * 4, kWidth, kHeight);
+  ARGBApply3DLut(argb, kWidth * 4, argb, kWidth * 4, lut_argb, kLutSize,
+                 kWidth, kHeight, 1);
+  ARGBToI420(argb, kWidth * 4, dst_y_ref, kWidth, dst_u_ref, kHalfWidth,
+             dst_v_ref, kHalfWidth, kWidth, kHeight);
+  for (int i = 0; i < benchmark_iterations_; ++i) {
+    EXPECT_EQ(0, I420Apply3DLut(src_y, kWidth, src_u, kHalfWidth,
+                                src_v, kHalfWidth, dst_y, kWidth,
+                                dst_u, kHalfWidth, dst_v, kHalfWidth,
+                                lut_argb, kLutSize, kWidth, kHeight, 2));
+  }
+  EXPECT_EQ(0, memcmp(dst_y_ref, dst_y, kWidth * kHeight));
+  EXPECT_EQ(0, memcmp(dst_u_ref, dst_u, kHalfWidth * kHalfHeight));
+  EXPECT_EQ(0, memcmp(dst_v_ref, dst_v, kHalfWidth * kHalfHeight));
+
+  // In place.
+  EXPECT_EQ(0, I420Apply3DLut(src_y, kWidth, src_u, kHalfWidth,
+                              src_v, kHalfWidth, src_y, kWidth,
+                              src_u, kHalfWidth, src_v, kHalfWidth,
+                              lut_argb, kLutSize, kWidth, kHeight, 2));
+  EXPECT_EQ(0, memcmp(dst_y_ref, src_y, kWidth * kHeight));
+  EXPECT_EQ(0, memcmp(dst_u_ref, src_u, kHalfWidth * kHalfHeight));
+  EXPECT_EQ(0, memcmp(dst_v_ref, src_v, kHalfWidth * kHalfHeight));
+
+  free_aligned_buffer_16(src_y)
+  free_aligned_buffer_16(src_u)
+  free_aligned_buffer_16(src_v)
+  free_aligned_buffer_16(argb)
+  free_aligned_buffer_16(dst_y_ref)
+  free_aligned_buffer_16(dst_u_ref)
+  free_aligned_buffer_16(dst_v_ref)
+  free_aligned_buffer_16(dst_y)
+  free_aligned_buffer_16(dst_u)
+  free_aligned_buffer_16(dst_v)
+  free_aligned_buffer_16(lut_argb)
+}
+
+// I420ToNV12 followed by NV12ToI420 is lossless, and I420ToNV21 stores V
+// first.  Odd widths exercise the Any and C kernels.
+TEST_F(libyuvTest, I420ToNV12RoundTrip) {
+  const int kWidths[3] = { 1280, 1282, 33 };
+  const int kHeight = 63;
+  for (int w = 0; w < 3; ++w) {
+    const int kWidth = kWidths[w];
+    const int kHalfWidth = (kWidth + 1) / 2;
+    const int kHalfHeight = (kHeight + 1) / 2;
+    align_buffer_16(src_y, kWidth * kHeight)
+    align_buffer_16(src_u, kHalfWidth * kHalfHeight)
+    align_buffer_16(src_v, kHalfWidth * kHalfHeight)
+    align_buffer_16(dst_y, kWidth * kHeight)
+    align_buffer_16(dst_uv_c, kHalfWidth * 2 * kHalfHeight)
+    align_buffer_16(dst_uv_opt, kHalfWidth * 2 * kHalfHeight)
+    align_buffer_16(dst_u, kHalfWidth * kHalfHeight)
+    align_buffer_16(dst_v, kHalfWidth * kHalfHeight)
+    for (int i = 0; i < kWidth * kHeight; ++i) {
+      src_y[i] = (random() & 0xff);
+    }
+    for (int i = 0; i < kHalfWidth * kHalfHeight; ++i) {
+      src_u[i] = (random() & 0xff);
+      src_v[i] = (random() & 0xff);
+    }
+    MaskCpuFlags(kCpuInitialized);
+    EXPECT_EQ(0, I420ToNV12(src_y, kWidth, src_u, kHalfWidth,
+                            src_v, kHalfWidth,
+                            dst_y, kWidth, dst_uv_c, kHalfWidth * 2,
+                            kWidth, kHeight));
+    MaskCpuFlags(-1);
+    EXPECT_EQ(0, I420ToNV12(src_y, kWidth, src_u, kHalfWidth,
+                            src_v, kHalfWidth,
+                            dst_y, kWidth, dst_uv_opt, kHalfWidth * 2,
+                            kWidth, kHeight));
+    EXPECT_EQ(0, memcmp(dst_uv_c, dst_uv_opt, kHalfWidth * 2 * kHalfHeight));
+    EXPECT_EQ(0, memcmp(src_y, dst_y, kWidth * kHeight));
+
+    NV12ToI420(dst_y, kWidth, dst_uv_opt, kHalfWidth * 2,
+               dst_y, kWidth, dst_u, kHalfWidth, dst_v, kHalfWidth,
+               kWidth, kHeight);
+    EXPECT_EQ(0, memcmp(src_u, dst_u, kHalfWidth * kHalfHeight));
+    EXPECT_EQ(0, memcmp(src_v, dst_v, kHalfWidth * kHalfHeight));
+
+    EXPECT_EQ(0, I420ToNV21(src_y, kWidth, src_u, kHalfWidth,
+                            src_v, kHalfWidth,
+                            dst_y, kWidth, dst_uv_opt, kHalfWidth * 2,
+                            kWidth, kHeight));
+    NV12ToI420(dst_y, kWidth, dst_uv_opt, kHalfWidth * 2,
+               dst_y, kWidth, dst_v, kHalfWidth, dst_u, kHalfWidth,
+               kWidth, kHeight);
+    EXPECT_EQ(0, memcmp(src_u, dst_u, kHalfWidth * kHalfHeight));
+    EXPECT_EQ(0, memcmp(src_v, dst_v, kHalfWidth * kHalfHeight));
+
+    free_aligned_buffer_16(src_y)
+    free_aligned_buffer_16(src_u)
+    free_aligned_buffer_16(src_v)
+    free_aligned_buffer_16(dst_y)
+    free_aligned_buffer_16(dst_uv_c)
+    free_aligned_buffer_16(dst_uv_opt)
+    free_aligned_buffer_16(dst_u)
+    free_aligned_buffer_16(dst_v)
+  }
+}
+
+// ARGBToNV12 and YUY2ToNV12 match the I420 conversion with U and V
+// interleaved, for both the C and optimized kernels.
+#define TESTATONV12(FMT_A, BPP_A)                                              \
+TEST_F(libyuvTest, FMT_A##ToNV12) {                                            \
+  const int kWidths[3] = { 1280, 1282, 33 };                                   \
+  const int kHeight = 63;                                                      \
+  for (int w = 0; w < 3; ++w) {                                                \
+    const int kWidth = kWidths[w];                                             \
+    const int kHalfWidth = (kWidth + 1) / 2;                                   \
+    const int kHalfHeight = (kHeight + 1) / 2;                                 \
+    const int kStride = kWidth * BPP_A;                                        \
+    align_buffer_16(src, kStride * kHeight)                                    \
+    align_buffer_16(dst_y_i420, kWidth * kHeight)                              \
+    align_buffer_16(dst_u, kHalfWidth * kHalfHeight)                           \
+    align_buffer_16(dst_v, kHalfWidth * kHalfHeight)                           \
+    align_buffer_16(dst_y_nv12, kWidth * kHeight)                              \
+    align_buffer_16(dst_uv, kHalfWidth * 2 * kHalfHeight)                      \
+    for (int i = 0; i < kStride * kHeight; ++i) {                              \
+      src[i] = (random() & 0xff);                                              \
+    }                                                                          \
+    for (int f = 0; f < 2; ++f) {                                              \
+      MaskCpuFlags(f ? -1 : kCpuInitialized);                                  \
+      EXPECT_EQ(0, FMT_A##ToI420(src, kStride, dst_y_i420, kWidth,             \
+                                 dst_u, kHalfWidth, dst_v, kHalfWidth,         \
+                                 kWidth, kHeight));                            \
+      EXPECT_EQ(0, FMT_A##ToNV12(src, kStride, dst_y_nv12, kWidth,             \
+                                 dst_uv, kHalfWidth * 2, kWidth, kHeight));    \
+      EXPECT_EQ(0, memcmp(dst_y_i420, dst_y_nv12, kWidth * kHeight));          \
+      int num_diff = 0;                                                        \
+      for (int i = 0; i < kHalfWidth * kHalfHeight; ++i) {                     \
+        if (dst_uv[i * 2 + 0] != dst_u[i] || dst_uv[i * 2 + 1] != dst_v[i]) {  \
+          ++num_diff;                                                          \
+        }                                                                      \
+      }                                                                        \
+      EXPECT_EQ(0, num_diff);                                                  \
+    }                                                                          \
+    MaskCpuFlags(-1);                                                          \
+    free_aligned_buffer_16(src)                                                \
+    free_aligned_buffer_16(dst_y_i420)                                         \
+    free_aligned_buffer_16(dst_u)                                              \
+    free_aligned_buffer_16(dst_v)                                              \
+    free_aligned_buffer_16(dst_y_nv12)                                         \
+    free_aligned_buffer_16(dst_uv)                                             \
+  }                                                                            \
+}
+
+TESTATONV12(ARGB, 4)
+TESTATONV12(YUY2, 2)
+
+// The fused 16 bit conversions match converting to ARGB and then packing.
+#define TESTPLANARTO16MATCH(FMT_B)                                             \
+TEST_F(libyuvTest, I420To##FMT_B##_MatchesARGB) {                              \
+  const int kWidth = 333;                                                      \
+  const int kHeight = 35;                                                      \
+  const int kHalfWidth = (kWidth + 1) / 2;                                     \
+  const int kHalfHeight = (kHeight + 1) / 2;                                   \
+  align_buffer_16(src_y, kWidth * kHeight)                                     \
+  align_buffer_16(src_u, kHalfWidth * kHalfHeight)                             \
+  align_buffer_16(src_v, kHalfWidth * kHalfHeight)                             \
+  align_buffer_16(dst_argb, kWidth * 4 * kHeight)                              \
+  align_buffer_16(dst_2pass, kWidth * 2 * kHeight)                             \
+  align_buffer_16(dst_fused, kWidth * 2 * kHeight)                             \
+  for (int i = 0; i < kWidth * kHeight; ++i) {                                 \
+    src_y[i] = (random() & 0xff);                                              \
+  }                                                                            \
+  for (int i = 0; i < kHalfWidth * kHalfHeight; ++i) {                         \
+    src_u[i] = (random() & 0xff);                                              \
+    src_v[i] = (random() & 0xff);                                              \
+  }                                                                            \
+  for (int f = 0; f < 2; ++f) {                                                \
+    MaskCpuFlags(f ? -1 : kCpuInitialized);                                    \
+    I420ToARGB(src_y, kWidth, src_u, kHalfWidth, src_v, kHalfWidth,            \
+               dst_argb, kWidth * 4, kWidth, kHeight);                         \
+    ARGBTo##FMT_B(dst_argb, kWidth * 4, dst_2pass, kWidth * 2,                 \
+                  kWidth, kHeight);                                            \
+    I420To##FMT_B(src_y, kWidth, src_u, kHalfWidth, src_v, kHalfWidth,         \
+                  dst_fused, kWidth * 2, kWidth, kHeight);                     \
+    EXPECT_EQ(0, memcmp(dst_2pass, dst_fused, kWidth * 2 * kHeight));          \
+  }                                                                            \
+  MaskCpuFlags(-1);                                                            \
+  free_aligned_buffer_16(src_y)                                                \
+  free_aligned_buffer_16(src_u)                                                \
+  free_aligned_buffer_16(src_v)                                                \
+  free_aligned_buffer_16(dst_argb)                                             \
+  free_aligned_buffer_16(dst_2pass)                                            \
+  free_aligned_buffer_16(dst_fused)                                            \
+}
+
+TESTPLANARTO16MATCH(RGB565)
+TESTPLANARTO16MATCH(ARGB1555)
+TESTPLANARTO16MATCH(ARGB4444)
+
+TEST_F(libyuvTest, I420ToRGB565Dither) {
+  const int kWidth = 1283;
+  const int kHeight = 35;
+  const int kHalfWidth = (kWidth + 1) / 2;
+  const int kHalfHeight = (kHeight + 1) / 2;
+  const int kSize = kWidth * 2 * kHeight;
+  align_buffer_16(src_y, kWidth * kHeight)
+  align_buffer_16(src_u, kHalfWidth * kHalfHeight)
+  align_buffer_16(src_v, kHalfWidth * kHalfHeight)
+  align_buffer_16(dst_plain, kSize)
+  align_buffer_16(dst_c, kSize)
+  align_buffer_16(dst_opt, kSize)
+  for (int i = 0; i < kWidth * kHeight; ++i) {
+    src_y[i] = (random() & 0xff);
+  }
+  for (int i = 0; i < kHalfWidth * kHalfHeight; ++i) {
+    src_u[i] = (random() & 0xff);
+    src_v[i] = (random() & 0xff);
+  }
+  // A zero matrix is the same as no dither.
+  static const uint8 kNoDither[16] = { 0 };
+  I420ToRGB565(src_y, kWidth, src_u, kHalfWidth, src_v, kHalfWidth,
+               dst_plain, kWidth * 2, kWidth, kHeight);
+  EXPECT_EQ(0, I420ToRGB565Dither(src_y, kWidth, src_u, kHalfWidth,
+                                  src_v, kHalfWidth, dst_opt, kWidth * 2,
+                                  kNoDither, kWidth, kHeight));
+  EXPECT_EQ(0, memcmp(dst_plain, dst_opt, kSize));
+
+  MaskCpuFlags(kCpuInitialized);
+  I420ToRGB565Dither(src_y, kWidth, src_u, kHalfWidth, src_v, kHalfWidth,
+                     dst_c, kWidth * 2, NULL, kWidth, kHeight);
+  MaskCpuFlags(-1);
+  for (int i = 0; i < benchmark_iterations_; ++i) {
+    I420ToRGB565Dither(src_y, kWidth, src_u, kHalfWidth, src_v, kHalfWidth,
+                       dst_opt, kWidth * 2, NULL, kWidth, kHeight);
+  }
+  EXPECT_EQ(0, memcmp(dst_c, dst_opt, kSize));
+  // Dither only rounds up, by less than one step of the 5 bit channels.
+  int num_diff = 0;
+  for (int i = 0; i < kWidth * kHeight; ++i) {
+    int p0 = dst_plain[i * 2] | (dst_plain[i * 2 + 1] << 8);
+    int p1 = dst_c[i * 2] | (dst_c[i * 2 + 1] << 8);
+    EXPECT_LE(p0 & 0x1f, p1 & 0x1f);
+    EXPECT_LE(p0 >> 11, p1 >> 11);
+    EXPECT_LE((p1 & 0x1f) - (p0 & 0x1f), 1);
+    EXPECT_LE((p1 >> 11) - (p0 >> 11), 1);
+    if (p0 != p1) {
+      ++num_diff;
+    }
+  }
+  EXPECT_GT(num_diff, 0);
+  free_aligned_buffer_16(src_y)
+  free_aligned_buffer_16(src_u)
+  free_aligned_buffer_16(src_v)
+  free_aligned_buffer_16(dst_plain)
+  free_aligned_buffer_16(dst_c)
+  free_aligned_buffer_16(dst_opt)
+}
+
+TEST_F(libyuvTest, NV12Mirror) {
+  const int kWidths[2] = { 1280, 66 };
+  const int kHeight = 35;
+  for (int w = 0; w < 2; ++w) {
+    const int kWidth = kWidths[w];
+    const int kHalfWidth = (kWidth + 1) / 2;
+    const int kHalfHeight = (kHeight + 1) / 2;
+    const int kUVSize = kHalfWidth * kHalfHeight;
+    align_buffer_16(src_y, kWidth * kHeight)
+    align_buffer_16(src_uv, kUVSize * 2)
+    align_buffer_16(src_u, kUVSize)
+    align_buffer_16(src_v, kUVSize)
+    align_buffer_16(dst_y_i420, kWidth * kHeight)
+    align_buffer_16(dst_u, kUVSize)
+    align_buffer_16(dst_v, kUVSize)
+    align_buffer_16(dst_y_nv12, kWidth * kHeight)
+    align_buffer_16(dst_uv, kUVSize * 2)
+    for (int i = 0; i < kWidth * kHeight; ++i) {
+      src_y[i] = (random() & 0xff);
+    }
+    for (int i = 0; i < kUVSize; ++i) {
+      src_u[i] = src_uv[i * 2 + 0] = (random() & 0xff);
+      src_v[i] = src_uv[i * 2 + 1] = (random() & 0xff);
+    }
+    I420Mirror(src_y, kWidth, src_u, kHalfWidth, src_v, kHalfWidth,
+               dst_y_i420, kWidth, dst_u, kHalfWidth, dst_v, kHalfWidth,
+               kWidth, kHeight);
+    for (int f = 0; f < 2; ++f) {
+      MaskCpuFlags(f ? -1 : kCpuInitialized);
+      memset(dst_uv, 0, kUVSize * 2);
+      EXPECT_EQ(0, NV12Mirror(src_y, kWidth, src_uv, kHalfWidth * 2,
+                              dst_y_nv12, kWidth, dst_uv, kHalfWidth * 2,
+                              kWidth, kHeight));
+      EXPECT_EQ(0, memcmp(dst_y_i420, dst_y_nv12, kWidth * kHeight));
+      int num_diff = 0;
+      for (int i = 0; i < kUVSize; ++i) {
+        if (dst_uv[i * 2 + 0] != dst_u[i] || dst_uv[i * 2 + 1] != dst_v[i]) {
+          ++num_diff;
+        }
+      }
+      EXPECT_EQ(0, num_diff);
+    }
+    MaskCpuFlags(-1);
+    free_aligned_buffer_16(src_y)
+    free_aligned_buffer_16(src_uv)
+    free_aligned_buffer_16(src_u)
+    free_aligned_buffer_16(src_v)
+    free_aligned_buffer_16(dst_y_i420)
+    free_aligned_buffer_16(dst_u)
+    free_aligned_buffer_16(dst_v)
+    free_aligned_buffer_16(dst_y_nv12)
+    free_aligned_buffer_16(dst_uv)
+  }
+}
+
 TEST_F(libyuvTest, Test565) {
   SIMD_ALIGNED(uint8 orig_pixels[256][4]);
   SIMD_ALIGNED(uint8 pixels565[256][2]);
@@ -1002,4 +2584,118 @@ TEST_F(libyuvTest, Test565) {
   EXPECT_EQ(610919429u, checksum);
 }
 
+// AVX2 kernels must match the SSSE3 ones exactly. Without AVX2 both runs
+// use the same kernels.
+TEST_F(libyuvTest, ARGBToI420_AVX2MatchesSSSE3) {
+  // Also covers the Any version, and widths 16 to 31 that are too narrow
+  // for AVX2 and run the SSSE3 kernels.
+  const int kWidth = 1280 + 17;
+  const int kHeight = 8;
+  align_buffer_16(src_argb, kWidth * 4 * kHeight)
+  align_buffer_16(dst_y_ssse3, kWidth * kHeight)
+  align_buffer_16(dst_y_avx2, kWidth * kHeight)
+  align_buffer_16(dst_uv, kWidth * kHeight)
+  srandom(time(NULL));
+  for (int i = 0; i < kWidth * 4 * kHeight; ++i) {
+    src_argb[i] = (random() & 0xff);
+  }
+  int widths[19];
+  for (int i = 0; i < 17; ++i) {
+    widths[i] = 16 + i;
+  }
+  widths[17] = kWidth - 17;
+  widths[18] = kWidth;
+  for (int w = 0; w < 19; ++w) {
+    const int width = widths[w];
+    MaskCpuFlags(~kCpuHasAVX2);
+    ARGBToI420(src_argb, width * 4, dst_y_ssse3, width,
+               dst_uv, width / 2, dst_uv + kWidth * kHeight / 2, width / 2,
+               width, kHeight);
+    MaskCpuFlags(-1);
+    ARGBToI420(src_argb, width * 4, dst_y_avx2, width,
+               dst_uv, width / 2, dst_uv + kWidth * kHeight / 2, width / 2,
+               width, kHeight);
+    EXPECT_EQ(0, memcmp(dst_y_ssse3, dst_y_avx2, width * kHeight));
+  }
+  free_aligned_buffer_16(src_argb)
+  free_aligned_buffer_16(dst_y_ssse3)
+  free_aligned_buffer_16(dst_y_avx2)
+  free_aligned_buffer_16(dst_uv)
+}
+
+// Batches match I420ToARGB on each frame, with any number of threads.
+TEST_F(libyuvTest, I420ToARGBBatch) {
+  const int kFrames = 64;
+  // Widths that need the Any version, and one too small for SIMD.
+  const int kWidths[4] = { 96, 100, 37, 5 };
+  YuvFrame src[kFrames];
+  YuvFrame dst[kFrames];
+  YuvFrame ref[kFrames];
+  srandom(time(NULL));
+  for (int i = 0; i < kFrames; ++i) {
+    const int width = kWidths[i & 3];
+    const int height = 33 + (i & 7);
+    EXPECT_EQ(0, AllocFrame(&src[i], FOURCC_I420, width, height));
+    EXPECT_EQ(0, AllocFrame(&dst[i], FOURCC_ARGB, width, height));
+    EXPECT_EQ(0, AllocFrame(&ref[i], FOURCC_ARGB, width, height));
+    for (int j = 0; j < static_cast<int>(src[i].size); ++j) {
+      src[i].buffer[j] = (random() & 0xff);
+    }
+    I420ToARGB(src[i].plane[0], src[i].stride[0],
+               src[i].plane[1], src[i].stride[1],
+               src[i].plane[2], src[i].stride[2],
+               ref[i].plane[0], ref[i].stride[0], width, height);
+  }
+  for (int threads = 1; threads <= 4; threads += 3) {
+    for (int i = 0; i < kFrames; ++i) {
+      memset(dst[i].buffer, 0, dst[i].size);
+    }
+    EXPECT_EQ(0, I420ToARGBBatch(src, dst, kFrames, threads));
+    for (int i = 0; i < kFrames; ++i) {
+      for (int y = 0; y < dst[i].height; ++y) {
+        EXPECT_EQ(0, memcmp(ref[i].plane[0] + y * ref[i].stride[0],
+                            dst[i].plane[0] + y * dst[i].stride[0],
+                            dst[i].width * 4));
+      }
+    }
+  }
+
+  // A batch smaller than the threads runs a band per frame.
+  for (int i = 0; i < 3; ++i) {
+    memset(dst[i].buffer, 0, dst[i].size);
+  }
+  EXPECT_EQ(0, I420ToARGBBatch(src, dst, 3, 4));
+  for (int i = 0; i < 3; ++i) {
+    for (int y = 0; y < dst[i].height; ++y) {
+      EXPECT_EQ(0, memcmp(ref[i].plane[0] + y * ref[i].stride[0],
+                          dst[i].plane[0] + y * dst[i].stride[0],
+                          dst[i].width * 4));
+    }
+  }
+
+  // A frame cropped out of a larger one keeps the pixels around it.
+  YuvFrame crop = dst[5];
+  crop.plane[0] += 4 * 4;
+  crop.width = src[2].width;
+  crop.height = src[2].height;
+  memset(dst[5].buffer, 0, dst[5].size);
+  EXPECT_EQ(0, I420ToARGBBatch(&src[2], &crop, 1, 1));
+  for (int y = 0; y < crop.height; ++y) {
+    const uint8* row = dst[5].plane[0] + y * dst[5].stride[0];
+    for (int x = (4 + crop.width) * 4; x < dst[5].width * 4; ++x) {
+      EXPECT_EQ(0, row[x]);
+    }
+  }
+
+  dst[0].height = 1;
+  EXPECT_EQ(-1, I420ToARGBBatch(src, dst, kFrames, 1));
+  EXPECT_EQ(-1, I420ToARGBBatch(dst, src, kFrames, 1));
+  EXPECT_EQ(-1, I420ToARGBBatch(src, dst, 0, 1));
+  for (int i = 0; i < kFrames; ++i) {
+    FreeFrame(&src[i]);
+    FreeFrame(&dst[i]);
+    FreeFrame(&ref[i]);
+  }
+}
+
 }  // namespace libyuv
@@ -9,8 +9,10 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
+#include "libyuv/cpu_id.h"
 #include "libyuv/rotate.h"
 #include "../unit_test/unit_test.h"
 
@@ -132,6 +134,67 @@ TEST_F(libyuvTest, TransposeUV) {
   EXPECT_EQ(0, err);
 }
 
+TEST_F(libyuvTest, TransposePlane_OptVsC) {
+  const int kWidth = benchmark_width_;
+  const int kHeight = benchmark_height_;
+  align_buffer_16(src, kWidth * kHeight)
+  align_buffer_16(dst_c, kWidth * kHeight)
+  align_buffer_16(dst_opt, kWidth * kHeight)
+  srandom(time(NULL));
+  for (int i = 0; i < kWidth * kHeight; ++i) {
+    src[i] = (random() & 0xff);
+  }
+  MaskCpuFlags(kCpuInitialized);
+  PerfTimer c_timer(1);
+  while (c_timer.Running()) {
+    TransposePlane(src, kWidth, dst_c, kHeight, kWidth, kHeight);
+  }
+  MaskCpuFlags(-1);
+  PerfTimer timer(benchmark_iterations_);
+  while (timer.Running()) {
+    TransposePlane(src, kWidth, dst_opt, kHeight, kWidth, kHeight);
+  }
+  PerfCheck(NULL, timer, c_timer, kWidth * kHeight, NULL);
+  EXPECT_EQ(0, memcmp(dst_c, dst_opt, kWidth * kHeight));
+  free_aligned_buffer_16(src)
+  free_aligned_buffer_16(dst_c)
+  free_aligned_buffer_16(dst_opt)
+}
+
+TEST_F(libyuvTest, TransposeUV_OptVsC) {
+  const int kWidth = benchmark_width_ / 2;
+  const int kHeight = benchmark_height_ / 2;
+  align_buffer_16(src, kWidth * 2 * kHeight)
+  align_buffer_16(dst_a_c, kWidth * kHeight)
+  align_buffer_16(dst_b_c, kWidth * kHeight)
+  align_buffer_16(dst_a_opt, kWidth * kHeight)
+  align_buffer_16(dst_b_opt, kWidth * kHeight)
+  srandom(time(NULL));
+  for (int i = 0; i < kWidth * 2 * kHeight; ++i) {
+    src[i] = (random() & 0xff);
+  }
+  MaskCpuFlags(kCpuInitialized);
+  PerfTimer c_timer(1);
+  while (c_timer.Running()) {
+    TransposeUV(src, kWidth * 2, dst_a_c, kHeight, dst_b_c, kHeight,
+                kWidth, kHeight);
+  }
+  MaskCpuFlags(-1);
+  PerfTimer timer(benchmark_iterations_);
+  while (timer.Running()) {
+    TransposeUV(src, kWidth * 2, dst_a_opt, kHeight, dst_b_opt, kHeight,
+                kWidth, kHeight);
+  }
+  PerfCheck(NULL, timer, c_timer, kWidth * kHeight * 2, NULL);
+  EXPECT_EQ(0, memcmp(dst_a_c, dst_a_opt, kWidth * kHeight));
+  EXPECT_EQ(0, memcmp(dst_b_c, dst_b_opt, kWidth * kHeight));
+  free_aligned_buffer_16(src)
+  free_aligned_buffer_16(dst_a_c)
+  free_aligned_buffer_16(dst_b_c)
+  free_aligned_buffer_16(dst_a_opt)
+  free_aligned_buffer_16(dst_b_opt)
+}
+
 TEST_F(libyuvTest, RotatePlane90) {
   int iw, ih, ow, oh;
   int err = 0;
@@ -1546,4 +1609,61 @@ TEST_F(libyuvTest, NV12ToI420RotateNegHeight180) {
   EXPECT_EQ(0, y_err + uv_err);
 }
 
+// Rows that are not 16 byte aligned, with widths that are a multiple of
+// 32, of 8 and neither, and a height that leaves a partial strip.
+TEST_F(libyuvTest, TransposePlane_Unaligned_OptVsC) {
+  const int kWidths[3] = { 1280, 1288, 1293 };
+  const int kHeight = 75;
+  const int kStride = 1293 + 4;
+  align_buffer_16(src, kStride * kHeight + 1)
+  align_buffer_16(dst_c, kWidths[2] * kHeight)
+  align_buffer_16(dst_opt, kWidths[2] * kHeight)
+  srandom(time(NULL));
+  for (int i = 0; i < kStride * kHeight + 1; ++i) {
+    src[i] = (random() & 0xff);
+  }
+  for (int w = 0; w < 3; ++w) {
+    const int width = kWidths[w];
+    MaskCpuFlags(kCpuInitialized);
+    TransposePlane(src + 1, kStride, dst_c, kHeight, width, kHeight);
+    MaskCpuFlags(-1);
+    TransposePlane(src + 1, kStride, dst_opt, kHeight, width, kHeight);
+    EXPECT_EQ(0, memcmp(dst_c, dst_opt, width * kHeight));
+  }
+  free_aligned_buffer_16(src)
+  free_aligned_buffer_16(dst_c)
+  free_aligned_buffer_16(dst_opt)
+}
+
+TEST_F(libyuvTest, TransposeUV_Unaligned_OptVsC) {
+  const int kWidths[3] = { 640, 648, 653 };
+  const int kHeight = 75;
+  const int kStride = 653 * 2 + 2;
+  align_buffer_16(src, kStride * kHeight + 1)
+  align_buffer_16(dst_a_c, kWidths[2] * kHeight)
+  align_buffer_16(dst_b_c, kWidths[2] * kHeight)
+  align_buffer_16(dst_a_opt, kWidths[2] * kHeight)
+  align_buffer_16(dst_b_opt, kWidths[2] * kHeight)
+  srandom(time(NULL));
+  for (int i = 0; i < kStride * kHeight + 1; ++i) {
+    src[i] = (random() & 0xff);
+  }
+  for (int w = 0; w < 3; ++w) {
+    const int width = kWidths[w];
+    MaskCpuFlags(kCpuInitialized);
+    TransposeUV(src + 1, kStride, dst_a_c, kHeight, dst_b_c, kHeight,
+                width, kHeight);
+    MaskCpuFlags(-1);
+    TransposeUV(src + 1, kStride, dst_a_opt, kHeight, dst_b_opt, kHeight,
+                width, kHeight);
+    EXPECT_EQ(0, memcmp(dst_a_c, dst_a_opt, width * kHeight));
+    EXPECT_EQ(0, memcmp(dst_b_c, dst_b_opt, width * kHeight));
+  }
+  free_aligned_buffer_16(src)
+  free_aligned_buffer_16(dst_a_c)
+  free_aligned_buffer_16(dst_b_c)
+  free_aligned_buffer_16(dst_a_opt)
+  free_aligned_buffer_16(dst_b_opt)
+}
+
 }  // namespace libyuv
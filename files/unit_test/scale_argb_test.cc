@@ -9,10 +9,13 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
 #include "libyuv/cpu_id.h"
+#include "libyuv/frame.h"
 #include "libyuv/scale_argb.h"
+#include "libyuv/video_common.h"
 #include "../unit_test/unit_test.h"
 
 namespace libyuv {
@@ -252,4 +255,52 @@ TEST_F(libyuvTest, ARGBScaleTo853) {
   }
 }
 
+// Batches match ARGBScale on each frame, with any number of threads.
+TEST_F(libyuvTest, ARGBScaleBatch) {
+  const int kFrames = 48;
+  // 1/2, even, odd and any size.
+  const int kDstSizes[4] = { 48, 24, 32, 72 };
+  YuvFrame src[kFrames];
+  YuvFrame dst[kFrames];
+  YuvFrame ref[kFrames];
+  srandom(time(NULL));
+  for (int f = 0; f < 2; ++f) {
+    const FilterMode filtering = static_cast<FilterMode>(f);
+    for (int i = 0; i < kFrames; ++i) {
+      const int size = kDstSizes[i & 3];
+      EXPECT_EQ(0, AllocFrame(&src[i], FOURCC_ARGB, 96, 96));
+      EXPECT_EQ(0, AllocFrame(&dst[i], FOURCC_ARGB, size, size));
+      EXPECT_EQ(0, AllocFrame(&ref[i], FOURCC_ARGB, size, size));
+      for (int j = 0; j < static_cast<int>(src[i].size); ++j) {
+        src[i].buffer[j] = (random() & 0xff);
+      }
+      ARGBScale(src[i].plane[0], src[i].stride[0], 96, 96,
+                ref[i].plane[0], ref[i].stride[0], size, size, filtering);
+    }
+    // 3 frames on 4 threads is a batch smaller than the threads.
+    const int kCounts[3] = { kFrames, kFrames, 3 };
+    const int kThreads[3] = { 1, 4, 4 };
+    for (int t = 0; t < 3; ++t) {
+      for (int i = 0; i < kFrames; ++i) {
+        memset(dst[i].buffer, 0, dst[i].size);
+      }
+      EXPECT_EQ(0, ARGBScaleBatch(src, dst, kCounts[t], filtering,
+                                  kThreads[t]));
+      for (int i = 0; i < kCounts[t]; ++i) {
+        for (int y = 0; y < dst[i].height; ++y) {
+          EXPECT_EQ(0, memcmp(ref[i].plane[0] + y * ref[i].stride[0],
+                              dst[i].plane[0] + y * dst[i].stride[0],
+                              dst[i].width * 4));
+        }
+      }
+    }
+    for (int i = 0; i < kFrames; ++i) {
+      FreeFrame(&src[i]);
+      FreeFrame(&dst[i]);
+      FreeFrame(&ref[i]);
+    }
+  }
+  EXPECT_EQ(-1, ARGBScaleBatch(src, dst, kFrames, kFilterNone, 1));
+}
+
 }  // namespace libyuv
@@ -8,10 +8,14 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
 #include "libyuv/cpu_id.h"
+#include "libyuv/explain.h"
+#include "libyuv/rotate.h"
 #include "libyuv/scale.h"
 #include "../unit_test/unit_test.h"
 
@@ -87,8 +91,8 @@ static int TestFilter(int src_width, int src_height,
             dst_width, dst_height, f);
 
   MaskCpuFlags(0);  // Disable all CPU optimization.
-  double c_time = get_time();
-  for (i = 0; i < benchmark_iterations; ++i) {
+  PerfTimer c_timer(benchmark_iterations);
+  while (c_timer.Running()) {
     I420Scale(src_y + (src_stride_y * b) + b, src_stride_y,
               src_u + (src_stride_uv * b) + b, src_stride_uv,
               src_v + (src_stride_uv * b) + b, src_stride_uv,
@@ -98,11 +102,11 @@ static int TestFilter(int src_width, int src_height,
               dst_v_c + (dst_stride_uv * b) + b, dst_stride_uv,
               dst_width, dst_height, f);
   }
-  c_time = (get_time() - c_time) / benchmark_iterations;
+  const double c_time = c_timer.seconds();
 
   MaskCpuFlags(-1);  // Enable all CPU optimization.
-  double opt_time = get_time();
-  for (i = 0; i < benchmark_iterations; ++i) {
+  PerfTimer timer(benchmark_iterations);
+  while (timer.Running()) {
     I420Scale(src_y + (src_stride_y * b) + b, src_stride_y,
               src_u + (src_stride_uv * b) + b, src_stride_uv,
               src_v + (src_stride_uv * b) + b, src_stride_uv,
@@ -112,7 +116,20 @@ static int TestFilter(int src_width, int src_height,
               dst_v_opt + (dst_stride_uv * b) + b, dst_stride_uv,
               dst_width, dst_height, f);
   }
-  opt_time = (get_time() - opt_time) / benchmark_iterations;
+  const double opt_time = timer.seconds();
+
+  KernelChoice choices[3];
+  ExplainI420Scale(src_y + (src_stride_y * b) + b, src_stride_y,
+                   src_u + (src_stride_uv * b) + b, src_stride_uv,
+                   src_v + (src_stride_uv * b) + b, src_stride_uv,
+                   src_width, src_height,
+                   dst_y_opt + (dst_stride_y * b) + b, dst_stride_y,
+                   dst_u_opt + (dst_stride_uv * b) + b, dst_stride_uv,
+                   dst_v_opt + (dst_stride_uv * b) + b, dst_stride_uv,
+                   dst_width, dst_height, f, choices);
+  const char* kFilterNames[] = { "None", "Bilinear", "Box" };
+  PerfCheck(kFilterNames[f], timer, c_timer, dst_width * dst_height,
+            choices[0].kernel);
 
   // Report performance of C vs OPT
   printf("filter %d - %8d us C - %8d us OPT\n",
@@ -373,4 +390,307 @@ TEST_F(libyuvTest, ScaleToHalf342) {
   }
 }
 
+// Compares I420RotateScale (or NV12ToI420RotateScale) against a rotate into
+// a frame followed by I420Scale. Returns the max difference.
+// If smooth, the source is a gradient, so filters that differ only in
+// footprint give close results.
+static int TestRotateScale(int src_width, int src_height,
+                           int dst_width, int dst_height,
+                           RotationMode mode, FilterMode f, bool nv12,
+                           bool smooth, int benchmark_iterations) {
+  const int src_halfwidth = (src_width + 1) >> 1;
+  const int src_halfheight = (src_height + 1) >> 1;
+  const int rot_width = (mode == kRotate90 || mode == kRotate270) ?
+      src_height : src_width;
+  const int rot_height = (mode == kRotate90 || mode == kRotate270) ?
+      src_width : src_height;
+  const int rot_halfwidth = (rot_width + 1) >> 1;
+  const int rot_halfheight = (rot_height + 1) >> 1;
+  const int dst_halfwidth = (dst_width + 1) >> 1;
+  const int dst_halfheight = (dst_height + 1) >> 1;
+
+  align_buffer_16(src_y, src_width * src_height)
+  align_buffer_16(src_u, src_halfwidth * src_halfheight)
+  align_buffer_16(src_v, src_halfwidth * src_halfheight)
+  align_buffer_16(src_uv, src_halfwidth * 2 * src_halfheight)
+  align_buffer_16(rot_y, rot_width * rot_height)
+  align_buffer_16(rot_u, rot_halfwidth * rot_halfheight)
+  align_buffer_16(rot_v, rot_halfwidth * rot_halfheight)
+  const int dst_y_size = dst_width * dst_height;
+  const int dst_uv_size = dst_halfwidth * dst_halfheight;
+  align_buffer_16(dst_ref, dst_y_size + dst_uv_size * 2)
+  align_buffer_16(dst_opt, dst_y_size + dst_uv_size * 2)
+
+  srandom(time(NULL));
+  for (int i = 0; i < src_height; ++i) {
+    for (int j = 0; j < src_width; ++j) {
+      src_y[i * src_width + j] = smooth ?
+          (i + j) * 255 / (src_width + src_height) : (random() & 0xff);
+    }
+  }
+  for (int i = 0; i < src_halfheight; ++i) {
+    for (int j = 0; j < src_halfwidth; ++j) {
+      int k = i * src_halfwidth + j;
+      src_u[k] = smooth ? i * 255 / src_halfheight : (random() & 0xff);
+      src_v[k] = smooth ? j * 255 / src_halfwidth : (random() & 0xff);
+      src_uv[k * 2 + 0] = src_u[k];
+      src_uv[k * 2 + 1] = src_v[k];
+    }
+  }
+  memset(dst_ref, 1, dst_y_size + dst_uv_size * 2);
+  memset(dst_opt, 2, dst_y_size + dst_uv_size * 2);
+
+  double ref_time = get_time();
+  for (int i = 0; i < benchmark_iterations; ++i) {
+    if (nv12) {
+      NV12ToI420Rotate(src_y, src_width, src_uv, src_halfwidth * 2,
+                       rot_y, rot_width, rot_u, rot_halfwidth,
+                       rot_v, rot_halfwidth, src_width, src_height, mode);
+    } else {
+      I420Rotate(src_y, src_width, src_u, src_halfwidth, src_v, src_halfwidth,
+                 rot_y, rot_width, rot_u, rot_halfwidth, rot_v, rot_halfwidth,
+                 src_width, src_height, mode);
+    }
+    I420Scale(rot_y, rot_width, rot_u, rot_halfwidth, rot_v, rot_halfwidth,
+              rot_width, rot_height,
+              dst_ref, dst_width,
+              dst_ref + dst_y_size, dst_halfwidth,
+              dst_ref + dst_y_size + dst_uv_size, dst_halfwidth,
+              dst_width, dst_height, f);
+  }
+  ref_time = (get_time() - ref_time) / benchmark_iterations;
+
+  double opt_time = get_time();
+  for (int i = 0; i < benchmark_iterations; ++i) {
+    if (nv12) {
+      EXPECT_EQ(0, NV12ToI420RotateScale(src_y, src_width,
+                                         src_uv, src_halfwidth * 2,
+                                         src_width, src_height,
+                                         dst_opt, dst_width,
+                                         dst_opt + dst_y_size, dst_halfwidth,
+                                         dst_opt + dst_y_size + dst_uv_size,
+                                         dst_halfwidth,
+                                         dst_width, dst_height, mode, f));
+    } else {
+      EXPECT_EQ(0, I420RotateScale(src_y, src_width, src_u, src_halfwidth,
+                                   src_v, src_halfwidth,
+                                   src_width, src_height,
+                                   dst_opt, dst_width,
+                                   dst_opt + dst_y_size, dst_halfwidth,
+                                   dst_opt + dst_y_size + dst_uv_size,
+                                   dst_halfwidth,
+                                   dst_width, dst_height, mode, f));
+    }
+  }
+  opt_time = (get_time() - opt_time) / benchmark_iterations;
+  printf("rotate %d filter %d - %8d us 2 pass - %8d us 1 pass\n",
+         mode, f, static_cast<int>(ref_time * 1e6),
+         static_cast<int>(opt_time * 1e6));
+
+  int max_diff = 0;
+  for (int i = 0; i < dst_y_size + dst_uv_size * 2; ++i) {
+    int abs_diff = abs(dst_ref[i] - dst_opt[i]);
+    if (abs_diff > max_diff) {
+      max_diff = abs_diff;
+    }
+  }
+
+  free_aligned_buffer_16(src_y)
+  free_aligned_buffer_16(src_u)
+  free_aligned_buffer_16(src_v)
+  free_aligned_buffer_16(src_uv)
+  free_aligned_buffer_16(rot_y)
+  free_aligned_buffer_16(rot_u)
+  free_aligned_buffer_16(rot_v)
+  free_aligned_buffer_16(dst_ref)
+  free_aligned_buffer_16(dst_opt)
+  return max_diff;
+}
+
+// Camera preview: 1280x720 sensor rotated to portrait and scaled to 480x640.
+// Point sampling and bilinear use the same filters as I420Scale. Bilinear
+// may be off by 1 where I420Scale uses C for unaligned rotated strides.
+TEST_F(libyuvTest, I420RotateScale) {
+  const RotationMode kModes[3] = { kRotate90, kRotate180, kRotate270 };
+  for (int m = 0; m < 3; ++m) {
+    int dst_width = (kModes[m] == kRotate180) ? 640 : 480;
+    int dst_height = (kModes[m] == kRotate180) ? 480 : 640;
+    for (int f = 0; f < 2; ++f) {
+      EXPECT_LE(TestRotateScale(1280, 720, dst_width, dst_height,
+                                kModes[m], static_cast<FilterMode>(f),
+                                false, false, benchmark_iterations_), f);
+    }
+  }
+}
+
+TEST_F(libyuvTest, NV12ToI420RotateScale) {
+  const RotationMode kModes[4] = { kRotate0, kRotate90, kRotate180,
+                                   kRotate270 };
+  for (int m = 0; m < 4; ++m) {
+    bool portrait = kModes[m] == kRotate90 || kModes[m] == kRotate270;
+    for (int f = 0; f < 2; ++f) {
+      EXPECT_LE(TestRotateScale(1280, 720,
+                                portrait ? 480 : 640, portrait ? 640 : 480,
+                                kModes[m], static_cast<FilterMode>(f),
+                                true, false, benchmark_iterations_), f);
+    }
+  }
+}
+
+// Odd sizes exercise the padded rotation window.
+TEST_F(libyuvTest, I420RotateScaleOdd) {
+  EXPECT_EQ(0, TestRotateScale(333, 197, 123, 222, kRotate90, kFilterNone,
+                               false, false, 1));
+  EXPECT_EQ(0, TestRotateScale(333, 197, 123, 222, kRotate270, kFilterNone,
+                               true, false, 1));
+  EXPECT_LE(TestRotateScale(333, 197, 123, 222, kRotate90, kFilterBilinear,
+                            true, true, 1), 2);
+}
+
+// Box filters more than 2x downscales, where I420Scale uses bilinear, so
+// compare on a gradient.
+TEST_F(libyuvTest, I420RotateScaleBox) {
+  EXPECT_LE(TestRotateScale(1280, 720, 240, 320, kRotate90, kFilterBox,
+                            false, true, benchmark_iterations_), 3);
+  EXPECT_LE(TestRotateScale(1280, 720, 240, 320, kRotate270, kFilterBox,
+                            true, true, benchmark_iterations_), 3);
+  EXPECT_LE(TestRotateScale(333, 197, 61, 101, kRotate90, kFilterBox,
+                            true, true, 1), 3);
+}
+
+// At 2x and 4x I420Scale box filters with ScalePlaneDown2 and
+// ScalePlaneDown4, so boxes that were not tiled from the top left would
+// differ on random pixels. Their rounding is off by up to s / 2.
+TEST_F(libyuvTest, I420RotateScaleBoxExact) {
+  const RotationMode kModes[3] = { kRotate90, kRotate180, kRotate270 };
+  for (int m = 0; m < 3; ++m) {
+    for (int s = 2; s <= 4; s += 2) {
+      int dst_width = (kModes[m] == kRotate180 ? 1280 : 720) / s;
+      int dst_height = (kModes[m] == kRotate180 ? 720 : 1280) / s;
+      EXPECT_LE(TestRotateScale(1280, 720, dst_width, dst_height,
+                                kModes[m], kFilterBox, false, false, 1),
+                s / 2);
+    }
+  }
+}
+
+// Scales NV12 with C and optimized code, and checks the C result for each of
+// U and V against ScalePlane of the split plane, which uses the same math.
+// Returns the max difference between the NV12 and split results.
+static int TestNV12Scale(int src_width, int src_height,
+                         int dst_width, int dst_height,
+                         FilterMode f, int benchmark_iterations) {
+  const int src_halfwidth = (src_width + 1) >> 1;
+  const int src_halfheight = (src_height + 1) >> 1;
+  const int dst_halfwidth = (dst_width + 1) >> 1;
+  const int dst_halfheight = (dst_height + 1) >> 1;
+  const int src_uv_size = src_halfwidth * src_halfheight;
+  const int dst_y_size = dst_width * dst_height;
+  const int dst_uv_size = dst_halfwidth * dst_halfheight;
+
+  align_buffer_16(src_y, src_width * src_height)
+  align_buffer_16(src_uv, src_uv_size * 2)
+  align_buffer_16(src_u, src_uv_size)
+  align_buffer_16(src_v, src_uv_size)
+  align_buffer_16(dst_c, dst_y_size + dst_uv_size * 2)
+  align_buffer_16(dst_opt, dst_y_size + dst_uv_size * 2)
+  align_buffer_16(dst_u, dst_uv_size)
+  align_buffer_16(dst_v, dst_uv_size)
+
+  srandom(time(NULL));
+  for (int i = 0; i < src_width * src_height; ++i) {
+    src_y[i] = (random() & 0xff);
+  }
+  for (int i = 0; i < src_uv_size; ++i) {
+    src_u[i] = src_uv[i * 2 + 0] = (random() & 0xff);
+    src_v[i] = src_uv[i * 2 + 1] = (random() & 0xff);
+  }
+
+  MaskCpuFlags(kCpuInitialized);
+  EXPECT_EQ(0, NV12Scale(src_y, src_width, src_uv, src_halfwidth * 2,
+                         src_width, src_height,
+                         dst_c, dst_width,
+                         dst_c + dst_y_size, dst_halfwidth * 2,
+                         dst_width, dst_height, f));
+  ScalePlane(src_u, src_halfwidth, src_halfwidth, src_halfheight,
+             dst_u, dst_halfwidth, dst_halfwidth, dst_halfheight, f);
+  ScalePlane(src_v, src_halfwidth, src_halfwidth, src_halfheight,
+             dst_v, dst_halfwidth, dst_halfwidth, dst_halfheight, f);
+  MaskCpuFlags(-1);
+
+  double opt_time = get_time();
+  for (int i = 0; i < benchmark_iterations; ++i) {
+    NV12Scale(src_y, src_width, src_uv, src_halfwidth * 2,
+              src_width, src_height,
+              dst_opt, dst_width,
+              dst_opt + dst_y_size, dst_halfwidth * 2,
+              dst_width, dst_height, f);
+  }
+  opt_time = (get_time() - opt_time) / benchmark_iterations;
+  printf("NV12Scale %dx%d -> %dx%d filter %d - %8d us\n",
+         src_width, src_height, dst_width, dst_height, f,
+         static_cast<int>(opt_time * 1e6));
+
+  int max_opt_diff = 0;
+  for (int i = 0; i < dst_y_size + dst_uv_size * 2; ++i) {
+    int abs_diff = abs(dst_c[i] - dst_opt[i]);
+    if (abs_diff > max_opt_diff) {
+      max_opt_diff = abs_diff;
+    }
+  }
+  EXPECT_LE(max_opt_diff, 1);
+
+  int max_diff = 0;
+  const uint8* dst_uv = dst_c + dst_y_size;
+  for (int i = 0; i < dst_uv_size; ++i) {
+    int abs_diff = abs(dst_uv[i * 2 + 0] - dst_u[i]);
+    if (abs_diff > max_diff) {
+      max_diff = abs_diff;
+    }
+    abs_diff = abs(dst_uv[i * 2 + 1] - dst_v[i]);
+    if (abs_diff > max_diff) {
+      max_diff = abs_diff;
+    }
+  }
+
+  free_aligned_buffer_16(src_y)
+  free_aligned_buffer_16(src_uv)
+  free_aligned_buffer_16(src_u)
+  free_aligned_buffer_16(src_v)
+  free_aligned_buffer_16(dst_c)
+  free_aligned_buffer_16(dst_opt)
+  free_aligned_buffer_16(dst_u)
+  free_aligned_buffer_16(dst_v)
+  return max_diff;
+}
+
+TEST_F(libyuvTest, NV12ScaleDownBy2) {
+  for (int f = 0; f < 2; ++f) {
+    EXPECT_EQ(0, TestNV12Scale(1280, 720, 640, 360,
+                               static_cast<FilterMode>(f),
+                               benchmark_iterations_));
+  }
+}
+
+// Even ratios sample the center of each box, as ARGBScale does, rather than
+// the corner used by ScalePlane, so only C vs optimized is checked.
+TEST_F(libyuvTest, NV12ScaleDownBy4) {
+  for (int f = 0; f < 2; ++f) {
+    TestNV12Scale(1280, 720, 320, 180, static_cast<FilterMode>(f),
+                  benchmark_iterations_);
+  }
+}
+
+TEST_F(libyuvTest, NV12ScaleAnySize) {
+  for (int f = 0; f < 2; ++f) {
+    EXPECT_EQ(0, TestNV12Scale(1280, 720, 800, 450,
+                               static_cast<FilterMode>(f),
+                               benchmark_iterations_));
+    EXPECT_EQ(0, TestNV12Scale(640, 360, 1280, 720,
+                               static_cast<FilterMode>(f),
+                               benchmark_iterations_));
+  }
+  EXPECT_EQ(0, TestNV12Scale(333, 197, 123, 222, kFilterNone, 1));
+}
+
 }  // namespace libyuv
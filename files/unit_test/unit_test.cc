@@ -10,14 +10,30 @@
 
 #include "../unit_test/unit_test.h"
 
+#include <stdio.h>
 #include <stdlib.h>  // For getenv()
 
 #include <cstring>
 
+#include "libyuv/cpu_id.h"
+
+#if defined(_MSC_VER)
+#define snprintf _snprintf
+#endif
+
 // Change this to 1000 for benchmarking.
 // TODO(fbarchard): Add command line parsing to pass this as option.
 #define BENCHMARK_ITERATIONS 1
 
+// Shortest block of calls PerfTimer times in perf regression mode, so timer
+// resolution and scheduling noise are small next to it.
+static const double kPerfBlockSeconds = 0.02;
+
+// Speedups over C of a SIMD kernel in the baseline, and under which a check
+// reports a fall back to C. The gap keeps noise from flipping a check.
+static const double kSimdSpeedup = 1.5;
+static const double kCSpeedup = 1.2;
+
 libyuvTest::libyuvTest() : rotate_max_w_(128), rotate_max_h_(128),
     benchmark_iterations_(BENCHMARK_ITERATIONS), benchmark_width_(1280),
     benchmark_height_(720) {
@@ -27,7 +43,231 @@ libyuvTest::libyuvTest() : rotate_max_w_(128), rotate_max_h_(128),
     }
 }
 
+PerfTimer::PerfTimer(int iterations)
+    : perf_(getenv("LIBYUV_PERF_BASELINE") != NULL),
+      calls_left_(iterations), block_calls_(0), block_start_(0.),
+      num_samples_(0), seconds_(0.), noise_(0.) {
+  if (perf_) {
+    calls_left_ = 0;
+  } else if (calls_left_ < 1) {
+    calls_left_ = 1;
+  }
+}
+
+bool PerfTimer::Running() {
+  if (!perf_) {
+    // All iterations are one block.
+    if (!block_calls_) {
+      block_calls_ = calls_left_;
+      block_start_ = get_time();
+    }
+    if (calls_left_-- > 0) {
+      return true;
+    }
+    seconds_ = (get_time() - block_start_) / block_calls_;
+    return false;
+  }
+  if (calls_left_ > 0) {
+    --calls_left_;
+    return true;
+  }
+  const double now = get_time();
+  if (!block_calls_) {
+    block_calls_ = 1;
+  } else if (now - block_start_ < kPerfBlockSeconds && !num_samples_) {
+    block_calls_ *= 2;
+  } else {
+    samples_[num_samples_++] = (now - block_start_) / block_calls_;
+    if (num_samples_ == kPerfSamples) {
+      // Insertion sort for the median.
+      for (int i = 1; i < kPerfSamples; ++i) {
+        const double t = samples_[i];
+        int j = i;
+        for (; j > 0 && samples_[j - 1] > t; --j) {
+          samples_[j] = samples_[j - 1];
+        }
+        samples_[j] = t;
+      }
+      seconds_ = samples_[kPerfSamples / 2];
+      noise_ = (samples_[kPerfSamples / 2 + 1] -
+                samples_[kPerfSamples / 2 - 1]) / seconds_;
+      return false;
+    }
+  }
+  calls_left_ = block_calls_ - 1;
+  block_start_ = get_time();
+  return true;
+}
+
+double PerfTimer::seconds() const {
+  return seconds_;
+}
+
+double PerfTimer::noise() const {
+  return noise_;
+}
+
+// Perf regression mode. The baseline file has a line per measurement:
+//   name megapixels_per_second speedup_over_c noise kernel
+// and a first line "# cpu_flags <hex>" for the machine it was recorded on.
+static const int kMaxPerfEntries = 1024;
+static const int kMaxPerfName = 128;
+
+struct PerfEntry {
+  char name[kMaxPerfName];
+  char kernel[kMaxPerfName];
+  double mpix_per_sec;
+  double speedup;
+  double noise;
+};
+
+static PerfEntry perf_entries_[kMaxPerfEntries];
+static int num_perf_entries_ = 0;
+static int perf_cpu_flags_ = 0;
+static bool perf_loaded_ = false;
+
+static bool PerfRecording() {
+  return getenv("LIBYUV_PERF_RECORD") != NULL;
+}
+
+static int CurrentCpuFlags() {
+  return libyuv::TestCpuFlag(-1);
+}
+
+static void LoadPerfBaseline(const char* filename) {
+  perf_loaded_ = true;
+  FILE* f = fopen(filename, "r");
+  if (!f) {
+    return;
+  }
+  char line[kMaxPerfName * 3];
+  while (fgets(line, sizeof(line), f)) {
+    if (line[0] == '#') {
+      unsigned int cpu_flags = 0;
+      if (sscanf(line, "# cpu_flags %x", &cpu_flags) == 1) {
+        perf_cpu_flags_ = static_cast<int>(cpu_flags);
+      }
+      continue;
+    }
+    if (num_perf_entries_ == kMaxPerfEntries) {
+      break;
+    }
+    PerfEntry* entry = &perf_entries_[num_perf_entries_];
+    if (sscanf(line, "%127s %lf %lf %lf %127s", entry->name,
+               &entry->mpix_per_sec, &entry->speedup, &entry->noise,
+               entry->kernel) == 5) {
+      ++num_perf_entries_;
+    }
+  }
+  fclose(f);
+}
+
+static PerfEntry* FindPerfEntry(const char* name) {
+  for (int i = 0; i < num_perf_entries_; ++i) {
+    if (!strcmp(perf_entries_[i].name, name)) {
+      return &perf_entries_[i];
+    }
+  }
+  return NULL;
+}
+
+static void SavePerfBaseline(const char* filename) {
+  FILE* f = fopen(filename, "w");
+  if (!f) {
+    printf("Can not write %s\n", filename);
+    return;
+  }
+  fprintf(f, "# cpu_flags %x\n", perf_cpu_flags_);
+  for (int i = 0; i < num_perf_entries_; ++i) {
+    fprintf(f, "%s %.1f %.2f %.3f %s\n", perf_entries_[i].name,
+            perf_entries_[i].mpix_per_sec, perf_entries_[i].speedup,
+            perf_entries_[i].noise, perf_entries_[i].kernel);
+  }
+  fclose(f);
+}
+
+void PerfCheck(const char* label, const PerfTimer& opt, const PerfTimer& c,
+               double pixels, const char* kernel) {
+  const char* filename = getenv("LIBYUV_PERF_BASELINE");
+  if (!filename || opt.seconds() <= 0. || c.seconds() <= 0.) {
+    return;
+  }
+  if (!perf_loaded_) {
+    LoadPerfBaseline(filename);
+  }
+  const ::testing::TestInfo* info =
+      ::testing::UnitTest::GetInstance()->current_test_info();
+  char name[kMaxPerfName];
+  snprintf(name, sizeof(name), "%s%s%s", info->name(), label ? "/" : "",
+           label ? label : "");
+  if (!kernel) {
+    kernel = "-";
+  }
+  const double mpix_per_sec = pixels / opt.seconds() * 1e-6;
+  const double speedup = c.seconds() / opt.seconds();
+  PerfEntry* entry = FindPerfEntry(name);
+
+  if (PerfRecording()) {
+    const double noise = opt.noise() + c.noise();
+    if (!entry) {
+      if (num_perf_entries_ == kMaxPerfEntries) {
+        return;
+      }
+      entry = &perf_entries_[num_perf_entries_++];
+      snprintf(entry->name, sizeof(entry->name), "%s", name);
+      entry->noise = 0.;
+    } else if (entry->speedup < speedup) {
+      // Recorded by an earlier run. The slowest run is kept, so a baseline
+      // recorded over several runs covers how much this machine varies.
+      if (entry->noise < noise) {
+        entry->noise = noise;
+      }
+      return;
+    }
+    snprintf(entry->kernel, sizeof(entry->kernel), "%s", kernel);
+    entry->mpix_per_sec = mpix_per_sec;
+    entry->speedup = speedup;
+    if (entry->noise < noise) {
+      entry->noise = noise;
+    }
+    perf_cpu_flags_ = CurrentCpuFlags();
+    return;
+  }
+  if (!entry) {
+    printf("%s: %.1f Mpixels/s, not in baseline\n", name, mpix_per_sec);
+    return;
+  }
+  EXPECT_EQ(perf_cpu_flags_, CurrentCpuFlags())
+      << "baseline " << filename << " was recorded on another cpu";
+  EXPECT_STREQ(entry->kernel, kernel) << name << " changed kernel";
+  if (entry->speedup >= kSimdSpeedup) {
+    EXPECT_GE(speedup, kCSpeedup)
+        << name << " is " << speedup << " times as fast as C, where the "
+        << "baseline is " << entry->speedup << " times, so it fell back to C";
+  }
+  // Throughput is compared as the speedup over C in the same test, so how
+  // busy the machine is cancels out.
+  const char* tolerance_env = getenv("LIBYUV_PERF_TOLERANCE");
+  double tolerance = tolerance_env ? atof(tolerance_env) : 15.;
+  double noise = opt.noise() + c.noise();
+  if (noise < entry->noise) {
+    noise = entry->noise;
+  }
+  if (tolerance < noise * 300.) {
+    tolerance = noise * 300.;
+  }
+  EXPECT_GE(speedup, entry->speedup * (1. - tolerance / 100.))
+      << name << " at " << mpix_per_sec << " Mpixels/s is " << speedup
+      << " times as fast as C, under the baseline of " << entry->speedup
+      << " times by more than " << tolerance << "%";
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
-  return RUN_ALL_TESTS();
+  int result = RUN_ALL_TESTS();
+  const char* filename = getenv("LIBYUV_PERF_BASELINE");
+  if (filename && PerfRecording() && num_perf_entries_) {
+    SavePerfBaseline(filename);
+  }
+  return result;
 }
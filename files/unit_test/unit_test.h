@@ -59,6 +59,57 @@ static inline double get_time() {
 }
 #endif
 
+// Times the calls of a loop:
+//   PerfTimer timer(benchmark_iterations_);
+//   while (timer.Running()) {
+//     Function(...);
+//   }
+// Normally the loop runs iterations times and seconds() is the average
+// call. In perf regression mode it runs blocks of calls that take at least
+// kPerfBlockSeconds, after doubling the block until it does, and seconds()
+// is the median call time of kPerfSamples blocks. noise() is the spread of
+// the middle blocks as a fraction of the median.
+class PerfTimer {
+ public:
+  explicit PerfTimer(int iterations);
+
+  // Returns true if the loop should make another call.
+  bool Running();
+  double seconds() const;
+  double noise() const;
+
+ private:
+  static const int kPerfSamples = 7;
+  bool perf_;
+  int calls_left_;
+  int block_calls_;
+  double block_start_;
+  int num_samples_;
+  double samples_[kPerfSamples];
+  double seconds_;
+  double noise_;
+};
+
+// Perf regression mode, enabled by setting LIBYUV_PERF_BASELINE to the
+// baseline file of this machine. testdata/perf_x86_64_avx2.txt is checked
+// in for x86-64 with AVX2 and shows the format. With LIBYUV_PERF_RECORD
+// also set, the measurements are written to the baseline instead. A
+// measurement already in the baseline is only replaced by a slower one, so
+// record a few runs to cover how much the machine varies.
+// Each _OptVsC test calls PerfCheck with a timer of the optimized calls, a
+// timer of the C calls, the pixels a call produced and the row kernel it
+// used, if known. label tells apart checks in one test. A check fails if:
+// - the kernel is not the one in the baseline. Only tests with an Explain
+//   function know it: I420ToARGB, NV12ToARGB, ARGBToI420 and I420Scale.
+// - the test was kSimdSpeedup times faster than C in the baseline and is
+//   now under kCSpeedup times, so it fell back to C. This covers the tests
+//   that do not know their kernel.
+// - throughput is more than a tolerance under the baseline. The tolerance
+//   is LIBYUV_PERF_TOLERANCE percent (default 15), or 3 times the noise of
+//   the baseline or of this run if that is more.
+void PerfCheck(const char* label, const PerfTimer& opt, const PerfTimer& c,
+               double pixels, const char* kernel);
+
 class libyuvTest : public ::testing::Test {
  protected:
   libyuvTest();
@@ -0,0 +1,444 @@
+/*
+ *  Copyright 2012 The LibYuv Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Throughput of libyuv functions by resolution, alignment and cpu flags.
+// libyuv_bench [-t seconds] [-f filter] [-s sizes] [-j]
+// prints one CSV line (or JSON object with -j) per measurement with
+// megapixels per second, gigabytes per second, cycles per pixel and frames
+// per second.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#include <intrin.h>  // For __rdtsc()
+#endif
+
+#include "libyuv/basic_types.h"
+#include "libyuv/compare.h"
+#include "libyuv/convert.h"
+#include "libyuv/convert_argb.h"
+#include "libyuv/cpu_id.h"
+#include "libyuv/frame.h"
+#include "libyuv/rotate.h"
+#include "libyuv/rotate_argb.h"
+#include "libyuv/scale.h"
+#include "libyuv/scale_argb.h"
+#include "libyuv/version.h"
+#include "libyuv/video_common.h"
+
+using namespace libyuv;  // NOLINT
+
+// Planes of an I420, NV12 and ARGB frame of the same size.
+struct Frame {
+  int width;
+  int height;
+  uint8* y;
+  uint8* u;
+  uint8* v;
+  uint8* uv;
+  uint8* argb;
+};
+
+struct Kernel {
+  const char* name;
+  // Bytes read plus bytes written for each source pixel.
+  double bytes_per_pixel;
+  void (*run)(const Frame& src, const Frame& dst);
+  // Frames each run converts.
+  int frames;
+};
+
+// Frames in each call of the batch functions. The sources share the planes
+// of one frame and each destination has its own, so bands of frames on
+// different threads never write the same memory.
+static const int kBatchFrames = 64;
+
+// ARGB destinations of the batch functions, kept until the size changes.
+static YuvFrame batch_dst_[kBatchFrames];
+
+static YuvFrame* BatchDestinations(int width, int height) {
+  if (batch_dst_[0].width != width || batch_dst_[0].height != height) {
+    for (int i = 0; i < kBatchFrames; ++i) {
+      FreeFrame(&batch_dst_[i]);
+      AllocFrame(&batch_dst_[i], FOURCC_ARGB, width, height);
+    }
+  }
+  return batch_dst_;
+}
+
+static void BenchI420ToARGB(const Frame& s, const Frame& d) {
+  const int hw = (s.width + 1) / 2;
+  I420ToARGB(s.y, s.width, s.u, hw, s.v, hw,
+             d.argb, d.width * 4, s.width, s.height);
+}
+
+static void BenchNV12ToARGB(const Frame& s, const Frame& d) {
+  NV12ToARGB(s.y, s.width, s.uv, (s.width + 1) & ~1,
+             d.argb, d.width * 4, s.width, s.height);
+}
+
+static void BenchARGBToI420(const Frame& s, const Frame& d) {
+  const int hw = (s.width + 1) / 2;
+  ARGBToI420(s.argb, s.width * 4, d.y, d.width, d.u, hw, d.v, hw,
+             s.width, s.height);
+}
+
+static void BenchI420ScaleHalfBox(const Frame& s, const Frame& d) {
+  const int hw = (s.width + 1) / 2;
+  const int dw = s.width / 2;
+  const int dhw = (dw + 1) / 2;
+  I420Scale(s.y, s.width, s.u, hw, s.v, hw, s.width, s.height,
+            d.y, dw, d.u, dhw, d.v, dhw, dw, s.height / 2, kFilterBox);
+}
+
+static void BenchI420ScaleBilinear(const Frame& s, const Frame& d) {
+  const int hw = (s.width + 1) / 2;
+  const int dw = s.width * 3 / 4;
+  const int dhw = (dw + 1) / 2;
+  I420Scale(s.y, s.width, s.u, hw, s.v, hw, s.width, s.height,
+            d.y, dw, d.u, dhw, d.v, dhw, dw, s.height * 3 / 4,
+            kFilterBilinear);
+}
+
+static void BenchARGBScaleBilinear(const Frame& s, const Frame& d) {
+  const int dw = s.width * 3 / 4;
+  ARGBScale(s.argb, s.width * 4, s.width, s.height,
+            d.argb, dw * 4, dw, s.height * 3 / 4, kFilterBilinear);
+}
+
+static void BenchI420ToARGBBatch(const Frame& s, const Frame&) {
+  YuvFrame src[kBatchFrames];
+  YuvFrame* dst = BatchDestinations(s.width, s.height);
+  const int hw = (s.width + 1) / 2;
+  for (int i = 0; i < kBatchFrames; ++i) {
+    memset(&src[i], 0, sizeof(src[i]));
+    src[i].fourcc = FOURCC_I420;
+    src[i].width = s.width;
+    src[i].height = s.height;
+    src[i].plane[0] = s.y;
+    src[i].plane[1] = s.u;
+    src[i].plane[2] = s.v;
+    src[i].stride[0] = s.width;
+    src[i].stride[1] = hw;
+    src[i].stride[2] = hw;
+  }
+  I420ToARGBBatch(src, dst, kBatchFrames, 1);
+}
+
+static void BenchARGBScaleBilinearBatch(const Frame& s, const Frame&) {
+  YuvFrame src[kBatchFrames];
+  YuvFrame* dst = BatchDestinations(s.width * 3 / 4, s.height * 3 / 4);
+  for (int i = 0; i < kBatchFrames; ++i) {
+    memset(&src[i], 0, sizeof(src[i]));
+    src[i].fourcc = FOURCC_ARGB;
+    src[i].width = s.width;
+    src[i].height = s.height;
+    src[i].plane[0] = s.argb;
+    src[i].stride[0] = s.width * 4;
+  }
+  ARGBScaleBatch(src, dst, kBatchFrames, kFilterBilinear, 1);
+}
+
+static void BenchI420Rotate90(const Frame& s, const Frame& d) {
+  const int hw = (s.width + 1) / 2;
+  const int dhw = (s.height + 1) / 2;
+  I420Rotate(s.y, s.width, s.u, hw, s.v, hw,
+             d.y, s.height, d.u, dhw, d.v, dhw,
+             s.width, s.height, kRotate90);
+}
+
+static void BenchARGBRotate90(const Frame& s, const Frame& d) {
+  ARGBRotate(s.argb, s.width * 4, d.argb, s.height * 4,
+             s.width, s.height, kRotate90);
+}
+
+static void BenchSumSquareError(const Frame& s, const Frame&) {
+  ComputeSumSquareErrorPlane(s.y, s.width, s.argb, s.width,
+                             s.width, s.height);
+}
+
+static void BenchHashDjb2(const Frame& s, const Frame&) {
+  HashDjb2(s.y, static_cast<uint64>(s.width) * s.height, 5381);
+}
+
+static void BenchPlaneStats(const Frame& s, const Frame&) {
+  uint64 sum;
+  uint64 sum_squares;
+  int min;
+  int max;
+  PlaneStats(s.y, s.width, s.width, s.height, &sum, &sum_squares, &min, &max);
+}
+
+static const Kernel kKernels[] = {
+  { "I420ToARGB", 1.5 + 4, BenchI420ToARGB, 1 },
+  { "NV12ToARGB", 1.5 + 4, BenchNV12ToARGB, 1 },
+  { "ARGBToI420", 4 + 1.5, BenchARGBToI420, 1 },
+  { "I420ScaleHalfBox", 1.5 + 1.5 / 4, BenchI420ScaleHalfBox, 1 },
+  { "I420Scale3_4Bilinear", 1.5 + 1.5 * 9 / 16, BenchI420ScaleBilinear, 1 },
+  { "ARGBScale3_4Bilinear", 4 + 4 * 9 / 16., BenchARGBScaleBilinear, 1 },
+  { "I420ToARGBBatch", 1.5 + 4, BenchI420ToARGBBatch, kBatchFrames },
+  { "ARGBScale3_4BilinearBatch", 4 + 4 * 9 / 16., BenchARGBScaleBilinearBatch,
+    kBatchFrames },
+  { "I420Rotate90", 1.5 + 1.5, BenchI420Rotate90, 1 },
+  { "ARGBRotate90", 4 + 4, BenchARGBRotate90, 1 },
+  { "ComputeSumSquareErrorPlane", 1 + 1, BenchSumSquareError, 1 },
+  { "HashDjb2", 1, BenchHashDjb2, 1 },
+  { "PlaneStats", 1, BenchPlaneStats, 1 },
+};
+
+struct Resolution {
+  const char* name;
+  int width;
+  int height;
+};
+
+static const Resolution kResolutions[] = {
+  { "thumb", 96, 96 },
+  { "qcif", 176, 144 },
+  { "cif", 352, 288 },
+  { "vga", 640, 480 },
+  { "720p", 1280, 720 },
+  { "1080p", 1920, 1080 },
+  { "4k", 3840, 2160 },
+  { "8k", 7680, 4320 },
+};
+
+// Each mask enables one instruction set and those below it. A mask is
+// measured when the cpu has its flag.
+struct CpuMask {
+  const char* name;
+  int flag;
+  int mask;
+};
+
+static const CpuMask kCpuMasks[] = {
+  { "C", 0, 0 },
+  { "SSE2", kCpuHasSSE2, kCpuHasX86 | kCpuHasSSE2 },
+  { "SSSE3", kCpuHasSSSE3, kCpuHasX86 | kCpuHasSSE2 | kCpuHasSSSE3 },
+  { "SSE41", kCpuHasSSE41,
+    kCpuHasX86 | kCpuHasSSE2 | kCpuHasSSSE3 | kCpuHasSSE41 | kCpuHasSSE42 },
+  { "AVX2", kCpuHasAVX2, -1 },
+  { "NEON", kCpuHasNEON, -1 },
+};
+
+#define ARRAY_SIZE(a) static_cast<int>(sizeof(a) / sizeof((a)[0]))
+
+static double GetSeconds() {
+#if defined(_WIN32)
+  LARGE_INTEGER count;
+  LARGE_INTEGER frequency;
+  QueryPerformanceCounter(&count);
+  QueryPerformanceFrequency(&frequency);
+  return static_cast<double>(count.QuadPart) /
+      static_cast<double>(frequency.QuadPart);
+#else
+  struct timeval t;
+  gettimeofday(&t, NULL);
+  return t.tv_sec + t.tv_usec * 0.000001;
+#endif
+}
+
+// Time stamp counter, or 0 where there is none.
+static uint64 GetCycles() {
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+  return __rdtsc();
+#elif defined(__i386__) || defined(__x86_64__)
+  uint32 lo;
+  uint32 hi;
+  asm volatile ("rdtsc" : "=a"(lo), "=d"(hi));
+  return (static_cast<uint64>(hi) << 32) | lo;
+#else
+  return 0;
+#endif
+}
+
+// Lays out the planes of a frame in buffer, offset by align from 16 bytes.
+static void SetFrame(uint8* buffer, int width, int height, int align,
+                     Frame* frame) {
+  const int y_size = width * height;
+  const int uv_size = ((width + 1) / 2) * ((height + 1) / 2);
+  uint8* p = reinterpret_cast<uint8*>(
+      (reinterpret_cast<uintptr_t>(buffer) + 15) & ~15);
+  frame->width = width;
+  frame->height = height;
+  frame->y = p + align;
+  p += (y_size + 31) & ~15;
+  frame->u = p + align;
+  p += (uv_size + 31) & ~15;
+  frame->v = p + align;
+  p += (uv_size + 31) & ~15;
+  frame->uv = p + align;
+  p += (uv_size * 2 + 31) & ~15;
+  frame->argb = p + align;
+}
+
+static int FrameBufferSize(int width, int height) {
+  const int uv_size = ((width + 1) / 2) * ((height + 1) / 2);
+  return width * height + uv_size * 4 + width * height * 4 + 16 * 6;
+}
+
+static void Usage() {
+  printf("libyuv_bench v%d\n", LIBYUV_VERSION);
+  printf("libyuv_bench [-t seconds] [-f filter] [-s sizes] [-j]\n");
+  printf("  -t  minimum time for each measurement. Default 0.1\n");
+  printf("  -f  only measure functions whose name contains filter\n");
+  printf("  -s  comma separated sizes: "
+         "thumb,qcif,cif,vga,720p,1080p,4k,8k\n");
+  printf("  -j  print JSON instead of CSV\n");
+}
+
+int main(int argc, char** argv) {
+  double min_seconds = 0.1;
+  const char* filter = NULL;
+  const char* sizes = NULL;
+  bool json = false;
+  for (int i = 1; i < argc; ++i) {
+    if (!strcmp(argv[i], "-t") && i + 1 < argc) {
+      min_seconds = atof(argv[++i]);
+    } else if (!strcmp(argv[i], "-f") && i + 1 < argc) {
+      filter = argv[++i];
+    } else if (!strcmp(argv[i], "-s") && i + 1 < argc) {
+      sizes = argv[++i];
+    } else if (!strcmp(argv[i], "-j")) {
+      json = true;
+    } else {
+      Usage();
+      return -1;
+    }
+  }
+
+  if (json) {
+    printf("{\"version\": %d, \"results\": [\n", LIBYUV_VERSION);
+  } else {
+    printf("function,width,height,align,cpu,iterations,ms,"
+           "mpix_per_s,gb_per_s,cycles_per_pixel,frames_per_s\n");
+  }
+  bool first = true;
+  for (int r = 0; r < ARRAY_SIZE(kResolutions); ++r) {
+    const Resolution& res = kResolutions[r];
+    if (sizes) {
+      // Match whole names in the comma separated list.
+      const char* s = strstr(sizes, res.name);
+      const size_t n = strlen(res.name);
+      if (!s || (s != sizes && s[-1] != ',') || (s[n] && s[n] != ',')) {
+        continue;
+      }
+    }
+    const int buffer_size = FrameBufferSize(res.width, res.height);
+    uint8* src_buffer = new uint8[buffer_size];
+    uint8* dst_buffer = new uint8[buffer_size];
+    srand(1234);
+    for (int i = 0; i < buffer_size; ++i) {
+      src_buffer[i] = static_cast<uint8>(rand());  // NOLINT
+    }
+    memset(dst_buffer, 0, buffer_size);
+    const double pixels = static_cast<double>(res.width) * res.height;
+
+    for (int k = 0; k < ARRAY_SIZE(kKernels); ++k) {
+      const Kernel& kernel = kKernels[k];
+      if (filter && !strstr(kernel.name, filter)) {
+        continue;
+      }
+      // Batches are for small frames.
+      if (kernel.frames > 1 && pixels > 352 * 288) {
+        continue;
+      }
+      for (int align = 0; align < 2; ++align) {
+        Frame src;
+        Frame dst;
+        SetFrame(src_buffer, res.width, res.height, align, &src);
+        SetFrame(dst_buffer, res.width, res.height, align, &dst);
+        for (int c = 0; c < ARRAY_SIZE(kCpuMasks); ++c) {
+          MaskCpuFlags(-1);
+          if (kCpuMasks[c].flag && !TestCpuFlag(kCpuMasks[c].flag)) {
+            continue;
+          }
+          MaskCpuFlags(kCpuMasks[c].mask);
+
+          // The first run warms the caches and sizes the loop.
+          double start = GetSeconds();
+          kernel.run(src, dst);
+          double elapsed = GetSeconds() - start;
+          int iterations = 1;
+          if (elapsed < min_seconds) {
+            iterations = static_cast<int>(min_seconds /
+                                          (elapsed > 0.000001 ?
+                                           elapsed : 0.000001)) + 1;
+          }
+          const uint64 start_cycles = GetCycles();
+          start = GetSeconds();
+          for (int i = 0; i < iterations; ++i) {
+            kernel.run(src, dst);
+          }
+          elapsed = GetSeconds() - start;
+          const uint64 cycles = GetCycles() - start_cycles;
+          if (elapsed <= 0.) {
+            elapsed = 0.000001;
+          }
+
+          const double total_frames =
+              static_cast<double>(iterations) * kernel.frames;
+          const double total_pixels = pixels * total_frames;
+          const double mpix_per_s = total_pixels / elapsed / 1000000.;
+          const double gb_per_s =
+              total_pixels * kernel.bytes_per_pixel / elapsed / 1000000000.;
+          const double cycles_per_pixel =
+              static_cast<double>(cycles) / total_pixels;
+          const double frames_per_s = total_frames / elapsed;
+          const char* align_name = align ? "unaligned" : "aligned";
+          if (json) {
+            printf("%s  {\"function\": \"%s\", \"width\": %d, "
+                   "\"height\": %d, \"align\": \"%s\", \"cpu\": \"%s\", "
+                   "\"iterations\": %d, \"ms\": %.4f, "
+                   "\"mpix_per_s\": %.2f, \"gb_per_s\": %.3f, "
+                   "\"cycles_per_pixel\": ",
+                   first ? "" : ",\n", kernel.name, res.width, res.height,
+                   align_name, kCpuMasks[c].name, iterations,
+                   elapsed * 1000. / iterations, mpix_per_s, gb_per_s);
+            if (cycles) {
+              printf("%.3f", cycles_per_pixel);
+            } else {
+              printf("null");
+            }
+            printf(", \"frames_per_s\": %.1f}", frames_per_s);
+          } else {
+            printf("%s,%d,%d,%s,%s,%d,%.4f,%.2f,%.3f,",
+                   kernel.name, res.width, res.height, align_name,
+                   kCpuMasks[c].name, iterations,
+                   elapsed * 1000. / iterations, mpix_per_s, gb_per_s);
+            if (cycles) {
+              printf("%.3f", cycles_per_pixel);
+            }
+            printf(",%.1f\n", frames_per_s);
+          }
+          first = false;
+          fflush(stdout);
+        }
+      }
+    }
+    delete[] src_buffer;
+    delete[] dst_buffer;
+  }
+  for (int i = 0; i < kBatchFrames; ++i) {
+    FreeFrame(&batch_dst_[i]);
+  }
+  MaskCpuFlags(-1);
+  if (json) {
+    printf("\n]}\n");
+  }
+  return 0;
+}